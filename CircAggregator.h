@@ -0,0 +1,445 @@
+// ==========================================================================
+// Copyright (C) 2026 DRNadler
+// ==========================================================================
+// classes defined here:
+// CircConcurrentAggregator       - lock-free multi-producer aggregation of circular values, read by snapshots
+// CircConcurrentAggregatorTester - tester for CircConcurrentAggregator
+// ==========================================================================
+
+#pragma once
+
+#include <assert.h>
+#include <algorithm>    // std::min, std::equal
+#include <cmath>        // std::abs
+#include <atomic>
+#include <cstdint>      // uint64_t
+#include <mutex>
+#include <random>       // CircConcurrentAggregatorTester
+#include <span>
+#include <stdexcept>    // std::length_error
+#include <thread>       // CircConcurrentAggregatorTester
+#include <vector>
+
+#include "CircVal.h"    // CircVal, CircValue
+#include "CircStat.h"   // CircHistogram, CircAverageSummary
+
+// ==========================================================================
+// lock-free multi-producer aggregation of circular values, read by snapshots
+// T is a circular value type defined with the CircValTypeDef macro
+// Summary is a mergeable summary of the values of T: CircHistogram<T> (default), CircAverageSummary<T> - any type with
+// Add(span<const CircVal<T>>) and Merge(const Summary&), copyable
+//
+// each producer thread appends to its own shard (see GetProducer): a block of BlockSize values, which only it writes.
+// an append stores the value, and publishes the shard's count with a release store - no locks, no atomic
+// read-modify-write, no shared cache line (wait-free).
+// once a block is full, the producer adds it to the shard's summary, and publishes a copy of the summary - and the
+// block that it writes next - through a triple buffer (an atomic exchange; producers never wait for readers). the
+// published blocks are recycled by the producer once the reader has moved on to a later one: 3 blocks and 4 summaries
+// per shard, whether or not snapshots are taken.
+// a snapshot (GetSnapshot) is the epoch of the published counts of all shards: a prefix of each producer's values. the
+// reader merges the latest published summary of each shard, and adds the values of its block that were published
+// after it - at most BlockSize values per producer - in the order of the producers. readers are serialized among
+// themselves. the snapshot's summary is finalized by its own functions: GetAvrg, GetMedian (CircHistogram), GetAvrg
+// (CircAverageSummary).
+// the summary of a snapshot is that of its prefixes - each added to a summary of its producer, merged in the order of
+// the producers - regardless of the timing of the snapshots (approximate CircAverageSummary: up to rounding of the sums).
+// costs: a producer adds and copies its summary once per BlockSize values - O(bins) for CircHistogram and approximate
+// CircAverageSummary, but O(values of the producer) for exact CircAverageSummary. a snapshot: O(producers) merges of
+// summaries + O(BlockSize) values per producer.
+template<typename T, typename Summary = CircHistogram<T>>
+class CircConcurrentAggregator
+{
+public:
+    static constexpr size_t BlockSize = 4096; // values per block
+
+private:
+    static constexpr size_t  CacheLine = 64; // the members written by producers and by the reader are in separate cache lines
+    static constexpr uint8_t Fresh     = 4 ; // the middle slot was published by the producer, not yet taken by the reader
+
+    struct Block
+    {
+        CircVal<T> Vals[BlockSize];
+    };
+
+    // a published state of a shard: the summary of its first nCount values, and the block of the values from nCount on
+    struct alignas(CacheLine) Slot
+    {
+        Summary  Sum        ;
+        uint64_t nCount = 0 ;
+        Block*   pBlock     ;
+
+        explicit Slot(const Summary& Proto) : Sum(Proto), pBlock(new Block)
+        {
+        }
+    };
+
+    struct alignas(CacheLine) Shard
+    {
+        // producer
+        Block*                                   pTail          ; // the block being written - that of the latest published slot
+        uint64_t                                 nWritten   = 0 ; // number of values written
+        uint8_t                                  nBack      = 2 ; // the slot written by the producer
+        Summary                                  ProdSum        ; // the summary of the full blocks
+
+        // published by the producer
+        alignas(CacheLine) std::atomic<uint64_t> nPublished { 0 }; // number of values visible to the reader
+
+        // the triple buffer of slots: front (the reader), middle (exchanged), back (the producer)
+        alignas(CacheLine) std::atomic<uint8_t>  nMiddle    { 1 }; // the middle slot | Fresh
+        Slot                                     Slots[3]       ;
+
+        // reader
+        alignas(CacheLine) uint8_t               nFront     = 0 ; // the slot read by the reader
+        uint64_t                                 nFolded    = 0 ; // number of values of the latest snapshot
+
+        Shard(const Summary& Proto) : ProdSum(Proto), Slots{ Slot(Proto), Slot(Proto), Slot(Proto) }
+        {
+            pTail = Slots[nFront].pBlock; // values from 0 on
+        }
+
+        ~Shard()
+        {
+            for (const auto& s : Slots)
+                delete s.pBlock;
+        }
+
+        // producer: the slot of the next value
+        CircVal<T>& Next()
+        {
+            const size_t k = nWritten % BlockSize;
+            if (k == 0 && nWritten)
+            {
+                // pTail is full: add it to the summary, and publish the summary, with the block of the back slot - which
+                // the reader does not read - as the next one
+                ProdSum.Add(std::span<const CircVal<T>>(pTail->Vals, BlockSize));
+
+                Slot& B = Slots[nBack];
+                B.Sum    = ProdSum ;
+                B.nCount = nWritten;
+                pTail    = B.pBlock;
+                nBack    = static_cast<uint8_t>(nMiddle.exchange(nBack | Fresh, std::memory_order_acq_rel) & ~Fresh);
+            }
+            return pTail->Vals[k];
+        }
+
+        void Publish()
+        {
+            nPublished.store(nWritten, std::memory_order_release);
+        }
+
+        // reader: take the latest published slot, and add its summary and the values of its block published since, to Sum
+        void Fold(Summary& Sum)
+        {
+            if (nMiddle.load(std::memory_order_relaxed) & Fresh)
+                nFront = static_cast<uint8_t>(nMiddle.exchange(nFront, std::memory_order_acq_rel) & ~Fresh);
+
+            const Slot&    F = Slots[nFront];
+            const uint64_t n = std::min<uint64_t>(nPublished.load(std::memory_order_acquire), F.nCount + BlockSize);
+
+            Sum.Merge(F.Sum);
+            Sum.Add(std::span<const CircVal<T>>(F.pBlock->Vals, static_cast<size_t>(n - F.nCount)));
+            nFolded = n;
+        }
+    };
+
+    const Summary                     m_Proto      ; // an empty summary - the mode / bins of all summaries
+    std::vector<std::atomic<Shard*>>  m_Shards     ; // registered shards; null: being registered
+    std::atomic<size_t>               m_nRegistered; // number of GetProducer calls
+    std::mutex                        m_ReaderLock ; // serializes the readers - never taken by producers
+
+public:
+    // ----------------------------------------------
+    // appends values to a shard - to be used by one thread at a time. the values remain in the aggregator after the
+    // producer is destroyed. a default-constructed producer is not valid
+    class Producer
+    {
+        Shard* m_pShard = nullptr;
+
+        friend class CircConcurrentAggregator;
+        explicit Producer(Shard* pShard) : m_pShard(pShard)
+        {
+        }
+
+    public:
+        Producer() = default;
+        Producer(Producer&& P) noexcept : m_pShard(P.m_pShard) { P.m_pShard = nullptr; }
+        Producer& operator=(Producer&& P) noexcept { m_pShard = P.m_pShard; P.m_pShard = nullptr; return *this; }
+        Producer(const Producer&) = delete;
+        Producer& operator=(const Producer&) = delete;
+
+        bool IsValid() const { return m_pShard != nullptr; }
+
+        void Add(const CircVal<T>& c)
+        {
+            assert(IsValid());
+            m_pShard->Next() = c;
+            ++m_pShard->nWritten;
+            m_pShard->Publish();
+        }
+
+        // the values of A are published together - once per block
+        // C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+        template<CircValue C>
+        void Add(std::span<const C> A)
+        {
+            assert(IsValid());
+            Shard& S = *m_pShard;
+            for (size_t i = 0; i < A.size(); )
+            {
+                CircVal<T>*  p = &S.Next();
+                const size_t e = std::min(A.size(), i + BlockSize - S.nWritten % BlockSize);
+                for (; i < e; ++i, ++S.nWritten)
+                    *p++ = CircVal<T>(A[i]);
+                S.Publish();
+            }
+        }
+    };
+
+    // the epoch of a snapshot, and its summary
+    struct Snapshot
+    {
+        Summary               Sum   ; // the summary of the values of the snapshot
+        uint64_t              nCount; // number of values
+        std::vector<uint64_t> Counts; // the epoch: number of values of each producer - in the order of GetProducer
+    };
+
+    // ----------------------------------------------
+    // Proto: an empty summary - e.g. CircHistogram<T>(3600), CircAverageSummary<T>() (exact), CircAverageSummary<T>(1024)
+    // nMaxProducers: the number of producers that may be registered
+    explicit CircConcurrentAggregator(const Summary& Proto = Summary(), size_t nMaxProducers = 256) :
+        m_Proto(Proto), m_Shards(nMaxProducers), m_nRegistered(0)
+    {
+    }
+
+    ~CircConcurrentAggregator()
+    {
+        for (auto& s : m_Shards)
+            delete s.load(std::memory_order_relaxed);
+    }
+
+    CircConcurrentAggregator(const CircConcurrentAggregator&) = delete;
+    CircConcurrentAggregator& operator=(const CircConcurrentAggregator&) = delete;
+
+    // register a producer - lock-free; may be called concurrently with producers and readers
+    // throws std::length_error beyond nMaxProducers
+    Producer GetProducer()
+    {
+        const size_t s = m_nRegistered.fetch_add(1, std::memory_order_relaxed);
+        if (s >= m_Shards.size())
+            throw std::length_error("CircConcurrentAggregator: too many producers");
+
+        Shard* p = new Shard(m_Proto);
+        m_Shards[s].store(p, std::memory_order_release);
+        return Producer(p);
+    }
+
+    size_t GetProducers() const
+    {
+        return std::min(m_nRegistered.load(std::memory_order_relaxed), m_Shards.size());
+    }
+
+    // ----------------------------------------------
+    // the summary of the values published by each producer so far - see above
+    // O(producers) merges of summaries + O(BlockSize) values per producer
+    Snapshot GetSnapshot()
+    {
+        std::lock_guard<std::mutex> Lock(m_ReaderLock);
+
+        Snapshot     Snap{ m_Proto, 0, {} };
+        const size_t n = GetProducers();
+        Snap.Counts.resize(n, 0);
+
+        for (size_t s = 0; s < n; ++s)
+            if (Shard* p = m_Shards[s].load(std::memory_order_acquire)) // null: being registered - no values yet
+            {
+                p->Fold(Snap.Sum);
+                Snap.Counts[s]  = p->nFolded;
+                Snap.nCount    += p->nFolded;
+            }
+
+        return Snap;
+    }
+};
+
+// ==========================================================================
+// tester for CircConcurrentAggregator
+// Type should be defined using the CircValType template
+template <typename Type>
+class CircConcurrentAggregatorTester
+{
+    using Hist = CircHistogram<Type>;
+    using Summ = CircAverageSummary<Type>;
+
+    // the summary of the first Counts[p] values of each producer p - as the snapshots should be
+    template<typename Summary>
+    static Summary Expected(const Summary& Proto, const std::vector<std::vector<CircVal<Type>>>& Vals, const std::vector<uint64_t>& Counts)
+    {
+        Summary Res = Proto;
+        for (size_t p = 0; p < Counts.size(); ++p)
+        {
+            Summary S = Proto;
+            S.Add(std::span<const CircVal<Type>>(Vals[p].data(), Counts[p]));
+            Res.Merge(S);
+        }
+        return Res;
+    }
+
+    static bool IsEqual(const Hist& H1, const Hist& H2)
+    {
+        if (H1.GetCount() != H2.GetCount() || H1.GetAvrg() != H2.GetAvrg() || H1.GetMedian() != H2.GetMedian())
+            return false;
+
+        for (size_t b = 0; b < H1.GetBins(); ++b)
+            if (H1.GetCount(b) != H2.GetCount(b) || (H1.GetCount(b) && H1.GetBinMean(b) != H2.GetBinMean(b)))
+                return false;
+        return true;
+    }
+
+    // approximate mode: the sums of the bins depend on the spans folded, up to rounding
+    static bool IsEqual(const Summ& S1, const Summ& S2)
+    {
+        if (S1.IsExact())
+            return S1.GetItems() == S2.GetItems() && S1.GetAvrg() == S2.GetAvrg();
+
+        const auto A1 = S1.GetAvrg(), A2 = S2.GetAvrg();
+        return S1.GetItems() == S2.GetItems() && A1.size() == A2.size() &&
+               std::equal(A1.begin(), A1.end(), A2.begin(), [](double a1, double a2) { return std::abs(CircVal<Type>::Sdist(a1, a2)) < 1e-9 * Type::R; });
+    }
+
+    // nProducers threads append Vals concurrently - single values and spans - while a reader takes snapshots
+    template<typename Summary>
+    static void TestConcurrent(const Summary& Proto, const std::vector<std::vector<CircVal<Type>>>& Vals)
+    {
+        using Aggregator = CircConcurrentAggregator<Type, Summary>;
+
+        const size_t nProducers = Vals.size();
+        Aggregator   Agg(Proto);
+
+        std::vector<typename Aggregator::Producer> P;
+        for (size_t p = 0; p < nProducers; ++p)
+            P.emplace_back(Agg.GetProducer());
+        assert(Agg.GetProducers() == nProducers);
+
+        std::atomic<size_t>                     nDone{ 0 };
+        std::vector<typename Aggregator::Snapshot> Snaps;
+
+        std::thread Reader([&]
+        {
+            std::vector<uint64_t> Prev(nProducers, 0);
+            while (nDone.load() < nProducers)
+            {
+                auto Snap = Agg.GetSnapshot();
+                assert(Snap.Counts.size() == nProducers);
+                for (size_t p = 0; p < nProducers; ++p)
+                {
+                    assert(Snap.Counts[p] >= Prev[p] && Snap.Counts[p] <= Vals[p].size()); // monotonic
+                    Prev[p] = Snap.Counts[p];
+                }
+                if (Snaps.size() < 20)
+                    Snaps.emplace_back(std::move(Snap));
+            }
+        });
+
+        std::vector<std::thread> Producers;
+        for (size_t p = 0; p < nProducers; ++p)
+            Producers.emplace_back([&, p]
+            {
+                const auto& V = Vals[p];
+                for (size_t i = 0; i < V.size(); )
+                    if (i % 3 == 0)
+                        P[p].Add(V[i++]);
+                    else // spans of 1..1000 values - within and across blocks
+                    {
+                        const size_t k = std::min(V.size() - i, 1 + (i * 7919) % 1000);
+                        P[p].Add(std::span<const CircVal<Type>>(V.data() + i, k));
+                        i += k;
+                    }
+                ++nDone;
+            });
+
+        for (auto& t : Producers)
+            t.join();
+        Reader.join();
+
+        // the snapshots taken while producing: their prefixes
+        for ([[maybe_unused]] const auto& Snap : Snaps)
+        {
+            [[maybe_unused]] uint64_t nCount = 0;
+            for (const auto c : Snap.Counts)
+                nCount += c;
+            assert(Snap.nCount == nCount);
+            assert(IsEqual(Snap.Sum, Expected(Proto, Vals, Snap.Counts)));
+        }
+
+        // all values
+        [[maybe_unused]] const auto Snap = Agg.GetSnapshot();
+        for (size_t p = 0; p < nProducers; ++p)
+            assert(Snap.Counts[p] == Vals[p].size());
+        assert(IsEqual(Snap.Sum, Expected(Proto, Vals, Snap.Counts)));
+
+        // a snapshot with no new values: the same
+        assert(IsEqual(Agg.GetSnapshot().Sum, Snap.Sum));
+    }
+
+public:
+    CircConcurrentAggregatorTester()
+    {
+        Test();
+    }
+
+    static void Test()
+    {
+        std::default_random_engine             rand_engine;
+        std::uniform_real_distribution<double> c_uni_dist(Type::L, Type::H);
+        std::normal_distribution<double>       c_nrm_dist(0., Type::R / 20.);
+
+        // producers of different lengths - over several blocks, within a block, none
+        const size_t                            Lengths[] = { 50000, 3 * CircConcurrentAggregator<Type>::BlockSize, 1000, 0 };
+        std::vector<std::vector<CircVal<Type>>> Vals;
+        for (const size_t n : Lengths)
+        {
+            const double fMean = c_uni_dist(rand_engine);
+            auto&        V     = Vals.emplace_back(n);
+            for (auto& v : V)
+                v = fMean + c_nrm_dist(rand_engine);
+        }
+
+        TestConcurrent(Hist(360), Vals);
+        TestConcurrent(Summ(   ), Vals); // exact
+        TestConcurrent(Summ(256), Vals); // approximate
+
+        // the exact summary: the average of all values
+        {
+            CircConcurrentAggregator<Type, Summ> Agg;
+            std::vector<CircVal<Type>>           All;
+            {
+                auto P = Agg.GetProducer();
+                for (const auto& V : Vals)
+                {
+                    P.Add(std::span<const CircVal<Type>>(V));
+                    All.insert(All.end(), V.begin(), V.end());
+                }
+            } // the values remain after the producer is destroyed
+
+            Summ S;
+            S.Add(std::span<const CircVal<Type>>(All));
+            assert(Agg.GetSnapshot().Sum.GetAvrg() == S.GetAvrg());
+        }
+
+        // the number of producers is bounded
+        {
+            CircConcurrentAggregator<Type> Agg(Hist(36), 2);
+            auto P1 = Agg.GetProducer();
+            [[maybe_unused]] auto P2 = Agg.GetProducer();
+
+            [[maybe_unused]] bool bThrown = false;
+            try { Agg.GetProducer(); } catch (const std::length_error&) { bThrown = true; }
+            assert(bThrown && Agg.GetProducers() == 2);
+
+            [[maybe_unused]] typename CircConcurrentAggregator<Type>::Producer P3;
+            assert(!P3.IsValid() && P1.IsValid());
+            P3 = std::move(P1);
+            assert(P3.IsValid() && !P1.IsValid());
+        }
+    }
+};
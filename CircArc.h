@@ -1,234 +1,1085 @@
-// ==========================================================================
-// Copyright (C) 2013 Lior Kogan (koganlior1@gmail.com)
-// ==========================================================================
-// classes defined here:
-// CircArc            - circular arc
-// CircArcTester      - tester for CircArc class
-// ==========================================================================
-
-#pragma once
-
-#include <cmath>
-#include <assert.h>
-
-#include "CircVal.h" // CircVal, CircValTypeDef
-
-// ==========================================================================
-// circular arc length
-// Type should be defined using the CircValTypeDef macro
-template <typename Type>
-class CircArcLen
-{
-    double l; // the arc length [0, Type::R]
-
-public:
-    // ---------------------------------------------
-    operator double() const
-    {
-        return l;
-    }
-
-    // ---------------------------------------------
-    // construction based on a floating-point value
-    // floating-point is truncated into the range [0, Type::R]
-    CircArcLen(double r) : l(__min(__max(0., r), Type::R))
-    {
-    }
-
-    // construction based on a circular arc length of the same type
-    CircArcLen(const CircArcLen& c) : l(c.l)
-    {
-    }
-
-    // construction based on a circular arc length another type
-    // sample use: CircArcLen<SignedRadRange> c= c2;   -or-   CircArcLen<SignedRadRange> c(c2);
-    template<typename Type2>
-    CircArcLen(const CircArcLen<Type2>& c) : l((c == Type2::R) ? Type::R : Type::R / Type2::R * c) // ... to avoid rounding errors
-    {
-    }
-
-    // ---------------------------------------------
-    // assignment from a floating-point value
-    // floating-point is truncated into the range [0, Type::R]
-    CircArcLen& operator= (double r)
-    {
-        l = __min(__max(0., r), Type::R);
-        return *this;
-    }
-
-    // assignment from a circular arc length of the same type
-    CircArcLen& operator=(const CircArcLen& c)
-    {
-        l = c.l;
-        return *this;
-    }    
-
-    // assignment from another type of circular arc length
-    template<typename Type2>
-    CircArcLen& operator= (const CircArcLen<Type2>& c)
-    {
-        l = (c == Type2::R) ? Type::R : Type::R / Type2::R * c; // ... to avoid rounding errors
-        return *this;
-    }
-};
-
-// ==========================================================================
-// circular arc
-// Type should be defined using the CircValTypeDef macro
-template <typename Type>
-class CircArc
-{
-    // the arc [c1,c1+l] is defined by the shortest increasing walk from c1 to c1+l, unless l=Type::R where the arc is defined as the whole circle
-    CircVal   <Type> c1; // the arc start-point [Type::L, Type::H)
-    CircVal   <Type> c2; // the arc end  -point [Type::L, Type::H). Note that c2=c1 in two cases: (a) l=0 (b) l=Type::R
-    CircArcLen<Type> l ; // the arc length      [0      , Type::R]
-
-    // ---------------------------------------------
-public:
-    CircVal   <Type> GetC1() const { return c1; } // the arc start-point [Type::L, Type::H)
-    CircVal   <Type> GetC2() const { return c2; } // the arc end  -point [Type::L, Type::H). Note that c2=c1 in two cases: (a) l=0 (b) l=Type::R
-    CircArcLen<Type> GetL () const { return l ; } // the arc length      [0      , Type::R]
-
-    // ---------------------------------------------
-    CircArc() : c1(Type::Z), c2(Type::Z), l(0)
-    {
-    }
-
-    // "reference" construction:
-    // construction based on CircVal (arc start point) and CircArcLen (arc length)
-    template<typename Type2, typename Type3>
-    CircArc(const CircVal<Type2>& _c1, const CircArcLen<Type3>& _l) : c1(_c1), c2((double)CircVal<Type>(c1)+(double)CircArcLen<Type>(_l)), l(_l)
-    {
-    }
-
-    // construction based on two floating-point values (arc start-point, arc length)
-    // c1 is wrapped into the range, r is truncated into the range
-    CircArc(double fc1, double fl) : c1(fc1), c2(fc1+CircArcLen<Type>(fl)), l(fl)
-    {
-    }
-
-    // construction based on two circular values of same/different type (arc start-point, arc end-point)
-    // note that if c1==c2, the arc length will be 0
-    template<typename Type2, typename Type3>
-    CircArc(const CircVal<Type2>& _c1, const CircVal<Type3>& _c2) : c1(_c1), c2(_c2), l(CircVal<Type>::Pdist(c1, c2))
-    {
-    }
-
-    // construction based on another circular arc of same/different circular-value type
-    // sample use: CircArc<SignedRadRange> a = a2;   -or-   CircArc<SignedRadRange> a(a2);
-    template<typename Type2>
-    CircArc(const CircArc<Type2>& a) : c1(a.GetC1()), c2(a.GetC2()), l(a.GetL())
-    {
-    }
-
-    // ---------------------------------------------
-    // assignment from a circular arc of same/different circular arc type
-    template<typename Type2>
-    CircArc& operator= (const CircArc<Type2>& a)
-    {
-        c1 = a.GetC1();
-        c2 = a.GetC2();
-        l  = a.GetL ();
-        return *this;
-    }
-
-    // ---------------------------------------------
-    bool operator==(const CircArc& a) const
-    {
-        if ((l == Type::R) && (a.l == Type::R)) // both are full-circle; start-point doesn't matter
-            return true;
-
-        return std::equal_to<decltype(c1)>{}(c1, a.c1) && std::equal_to<decltype(l)>{}(l, a.l); // std::equal_to instead of == to avoid triggering -Wfloat-equal
-    }
-
-    bool operator!=(const CircArc& a) const
-    {
-        return !(*this == a);
-    }
-
-    // check if this arc contains a circular value (note that arc contains its endpoints)
-    bool Contains(const CircVal<Type>& c) const
-    {
-        return l - CircVal<Type>::Pdist(c1, c) > -1e-12;
-    }
-
-    // check if this arc contains another circular arc (note that arcs contain their endpoints)
-    bool Contains(const CircArc& a) const
-    {
-        if (  l == Type::R) return true ; // full-circle
-        if (a.l == Type::R) return false; // full-circle
-
-        // ensure order: c1 --- a.c1 --- a.c2 --- c2
-        const double l1 = CircVal<Type>::Pdist(c1, a.c1);
-        const double l2 = CircVal<Type>::Pdist(c1, a.c2);
-        return (l2 - l1 > -1e-12) && (l - l2 > -1e-12);
-    }
-
-    // check if two circular arcs intersect (note that arcs contain their endpoints)
-    bool Intersect(const CircArc& a) const
-    {
-        return Contains(a.c1) || a.Contains(c1); // one of them contains the start of the other
-    }
-};
-
-// ==========================================================================
-// circular arcs
-// Type should be defined using the CircValTypeDef macro
-template <typename Type>
-class CircArcs
-{
-};
-
-// CircArcs Union       (const CircArc& a);
-// CircArcs Intersection(const CircArc& a);
-// CircArcs Diff        (const CircArc& a);
-
-// ==========================================================================
-// tester for CircVal class
-template <typename Type>
-class CircArcTester
-{
-public:
-    CircArcTester()
-    {
-        Test();
-    }
-
-    static void Test()
-    {
-        const unsigned nSteps = 36              ;
-        const double   fStep  = Type::R / nSteps;
-
-        unsigned m = 0, n = 0, p = 0, q[nSteps+1];
-
-        for (unsigned i = 0; i<nSteps; ++i)
-            q[i] = 0;
-
-        for (unsigned i = 0; i < nSteps; ++i)
-            for (unsigned j = 0; j <= nSteps; ++j)
-            {
-                CircArc<Type> a1(Type::L + i*fStep, j*fStep); // 1st arc: start-point, length
-
-                for (unsigned k = 0; k < nSteps; ++k)
-                    for (unsigned l = 0; l <= nSteps; ++l)
-                    {
-                        CircArc<Type> a2(Type::L + k*fStep, l*fStep); // 2nd arc: start-point, length
-
-                        bool b1 = a1.Contains(a2); if (b1) ++m;       // if a2 is a sub-arc of a1
-                        bool b2 = a2.Contains(a1); if (b2) ++n;       // if a1 is a sub-arc of a2
-
-                        if   (a1 == a2) { assert(  b1 && b2 ); ++p; } // if identical
-                        else              assert(!(b1 && b2));
-
-                        if (a1.Intersect(a2)) ++q[j];
-                    }
-            }
-
-        assert (p == 2*nSteps*nSteps                                     ); // number of identical arcs
-        assert (m ==   nSteps*nSteps * (nSteps*nSteps + 9*nSteps + 8) / 6); // number of times a2 is a sub-arc of a1
-        assert (m == n                                                   ); // number of times a1 is a sub-arc of a2 shuould be identical
-//      assert (q == ...)                                                   // number of intersecting arcs
-
-        // --------------
-    }
-};
+// ==========================================================================
+// Copyright (C) 2013 Lior Kogan (koganlior1@gmail.com)
+// ==========================================================================
+// classes defined here:
+// CircArc            - circular arc
+// CircArcs           - set of circular arcs
+// CircArcIndex       - index of circular arcs, for stabbing queries
+// CircArcTester      - tester for CircArc class
+// CircArcsTester     - tester for CircArcs class
+// CircArcIndexTester - tester for CircArcIndex class
+// ==========================================================================
+
+// DRNadler 14-Oct-2026: CircArcLen and CircArc take the storage type of their values as a template parameter.
+
+// DRNadler 14-Oct-2026: Add CircArcIndex - batch stabbing queries over many arcs.
+
+// DRNadler 14-Oct-2026: CircArcs is a normalized sorted set of disjoint arcs: union, intersection and difference by
+// merging.
+
+#pragma once
+
+#include <cmath>
+#include <assert.h>
+#include <algorithm>  // std::lower_bound, std::merge, std::sort, std::push_heap, std::pop_heap
+#include <functional> // std::equal_to
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "CircVal.h" // CircVal, CircValTypeDef
+
+// ==========================================================================
+// circular arc length
+// Type should be defined using the CircValTypeDef macro
+// F is the storage type: float, double or long double - see CircVal
+template <typename Type, typename F = double>
+class CircArcLen
+{
+    static constexpr F R = static_cast<F>(Type::R);
+
+    F l; // the arc length [0, R]
+
+public:
+    // ---------------------------------------------
+    operator F() const
+    {
+        return l;
+    }
+
+    // ---------------------------------------------
+    // construction based on a floating-point value
+    // floating-point is truncated into the range [0, Type::R]
+    CircArcLen(F r) : l(__min(__max(F(0), r), R))
+    {
+    }
+
+    // construction based on a circular arc length of the same type
+    CircArcLen(const CircArcLen& c) : l(c.l)
+    {
+    }
+
+    // construction based on a circular arc length another type and/or storage type
+    // sample use: CircArcLen<SignedRadRange> c= c2;   -or-   CircArcLen<SignedRadRange> c(c2);
+    template<typename Type2, typename F2>
+    CircArcLen(const CircArcLen<Type2, F2>& c) : l(Convert(c))
+    {
+    }
+
+    // ---------------------------------------------
+    // assignment from a floating-point value
+    // floating-point is truncated into the range [0, Type::R]
+    CircArcLen& operator= (F r)
+    {
+        l = __min(__max(F(0), r), R);
+        return *this;
+    }
+
+    // assignment from a circular arc length of the same type
+    CircArcLen& operator=(const CircArcLen& c)
+    {
+        l = c.l;
+        return *this;
+    }    
+
+    // assignment from another type and/or storage type of circular arc length
+    template<typename Type2, typename F2>
+    CircArcLen& operator= (const CircArcLen<Type2, F2>& c)
+    {
+        l = Convert(c);
+        return *this;
+    }
+
+private:
+    // length of a circular arc length of another type and/or storage type, in this range
+    template<typename Type2, typename F2>
+    static F Convert(const CircArcLen<Type2, F2>& c)
+    {
+        if (std::equal_to<F2>{}(c, static_cast<F2>(Type2::R))) // ... to avoid rounding errors
+            return R;
+
+        const F r = static_cast<F>(static_cast<std::common_type_t<F, F2>>(Type::R / Type2::R) * static_cast<F2>(c));
+        return __min(r, R); // a rounded-up length of another storage type
+    }
+};
+
+// ==========================================================================
+// circular arc
+// Type should be defined using the CircValTypeDef macro
+// F is the storage type: float, double or long double - see CircVal
+template <typename Type, typename F = double>
+class CircArc
+{
+    static constexpr F R = static_cast<F>(Type::R);
+
+    // tolerance of Contains: 1e-12 for double; the rounding error of a few operations on values of the order of R otherwise
+    static constexpr F Eps = std::is_same_v<F, double> ? F(1e-12) : 16 * std::numeric_limits<F>::epsilon() * R;
+
+    // the arc [c1,c1+l] is defined by the shortest increasing walk from c1 to c1+l, unless l=Type::R where the arc is defined as the whole circle
+    CircVal   <Type, F> c1; // the arc start-point [Type::L, Type::H)
+    CircVal   <Type, F> c2; // the arc end  -point [Type::L, Type::H). Note that c2=c1 in two cases: (a) l=0 (b) l=Type::R
+    CircArcLen<Type, F> l ; // the arc length      [0      , Type::R]
+
+    // ---------------------------------------------
+public:
+    CircVal   <Type, F> GetC1() const { return c1; } // the arc start-point [Type::L, Type::H)
+    CircVal   <Type, F> GetC2() const { return c2; } // the arc end  -point [Type::L, Type::H). Note that c2=c1 in two cases: (a) l=0 (b) l=Type::R
+    CircArcLen<Type, F> GetL () const { return l ; } // the arc length      [0      , Type::R]
+
+    // ---------------------------------------------
+    CircArc() : c1(static_cast<F>(Type::Z)), c2(static_cast<F>(Type::Z)), l(0)
+    {
+    }
+
+    // "reference" construction:
+    // construction based on CircVal (arc start point) and CircArcLen (arc length)
+    template<typename Type2, typename F2, typename Type3, typename F3>
+    CircArc(const CircVal<Type2, F2>& _c1, const CircArcLen<Type3, F3>& _l) : c1(_c1), c2((F)c1+(F)CircArcLen<Type, F>(_l)), l(_l)
+    {
+    }
+
+    // construction based on two floating-point values (arc start-point, arc length)
+    // c1 is wrapped into the range, r is truncated into the range
+    CircArc(F fc1, F fl) : c1(fc1), c2(fc1+CircArcLen<Type, F>(fl)), l(fl)
+    {
+    }
+
+    // construction based on two circular values of same/different type (arc start-point, arc end-point)
+    // note that if c1==c2, the arc length will be 0
+    template<typename Type2, typename F2, typename Type3, typename F3>
+    CircArc(const CircVal<Type2, F2>& _c1, const CircVal<Type3, F3>& _c2) : c1(_c1), c2(_c2), l(CircVal<Type, F>::Pdist(c1, c2))
+    {
+    }
+
+    // construction based on another circular arc of same/different circular-value type and/or storage type
+    // sample use: CircArc<SignedRadRange> a = a2;   -or-   CircArc<SignedRadRange> a(a2);
+    template<typename Type2, typename F2>
+    CircArc(const CircArc<Type2, F2>& a) : c1(a.GetC1()), c2(a.GetC2()), l(a.GetL())
+    {
+    }
+
+    // ---------------------------------------------
+    // assignment from a circular arc of same/different circular arc type and/or storage type
+    template<typename Type2, typename F2>
+    CircArc& operator= (const CircArc<Type2, F2>& a)
+    {
+        c1 = a.GetC1();
+        c2 = a.GetC2();
+        l  = a.GetL ();
+        return *this;
+    }
+
+    // ---------------------------------------------
+    bool operator==(const CircArc& a) const
+    {
+        if ((l == R) && (a.l == R)) // both are full-circle; start-point doesn't matter
+            return true;
+
+        return std::equal_to<decltype(c1)>{}(c1, a.c1) && std::equal_to<decltype(l)>{}(l, a.l); // std::equal_to instead of == to avoid triggering -Wfloat-equal
+    }
+
+    bool operator!=(const CircArc& a) const
+    {
+        return !(*this == a);
+    }
+
+    // check if this arc contains a circular value (note that arc contains its endpoints)
+    bool Contains(const CircVal<Type, F>& c) const
+    {
+        return l - CircVal<Type, F>::Pdist(c1, c) > -Eps;
+    }
+
+    // check if this arc contains another circular arc (note that arcs contain their endpoints)
+    bool Contains(const CircArc& a) const
+    {
+        if (  l == R) return true ; // full-circle
+        if (a.l == R) return false; // full-circle
+
+        // ensure order: c1 --- a.c1 --- a.c2 --- c2
+        const F l1 = CircVal<Type, F>::Pdist(c1, a.c1);
+        const F l2 = CircVal<Type, F>::Pdist(c1, a.c2);
+        return (l2 - l1 > -Eps) && (l - l2 > -Eps);
+    }
+
+    // check if two circular arcs intersect (note that arcs contain their endpoints)
+    bool Intersect(const CircArc& a) const
+    {
+        return Contains(a.c1) || a.Contains(c1); // one of them contains the start of the other
+    }
+};
+
+// ==========================================================================
+// circular arcs - a set of circular values, represented as a sorted list of disjoint arcs
+// Type should be defined using the CircValTypeDef macro
+//
+// the set is kept normalized: each arc is stored as a closed interval [s,e] of offsets from Type::L (0 <= s <= e <= Type::R);
+// arcs that cross Type::H are split into [s,Type::R] and [0,e]; the intervals are sorted, and disjoint - overlapping
+// or touching arcs are merged. hence the representation of a set is unique, set operations are linear merges
+// (O(n+m)), and queries are binary searches (O(log n)).
+// as in CircArc, arcs contain their endpoints, and values closer than 1e-12 are considered equal
+template <typename Type>
+class CircArcs
+{
+    struct Interval
+    {
+        double s; // start offset from Type::L
+        double e; // end   offset from Type::L
+
+        bool operator==(const Interval& i) const
+        {
+            return std::equal_to<double>{}(s, i.s) && std::equal_to<double>{}(e, i.e); // std::equal_to instead of == to avoid triggering -Wfloat-equal
+        }
+    };
+
+    static constexpr double Eps = 1e-12;
+
+    std::vector<Interval> v; // sorted, disjoint intervals
+
+    // ---------------------------------------------
+    // split an arc into one or two intervals at Type::H, and append them to V
+    static void Split(const CircArc<Type>& a, std::vector<Interval>& V)
+    {
+        double s = (double)a.GetC1() - Type::L;
+        if (s >= Type::R) // rounding
+            s = 0.;
+
+        const double l = a.GetL();
+        if (l >= Type::R)
+        {
+            V.push_back({ 0., Type::R });
+            return;
+        }
+
+        const double e = s + l;
+        if (e <= Type::R)
+            V.push_back({ s, e });
+        else
+        {
+            V.push_back({ 0., e - Type::R });
+            V.push_back({ s, Type::R     });
+        }
+    }
+
+    // merge overlapping or touching intervals of V - which is sorted by s
+    static std::vector<Interval> Coalesce(const std::vector<Interval>& V)
+    {
+        std::vector<Interval> Res;
+        Res.reserve(V.size());
+
+        for (const Interval& i : V)
+            if (!Res.empty() && i.s <= Res.back().e + Eps)
+                Res.back().e = __max(Res.back().e, i.e);
+            else
+                Res.push_back(i);
+
+        return Res;
+    }
+
+    // Type::L and Type::H are the same point: drop a point at one end of [0,Type::R], which is contained in an interval at the other end
+    static void Seam(std::vector<Interval>& V)
+    {
+        if (V.size() > 1 && V.front().e <= Eps           && V.back ().e >= Type::R - Eps) V.erase(V.begin());
+        if (V.size() > 1 && V.back ().s >= Type::R - Eps && V.front().s <= Eps          ) V.pop_back();
+    }
+
+    // the first interval whose end is not before x
+    auto FirstNotBefore(double x) const
+    {
+        return std::lower_bound(v.begin(), v.end(), x - Eps, [](const Interval& i, double r) { return i.e < r; });
+    }
+
+    // check if the set contains offset x [0, Type::R]
+    bool ContainsOffset(double x) const
+    {
+        if (v.empty())
+            return false;
+
+        const auto it = FirstNotBefore(x);
+        if (it != v.end() && it->s <= x + Eps)
+            return true;
+
+        // Type::L and Type::H are the same point
+        return (x > Type::R - Eps && v.front().s <= x + Eps - Type::R) ||
+               (x <           Eps && v.back ().e >= x - Eps + Type::R);
+    }
+
+    // ---------------------------------------------
+public:
+    // empty set
+    CircArcs()
+    {
+    }
+
+    // construction based on a single arc
+    CircArcs(const CircArc<Type>& a)
+    {
+        Split(a, v);
+        std::sort(v.begin(), v.end(), [](const Interval& i1, const Interval& i2) { return i1.s < i2.s; });
+    }
+
+    // construction based on a range of arcs, which may overlap - O(n log n)
+    // sample use: CircArcs<SignedDegRange> A(Arcs.begin(), Arcs.end());
+    template<typename InputIt>
+    CircArcs(InputIt first, InputIt last)
+    {
+        std::vector<Interval> V;
+        for (; first != last; ++first)
+            Split(*first, V);
+
+        std::sort(V.begin(), V.end(), [](const Interval& i1, const Interval& i2) { return i1.s < i2.s; });
+        v = Coalesce(V);
+        Seam(v);
+    }
+
+    // the whole circle
+    static CircArcs Full()
+    {
+        return CircArcs(CircArc<Type>(Type::L, Type::R));
+    }
+
+    // ---------------------------------------------
+    bool IsEmpty() const { return v.empty(); }
+    bool IsFull () const { return v.size() == 1 && v[0].s <= Eps && v[0].e >= Type::R - Eps; }
+
+    // the arcs of the set, in increasing order of start-point offset from Type::L
+    // an arc that crosses Type::H is returned as a single arc (last)
+    std::vector<CircArc<Type>> GetArcs() const
+    {
+        std::vector<CircArc<Type>> Res;
+        if (v.empty())
+            return Res;
+
+        if (IsFull())
+        {
+            Res.push_back(CircArc<Type>(Type::L, Type::R));
+            return Res;
+        }
+
+        const bool   bJoin = v.size() > 1 && v.front().s <= Eps && v.back().e >= Type::R - Eps; // [0,e] and [s,Type::R] are one arc
+        const size_t nFrst = bJoin ? 1            : 0       ;
+        const size_t nLast = bJoin ? v.size() - 1 : v.size();
+
+        Res.reserve(nLast - nFrst + bJoin);
+        for (size_t i = nFrst; i < nLast; ++i)
+            Res.push_back(CircArc<Type>(Type::L + v[i].s, v[i].e - v[i].s));
+
+        if (bJoin)
+            Res.push_back(CircArc<Type>(Type::L + v.back().s, Type::R - v.back().s + v.front().e));
+
+        return Res;
+    }
+
+    // number of arcs
+    size_t Size() const
+    {
+        return v.size() - (v.size() > 1 && v.front().s <= Eps && v.back().e >= Type::R - Eps);
+    }
+
+    // total length of the arcs [0, Type::R]
+    double Length() const
+    {
+        double l = 0.;
+        for (const Interval& i : v)
+            l += i.e - i.s;
+
+        return l;
+    }
+
+    // ---------------------------------------------
+    bool operator==(const CircArcs& A) const
+    {
+        return v == A.v;
+    }
+
+    bool operator!=(const CircArcs& A) const
+    {
+        return !(*this == A);
+    }
+
+    // ---------------------------------------------
+    // check if this set contains a circular value - O(log n)
+    bool Contains(const CircVal<Type>& c) const
+    {
+        return ContainsOffset((double)c - Type::L);
+    }
+
+    // check if this set contains a circular arc - O(log n)
+    bool Contains(const CircArc<Type>& a) const
+    {
+        std::vector<Interval> A;
+        Split(a, A);
+
+        for (const Interval& i : A)
+        {
+            if (i.e - i.s <= Eps) // a point - may be contained at the other side of Type::H
+            {
+                if (!ContainsOffset(i.s))
+                    return false;
+
+                continue;
+            }
+
+            const auto it = FirstNotBefore(i.s);
+            if (it == v.end() || it->s > i.s + Eps || it->e < i.e - Eps)
+                return false;
+        }
+
+        return true;
+    }
+
+    // check if this set intersects a circular arc - O(log n)
+    bool Intersect(const CircArc<Type>& a) const
+    {
+        std::vector<Interval> A;
+        Split(a, A);
+
+        for (const Interval& i : A)
+        {
+            const auto it = FirstNotBefore(i.s);
+            if ((it != v.end() && it->s <= i.e + Eps) || ContainsOffset(i.s) || ContainsOffset(i.e))
+                return true;
+        }
+
+        return false;
+    }
+
+    // ---------------------------------------------
+    // union of two sets - O(n+m)
+    CircArcs Union(const CircArcs& A) const
+    {
+        std::vector<Interval> V(v.size() + A.v.size());
+        std::merge(v.begin(), v.end(), A.v.begin(), A.v.end(), V.begin(), [](const Interval& i1, const Interval& i2) { return i1.s < i2.s; });
+
+        CircArcs Res;
+        Res.v = Coalesce(V);
+        Seam(Res.v);
+        return Res;
+    }
+
+    // intersection of two sets - O(n+m)
+    CircArcs Intersection(const CircArcs& A) const
+    {
+        CircArcs Res;
+
+        for (size_t i = 0, j = 0; i < v.size() && j < A.v.size();)
+        {
+            const double s = __max(v[i].s, A.v[j].s);
+            const double e = __min(v[i].e, A.v[j].e);
+
+            if (e - s > -Eps)
+                Res.v.push_back({ s, __max(s, e) });
+
+            if (v[i].e < A.v[j].e) ++i; // the interval that ends first can't intersect other intervals
+            else                   ++j;
+        }
+
+        if (ContainsOffset(0.) && A.ContainsOffset(0.) && !Res.ContainsOffset(0.)) // intersect at Type::L only
+            Res.v.insert(Res.v.begin(), { 0., 0. });
+
+        // pieces of different intervals may be within 1e-12 of each other
+        Res.v = Coalesce(Res.v);
+        Seam(Res.v);
+        return Res;
+    }
+
+    // difference of two sets (the values of this set which are not in A) - O(n+m)
+    // as sets of arcs are closed, the result contains the endpoints of A's arcs; pieces shorter than 1e-12 are dropped
+    CircArcs Diff(const CircArcs& A) const
+    {
+        CircArcs Res;
+
+        size_t j = 0;
+        for (const Interval& i : v)
+        {
+            while (j < A.v.size() && A.v[j].e < i.s - Eps) // A's intervals before this interval
+                ++j;
+
+            if (j == A.v.size() || A.v[j].s > i.e + Eps) // not cut
+            {
+                Res.v.push_back(i);
+                continue;
+            }
+
+            double s = i.s;
+            for (; j < A.v.size() && A.v[j].s <= i.e + Eps; ++j)
+            {
+                if (A.v[j].s - s > Eps)
+                    Res.v.push_back({ s, A.v[j].s });
+
+                s = __max(s, A.v[j].e);
+
+                if (A.v[j].e > i.e) // may cut the next interval too
+                    break;
+            }
+
+            if (i.e - s > Eps)
+                Res.v.push_back({ s, i.e });
+        }
+
+        // a point at Type::L or Type::H, which is contained in A at the other side
+        if (!Res.v.empty() && Res.v.front().e <= Eps           && A.ContainsOffset(0.     )) Res.v.erase(Res.v.begin());
+        if (!Res.v.empty() && Res.v.back ().s >= Type::R - Eps && A.ContainsOffset(Type::R)) Res.v.pop_back();
+
+        return Res;
+    }
+
+    // the values of the circle which are not in this set - O(n)
+    CircArcs Complement() const
+    {
+        return Full().Diff(*this);
+    }
+};
+
+// ==========================================================================
+// index of circular arcs, for stabbing queries: which of the arcs contain a circular value / intersect a circular arc
+// Type should be defined using the CircValTypeDef macro
+//
+// each arc is stored as a closed interval [s,e] of offsets from Type::L (0 <= s <= e <= Type::R); arcs that cross
+// Type::H are split into [0,e] and [s,Type::R]. the intervals are kept in a single array, sorted by s, which is the
+// in-order layout of an implicit binary tree: the node at index i of level k has children at i -/+ 2^(k-1), and holds
+// the maximal end of its subtree. queries walk the tree top-down, and scan small subtrees linearly - O(log n + k).
+// as in CircArc, arcs contain their endpoints, and values closer than 1e-12 are considered equal.
+// each query reports the index (in the vector given to the constructor) of each matching arc exactly once, in no specific order
+template <typename Type>
+class CircArcIndex
+{
+    struct Node
+    {
+        double s    ; // start offset from Type::L
+        double e    ; // end   offset from Type::L
+        double m    ; // maximal e of the subtree
+        double p    ; // for the [s,Type::R] part of a split arc: e of its [0,e] part; otherwise -1
+        size_t nArc ; // index of the arc
+    };
+
+    struct Interval
+    {
+        double s;
+        double e;
+    };
+
+    static constexpr double Eps = 1e-12;
+
+    std::vector<Node> v          ; // sorted by s
+    size_t            nArcs  = 0 ;
+    int               nLevel = -1; // level of the root
+
+    // ---------------------------------------------
+    // offset of a circular value from Type::L [0, Type::R)
+    static double Offset(const CircVal<Type>& c)
+    {
+        const double x = (double)c - Type::L;
+        return x < Type::R ? x : 0.; // rounding
+    }
+
+    // call F(Node) for each node that intersects [s,e]
+    template<typename Fn>
+    void Visit(double s, double e, Fn&& F) const
+    {
+        struct Frame
+        {
+            size_t x; // node index
+            int    k; // node level
+            bool   w; // left subtree already visited
+        };
+
+        if (nLevel < 0)
+            return;
+
+        const size_t n = v.size();
+
+        Frame Stack[128];
+        int   t = 0;
+        Stack[t++] = { (size_t(1) << nLevel) - 1, nLevel, false };
+
+        while (t)
+        {
+            const Frame z = Stack[--t];
+
+            if (z.k <= 3) // small subtree - linear scan
+            {
+                const size_t i0 = z.x >> z.k << z.k;
+                const size_t i1 = __min(i0 + (size_t(1) << (z.k + 1)) - 1, n);
+
+                for (size_t i = i0; i < i1 && v[i].s <= e + Eps; ++i)
+                    if (v[i].e >= s - Eps)
+                        F(v[i]);
+            }
+            else if (!z.w) // visit the left subtree, then this node
+            {
+                const size_t y = z.x - (size_t(1) << (z.k - 1));
+
+                Stack[t++] = { z.x, z.k, true };
+                if (y >= n || v[y].m >= s - Eps) // the subtree may reach s
+                    Stack[t++] = { y, z.k - 1, false };
+            }
+            else if (z.x < n && v[z.x].s <= e + Eps) // this node, then the right subtree
+            {
+                if (v[z.x].e >= s - Eps)
+                    F(v[z.x]);
+
+                Stack[t++] = { z.x + (size_t(1) << (z.k - 1)), z.k - 1, false };
+            }
+        }
+    }
+
+    // the pieces of the circular value at offset x, sorted by s; returns their number
+    static size_t Pieces(double x, Interval* P)
+    {
+        // Type::L and Type::H are the same point
+        if (x <           Eps) { P[0] = { x , x  }; P[1] = { Type::R, Type::R }; return 2; }
+        if (x > Type::R - Eps) { P[0] = { 0., 0. }; P[1] = { x      , x       }; return 2; }
+
+        P[0] = { x, x };
+        return 1;
+    }
+
+    // call F(nArc) for each arc that intersects one of the pieces P, sorted by s - once
+    template<typename Fn>
+    void Query(const Interval* P, size_t nP, Fn&& F) const
+    {
+        for (size_t j = 0; j < nP; ++j)
+            Visit(P[j].s, P[j].e, [&](const Node& x)
+            {
+                if (x.p >= 0. && P[0].s <= x.p + Eps) // split arc; its [0,e] part intersects P[0]
+                    return;
+
+                for (size_t i = 0; i < j; ++i)        // already reported
+                    if (x.s <= P[i].e + Eps && x.e >= P[i].s - Eps)
+                        return;
+
+                F(x.nArc);
+            });
+    }
+
+    // ---------------------------------------------
+public:
+    // construction based on a vector of arcs - O(n log n)
+    CircArcIndex(const std::vector<CircArc<Type>>& Arcs) : nArcs(Arcs.size())
+    {
+        v.reserve(Arcs.size() + Arcs.size() / 4);
+
+        for (size_t i = 0; i < Arcs.size(); ++i)
+        {
+            const double s = Offset(Arcs[i].GetC1());
+            const double l = Arcs[i].GetL();
+            const double e = s + l;
+
+            if      (l >= Type::R) v.push_back({ 0., Type::R, 0., -1.        , i });
+            else if (e <= Type::R) v.push_back({ s , e      , 0., -1.        , i });
+            else
+            {
+                v.push_back({ 0., e - Type::R, 0., -1.         , i });
+                v.push_back({ s , Type::R    , 0., e - Type::R , i });
+            }
+        }
+
+        std::sort(v.begin(), v.end(), [](const Node& x1, const Node& x2) { return x1.s < x2.s; });
+
+        // maximal end of each subtree, bottom-up
+        const size_t n = v.size();
+        if (n == 0)
+            return;
+
+        size_t nLast = 0 ; // index of the last node at the current level
+        double fLast = 0.; // maximal end of the subtree of nLast
+
+        for (size_t i = 0; i < n; i += 2)
+        {
+            nLast = i;
+            fLast = v[i].m = v[i].e;
+        }
+
+        int k = 1;
+        for (; (size_t(1) << k) <= n; ++k)
+        {
+            const size_t x = size_t(1) << (k - 1);
+
+            for (size_t i = (x << 1) - 1; i < n; i += x << 2)
+            {
+                const double el = v[i - x].m;
+                const double er = i + x < n ? v[i + x].m : fLast; // the right subtree may be partial
+                v[i].m = __max(v[i].e, __max(el, er));
+            }
+
+            nLast = (nLast >> k & 1) ? nLast - x : nLast + x;
+            if (nLast < n && v[nLast].m > fLast)
+                fLast = v[nLast].m;
+        }
+
+        nLevel = k - 1;
+    }
+
+    // ---------------------------------------------
+    size_t Size() const // number of arcs
+    {
+        return nArcs;
+    }
+
+    // indices of the arcs that contain a circular value - O(log n + k)
+    // sample use: Index.Query(c, back_inserter(Res));
+    template<typename OutIter>
+    OutIter Query(const CircVal<Type>& c, OutIter Out) const
+    {
+        Interval P[2];
+        Query(P, Pieces(Offset(c), P), [&](size_t nArc) { *Out++ = nArc; });
+        return Out;
+    }
+
+    // indices of the arcs that intersect a circular arc - O(log n + k)
+    template<typename OutIter>
+    OutIter Query(const CircArc<Type>& a, OutIter Out) const
+    {
+        const double s = Offset(a.GetC1());
+        const double l = a.GetL();
+        const double e = s + l;
+
+        Interval P[3];
+        size_t   nP = 0;
+
+        if (l >= Type::R)
+            P[nP++] = { 0., Type::R };
+        else if (e > Type::R)
+        {
+            P[nP++] = { 0., e - Type::R };
+            P[nP++] = { s , Type::R     };
+        }
+        else // Type::L and Type::H are the same point
+        {
+            if (e > Type::R - Eps)
+                P[nP++] = { 0., 0. };
+
+            P[nP++] = { s, e };
+
+            if (s < Eps)
+                P[nP++] = { Type::R, Type::R };
+        }
+
+        Query(P, nP, [&](size_t nArc) { *Out++ = nArc; });
+        return Out;
+    }
+
+    // batch query: for each of the circular values Q - which should be sorted in increasing order - call F(q, nArc)
+    // for each arc nArc that contains Q[q]. a single sweep over the arcs - O((n + m) log n + k)
+    template<typename Fn>
+    void QuerySorted(std::span<const CircVal<Type>> Q, Fn&& F) const
+    {
+        auto Cmp = [this](size_t i1, size_t i2) { return v[i1].e > v[i2].e; };
+        std::vector<size_t> Active; // heap of the nodes which started, by increasing end
+
+        size_t j = 0;
+        for (size_t q = 0; q < Q.size(); ++q)
+        {
+            assert(q == 0 || Q[q - 1] <= Q[q]);
+            const double x = Offset(Q[q]);
+
+            if (x < Eps || x > Type::R - Eps) // Type::L and Type::H are the same point
+            {
+                Interval P[2];
+                Query(P, Pieces(x, P), [&](size_t nArc) { F(q, nArc); });
+                continue;
+            }
+
+            for (; j < v.size() && v[j].s <= x + Eps; ++j)
+            {
+                Active.push_back(j);
+                std::push_heap(Active.begin(), Active.end(), Cmp);
+            }
+
+            while (!Active.empty() && v[Active.front()].e < x - Eps)
+            {
+                std::pop_heap(Active.begin(), Active.end(), Cmp);
+                Active.pop_back();
+            }
+
+            for (size_t i : Active)
+                if (v[i].p < 0. || x > v[i].p + Eps) // split arc - report by its [0,e] part
+                    F(q, v[i].nArc);
+        }
+    }
+};
+
+// ==========================================================================
+// tester for CircVal class
+template <typename Type, typename F = double>
+class CircArcTester
+{
+public:
+    CircArcTester()
+    {
+        Test();
+    }
+
+    static void Test()
+    {
+        const unsigned nSteps = 36              ;
+        const F        fStep  = F(Type::R) / nSteps;
+
+        unsigned m = 0, n = 0, p = 0, q[nSteps+1];
+
+        for (unsigned i = 0; i<nSteps; ++i)
+            q[i] = 0;
+
+        for (unsigned i = 0; i < nSteps; ++i)
+            for (unsigned j = 0; j <= nSteps; ++j)
+            {
+                CircArc<Type, F> a1(F(Type::L) + i*fStep, j*fStep); // 1st arc: start-point, length
+
+                for (unsigned k = 0; k < nSteps; ++k)
+                    for (unsigned l = 0; l <= nSteps; ++l)
+                    {
+                        CircArc<Type, F> a2(F(Type::L) + k*fStep, l*fStep); // 2nd arc: start-point, length
+
+                        bool b1 = a1.Contains(a2); if (b1) ++m;       // if a2 is a sub-arc of a1
+                        bool b2 = a2.Contains(a1); if (b2) ++n;       // if a1 is a sub-arc of a2
+
+                        if   (a1 == a2) { assert(  b1 && b2 ); ++p; } // if identical
+                        else              assert(!(b1 && b2));
+
+                        if (a1.Intersect(a2)) ++q[j];
+                    }
+            }
+
+        assert (p == 2*nSteps*nSteps                                     ); // number of identical arcs
+        assert (m ==   nSteps*nSteps * (nSteps*nSteps + 9*nSteps + 8) / 6); // number of times a2 is a sub-arc of a1
+        assert (m == n                                                   ); // number of times a1 is a sub-arc of a2 shuould be identical
+//      assert (q == ...)                                                   // number of intersecting arcs
+
+        // --------------
+    }
+};
+
+// ==========================================================================
+// tester for CircArcs class
+template <typename Type>
+class CircArcsTester
+{
+public:
+    CircArcsTester()
+    {
+        Test();
+    }
+
+    static void Test()
+    {
+        const unsigned nSteps = 36              ;
+        const double   fStep  = Type::R / nSteps;
+
+        // same arcs, up to rounding errors
+        [[maybe_unused]] auto IsNear = [](const CircArcs<Type>& X, const CircArcs<Type>& Y)
+        {
+            return X.Size() == Y.Size() && X.Diff(Y).Length() < 1e-9 * Type::R && Y.Diff(X).Length() < 1e-9 * Type::R;
+        };
+
+        // --------------
+        // special sets
+        const CircArcs<Type> E;
+        const CircArcs<Type> F = CircArcs<Type>::Full();
+
+        assert( E.IsEmpty() && !E.IsFull() && E.Size() == 0 && E.Length() == 0.     );
+        assert(!F.IsEmpty() &&  F.IsFull() && F.Size() == 1 && F.Length() == Type::R);
+        assert( F.Complement() == E && E.Complement() == F                          );
+        assert(CircArcs<Type>(CircArc<Type>(Type::Z, Type::R)) == F                 ); // full-circle; start-point doesn't matter
+        assert(F.Contains(CircArc<Type>(Type::Z, Type::R)) && !E.Contains(CircVal<Type>(Type::Z)));
+
+        // an arc that crosses Type::H is a single arc
+        const CircArc <Type> a(Type::H - fStep, 2 * fStep);
+        const CircArcs<Type> A(a);
+        assert( A.Size() == 1 && A.GetArcs().size() == 1                            );
+        assert( A.Contains(CircVal<Type>(Type::L)) && A.Contains(CircVal<Type>(Type::H - fStep / 2)));
+        assert(!A.Contains(CircVal<Type>(Type::L + 2 * fStep)) && A.Contains(a)     );
+        assert( A.Complement().Size() == 1 && A.Complement().Union(A) == F          );
+
+        assert(IsNear(CircArcs<Type>(A.GetArcs()[0]), A)                            );
+
+        // an intersection is normalized as a directly built set: a point within 1e-12 of an arc is merged into the arc
+        const std::vector<CircArc<Type>> VP = { CircArc<Type>(Type::L, fStep), CircArc<Type>(Type::L + fStep + 1.6e-12, fStep) };
+        const CircArcs<Type> P(VP.begin(), VP.end());
+        const CircArcs<Type> Q(CircArc<Type>(Type::L + fStep + 0.8e-12, fStep));
+        assert( P.Size() == 2 && P.Intersection(Q) == Q && Q.Intersection(P) == Q   );
+
+        // --------------
+        // random sets of arcs on a grid, vs. CircArc
+        std::default_random_engine              rand_engine;
+        std::uniform_int_distribution<unsigned> n_dist(0, 20        ); // number of arcs
+        std::uniform_int_distribution<unsigned> s_dist(0, nSteps - 1); // start-point
+        std::uniform_int_distribution<unsigned> l_dist(0, nSteps / 2); // length
+
+        std::random_device rnd_device;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        auto RandArcs = [&]()
+        {
+            std::vector<CircArc<Type>> V(n_dist(rand_engine));
+            for (auto& a : V)
+                a = CircArc<Type>(Type::L + s_dist(rand_engine) * fStep, (n_dist(rand_engine) ? l_dist(rand_engine) : nSteps) * fStep);
+            return V;
+        };
+
+        // pairwise test of the arcs
+        auto AnyContains = [](const std::vector<CircArc<Type>>& V, const auto& c)
+        {
+            return std::any_of(V.begin(), V.end(), [&](const CircArc<Type>& a) { return a.Contains(c); });
+        };
+
+        for (unsigned t = 1000; t--;)
+        {
+            const std::vector<CircArc<Type>> VA = RandArcs();
+            const std::vector<CircArc<Type>> VB = RandArcs();
+
+            const CircArcs<Type> A(VA.begin(), VA.end());
+            const CircArcs<Type> B(VB.begin(), VB.end());
+
+            const CircArcs<Type> U = A.Union       (B);
+            const CircArcs<Type> I = A.Intersection(B);
+            const CircArcs<Type> D = A.Diff        (B);
+            const CircArcs<Type> C = A.Complement  ( );
+
+            // values between grid points
+            for (unsigned k = 0; k < nSteps; ++k)
+            {
+                const CircVal<Type> c  = Type::L + (k + 0.5) * fStep;
+                [[maybe_unused]] const bool bA = AnyContains(VA, c);
+                [[maybe_unused]] const bool bB = AnyContains(VB, c);
+
+                assert(A.Contains(c) ==  bA       );
+                assert(U.Contains(c) == (bA || bB));
+                assert(I.Contains(c) == (bA && bB));
+                assert(D.Contains(c) == (bA && !bB));
+                assert(C.Contains(c) == !bA       );
+            }
+
+            // grid points - the arcs' endpoints
+            for (unsigned k = 0; k < nSteps; ++k)
+            {
+                [[maybe_unused]] const CircVal<Type> c = Type::L + k * fStep;
+
+                assert(A.Contains(c) ==  AnyContains(VA, c)                      );
+                assert(U.Contains(c) == (AnyContains(VA, c) || AnyContains(VB, c)));
+            }
+
+            // arcs
+            for ([[maybe_unused]] const CircArc<Type>& b : VB)
+            {
+                assert(A.Intersect(b) == std::any_of(VA.begin(), VA.end(), [&](const CircArc<Type>& a) { return a.Intersect(b); }));
+                assert(A.Contains (b) == CircArcs<Type>(b).Diff(A).IsEmpty());
+                assert(A.Contains (b) || !AnyContains(VA, b)                 );
+            }
+
+            // identities
+            assert(U == B.Union       (A));
+            assert(I == B.Intersection(A));
+            assert(IsNear(D.Union(I), A)  );
+            assert(C.Union(A) == F || A.IsEmpty() == C.IsFull());
+            assert(std::abs(U.Length() - (A.Length() + B.Length() - I.Length())) < 1e-9 * Type::R);
+
+            // round trip through GetArcs()
+            const std::vector<CircArc<Type>> VU = U.GetArcs();
+            assert(VU.size() == U.Size());
+            assert(std::abs(CircArcs<Type>(VU.begin(), VU.end()).Length() - U.Length()) < 1e-9 * Type::R);
+        }
+    }
+};
+
+// ==========================================================================
+// tester for CircArcIndex class
+template <typename Type>
+class CircArcIndexTester
+{
+public:
+    CircArcIndexTester()
+    {
+        Test();
+    }
+
+    static void Test()
+    {
+        const unsigned nSteps = 36              ;
+        const double   fStep  = Type::R / nSteps;
+
+        // --------------
+        // empty index
+        const CircArcIndex<Type> E(std::vector<CircArc<Type>>{});
+        std::vector<size_t> Res;
+        E.Query(CircVal<Type>(Type::Z), back_inserter(Res));
+        assert(E.Size() == 0 && Res.empty());
+
+        // --------------
+        // random arcs - on a grid, or arbitrary - vs. CircArc
+        std::default_random_engine              rand_engine;
+        std::uniform_int_distribution<unsigned> n_dist(0, 200       ); // number of arcs
+        std::uniform_int_distribution<unsigned> s_dist(0, nSteps - 1); // start-point
+        std::uniform_int_distribution<unsigned> l_dist(0, nSteps / 2); // length
+        std::uniform_real_distribution<double>  r_dist(0., 1.       );
+
+        std::random_device rnd_device;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        for (unsigned t = 200; t--;)
+        {
+            const bool bGrid = t % 2;
+
+            auto RandVal = [&]()
+            {
+                return bGrid ? Type::L + s_dist(rand_engine) * fStep : Type::L + r_dist(rand_engine) * Type::R;
+            };
+
+            auto RandLen = [&]()
+            {
+                if (s_dist(rand_engine) == 0)
+                    return Type::R; // full-circle
+                return bGrid ? l_dist(rand_engine) * fStep : r_dist(rand_engine) * Type::R / 2;
+            };
+
+            std::vector<CircArc<Type>> Arcs(n_dist(rand_engine));
+            for (auto& a : Arcs)
+                a = CircArc<Type>(RandVal(), RandLen());
+
+            const CircArcIndex<Type> Index(Arcs);
+            assert(Index.Size() == Arcs.size());
+
+            // point queries
+            std::vector<CircVal<Type>> Q(100);
+            for (auto& c : Q)
+                c = RandVal();
+
+            std::sort(Q.begin(), Q.end());
+            std::vector<std::vector<size_t>> SortedRes(Q.size());
+            Index.QuerySorted(std::span<const CircVal<Type>>(Q), [&](size_t q, size_t nArc) { SortedRes[q].push_back(nArc); });
+
+            for (size_t q = 0; q < Q.size(); ++q)
+            {
+                std::vector<size_t> Expected;
+                for (size_t i = 0; i < Arcs.size(); ++i)
+                    if (Arcs[i].Contains(Q[q]))
+                        Expected.push_back(i);
+
+                Res.clear();
+                Index.Query(Q[q], back_inserter(Res));
+                std::sort(Res         .begin(), Res         .end());
+                std::sort(SortedRes[q].begin(), SortedRes[q].end());
+
+                assert(Res          == Expected);
+                assert(SortedRes[q] == Expected);
+            }
+
+            // arc-overlap queries
+            for (unsigned k = 0; k < 20; ++k)
+            {
+                const CircArc<Type> b(RandVal(), RandLen());
+
+                std::vector<size_t> Expected;
+                for (size_t i = 0; i < Arcs.size(); ++i)
+                    if (Arcs[i].Intersect(b))
+                        Expected.push_back(i);
+
+                Res.clear();
+                Index.Query(b, back_inserter(Res));
+                std::sort(Res.begin(), Res.end());
+
+                assert(Res == Expected);
+            }
+        }
+    }
+};
@@ -0,0 +1,641 @@
+// ==========================================================================
+// Copyright (C) 2026 DRNadler
+// ==========================================================================
+// classes defined here:
+// CircFileHeader     - header of a binary file of circular values
+// CircFileTraits     - file element description of a circular-value type
+// CircMappedFile     - read-only memory mapping of a whole file
+// CircBufferedWriter - buffered binary file writer
+// CircFileWriter     - writer of a binary file of circular values
+// CircFileReader     - zero-copy (memory-mapped) reader of a binary file of circular values
+// CircFileTester     - tester for CircFileWriter and CircFileReader classes
+// ==========================================================================
+
+#pragma once
+
+#include <assert.h>
+#include <algorithm>       // std::equal
+#include <bit>             // std::endian
+#include <cerrno>          // errno
+#include <cstddef>         // offsetof
+#include <cstdint>
+#include <cstring>         // std::memcpy
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <span>
+#include <stdexcept>       // std::invalid_argument, std::runtime_error
+#include <string>
+#include <system_error>    // std::system_error
+#include <type_traits>
+#include <utility>         // std::exchange
+#include <vector>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>   // CreateFileW, CreateFileMappingW, MapViewOfFile
+#else
+    #include <fcntl.h>     // open
+    #include <sys/mman.h>  // mmap, munmap
+    #include <sys/stat.h>  // fstat
+    #include <unistd.h>    // close
+#endif
+
+#include "CircVal.h"       // CircVal, CircValType
+#include "CircValFixed.h"  // CircValFixed
+#include "CircValArray.h"  // CircValArray - CircFileTester
+
+// the file layout is the in-memory layout of a little-endian host; the values are used in place, without conversion
+static_assert(std::endian::native == std::endian::little, "CircFile: little-endian host expected");
+
+// ==========================================================================
+// element kinds of a binary file of circular values
+enum class CircFileElem : uint32_t
+{
+    Float  = 1, // CircVal<Type, float >
+    Double = 2, // CircVal<Type, double>
+    Fixed  = 3  // CircValFixed<Type, IntT, Bits>
+};
+
+// ==========================================================================
+// header of a binary file of circular values: the header is followed by nCount elements of nElemSize bytes
+// L, H, Z are the CircValType of the values. the header is 64 bytes, so the (page-aligned) mapped values are aligned
+struct CircFileHeader
+{
+    char         Magic[4]  ; // "CIRC"
+    uint32_t     nVersion  ; // 1
+    CircFileElem Elem      ; // element kind
+    uint32_t     nElemSize ; // bytes per element: 4, 8 (float, double); sizeof(IntT) (fixed)
+    uint32_t     nBits     ; // fixed: number of bits; otherwise 0
+    uint32_t     nReserved ; // 0
+    double       L, H, Z   ; // CircValType of the values
+    uint64_t     nCount    ; // number of elements
+    uint8_t      Pad[8]    ; // 0
+
+    static constexpr uint32_t Version = 1;
+};
+
+static_assert(sizeof(CircFileHeader) == 64 && std::is_trivially_copyable_v<CircFileHeader>);
+
+// ==========================================================================
+// file element description of circular-value type C: CircVal<Type, float>, CircVal<Type, double> or CircValFixed<Type, IntT, Bits>
+// the element is the storage of C - the single data member of these types - so a file element can be used in place as a C
+template<typename C>
+struct CircFileTraits;
+
+template<typename Type, typename F>
+struct CircFileTraits<CircVal<Type, F>>
+{
+    static_assert(std::is_same_v<F, float> || std::is_same_v<F, double>, "CircFile: float or double storage expected");
+
+    using CircType = Type;
+    using Storage  = F   ;
+
+    static constexpr CircFileElem Elem  = std::is_same_v<F, float> ? CircFileElem::Float : CircFileElem::Double;
+    static constexpr uint32_t     nBits = 0;
+
+    static bool IsInRange(const CircVal<Type, F>& c) { return CircVal<Type, F>::IsInRange(static_cast<F>(c)); }
+};
+
+template<typename Type, typename IntT, int Bits>
+struct CircFileTraits<CircValFixed<Type, IntT, Bits>>
+{
+    using CircType = Type;
+    using Storage  = IntT;
+
+    static constexpr CircFileElem Elem  = CircFileElem::Fixed;
+    static constexpr uint32_t     nBits = Bits;
+
+    static bool IsInRange(const CircValFixed<Type, IntT, Bits>& c) { return uint64_t(c.Raw()) <= CircValFixed<Type, IntT, Bits>::Mask; }
+};
+
+// header of a file of nCount values of type C
+template<typename C>
+CircFileHeader MakeCircFileHeader(uint64_t nCount)
+{
+    using Traits = CircFileTraits<C>;
+    using T      = typename Traits::CircType;
+
+    CircFileHeader h{};
+    std::memcpy(h.Magic, "CIRC", 4);
+    h.nVersion  = CircFileHeader::Version;
+    h.Elem      = Traits::Elem;
+    h.nElemSize = sizeof(typename Traits::Storage);
+    h.nBits     = Traits::nBits;
+    h.L         = T::L;
+    h.H         = T::H;
+    h.Z         = T::Z;
+    h.nCount    = nCount;
+    return h;
+}
+
+// true if header h describes values of type C
+template<typename C>
+bool IsCircFileOf(const CircFileHeader& h)
+{
+    using Traits = CircFileTraits<C>;
+    using T      = typename Traits::CircType;
+
+    return h.Elem == Traits::Elem && h.nElemSize == sizeof(typename Traits::Storage) && h.nBits == Traits::nBits &&
+           h.L    == T::L         && h.H         == T::H                             && h.Z     == T::Z;
+}
+
+// ==========================================================================
+// read-only memory mapping of a whole file
+// throws std::system_error if the file cannot be opened or mapped
+class CircMappedFile
+{
+#ifdef _WIN32
+    HANDLE         m_hFile = INVALID_HANDLE_VALUE;
+    HANDLE         m_hMap  = nullptr;
+#else
+    int            m_fd    = -1;
+#endif
+    const uint8_t* m_pData = nullptr;
+    size_t         m_nSize = 0;
+
+    // ---------------------------------------------
+    void Unmap()
+    {
+#ifdef _WIN32
+        if (m_pData                        ) UnmapViewOfFile(m_pData);
+        if (m_hMap                         ) CloseHandle    (m_hMap );
+        if (m_hFile != INVALID_HANDLE_VALUE) CloseHandle    (m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+        m_hMap  = nullptr;
+#else
+        if (m_pData  ) munmap(const_cast<uint8_t*>(m_pData), m_nSize);
+        if (m_fd >= 0) close (m_fd);
+        m_fd    = -1;
+#endif
+        m_pData = nullptr;
+        m_nSize = 0;
+    }
+
+    [[noreturn]] void Fail(const char* szWhat)
+    {
+#ifdef _WIN32
+        const std::error_code ec(static_cast<int>(GetLastError()), std::system_category());
+#else
+        const std::error_code ec(errno, std::generic_category());
+#endif
+        Unmap();
+        throw std::system_error(ec, szWhat);
+    }
+
+    // ---------------------------------------------
+public:
+    explicit CircMappedFile(const std::filesystem::path& Path)
+    {
+#ifdef _WIN32
+        m_hFile = CreateFileW(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_hFile == INVALID_HANDLE_VALUE)
+            Fail("CircMappedFile: open");
+
+        LARGE_INTEGER Size;
+        if (!GetFileSizeEx(m_hFile, &Size))
+            Fail("CircMappedFile: size");
+
+        m_nSize = static_cast<size_t>(Size.QuadPart);
+        if (m_nSize == 0)                                    // an empty file cannot be mapped
+            return;
+
+        m_hMap = CreateFileMappingW(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_hMap)
+            Fail("CircMappedFile: map");
+
+        m_pData = static_cast<const uint8_t*>(MapViewOfFile(m_hMap, FILE_MAP_READ, 0, 0, 0));
+        if (!m_pData)
+            Fail("CircMappedFile: map");
+#else
+        m_fd = open(Path.c_str(), O_RDONLY);
+        if (m_fd < 0)
+            Fail("CircMappedFile: open");
+
+        struct stat St;
+        if (fstat(m_fd, &St) != 0)
+            Fail("CircMappedFile: size");
+
+        m_nSize = static_cast<size_t>(St.st_size);
+        if (m_nSize == 0)                                    // an empty file cannot be mapped
+            return;
+
+        void* p = mmap(nullptr, m_nSize, PROT_READ, MAP_SHARED, m_fd, 0);
+        if (p == MAP_FAILED)
+            Fail("CircMappedFile: map");
+
+        m_pData = static_cast<const uint8_t*>(p);
+#endif
+    }
+
+    CircMappedFile(CircMappedFile&& f) noexcept :
+#ifdef _WIN32
+        m_hFile(std::exchange(f.m_hFile, INVALID_HANDLE_VALUE)), m_hMap(std::exchange(f.m_hMap, nullptr)),
+#else
+        m_fd   (std::exchange(f.m_fd   , -1                  )),
+#endif
+        m_pData(std::exchange(f.m_pData, nullptr)), m_nSize(std::exchange(f.m_nSize, 0))
+    {
+    }
+
+    CircMappedFile(const CircMappedFile&           ) = delete;
+    CircMappedFile& operator=(const CircMappedFile&) = delete;
+    CircMappedFile& operator=(CircMappedFile&&     ) = delete;
+
+    ~CircMappedFile()
+    {
+        Unmap();
+    }
+
+    // ---------------------------------------------
+    std::span<const uint8_t> Bytes() const { return { m_pData, m_nSize }; } // the file contents; valid while the object lives
+};
+
+// ==========================================================================
+// buffered binary file writer
+// the bytes are collected in a buffer of nBufSize bytes, which is written to the file when full - instead of a write per item
+// throws std::runtime_error if the file cannot be created or written
+class CircBufferedWriter
+{
+    std::ofstream        m_File ;
+    std::vector<uint8_t> m_Buf  ;
+    size_t               m_nUsed = 0; // bytes used in m_Buf
+    uint64_t             m_nPos  = 0; // bytes written, including the buffered bytes
+
+    // ---------------------------------------------
+    void WriteFile(const void* p, size_t n)
+    {
+        m_File.write(static_cast<const char*>(p), static_cast<std::streamsize>(n));
+        if (!m_File)
+            throw std::runtime_error("CircBufferedWriter: write failed");
+    }
+
+    // ---------------------------------------------
+public:
+    explicit CircBufferedWriter(const std::filesystem::path& Path, size_t nBufSize = 1 << 20) :
+        m_File(Path, std::ios::binary | std::ios::trunc), m_Buf(nBufSize)
+    {
+        assert(nBufSize > 0);
+        if (!m_File)
+            throw std::runtime_error("CircBufferedWriter: cannot create file");
+    }
+
+    CircBufferedWriter(const CircBufferedWriter&           ) = delete;
+    CircBufferedWriter& operator=(const CircBufferedWriter&) = delete;
+
+    ~CircBufferedWriter()
+    {
+        try { Close(); } catch (...) {}                      // call Close() to get the errors
+    }
+
+    // ---------------------------------------------
+    bool     IsOpen() const { return m_File.is_open(); }
+    uint64_t GetPos() const { return m_nPos;           } // bytes written so far
+
+    // append n bytes
+    void Write(const void* p, size_t n)
+    {
+        assert(IsOpen());
+        if (n > m_Buf.size() - m_nUsed)
+        {
+            Flush();
+            if (n >= m_Buf.size())                           // large blocks are written directly
+            {
+                WriteFile(p, n);
+                m_nPos += n;
+                return;
+            }
+        }
+
+        std::memcpy(m_Buf.data() + m_nUsed, p, n);
+        m_nUsed += n;
+        m_nPos  += n;
+    }
+
+    // append the bytes of x
+    template<typename P> requires std::is_trivially_copyable_v<P>
+    void Write(const P& x)
+    {
+        Write(&x, sizeof x);
+    }
+
+    // overwrite n previously written bytes at position nPos - e.g. a header
+    void WriteAt(uint64_t nPos, const void* p, size_t n)
+    {
+        assert(nPos + n <= m_nPos);
+        Flush();
+        m_File.seekp(static_cast<std::streamoff>(nPos));
+        WriteFile(p, n);
+        m_File.seekp(0, std::ios::end);
+    }
+
+    // write the buffered bytes to the file
+    void Flush()
+    {
+        if (m_nUsed > 0)
+            WriteFile(m_Buf.data(), std::exchange(m_nUsed, 0));
+    }
+
+    void Close()
+    {
+        if (!IsOpen())
+            return;
+
+        Flush();
+        m_File.close();
+        if (!m_File)
+            throw std::runtime_error("CircBufferedWriter: close failed");
+    }
+};
+
+// ==========================================================================
+// writer of a binary file of circular values of type C - see CircFileHeader
+// C is CircVal<Type, float>, CircVal<Type, double> or CircValFixed<Type, IntT, Bits>
+// sample use: CircFileWriter<CircVal<UnsignedDegRange>> w("angles.bin"); w.Write(span<const CircVal<UnsignedDegRange>>(A)); w.Close();
+template<typename C>
+class CircFileWriter
+{
+    using Traits = CircFileTraits<C>;
+    static_assert(sizeof(C) == sizeof(typename Traits::Storage) && std::is_standard_layout_v<C>, "CircFile: C should hold its storage only");
+
+    CircBufferedWriter m_Out;
+    uint64_t           m_nCount = 0;
+
+    // ---------------------------------------------
+public:
+    explicit CircFileWriter(const std::filesystem::path& Path, size_t nBufSize = 1 << 20) : m_Out(Path, nBufSize)
+    {
+        m_Out.Write(MakeCircFileHeader<C>(0));               // the count is written by Close()
+    }
+
+    ~CircFileWriter()
+    {
+        try { Close(); } catch (...) {}                      // call Close() to get the errors
+    }
+
+    // ---------------------------------------------
+    uint64_t GetCount() const { return m_nCount; }
+
+    void Write(const C& c)
+    {
+        m_Out.Write(&c, sizeof c);
+        ++m_nCount;
+    }
+
+    void Write(std::span<const C> A)
+    {
+        m_Out.Write(A.data(), A.size_bytes());
+        m_nCount += A.size();
+    }
+
+    // write the count to the header, and close the file
+    void Close()
+    {
+        if (!m_Out.IsOpen())
+            return;
+
+        m_Out.WriteAt(offsetof(CircFileHeader, nCount), &m_nCount, sizeof m_nCount);
+        m_Out.Close();
+    }
+};
+
+// ==========================================================================
+// zero-copy reader of a binary file of circular values - see CircFileHeader
+// the file is memory-mapped, and its values are exposed in place as a span - which the CircStat functions (span<const C>)
+// and the CircValArray bulk operations (span<const double>) consume without copying. the spans are valid while the reader lives
+// throws std::system_error if the file cannot be mapped; std::invalid_argument if it is malformed, or holds values of another type
+// sample use: CircFileReader f("angles.bin"); auto A= f.Values<CircVal<UnsignedDegRange>>(); CircAverage(A, W, Out);
+class CircFileReader
+{
+    CircMappedFile m_File  ;
+    CircFileHeader m_Header;
+
+    const uint8_t* Elems() const { return m_File.Bytes().data() + sizeof(CircFileHeader); }
+
+    // ---------------------------------------------
+public:
+    explicit CircFileReader(const std::filesystem::path& Path) : m_File(Path)
+    {
+        const auto B = m_File.Bytes();
+        if (B.size() < sizeof(CircFileHeader))
+            throw std::invalid_argument("CircFileReader: file too short");
+
+        std::memcpy(&m_Header, B.data(), sizeof(CircFileHeader));
+        if (std::memcmp(m_Header.Magic, "CIRC", 4) != 0 || m_Header.nVersion != CircFileHeader::Version)
+            throw std::invalid_argument("CircFileReader: not a circular-values file");
+
+        const bool bFloat  = m_Header.Elem == CircFileElem::Float  && m_Header.nElemSize == 4 && m_Header.nBits == 0;
+        const bool bDouble = m_Header.Elem == CircFileElem::Double && m_Header.nElemSize == 8 && m_Header.nBits == 0;
+        const bool bFixed  = m_Header.Elem == CircFileElem::Fixed  && (m_Header.nElemSize == 1 || m_Header.nElemSize == 2 || m_Header.nElemSize == 4 || m_Header.nElemSize == 8) &&
+                             m_Header.nBits >= 1 && m_Header.nBits <= 8*m_Header.nElemSize;
+        if (!bFloat && !bDouble && !bFixed)
+            throw std::invalid_argument("CircFileReader: bad element description");
+
+        if (m_Header.nCount > (B.size() - sizeof(CircFileHeader)) / m_Header.nElemSize ||
+            m_Header.nCount * m_Header.nElemSize != B.size() - sizeof(CircFileHeader))
+            throw std::invalid_argument("CircFileReader: file size does not match the count");
+    }
+
+    // ---------------------------------------------
+    const CircFileHeader& GetHeader() const { return m_Header;                                  }
+    size_t                Size     () const { return static_cast<size_t>(m_Header.nCount);      }
+
+    // true if the file holds values of type C
+    template<typename C>
+    bool Is() const
+    {
+        return IsCircFileOf<C>(m_Header);
+    }
+
+    // the values, in place. C should match the file - see Is()
+    // the values are not checked: a file not written by CircFileWriter may hold values out of range - see IsValid()
+    template<typename C>
+    std::span<const C> Values() const
+    {
+        static_assert(sizeof(C) == sizeof(typename CircFileTraits<C>::Storage) && std::is_standard_layout_v<C>, "CircFile: C should hold its storage only");
+        if (!Is<C>())
+            throw std::invalid_argument("CircFileReader: the file holds values of another type");
+
+        return { reinterpret_cast<const C*>(Elems()), Size() };
+    }
+
+    // the values [Type::L, Type::H), in place - for the CircValArray bulk operations. the file should hold CircVal<Type, double>
+    template<typename Type>
+    std::span<const double> Doubles() const
+    {
+        if (!Is<CircVal<Type, double>>())
+            throw std::invalid_argument("CircFileReader: the file holds values of another type");
+
+        return { reinterpret_cast<const double*>(Elems()), Size() };
+    }
+
+    // true if all values are in range - O(n)
+    template<typename C>
+    bool IsValid() const
+    {
+        for (const C& c : Values<C>())
+            if (!CircFileTraits<C>::IsInRange(c))
+                return false;
+
+        return true;
+    }
+};
+
+// ==========================================================================
+// tester for CircFileWriter and CircFileReader classes
+// writes temporary files in std::filesystem::temp_directory_path()
+template <typename Type>
+class CircFileTester
+{
+    template<typename C>
+    static std::filesystem::path TempPath(const char* szName)
+    {
+        return std::filesystem::temp_directory_path() / (std::string("CircFileTester_") + szName + "_" + std::to_string(int(CircFileTraits<C>::Elem)) +
+                                                         "_" + std::to_string(sizeof(C)) + ".bin");
+    }
+
+    template<typename E>
+    static bool Throws(auto&& f)
+    {
+        try { f(); } catch (const E&) { return true; }
+        return false;
+    }
+
+    // write A, read it back, then check the header validation
+    template<typename C, typename Other>
+    static void TestRoundTrip(const std::vector<C>& A)
+    {
+        const auto Path = TempPath<C>("rt");
+        {
+            CircFileWriter<C> w(Path, 256);                  // a small buffer: the buffer is flushed many times
+            const size_t n1 = A.size() / 3;
+            for (size_t i = 0; i < n1; ++i)
+                w.Write(A[i]);
+            w.Write(std::span<const C>(A).subspan(n1));      // also larger than the buffer
+            assert(w.GetCount() == A.size());
+        }                                                    // closed by the destructor
+
+        {
+            CircFileReader r(Path);
+            assert(r.Size() == A.size());
+            assert(r.template Is<C>() && !r.template Is<Other>());
+            assert(std::filesystem::file_size(Path) == sizeof(CircFileHeader) + A.size() * sizeof(C));
+
+            const std::span<const C> V = r.template Values<C>();
+            assert(std::equal(V.begin(), V.end(), A.begin(), A.end()));
+            assert(r.template IsValid<C>());
+            assert(Throws<std::invalid_argument>([&] { r.template Values<Other>(); }));
+        }
+
+        std::filesystem::remove(Path);
+    }
+
+public:
+    CircFileTester()
+    {
+        using CV  = CircVal<Type>;
+        using CVF = CircVal<Type, float>;
+        using CX  = CircValFixed<Type, uint16_t, 12>;
+
+        std::mt19937_64                        Eng(101);
+        std::uniform_real_distribution<double> ud(Type::L, Type::H);
+
+        std::vector<CV > A(1000);
+        std::vector<CVF> Af;
+        std::vector<CX > Ax;
+        for (auto& c : A)
+            c = ud(Eng);
+        A[0] = Type::L;
+        A[1] = Type::Z;
+
+        for (const auto& c : A)
+        {
+            Af.push_back(CVF(c));
+            Ax.push_back(CX (c));
+        }
+
+        TestRoundTrip<CV , CVF>(A );
+        TestRoundTrip<CVF, CV >(Af);
+        TestRoundTrip<CX , CircValFixed<Type, uint16_t>>(Ax);
+        TestRoundTrip<CV , CircVal<TestRange0>>(std::vector<CV>());
+
+        // mapped values - CircValArray bulk operations consume them in place
+        {
+            const auto Path = TempPath<CV>("arr");
+            {
+                CircFileWriter<CV> w(Path);
+                w.Write(std::span<const CV>(A));
+            }
+
+            {
+                CircFileReader                r(Path);
+                const std::span<const double> D = r.template Doubles<Type>();
+                assert(D.data() == reinterpret_cast<const double*>(r.template Values<CV>().data())); // no copy
+
+                const std::vector<CV> B(A.rbegin(), A.rend());
+                const CircValArray<Type> a1{std::span<const CV>(A)};
+                const CircValArray<Type> a2{std::span<const CV>(B)};
+                std::vector<double> d1(A.size()), d2(A.size());
+                CircValArray<Type>::Sdist(D, a2.Vals(), d1);
+                CircValArray<Type>::Sdist(a1, a2, d2);
+                assert(d1 == d2);
+                CircValArray<Type>::Pdist(D, a2.Vals(), d1);
+                CircValArray<Type>::Pdist(a1, a2, d2);
+                assert(d1 == d2);
+
+                assert(Throws<std::invalid_argument>([&] { r.template Doubles<TestRange0>(); }));
+            }                                                // unmapped by the destructor
+
+            std::filesystem::remove(Path);
+        }
+
+        // malformed files
+        {
+            const auto Path = TempPath<CV>("bad");
+            auto WriteRaw = [&](const CircFileHeader& h, size_t nBytes)
+            {
+                CircBufferedWriter w(Path);
+                w.Write(h);
+                for (size_t i = 0; i < nBytes; ++i)
+                    w.Write(uint8_t(0));
+            };
+
+            CircFileHeader h = MakeCircFileHeader<CV>(4);
+            WriteRaw(h, 4*8);
+            assert(CircFileReader(Path).Size() == 4);
+
+            WriteRaw(h, 3*8 + 1);                            // size does not match the count
+            assert(Throws<std::invalid_argument>([&] { CircFileReader r(Path); }));
+
+            CircFileHeader h2 = h; h2.nCount = ~uint64_t(0) / 4; // count * size overflows
+            WriteRaw(h2, 4*8);
+            assert(Throws<std::invalid_argument>([&] { CircFileReader r(Path); }));
+
+            CircFileHeader h3 = h; h3.Magic[0] = 'X';
+            WriteRaw(h3, 4*8);
+            assert(Throws<std::invalid_argument>([&] { CircFileReader r(Path); }));
+
+            CircFileHeader h4 = h; h4.nElemSize = 4;         // double of 4 bytes
+            WriteRaw(h4, 4*4);
+            assert(Throws<std::invalid_argument>([&] { CircFileReader r(Path); }));
+
+            { CircBufferedWriter w(Path); w.Write(&h, 10); }
+            assert(Throws<std::invalid_argument>([&] { CircFileReader r(Path); }));
+
+            { CircBufferedWriter w(Path); }                  // empty file
+            assert(Throws<std::invalid_argument>([&] { CircFileReader r(Path); }));
+
+            CircFileHeader h5 = h; h5.nCount = 1;            // value out of range
+            { CircBufferedWriter w(Path); w.Write(h5); w.Write(Type::H); }
+            assert(!CircFileReader(Path).template IsValid<CV>());
+
+            std::filesystem::remove(Path);
+            assert(Throws<std::system_error>([&] { CircFileReader r(Path); }));
+        }
+    }
+};
@@ -1,59 +1,450 @@
-// ==========================================================================
-// Copyright (C) 2011 Lior Kogan (koganlior1@gmail.com)
-// ==========================================================================
-
-#pragma once
-
-// ==========================================================================
-// square (x*x)
-template <typename T>
-T Sqr(const T& x)
-{
-    return x*x;
-}
-
-// ==========================================================================
-// Floating-point modulo
-// The result (the remainder) has the same sign as the divisor.
-// Similar to Matlab's mod(); Not similar to fmod() -   Mod(-3,4)= 1   fmod(-3,4)= -3
-template<typename T>
-T Mod(T x, T y)
-{
-    static_assert(!std::numeric_limits<T>::is_exact , "Mod: floating-point type expected");
-
-    if (0. == y)
-        return x;
-
-    double m = x - y * floor(x/y);
-
-    // handle boundary cases resulting from floating-point limited accuracy:
-
-    if (y > 0)                // modulo range: [0..y)
-    {
-        if (m >= y)           // Mod(-1e-16             , 360.    ): m= 360.
-            return 0;
-
-        if (m < 0 )
-        {
-            if (y + m == y)
-                return 0    ; // just in case...
-            else
-                return y + m; // Mod(106.81415022205296 , _TWO_PI ): m= -1.421e-14
-        }
-    }
-    else                      // modulo range: (y..0]
-    {
-        if (m <= y)           // Mod(1e-16              , -360.   ): m= -360.
-            return 0;
-
-        if (m > 0 )
-        {
-            if (y + m == y)
-                return 0    ; // just in case...
-            else
-                return y + m; // Mod(-106.81415022205296, -_TWO_PI): m= 1.421e-14
-        }
-    }
-
-    return m;
-}
+// ==========================================================================
+// Copyright (C) 2011 Lior Kogan (koganlior1@gmail.com)
+// ==========================================================================
+
+// DRNadler 14-Oct-2026: Define __min, __max for compilers other than MSVC.
+
+// DRNadler 14-Oct-2026: Add sincos over the operations classes of CircSimd.h, and SinCosTable.
+
+// DRNadler 14-Oct-2026: ModConst at the precision of T.
+
+// DRNadler 14-Oct-2026: RadixSort of all doubles; add SortValues.
+
+// DRNadler 14-Oct-2026: Add AddCompensated.
+
+// DRNadler 14-Oct-2026: Add RadixSort of non-negative doubles with payloads.
+
+// DRNadler 14-Oct-2026: Add ModConst - Mod by a compile-time divisor.
+
+// DRNadler 14-Oct-2026: Add branchless Mod over the operations classes of CircSimd.h, and Mod of each element of an
+// array.
+
+// DRNadler 14-Oct-2026: Add ExactSum128.
+
+#pragma once
+
+#include <cmath>
+#include <algorithm>   // std::copy, std::sort
+#include <array>
+#include <bit>         // std::bit_cast
+#include <cstdint>
+#include <limits>
+#include <numbers>     // std::numbers::pi
+#include <span>
+#include <type_traits>
+#include <utility>     // std::swap
+#include <vector>
+#include "CircSimd.h" // CircSimdLoop
+
+// ==========================================================================
+// MSVC's __min, __max macros (stdlib.h), for other compilers
+#ifndef _MSC_VER
+    #ifndef __min
+        #define __min(a,b) (((a) < (b)) ? (a) : (b))
+    #endif
+    #ifndef __max
+        #define __max(a,b) (((a) > (b)) ? (a) : (b))
+    #endif
+#endif
+
+// ==========================================================================
+// square (x*x)
+template <typename T>
+T Sqr(const T& x)
+{
+    return x*x;
+}
+
+// ==========================================================================
+// compensated (Neumaier) summation: fSum+fComp += x
+inline void AddCompensated(double& fSum, double& fComp, double x)
+{
+    const double t = fSum + x;
+    if (std::abs(fSum) >= std::abs(x)) fComp += (fSum - t) + x;
+    else                               fComp += (x - t) + fSum;
+    fSum = t;
+}
+
+// ==========================================================================
+// exact sum of 64-bit integers: a 128-bit two's-complement accumulator.
+// the sum doesn't depend on the order of the additions, and Sub undoes Add exactly
+struct ExactSum128
+{
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+
+    void Add(int64_t x)
+    {
+        const uint64_t l = lo + static_cast<uint64_t>(x);
+        hi += static_cast<uint64_t>(l < lo) + static_cast<uint64_t>(x >> 63); // carry, sign extension
+        lo  = l;
+    }
+
+    void Add(const ExactSum128& s)
+    {
+        const uint64_t l = lo + s.lo;
+        hi += s.hi + static_cast<uint64_t>(l < lo);
+        lo  = l;
+    }
+
+    void Sub(const ExactSum128& s)
+    {
+        const uint64_t l = lo - s.lo;
+        hi -= s.hi + static_cast<uint64_t>(l > lo);
+        lo  = l;
+    }
+
+    // the sum, rounded to double (not necessarily to nearest - but a function of the sum only)
+    double ToDouble() const
+    {
+        if (static_cast<int64_t>(hi) >= 0)
+            return static_cast<double>(hi) * 0x1p64 + static_cast<double>(lo);
+
+        ExactSum128 n;  // -sum
+        n.Sub(*this);
+        return -n.ToDouble();
+    }
+
+    bool operator==(const ExactSum128&) const = default;
+};
+
+// ==========================================================================
+// Floating-point modulo
+// The result (the remainder) has the same sign as the divisor.
+// Similar to Matlab's mod(); Not similar to fmod() -   Mod(-3,4)= 1   fmod(-3,4)= -3
+template<typename T>
+T Mod(T x, T y)
+{
+    static_assert(!std::numeric_limits<T>::is_exact , "Mod: floating-point type expected");
+
+    if (0. == y)
+        return x;
+
+    T m = x - y * std::floor(x/y); // at the precision of T - the boundary cases below are of T
+
+    // handle boundary cases resulting from floating-point limited accuracy:
+
+    if (y > 0)                // modulo range: [0..y)
+    {
+        if (m >= y)           // Mod(-1e-16             , 360.    ): m= 360.
+            return 0;
+
+        if (m < 0 )
+        {
+            if (y + m == y)
+                return 0    ; // just in case...
+            else
+                return y + m; // Mod(106.81415022205296 , _TWO_PI ): m= -1.421e-14
+        }
+    }
+    else                      // modulo range: (y..0]
+    {
+        if (m <= y)           // Mod(1e-16              , -360.   ): m= -360.
+            return 0;
+
+        if (m > 0 )
+        {
+            if (y + m == y)
+                return 0    ; // just in case...
+            else
+                return y + m; // Mod(-106.81415022205296, -_TWO_PI): m= 1.421e-14
+        }
+    }
+
+    return m;
+}
+
+// ==========================================================================
+// Floating-point modulo by a compile-time divisor Y > 0: Mod(x, T(Y)), range: [0..T(Y))
+// the divisor checks are resolved at compile time, and x/Y is replaced by x*(1/Y) - exact when Y is a power of two.
+// otherwise, floor(x*(1/Y)) may differ from floor(x/Y) when x is (almost) a multiple of Y; the boundary cases handle this
+// all operations are at the precision of T, so the result is in range as a T
+template<double Y, typename T>
+T ModConst(T x)
+{
+    static_assert(!std::numeric_limits<T>::is_exact , "ModConst: floating-point type expected");
+    static_assert(Y > 0.                             , "ModConst: positive divisor expected"   );
+
+    constexpr T y    = static_cast<T>(Y);
+    constexpr T InvY = T(1) / y;
+
+    T m = x - y * std::floor(x * InvY);
+
+    if (m >= y)               // ModConst<360.>(-1e-16): m= 360.
+        return 0;
+
+    if (m < 0 )
+    {
+        if (y + m == y)
+            return 0    ;
+        else
+            return y + m;     // x*InvY rounded up to an integer
+    }
+
+    return m;
+}
+
+// ==========================================================================
+// branchless Mod boundary-case handling, over one of the operations classes of CircSimd.h: m= x - y*floor(q), q ~ x/y
+template<typename Ops>
+typename Ops::V ModKernelQ(typename Ops::V x, typename Ops::V y, typename Ops::V q)
+{
+    using V = typename Ops::V;
+
+    const V Z  = Ops::Set(0.);
+    const V m  = Ops::Sub(x, Ops::Mul(y, Ops::Floor(q)));
+    const V ym = Ops::Add(y, m);
+
+    V res = Ops::Select(Ops::Lt(m , Z), Ops::Select(Ops::Eq(ym, y), Z, ym), m);
+    res   = Ops::Select(Ops::Ge(m , y), Z, res);
+    return res;
+}
+
+// branchless Mod(x, y) for y > 0 - computes the same operations as Mod(), so results are bit-identical
+template<typename Ops>
+typename Ops::V ModKernel(typename Ops::V x, typename Ops::V y)
+{
+    return ModKernelQ<Ops>(x, y, Ops::Div(x, y));
+}
+
+// branchless ModConst<Y>(x) - computes the same operations as ModConst(), so results are bit-identical
+template<double Y, typename Ops>
+typename Ops::V ModConstKernel(typename Ops::V x)
+{
+    return ModKernelQ<Ops>(x, Ops::Set(Y), Ops::Mul(x, Ops::Set(1. / Y)));
+}
+
+// ==========================================================================
+// sine and cosine of x in [-pi, pi], over one of the operations classes of CircSimd.h
+// x is already reduced - e.g. a circular value converted to SignedRadRange - so libm's general range reduction is skipped:
+// k= round(x/(pi/2)) is in [-2, 2], r= x - k*pi/2 is computed with the three-part pi/2 of fdlibm (exact for |k| <= 2),
+// and the fdlibm polynomials of sin and cos on [-pi/4, pi/4] are combined by the quadrant, without branches.
+// error: 1.5 ulp at most (std::sin, std::cos: ~0.5 ulp)
+template<typename Ops>
+void SinCosKernel(typename Ops::V x, typename Ops::V& s, typename Ops::V& c)
+{
+    using V = typename Ops::V;
+
+    const V Round = Ops::Set(6755399441055744.);                                                                  // 1.5*2^52: x+Round-Round rounds x to an integer
+    const V k     = Ops::Sub(Ops::Add(Ops::Mul(x, Ops::Set(2. / std::numbers::pi)), Round), Round);              // quadrant [-2, 2]
+    const V r     = Ops::Sub(Ops::Sub(Ops::Sub(x, Ops::Mul(k, Ops::Set(1.57079632673412561417e+00))),            // pio2_1
+                                                  Ops::Mul(k, Ops::Set(6.07710050630396597660e-11))),            // pio2_2
+                                                  Ops::Mul(k, Ops::Set(2.02226624879595063154e-21)));            // pio2_2t
+    const V z     = Ops::Mul(r, r);
+
+    // sin(r)= r + r^3*(S1 + z*(S2 + ... + z*S6))
+    V ps = Ops::Set(1.58969099521155010221e-10);
+    ps = Ops::Add(Ops::Mul(ps, z), Ops::Set(-2.50507602534068634195e-08));
+    ps = Ops::Add(Ops::Mul(ps, z), Ops::Set( 2.75573137070700676789e-06));
+    ps = Ops::Add(Ops::Mul(ps, z), Ops::Set(-1.98412698298579493134e-04));
+    ps = Ops::Add(Ops::Mul(ps, z), Ops::Set( 8.33333333332248946124e-03));
+    ps = Ops::Add(Ops::Mul(ps, z), Ops::Set(-1.66666666666666324348e-01));
+    const V sr = Ops::Add(r, Ops::Mul(Ops::Mul(z, r), ps));
+
+    // cos(r)= w + ((1-w) - z/2) + z^2*(C1 + z*(C2 + ... + z*C6)),  w= 1 - z/2
+    V pc = Ops::Set(-1.13596475577881948265e-11);
+    pc = Ops::Add(Ops::Mul(pc, z), Ops::Set( 2.08757232129817482790e-09));
+    pc = Ops::Add(Ops::Mul(pc, z), Ops::Set(-2.75573143513906633035e-07));
+    pc = Ops::Add(Ops::Mul(pc, z), Ops::Set( 2.48015872894767294178e-05));
+    pc = Ops::Add(Ops::Mul(pc, z), Ops::Set(-1.38888888888741095749e-03));
+    pc = Ops::Add(Ops::Mul(pc, z), Ops::Set( 4.16666666666666019037e-02));
+    const V one = Ops::Set(1.);
+    const V hz  = Ops::Mul(z, Ops::Set(0.5));
+    const V w   = Ops::Sub(one, hz);
+    const V cr  = Ops::Add(w, Ops::Add(Ops::Sub(Ops::Sub(one, w), hz), Ops::Mul(Ops::Mul(z, z), pc)));
+
+    // sin(r + k*pi/2)= sin(r)*cos(k*pi/2) + cos(r)*sin(k*pi/2), where cos(k*pi/2)= 1-|k| and sin(k*pi/2)= k*(2-|k|) are 0, 1 or -1
+    const V a  = Ops::Abs(k);
+    const V ck = Ops::Sub(one, a);
+    const V sk = Ops::Mul(k, Ops::Sub(Ops::Set(2.), a));
+    s = Ops::Add(Ops::Mul(sr, ck), Ops::Mul(cr, sk));
+    c = Ops::Sub(Ops::Mul(cr, ck), Ops::Mul(sr, sk));
+}
+
+// ==========================================================================
+// fast sine and cosine of an angle given in turns (1 turn = 2*pi), by table and polynomial
+// the angle is split into the nearest of N table angles and a remainder r in [-pi/N, pi/N], and
+// sin(a+r)= sin(a)*cos(r) + cos(a)*sin(r), with cos(r) ~ 1 - r^2/2 and sin(r) ~ r - r^3/6.
+// max abs error: r^4/24 + r^5/120 < 9.5e-10 for N= 256, plus rounding - use when ~1e-9 is accurate enough
+// t should be in [-2^20, 2^20]: the accuracy decreases for larger |t|, as t*N loses fraction bits
+struct SinCosTable
+{
+    static constexpr int    N        = 256;
+    static constexpr double MaxError = 1e-9; // max abs error of Get()
+
+    // s= sin(2*pi*t), c= cos(2*pi*t)
+    static void Get(double t, double& s, double& c)
+    {
+        const double u  = t * N;
+        const double k  = std::floor(u + 0.5);
+        const double r  = (u - k) * (2. * std::numbers::pi / N);
+        const double z  = r * r;
+        const double sr = r - r * z * (1. / 6.);
+        const double cr = 1. - z * 0.5;
+        const Entry& e  = Tab[static_cast<size_t>(static_cast<int64_t>(k)) & (N-1)];
+
+        s = e.s * cr + e.c * sr;
+        c = e.c * cr - e.s * sr;
+    }
+
+private:
+    struct Entry
+    {
+        double s, c; // sin, cos of 2*pi*i/N
+    };
+
+    inline static const std::array<Entry, N> Tab = []
+    {
+        std::array<Entry, N> T;
+        for (int i = 0; i < N; ++i)  // by octant symmetry from [0, pi/4]: exact multiples give exact 0, 1
+        {
+            const int    j = i % (N/4);                                // angle within the quadrant, in steps
+            const bool   b = j > N/8;                                  // upper half of the quadrant
+            const double a = (b ? N/4 - j : j) * (2. * std::numbers::pi / N);
+            double s = b ? std::cos(a) : std::sin(a);
+            double c = b ? std::sin(a) : std::cos(a);
+            for (int q = 0; q < i / (N/4); ++q)                        // rotate by pi/2 per quadrant: (s, c) -> (c, -s)
+            {
+                std::swap(s, c);
+                c = -c;
+            }
+            T[i] = { s, c };
+        }
+        return T;
+    }();
+};
+
+// ==========================================================================
+// Floating-point modulo of each element: x[i]= Mod(x[i], y)
+// vectorized for double and y > 0
+template<typename T>
+void Mod(std::span<T> x, T y)
+{
+    if constexpr (std::is_same_v<T, double>)
+    {
+        if (y > 0.)
+        {
+            double* p = x.data();
+            CircSimdLoop(x.size(), [&](auto ops, size_t i)
+            {
+                using Ops = decltype(ops);
+                Ops::Store(&p[i], ModKernel<Ops>(Ops::Load(&p[i]), Ops::Set(y)));
+            });
+            return;
+        }
+    }
+
+    for (T& a : x)
+        a = Mod(a, y);
+}
+
+// ==========================================================================
+// LSD radix sort of doubles in increasing order, together with their payloads (if bPayload): K[i] is the key of V[i]
+// the sort key is the IEEE-754 bit pattern, with the sign bit flipped for non-negative values and all bits flipped for
+// negative values - which is ordered as the values (-0. is sorted as 0.; NaNs are not allowed). stable
+// 8 passes of 8 bits at most - a pass is skipped if all keys have the same digit: O(n)
+template<bool bPayload, typename P>
+void RadixSortImpl(double* K, P* V, size_t n, std::vector<double>& TmpK, std::vector<P>* TmpV)
+{
+    auto Bits = [](double k) -> uint64_t
+    {
+        const uint64_t b = std::bit_cast<uint64_t>(k + 0.);                    // -0. + 0. = 0.
+        return b ^ (static_cast<uint64_t>(static_cast<int64_t>(b) >> 63) | (uint64_t(1) << 63));
+    };
+
+    if (n < 64) // insertion sort
+    {
+        for (size_t i = 1; i < n; ++i)
+        {
+            const double   k  = K[i];
+            const uint64_t kb = Bits(k);
+            P v{};
+            if constexpr (bPayload) v = V[i];
+
+            size_t j = i;
+            for (; j > 0 && Bits(K[j-1]) > kb; --j)
+            {
+                K[j] = K[j-1];
+                if constexpr (bPayload) V[j] = V[j-1];
+            }
+
+            K[j] = k;
+            if constexpr (bPayload) V[j] = v;
+        }
+        return;
+    }
+
+    // digit histograms of all passes - in a single pass over the keys
+    size_t Hist[8][256] = {};
+    for (size_t i = 0; i < n; ++i)
+    {
+        const uint64_t b = Bits(K[i]);
+        for (unsigned d = 0; d < 8; ++d)
+            ++Hist[d][(b >> (8*d)) & 0xFF];
+    }
+
+    TmpK.resize(n);
+    if constexpr (bPayload) TmpV->resize(n);
+
+    double* SrcK = K;
+    P*      SrcV = V;
+    double* DstK = TmpK.data();
+    P*      DstV = bPayload ? TmpV->data() : nullptr;
+
+    for (unsigned d = 0; d < 8; ++d)
+    {
+        size_t* H = Hist[d];
+        if (H[(Bits(SrcK[0]) >> (8*d)) & 0xFF] == n) // all keys have the same digit
+            continue;
+
+        size_t nSum = 0; // first destination of each digit
+        for (size_t& h : Hist[d])
+        {
+            const size_t c = h;
+            h     = nSum;
+            nSum += c;
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const size_t j = H[(Bits(SrcK[i]) >> (8*d)) & 0xFF]++;
+            DstK[j] = SrcK[i];
+            if constexpr (bPayload) DstV[j] = SrcV[i];
+        }
+
+        std::swap(SrcK, DstK);
+        std::swap(SrcV, DstV);
+    }
+
+    if (SrcK != K)
+    {
+        std::copy(SrcK, SrcK + n, K);
+        if constexpr (bPayload) std::copy(SrcV, SrcV + n, V);
+    }
+}
+
+// sort doubles in increasing order, together with their payloads: K[i] is the key of V[i]. see RadixSortImpl
+// TmpK, TmpV - scratch buffers, resized to n
+template<typename P>
+void RadixSort(std::span<double> K, std::span<P> V, std::vector<double>& TmpK, std::vector<P>& TmpV)
+{
+    RadixSortImpl<true>(K.data(), V.data(), K.size(), TmpK, &TmpV);
+}
+
+// sort doubles in increasing order. see RadixSortImpl
+// Tmp - scratch buffer, resized to n
+inline void RadixSort(std::span<double> K, std::vector<double>& Tmp)
+{
+    RadixSortImpl<false, double>(K.data(), nullptr, K.size(), Tmp, nullptr);
+}
+
+// ==========================================================================
+// sort doubles in increasing order: std::sort for small inputs, RadixSort otherwise
+// below RadixSortMinSize, the histogram and pass overhead of the radix sort (and its scratch buffer) is not paid back
+constexpr size_t RadixSortMinSize = 2048;
+
+inline void SortValues(std::span<double> K, std::vector<double>& Tmp)
+{
+    if (K.size() < RadixSortMinSize) std::sort (K.begin(), K.end());
+    else                             RadixSort(K, Tmp);
+}
@@ -0,0 +1,263 @@
+// ==========================================================================
+// Copyright (C) 2026 DRNadler
+// ==========================================================================
+// classes defined here:
+// CircSite               - instrumented algorithms
+// CircPhase              - phases of an instrumented algorithm
+// CircCounter            - event counters of an instrumented algorithm
+// CircInstrumentData     - per-phase timings and counters of all sites, of one thread
+// CircInstrument         - access to the thread-local data: record, drain
+// CircPhaseClock         - times consecutive phases of a single call
+// ==========================================================================
+// optional instrumentation of the hot paths of CircStat.h, TruncNormalDist.h and WrappedTruncNormalDist.h
+//
+// disabled by default: the CIRC_PHASE_*, CIRC_COUNT macros expand to nothing, and their arguments are not
+// evaluated.
+//     CIRC_PHASE_START(site, phase)  - start timing phase 'phase' (a CircPhase name) of site 'site' (a CircSite), count the call
+//     CIRC_PHASE_NEXT(phase)         - end the current phase of the enclosing CIRC_PHASE_START, start the next one
+//     CIRC_COUNT(site, counter, n)   - add n to counter 'counter' (a CircCounter name) of the site
+// define CIRC_INSTRUMENT (e.g. -DCIRC_INSTRUMENT, or the CMake option of the same name) to enable.
+//
+// each thread records into its own buffer - no locks, no atomics. a caller drains the buffer of its own thread:
+//     CircAverage(A);
+//     CircInstrumentData D = CircInstrument::Drain();
+//     D.Nsec(CircSite::CircAverage, CircPhase::Sort), D.Count(CircSite::CircAverage, CircCounter::Ties), ...
+// work run by an execution policy on other threads is timed as a whole, by the phase that launched it.
+// ==========================================================================
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+#ifdef CIRC_INSTRUMENT
+    #define CIRC_PHASE_START(site, phase) CircPhaseClock _CircPhases(site, CircPhase::phase)
+    #define CIRC_PHASE_NEXT(phase)        _CircPhases.Next(CircPhase::phase)
+    #define CIRC_COUNT(site, counter, n)  CircInstrument::Count(site, CircCounter::counter, static_cast<uint64_t>(n))
+#else
+    #define CIRC_PHASE_START(site, phase) static_cast<void>(0)
+    #define CIRC_PHASE_NEXT(phase)        static_cast<void>(0)
+    #define CIRC_COUNT(site, counter, n)  static_cast<void>(0)
+#endif
+
+// ==========================================================================
+// instrumented algorithms
+// TruncNormal0..5, WrappedTruncNormal0..5: the sampling algorithm (alg()) chosen by the distribution's parameters
+enum class CircSite : uint8_t
+{
+    CircAverage        , // including the sweeps of CircAverageAccumulator and CircAverageSummary
+    CircAverage2       , // serial and execution-policy overloads
+    WeightedCircAverage, // including the sweeps of WeightedCircAverageSummary
+    CircMedian         ,
+    WeightedCircMedian ,
+    TruncNormal0       , TruncNormal1       , TruncNormal2       , TruncNormal3       , TruncNormal4       , TruncNormal5       ,
+    WrappedTruncNormal0, WrappedTruncNormal1, WrappedTruncNormal2, WrappedTruncNormal3, WrappedTruncNormal4, WrappedTruncNormal5,
+    Count
+};
+
+// the site of sampling algorithm nAlg (0..5) of a truncated distribution; Base is TruncNormal0 or WrappedTruncNormal0
+constexpr CircSite CircSiteOfAlg(CircSite Base, int nAlg)
+{
+    return static_cast<CircSite>(static_cast<int>(Base) + nAlg);
+}
+
+// phases of an instrumented algorithm
+enum class CircPhase : uint8_t
+{
+    Convert, // conversion of the input to the range of T / to double
+    Sort   , // sorting the converted values
+    Sweep  , // sector sweep / shift scan / candidate sweep
+    Refine , // CircMedian, WeightedCircMedian: exact re-evaluation of the near-minimal candidates
+    Result , // conversion of the results, and writing them to the output (e.g. building the std::set)
+    Count
+};
+
+// event counters of an instrumented algorithm
+enum class CircCounter : uint8_t
+{
+    Calls     , // instrumented calls
+    Elements  , // input values
+    Ties      , // tie-handling path: a candidate equal to the current minimum was added
+    Candidates, // CircMedian, WeightedCircMedian: candidate medians; CircAverage2: shifts
+    Refined   , // CircMedian, WeightedCircMedian: candidates re-evaluated exactly
+    Samples   , // truncated distributions: values generated
+    Attempts  , // truncated distributions: rejection-loop iterations (Attempts - Samples: rejections)
+    Count
+};
+
+// ==========================================================================
+// per-phase timings and counters of all sites, of one thread
+struct CircInstrumentData
+{
+    static constexpr size_t nSites    = static_cast<size_t>(CircSite   ::Count);
+    static constexpr size_t nPhases   = static_cast<size_t>(CircPhase  ::Count);
+    static constexpr size_t nCounters = static_cast<size_t>(CircCounter::Count);
+
+    std::array<std::array<uint64_t, nPhases  >, nSites> m_Nsec  {}; // [site][phase]   : total time [ns]
+    std::array<std::array<uint64_t, nCounters>, nSites> m_Counts{}; // [site][counter] : total count
+
+    uint64_t  Nsec (CircSite s, CircPhase   p) const { return m_Nsec  [static_cast<size_t>(s)][static_cast<size_t>(p)]; }
+    uint64_t  Count(CircSite s, CircCounter c) const { return m_Counts[static_cast<size_t>(s)][static_cast<size_t>(c)]; }
+    uint64_t& Nsec (CircSite s, CircPhase   p)       { return m_Nsec  [static_cast<size_t>(s)][static_cast<size_t>(p)]; }
+    uint64_t& Count(CircSite s, CircCounter c)       { return m_Counts[static_cast<size_t>(s)][static_cast<size_t>(c)]; }
+
+    // total time of all phases of site s [ns]
+    uint64_t TotalNsec(CircSite s) const
+    {
+        uint64_t n = 0;
+        for (const auto& t : m_Nsec[static_cast<size_t>(s)])
+            n += t;
+        return n;
+    }
+
+    // nothing recorded for site s
+    bool IsEmpty(CircSite s) const
+    {
+        for (const auto& n : m_Counts[static_cast<size_t>(s)])
+            if (n != 0)
+                return false;
+        return TotalNsec(s) == 0;
+    }
+
+    // nothing recorded
+    bool IsEmpty() const
+    {
+        for (size_t s = 0; s < nSites; ++s)
+            if (!IsEmpty(static_cast<CircSite>(s)))
+                return false;
+        return true;
+    }
+
+    // accumulate the data of another thread / drain
+    CircInstrumentData& operator+=(const CircInstrumentData& D)
+    {
+        for (size_t s = 0; s < nSites; ++s)
+        {
+            for (size_t p = 0; p < nPhases  ; ++p) m_Nsec  [s][p] += D.m_Nsec  [s][p];
+            for (size_t c = 0; c < nCounters; ++c) m_Counts[s][c] += D.m_Counts[s][c];
+        }
+        return *this;
+    }
+
+    static const char* Name(CircSite s)
+    {
+        static constexpr const char* Names[nSites] = { "CircAverage", "CircAverage2", "WeightedCircAverage", "CircMedian", "WeightedCircMedian",
+                                                       "TruncNormal0"       , "TruncNormal1"       , "TruncNormal2"       , "TruncNormal3"       , "TruncNormal4"       , "TruncNormal5"       ,
+                                                       "WrappedTruncNormal0", "WrappedTruncNormal1", "WrappedTruncNormal2", "WrappedTruncNormal3", "WrappedTruncNormal4", "WrappedTruncNormal5" };
+        return Names[static_cast<size_t>(s)];
+    }
+
+    static const char* Name(CircPhase p)
+    {
+        static constexpr const char* Names[nPhases] = { "Convert", "Sort", "Sweep", "Refine", "Result" };
+        return Names[static_cast<size_t>(p)];
+    }
+
+    static const char* Name(CircCounter c)
+    {
+        static constexpr const char* Names[nCounters] = { "Calls", "Elements", "Ties", "Candidates", "Refined", "Samples", "Attempts" };
+        return Names[static_cast<size_t>(c)];
+    }
+
+    // one line for each site that recorded anything: phase times [us] and non-zero counters
+    friend std::ostream& operator<<(std::ostream& os, const CircInstrumentData& D)
+    {
+        for (size_t s = 0; s < nSites; ++s)
+        {
+            const CircSite Site = static_cast<CircSite>(s);
+            if (D.IsEmpty(Site))
+                continue;
+
+            os << Name(Site) << ':';
+            for (size_t p = 0; p < nPhases; ++p)
+                if (D.m_Nsec[s][p])
+                    os << ' ' << Name(static_cast<CircPhase>(p)) << '=' << D.m_Nsec[s][p] / 1000. << "us";
+            for (size_t c = 0; c < nCounters; ++c)
+                if (D.m_Counts[s][c])
+                    os << ' ' << Name(static_cast<CircCounter>(c)) << '=' << D.m_Counts[s][c];
+            os << '\n';
+        }
+        return os;
+    }
+};
+
+// ==========================================================================
+// access to the thread-local data
+class CircInstrument
+{
+public:
+#ifdef CIRC_INSTRUMENT
+    static constexpr bool bEnabled = true ;
+#else
+    static constexpr bool bEnabled = false;
+#endif
+
+    // the buffer of the calling thread
+    static CircInstrumentData& Local()
+    {
+        thread_local CircInstrumentData D;
+        return D;
+    }
+
+    // return the data recorded by the calling thread since the last drain, and reset it
+    static CircInstrumentData Drain()
+    {
+        CircInstrumentData& L = Local();
+        CircInstrumentData  D = L;
+        L = CircInstrumentData{};
+        return D;
+    }
+
+    static void Count(CircSite s, CircCounter c, uint64_t n = 1)
+    {
+        Local().Count(s, c) += n;
+    }
+
+    static void AddNsec(CircSite s, CircPhase p, uint64_t nNsec)
+    {
+        Local().Nsec(s, p) += nNsec;
+    }
+};
+
+// ==========================================================================
+// times consecutive phases of a single call: each phase lasts until the next one starts, the last one until destruction
+// counts the call
+class CircPhaseClock
+{
+    using Clock = std::chrono::steady_clock;
+
+    CircSite          m_Site ;
+    CircPhase         m_Phase;
+    Clock::time_point m_Start;
+
+public:
+    CircPhaseClock(CircSite Site, CircPhase Phase) : m_Site(Site), m_Phase(Phase), m_Start(Clock::now())
+    {
+        CircInstrument::Count(m_Site, CircCounter::Calls);
+    }
+
+    CircPhaseClock(const CircPhaseClock&) = delete;
+    CircPhaseClock& operator=(const CircPhaseClock&) = delete;
+
+    ~CircPhaseClock()
+    {
+        Stop();
+    }
+
+    // end the current phase, start phase Phase
+    void Next(CircPhase Phase)
+    {
+        Stop();
+        m_Phase = Phase;
+    }
+
+private:
+    void Stop()
+    {
+        const Clock::time_point Now = Clock::now();
+        CircInstrument::AddNsec(m_Site, m_Phase, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Now - m_Start).count()));
+        m_Start = Now;
+    }
+};
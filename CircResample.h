@@ -0,0 +1,607 @@
+// ==========================================================================
+// Copyright (C) 2026 DRNadler
+// ==========================================================================
+// classes defined here:
+// CircResampler       - resample a sampled circular signal onto a time grid: linear, shortest-arc spline, bucket averages
+// CircResamplerTester - tester for CircResampler
+// ==========================================================================
+
+#pragma once
+
+#include <assert.h>
+#include <algorithm>       // std::upper_bound, std::min, std::max, std::clamp
+#include <cmath>
+#include <iterator>        // std::back_inserter
+#include <limits>
+#include <random>          // CircResamplerTester
+#include <span>
+#include <type_traits>     // std::is_standard_layout_v
+#include <vector>
+
+#include "CircVal.h"       // CircVal
+#include "CircSimd.h"      // CircSimdLoop
+#include "CircValArray.h"  // CircValKernels, CircValArray
+#include "CircStat.h"      // CircStatWorkspace, WeightedCircAverage, CAvrgSampledCircSignal - CircResamplerTester
+
+// ==========================================================================
+// resample a sampled circular signal onto a time grid
+// T is a circular value type defined with the CircValTypeDef macro
+//
+// the samples are given as structure of arrays: Times (strictly ascending) and Vals (values [T::L, T::H) - e.g.
+// CircValArray::Vals(), CircFileReader::Doubles()). the signal between consecutive samples follows the shortest arc:
+// Linear - v[i] + Sdist(v[i], v[i+1]) * s; s in [0,1) is the fraction of the interval
+// Spline - cubic Hermite spline of the unwrapped signal: the value and the slope are continuous at the samples. the
+//          slope at a sample is the Catmull-Rom finite difference (p[i+1] - p[i-1]) / (t[i+1] - t[i-1]) of the
+//          unwrapped values p (one-sided at the first and last samples) - a signal rotating at a constant rate is
+//          reproduced. the spline may overshoot the samples, as any interpolating cubic
+// both interpolate the samples: at a sample time the result is the sample. before the first sample and after the last
+// one, the first / last sample is held.
+//
+// ResampleAvrg: the average of each bucket [Edges[j], Edges[j+1]) of the grid, by the interval weighting of
+// CAvrgSampledCircSignal: the linear signal within the bucket is cut at the samples into intervals; the average of each
+// interval is its circular mid-point, its weight is its duration; the bucket average is the lowest of the
+// WeightedCircAverage set of its intervals. a bucket whose edges are sample times averages exactly the intervals of
+// these samples - the same result as CAvrgSampledCircSignal (Exact mode) over them. a bucket that does not overlap the
+// samples holds the value at its clamped center.
+//
+// the grid may be given as times (any order; ascending grids are located in a single merge pass: O(n+m)) or as a
+// uniform grid fStart + j*fStep - e.g. 100 Hz. the computations run in passes over contiguous arrays:
+// 1. per sample / interval - vectorized (see CircSimd.h): Sdist of consecutive samples; Spline: the slopes
+// 2. per output         - scalar: locate the interval of each grid time; gather its operands
+// 3. per output         - vectorized: the interpolation kernel - bit-identical to the equivalent CircVal expressions
+// the buffers are kept by the resampler: once grown, a resampler reused for further channels allocates nothing.
+// a resampler may not be used concurrently.
+template<typename T>
+class CircResampler
+{
+public:
+    enum class Mode { Linear, Spline };
+
+private:
+    static_assert(sizeof(CircVal<T>) == sizeof(double) && std::is_standard_layout_v<CircVal<T>>, "CircResampler: CircVal should hold its value only");
+
+    Mode                    m_eMode  ;
+
+    std::vector<double>     m_D      ; // per interval: Sdist(v[i], v[i+1])
+    std::vector<double>     m_Slope  ; // per sample  : Spline: slope of the unwrapped signal
+    std::vector<double>     m_G0     ; // per output  : value at the start of the interval
+    std::vector<double>     m_GD     ; // per output  : Sdist over the interval
+    std::vector<double>     m_GF     ; // per output  : fraction of the interval
+    std::vector<double>     m_GA     ; // per output  : Spline: duration * slope at the start of the interval
+    std::vector<double>     m_GB     ; // per output  : Spline: duration * slope at the end   of the interval
+    std::vector<double>     m_PieceW ; // ResampleAvrg: per piece of interval: weight; 0 for a held value
+    std::vector<size_t>     m_Bucket ; // ResampleAvrg: per bucket: end of its pieces
+    std::vector<double>     m_Mids   ; // ResampleAvrg: per piece of interval: circular mid-point
+    CircStatWorkspace       m_W      ; // ResampleAvrg: reused by WeightedCircAverage
+    std::vector<CircVal<T>> m_Res    ; // ResampleAvrg: reused by WeightedCircAverage
+
+    // ---------------------------------------------
+    // interpolation kernels; Ops is one of the operations classes of CircSimd.h
+    // CircVal<T>::Wrap(v0 + d*f)
+    template<typename Ops>
+    static typename Ops::V LinearKernel(typename Ops::V v0, typename Ops::V d, typename Ops::V f)
+    {
+        return CircValKernels<T, Ops>::Wrap(Ops::Add(v0, Ops::Mul(d, f)));
+    }
+
+    // CircVal<T>::Wrap(v0 + s*u*u*a + s*s*(3-2*s)*d - s*s*u*b); u = 1-s: the cubic Hermite basis over the interval
+    template<typename Ops>
+    static typename Ops::V SplineKernel(typename Ops::V v0, typename Ops::V d, typename Ops::V a, typename Ops::V b, typename Ops::V s)
+    {
+        using V = typename Ops::V;
+
+        const V u  = Ops::Sub(Ops::Set(1.), s);
+        const V s2 = Ops::Mul(s, s);
+        const V pa = Ops::Mul(Ops::Mul(Ops::Mul(s, u), u), a);
+        const V pd = Ops::Mul(Ops::Mul(s2, Ops::Sub(Ops::Set(3.), Ops::Add(s, s))), d);
+        const V pb = Ops::Mul(Ops::Mul(s2, u), b);
+        return CircValKernels<T, Ops>::Wrap(Ops::Add(v0, Ops::Sub(Ops::Add(pa, pd), pb)));
+    }
+
+    // ---------------------------------------------
+    // pass 1: Sdist of consecutive samples; Spline: the slopes
+    void Prepare(std::span<const double> Times, std::span<const double> Vals, bool bSlopes)
+    {
+        assert(Times.size() == Vals.size());
+        assert(std::adjacent_find(Times.begin(), Times.end(), [](double a, double b) { return !(a < b); }) == Times.end());
+
+        const size_t n = Times.size();
+        m_D.resize(n > 1 ? n - 1 : 0);
+        if (n < 2)
+            return;
+
+        CircValArray<T>::Sdist(Vals.first(n - 1), Vals.subspan(1), m_D);
+
+        if (!bSlopes)
+            return;
+
+        m_Slope.resize(n);
+        const double* pt = Times  .data();
+        const double* pd = m_D    .data();
+        double*       pm = m_Slope.data() + 1;
+
+        // interior samples: (p[i+1] - p[i-1]) / (t[i+1] - t[i-1]), at pm[i] - sample i+1
+        CircSimdLoop(n - 2, [&](auto ops, size_t i)
+        {
+            using Ops = decltype(ops);
+            Ops::Store(&pm[i], Ops::Div(Ops::Add(Ops::Load(&pd[i]), Ops::Load(&pd[i+1])), Ops::Sub(Ops::Load(&pt[i+2]), Ops::Load(&pt[i]))));
+        });
+
+        m_Slope[0    ] = m_D[0    ] / (Times[1    ] - Times[0    ]);
+        m_Slope[n - 1] = m_D[n - 2] / (Times[n - 1] - Times[n - 2]);
+    }
+
+    // the interval [Times[i], Times[i+1]) of t; t in [Times[0], Times[n-1]). i: a hint - the interval of the previous call
+    // forward: a galloping search from the hint - O(1) for the next interval, O(log k) for k intervals ahead - so an
+    // unsorted grid costs O(m log n) rather than O(m n)
+    static size_t Locate(std::span<const double> Times, double t, size_t i)
+    {
+        if (t < Times[i])
+            return std::upper_bound(Times.begin(), Times.begin() + i, t) - Times.begin() - 1;
+
+        size_t k = 1; // Times[i] <= t
+        while (i + k < Times.size() && Times[i + k] <= t)
+        {
+            i += k;
+            k *= 2;
+        }
+
+        const size_t e = std::min(i + k, Times.size()); // t < Times[e], or e = n
+        return std::upper_bound(Times.begin() + i + 1, Times.begin() + e, t) - Times.begin() - 1;
+    }
+
+    // pass 2: gather the operands of output j - the value at time t
+    void Gather(std::span<const double> Times, std::span<const double> Vals, size_t j, double t, size_t& i, bool bSpline)
+    {
+        const size_t n = Times.size();
+        double d = 0., f = 0., a = 0., b = 0.;
+
+        if (t <= Times[0])
+            m_G0[j] = Vals[0];
+        else if (t >= Times[n - 1])
+            m_G0[j] = Vals[n - 1];
+        else
+        {
+            i = Locate(Times, t, i);
+            const double h = Times[i + 1] - Times[i];
+
+            m_G0[j] = Vals[i];
+            d       = m_D[i];
+            f       = (t - Times[i]) / h;
+            if (bSpline)
+            {
+                a = h * m_Slope[i    ];
+                b = h * m_Slope[i + 1];
+            }
+        }
+
+        m_GD[j] = d;
+        m_GF[j] = f;
+        if (bSpline)
+        {
+            m_GA[j] = a;
+            m_GB[j] = b;
+        }
+    }
+
+    // pass 3: Out[j] = the value of the gathered operands
+    void Interpolate(std::span<double> Out, bool bSpline) const
+    {
+        const double* p0 = m_G0.data();
+        const double* pd = m_GD.data();
+        const double* pf = m_GF.data();
+        double*       po = Out .data();
+
+        if (!bSpline)
+            CircSimdLoop(Out.size(), [&](auto ops, size_t j)
+            {
+                using Ops = decltype(ops);
+                Ops::Store(&po[j], LinearKernel<Ops>(Ops::Load(&p0[j]), Ops::Load(&pd[j]), Ops::Load(&pf[j])));
+            });
+        else
+        {
+            const double* pa = m_GA.data();
+            const double* pb = m_GB.data();
+            CircSimdLoop(Out.size(), [&](auto ops, size_t j)
+            {
+                using Ops = decltype(ops);
+                Ops::Store(&po[j], SplineKernel<Ops>(Ops::Load(&p0[j]), Ops::Load(&pd[j]), Ops::Load(&pa[j]), Ops::Load(&pb[j]), Ops::Load(&pf[j])));
+            });
+        }
+    }
+
+    void Resize(size_t m, bool bSpline)
+    {
+        m_G0.resize(m);
+        m_GD.resize(m);
+        m_GF.resize(m);
+        if (bSpline)
+        {
+            m_GA.resize(m);
+            m_GB.resize(m);
+        }
+    }
+
+    // ---------------------------------------------
+    // Grid(j): the time of output j
+    template<typename GridFn>
+    bool ResampleT(std::span<const double> Times, std::span<const double> Vals, GridFn&& Grid, std::span<double> Out)
+    {
+        if (Times.empty())
+        {
+            std::fill(Out.begin(), Out.end(), CircVal<T>::GetZ());
+            return false;
+        }
+
+        const bool bSpline = m_eMode == Mode::Spline && Times.size() > 2;
+        Prepare(Times, Vals, bSpline);
+        Resize(Out.size(), bSpline);
+
+        size_t i = 0;
+        for (size_t j = 0; j < Out.size(); ++j)
+            Gather(Times, Vals, j, Grid(j), i, bSpline);
+
+        Interpolate(Out, bSpline);
+        return true;
+    }
+
+    // Edge(j): the start of bucket j; Edge(j+1): its end
+    template<typename EdgeFn>
+    bool ResampleAvrgT(std::span<const double> Times, std::span<const double> Vals, EdgeFn&& Edge, std::span<double> Out)
+    {
+        if (Times.empty())
+        {
+            std::fill(Out.begin(), Out.end(), CircVal<T>::GetZ());
+            return false;
+        }
+
+        Prepare(Times, Vals, false);
+
+        const size_t n      = Times.size();
+        const double fFirst = Times[0    ];
+        const double fLast  = Times[n - 1];
+
+        // gather the pieces of the intervals within each bucket: operands of the mid-point, and weight
+        m_G0.clear(); m_GD.clear(); m_GF.clear(); m_PieceW.clear();
+        m_Bucket.resize(Out.size());
+
+        size_t i = 0;
+        for (size_t j = 0; j < Out.size(); ++j)
+        {
+            const double fStart = Edge(j    );
+            const double fEnd   = Edge(j + 1);
+            assert(fStart <= fEnd);
+
+            const double a = std::max(fStart, fFirst);
+            const double b = std::min(fEnd  , fLast );
+
+            if (!(a < b)) // no overlap: hold the value at the clamped center
+            {
+                m_G0.emplace_back(); m_GD.emplace_back(); m_GF.emplace_back();
+                Gather(Times, Vals, m_G0.size() - 1, std::clamp((fStart + fEnd) / 2, fFirst, fLast), i, false);
+                m_PieceW.emplace_back(0.);
+            }
+            else
+                for (i = Locate(Times, a, i); i + 1 < n && Times[i] < b; ++i)
+                {
+                    const double t0 = Times[i], t1 = Times[i + 1], h = t1 - t0;
+                    const double lo = std::max(a, t0);
+                    const double hi = std::min(b, t1);
+                    if (!(lo < hi))
+                        continue;
+
+                    m_G0    .emplace_back(Vals[i]);
+                    m_GD    .emplace_back(m_D[i]);
+                    m_GF    .emplace_back(((lo - t0) / h + (hi - t0) / h) / 2); // the mid-point of the piece [lo,hi]
+                    m_PieceW.emplace_back(hi - lo);
+                }
+
+            if (a < b) // the hint: the last interval of the bucket - the first of the next one, for ascending edges
+                --i;
+
+            m_Bucket[j] = m_PieceW.size();
+        }
+
+        // the mid-points of all pieces - the hold values too: their interval Sdist is 0
+        m_Mids.resize(m_PieceW.size());
+        Interpolate(m_Mids, false);
+
+        const CircVal<T>* pMids = reinterpret_cast<const CircVal<T>*>(m_Mids.data());
+        size_t            b     = 0;
+        for (size_t j = 0; j < Out.size(); b = m_Bucket[j++])
+        {
+            const size_t e = m_Bucket[j];
+            if (e - b == 1 && m_PieceW[b] == 0.)
+            {
+                Out[j] = m_Mids[b];
+                continue;
+            }
+
+            m_Res.clear();
+            WeightedCircAverage(std::span<const CircVal<T>>(pMids + b, e - b), std::span<const double>(m_PieceW.data() + b, e - b), m_W, std::back_inserter(m_Res));
+            Out[j] = m_Res.front(); // lowest of the average set
+        }
+
+        return true;
+    }
+
+public:
+    explicit CircResampler(Mode eMode = Mode::Linear) : m_eMode(eMode)
+    {
+    }
+
+    Mode GetMode() const { return m_eMode; }
+
+    // ---------------------------------------------
+    // Out[j] = the signal at time Grid[j]
+    // Times, Vals: the samples - same size; Grid, Out: same size
+    // return false if there are no samples: Out is then filled with T::Z
+    bool Resample(std::span<const double> Times, std::span<const double> Vals, std::span<const double> Grid, std::span<double> Out)
+    {
+        assert(Grid.size() == Out.size());
+        return ResampleT(Times, Vals, [&](size_t j) { return Grid[j]; }, Out);
+    }
+
+    // Out[j] = the signal at time fStart + j*fStep
+    bool Resample(std::span<const double> Times, std::span<const double> Vals, double fStart, double fStep, std::span<double> Out)
+    {
+        assert(fStep > 0.);
+        return ResampleT(Times, Vals, [&](size_t j) { return fStart + j * fStep; }, Out);
+    }
+
+    // Out[j] = the average of the signal over [Edges[j], Edges[j+1]) - linear interpolation
+    // Edges: ascending, one more than Out
+    // return false if there are no samples: Out is then filled with T::Z
+    bool ResampleAvrg(std::span<const double> Times, std::span<const double> Vals, std::span<const double> Edges, std::span<double> Out)
+    {
+        assert(Edges.size() == Out.size() + 1);
+        return ResampleAvrgT(Times, Vals, [&](size_t j) { return Edges[j]; }, Out);
+    }
+
+    // Out[j] = the average of the signal over [fStart + j*fStep, fStart + (j+1)*fStep) - linear interpolation
+    bool ResampleAvrg(std::span<const double> Times, std::span<const double> Vals, double fStart, double fStep, std::span<double> Out)
+    {
+        assert(fStep > 0.);
+        return ResampleAvrgT(Times, Vals, [&](size_t j) { return fStart + j * fStep; }, Out);
+    }
+};
+
+// ==========================================================================
+// tester for CircResampler
+// Type should be defined using the CircValType template
+template <typename Type>
+class CircResamplerTester
+{
+    using Resampler = CircResampler<Type>;
+
+    static bool IsNear(double c1, double c2, double fTol)
+    {
+        return std::abs(CircVal<Type>::Sdist(c1, c2)) <= fTol * Type::R;
+    }
+
+    // scalar reference of the Spline kernel - the same operations, in the same order
+    static double SplineRef(double v0, double d, double a, double b, double s)
+    {
+        const double u = 1. - s;
+        return CircVal<Type>::Wrap(v0 + ((s*u*u*a + s*s*(3. - (s + s))*d) - s*s*u*b));
+    }
+
+public:
+    CircResamplerTester()
+    {
+        Test();
+    }
+
+    static void Test()
+    {
+        std::default_random_engine             rand_engine            ;
+        std::uniform_real_distribution<double> c_uni_dist(Type::L, Type::H);
+        std::uniform_real_distribution<double> u_uni_dist(0., 1.  );
+        std::uniform_real_distribution<double> s_uni_dist(-0.2, 0.2); // steps of a random walk, relative to R
+
+        Resampler Lin;
+        Resampler Spl(Resampler::Mode::Spline);
+        assert(Lin.GetMode() == Resampler::Mode::Linear && Spl.GetMode() == Resampler::Mode::Spline);
+
+        // no samples
+        {
+            std::vector<double> Out(3, Type::L);
+            [[maybe_unused]] const bool bRes = Lin.Resample({}, {}, 0., 1., Out);
+            assert(!bRes && Out[0] == Type::Z && Out[2] == Type::Z);
+        }
+
+        for (size_t r = 0; r < 200; ++r)
+        {
+            // irregular times, random walk values - with steps beyond R/2 close to the wrap
+            const size_t n = 1 + r % 40;
+            std::vector<double> Times(n), Vals(n);
+            double t = -5. + u_uni_dist(rand_engine);
+            double v = c_uni_dist(rand_engine);
+            for (size_t i = 0; i < n; ++i)
+            {
+                Times[i] = t += 0.05 + u_uni_dist(rand_engine);
+                Vals [i] = CircVal<Type>::Wrap(v += (r % 5 ? s_uni_dist(rand_engine) : u_uni_dist(rand_engine)) * Type::R);
+            }
+
+            const double fFirst = Times.front(), fLast = Times.back();
+
+            // grid: random times within and around the samples - unsorted; and the sample times
+            std::vector<double> Grid;
+            for (size_t j = 0; j < 50; ++j)
+                Grid.emplace_back(fFirst - 1. + (fLast - fFirst + 2.) * u_uni_dist(rand_engine));
+            Grid.insert(Grid.end(), Times.begin(), Times.end());
+
+            std::vector<double> OutL(Grid.size()), OutS(Grid.size());
+            [[maybe_unused]] bool bRes = Lin.Resample(Times, Vals, Grid, OutL);
+            assert(bRes);
+            bRes = Spl.Resample(Times, Vals, Grid, OutS);
+            assert(bRes);
+
+            // slopes for the spline reference
+            std::vector<double> M(n, 0.);
+            for (size_t i = 1; i + 1 < n; ++i)
+                M[i] = (CircVal<Type>::Sdist(Vals[i-1], Vals[i]) + CircVal<Type>::Sdist(Vals[i], Vals[i+1])) / (Times[i+1] - Times[i-1]);
+            if (n > 1)
+            {
+                M[0  ] = CircVal<Type>::Sdist(Vals[0  ], Vals[1  ]) / (Times[1  ] - Times[0  ]);
+                M[n-1] = CircVal<Type>::Sdist(Vals[n-2], Vals[n-1]) / (Times[n-1] - Times[n-2]);
+            }
+
+            for (size_t j = 0; j < Grid.size(); ++j)
+            {
+                const double g = Grid[j];
+                double       fL, fS;
+
+                if      (g <= fFirst) fL = fS = Vals.front();
+                else if (g >= fLast ) fL = fS = Vals.back ();
+                else
+                {
+                    const size_t i = std::upper_bound(Times.begin(), Times.end(), g) - Times.begin() - 1;
+                    const double h = Times[i+1] - Times[i];
+                    const double d = CircVal<Type>::Sdist(Vals[i], Vals[i+1]);
+                    const double s = (g - Times[i]) / h;
+
+                    fL = CircVal<Type>::Wrap(Vals[i] + d * s);
+                    fS = n > 2 ? SplineRef(Vals[i], d, h * M[i], h * M[i+1], s) : fL; // 2 samples: the spline is linear
+                }
+
+                assert(OutL[j] == fL); // bit-identical to the scalar expressions
+                assert(OutS[j] == fS);
+                assert(CircVal<Type>::IsInRange(OutL[j]) && CircVal<Type>::IsInRange(OutS[j]));
+            }
+
+            // the sample times: the samples
+            for (size_t i = 0; i < n; ++i)
+                assert(OutL[50 + i] == Vals[i] && OutS[50 + i] == Vals[i]);
+
+            // uniform grid == the same times given as a grid
+            {
+                const double fStep = (fLast - fFirst + 2.) / 37.;
+                std::vector<double> UGrid(37), OutU(37), OutG(37);
+                for (size_t j = 0; j < UGrid.size(); ++j)
+                    UGrid[j] = (fFirst - 1.) + j * fStep;
+
+                Spl.Resample(Times, Vals, fFirst - 1., fStep, OutU);
+                Spl.Resample(Times, Vals, UGrid, OutG);
+                assert(OutU == OutG);
+            }
+
+            // bucket averages
+            {
+                // a single bucket over all samples: CAvrgSampledCircSignal
+                if (n > 1)
+                {
+                    CAvrgSampledCircSignal<Type> Sig;
+                    for (size_t i = 0; i < n; ++i)
+                        Sig.AddMeasurement(Vals[i], Times[i]);
+
+                    CircVal<Type> Avrg;
+                    Sig.GetAvrg(Avrg);
+
+                    double fAvrg;
+                    const std::vector<double> Edges = { fFirst - 1., fLast + 1. };
+                    Lin.ResampleAvrg(Times, Vals, Edges, std::span<double>(&fAvrg, 1));
+                    assert(fAvrg == static_cast<double>(Avrg));
+                }
+
+                // buckets whose edges are sample times: CAvrgSampledCircSignal over the samples of each bucket
+                {
+                    std::vector<double> Edges, Out;
+                    std::vector<size_t> Idx;
+                    for (size_t i = 0; i < n; i += 1 + r % 4)
+                    {
+                        Edges.emplace_back(Times[i]);
+                        Idx  .emplace_back(i);
+                    }
+                    Out.resize(Edges.size() - 1);
+                    Lin.ResampleAvrg(Times, Vals, Edges, Out);
+
+                    for (size_t j = 0; j < Out.size(); ++j)
+                    {
+                        CAvrgSampledCircSignal<Type> Sig;
+                        for (size_t i = Idx[j]; i <= Idx[j+1]; ++i)
+                            Sig.AddMeasurement(Vals[i], Times[i]);
+
+                        CircVal<Type> Avrg;
+                        Sig.GetAvrg(Avrg);
+                        assert(Out[j] == static_cast<double>(Avrg));
+                    }
+                }
+
+                // uniform buckets: the weighted average of the pieces of the intervals within each bucket
+                {
+                    const double        fStep = (fLast - fFirst + 2.) / 23.;
+                    std::vector<double> Out(23);
+                    Lin.ResampleAvrg(Times, Vals, fFirst - 1., fStep, Out);
+
+                    for (size_t j = 0; j < Out.size(); ++j)
+                    {
+                        const double a = std::max(fFirst - 1. +  j      * fStep, fFirst);
+                        const double b = std::min(fFirst - 1. + (j + 1) * fStep, fLast );
+
+                        std::vector<CircVal<Type>> Mids;
+                        std::vector<double>        W;
+                        for (size_t i = 0; i + 1 < n; ++i)
+                        {
+                            const double lo = std::max(a, Times[i]), hi = std::min(b, Times[i+1]), h = Times[i+1] - Times[i];
+                            if (lo < hi)
+                            {
+                                Mids.emplace_back(Vals[i] + CircVal<Type>::Sdist(Vals[i], Vals[i+1]) * (((lo - Times[i]) / h + (hi - Times[i]) / h) / 2));
+                                W   .emplace_back(hi - lo);
+                            }
+                        }
+
+                        if (Mids.empty()) // no overlap: the value at the clamped center
+                        {
+                            const double c = std::clamp(fFirst - 1. + (j + 0.5) * fStep, fFirst, fLast);
+                            std::vector<double> Out1(1);
+                            Lin.Resample(Times, Vals, std::span<const double>(&c, 1), Out1);
+                            assert(Out[j] == Out1[0]);
+                        }
+                        else
+                            assert(Out[j] == static_cast<double>(*WeightedCircAverage(Mids, W).begin()));
+                    }
+                }
+            }
+        }
+
+        // a signal rotating at a constant rate through the wrap: Linear and Spline reproduce it
+        {
+            const size_t n = 100;
+            std::vector<double> Times(n), Vals(n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                Times[i] = 0.01 * i + (i % 3) * 0.002;                  // irregular sampling
+                Vals [i] = CircVal<Type>::Wrap(Type::Z + 0.7 * Type::R * Times[i]); // 0.7 turns per time unit
+            }
+
+            std::vector<double> OutL(997), OutS(997);
+            Lin.Resample(Times, Vals, Times.front(), (Times.back() - Times.front()) / 996., OutL);
+            Spl.Resample(Times, Vals, Times.front(), (Times.back() - Times.front()) / 996., OutS);
+
+            for (size_t j = 0; j < OutL.size(); ++j)
+            {
+                const double t = Times.front() + j * (Times.back() - Times.front()) / 996.;
+                [[maybe_unused]] const double c = CircVal<Type>::Wrap(Type::Z + 0.7 * Type::R * t);
+                assert(IsNear(OutL[j], c, 1e-12));
+                assert(IsNear(OutS[j], c, 1e-12));
+            }
+
+            // bucket averages of the rotation: the value at the center of each bucket
+            std::vector<double> Out(20);
+            Lin.ResampleAvrg(Times, Vals, 0.05, 0.04, Out);
+            for (size_t j = 0; j < Out.size(); ++j)
+                assert(IsNear(Out[j], CircVal<Type>::Wrap(Type::Z + 0.7 * Type::R * (0.05 + (j + 0.5) * 0.04)), 1e-12));
+        }
+
+        // a single sample: held
+        {
+            const std::vector<double> Times = { 1. }, Vals = { c_uni_dist(rand_engine) };
+            std::vector<double> Out(4);
+            Spl.Resample(Times, Vals, 0., 0.7, Out);
+            assert(Out[0] == Vals[0] && Out[3] == Vals[0]);
+            Lin.ResampleAvrg(Times, Vals, 0., 0.7, Out);
+            assert(Out[1] == Vals[0] && Out[3] == Vals[0]);
+        }
+    }
+};
@@ -0,0 +1,181 @@
+// ==========================================================================
+// Copyright (C) 2026 DRNadler
+// ==========================================================================
+// classes defined here:
+// CircSimdScalar     - scalar (single lane) implementation of the SIMD operations
+// CircSimdAVX512     - AVX-512 implementation of the SIMD operations (8 lanes)
+// CircSimdAVX2       - AVX2    implementation of the SIMD operations (4 lanes)
+// CircSimdNEON       - NEON    implementation of the SIMD operations (2 lanes, AArch64 only)
+// CircSimdNative     - the widest implementation enabled by the compiler flags
+// CircSimdLoop       - apply a kernel to [0,n), using CircSimdNative and CircSimdScalar for the tail
+// ==========================================================================
+
+// kernels are written once, as templates over the operations class (Ops), and must use only the operations below.
+// all operations are IEEE correctly rounded, so a kernel returns bit-identical results for all implementations,
+// and bit-identical results to the equivalent scalar code - provided the compiler does not contract a*b+c into FMA
+// (MSVC /fp:precise does not; for GCC/Clang use -ffp-contract=off).
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <functional>   // std::equal_to
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+#endif
+
+// ==========================================================================
+// scalar implementation
+struct CircSimdScalar
+{
+    using V = double; // vector of doubles
+    using M = bool  ; // mask
+
+    static constexpr size_t N = 1; // number of lanes
+
+    static V    Load  (const double* p         ) { return *p;                            }
+    static void Store (double* p, V a          ) { *p = a;                               }
+    static V    Set   (double r                ) { return r;                             }
+
+    static V    Add   (V a, V b                ) { return a + b;                         }
+    static V    Sub   (V a, V b                ) { return a - b;                         }
+    static V    Mul   (V a, V b                ) { return a * b;                         }
+    static V    Div   (V a, V b                ) { return a / b;                         }
+    static V    Floor (V a                     ) { return std::floor(a);                 }
+    static V    Abs   (V a                     ) { return std::abs(a);                   }
+
+    static M    Ge    (V a, V b                ) { return a >= b;                        }
+    static M    Lt    (V a, V b                ) { return a <  b;                        }
+    static M    Eq    (V a, V b                ) { return std::equal_to<V>{}(a, b);      } // instead of == to avoid triggering -Wfloat-equal
+
+    static M    And   (M a, M b                ) { return a & b;                         }
+    static M    AndNot(M a, M b                ) { return !a & b;                        } // (not a) and b
+    static V    Select(M m, V a, V b           ) { return m ? a : b;                     } // m ? a : b, per lane
+};
+
+// ==========================================================================
+#if defined(__AVX512F__)
+// AVX-512 implementation
+struct CircSimdAVX512
+{
+    using V = __m512d;
+    using M = __mmask8;
+
+    static constexpr size_t N = 8;
+
+    static V    Load  (const double* p         ) { return _mm512_loadu_pd(p);                          }
+    static void Store (double* p, V a          ) { _mm512_storeu_pd(p, a);                             }
+    static V    Set   (double r                ) { return _mm512_set1_pd(r);                           }
+
+    static V    Add   (V a, V b                ) { return _mm512_add_pd(a, b);                         }
+    static V    Sub   (V a, V b                ) { return _mm512_sub_pd(a, b);                         }
+    static V    Mul   (V a, V b                ) { return _mm512_mul_pd(a, b);                         }
+    static V    Div   (V a, V b                ) { return _mm512_div_pd(a, b);                         }
+    static V    Floor (V a                     ) { return _mm512_mask_roundscale_pd(a, 0xFF, a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); } // masked form: defined pass-through
+    static V    Abs   (V a                     ) { return _mm512_abs_pd(a);                            }
+
+    static M    Ge    (V a, V b                ) { return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ);        }
+    static M    Lt    (V a, V b                ) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ);        }
+    static M    Eq    (V a, V b                ) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ);        }
+
+    static M    And   (M a, M b                ) { return static_cast<M>( a & b);                     }
+    static M    AndNot(M a, M b                ) { return static_cast<M>(~a & b);                     }
+    static V    Select(M m, V a, V b           ) { return _mm512_mask_blend_pd(m, b, a);               }
+};
+#endif
+
+// ==========================================================================
+#if defined(__AVX2__)
+// AVX2 implementation
+struct CircSimdAVX2
+{
+    using V = __m256d;
+    using M = __m256d;
+
+    static constexpr size_t N = 4;
+
+    static V    Load  (const double* p         ) { return _mm256_loadu_pd(p);                          }
+    static void Store (double* p, V a          ) { _mm256_storeu_pd(p, a);                             }
+    static V    Set   (double r                ) { return _mm256_set1_pd(r);                           }
+
+    static V    Add   (V a, V b                ) { return _mm256_add_pd(a, b);                         }
+    static V    Sub   (V a, V b                ) { return _mm256_sub_pd(a, b);                         }
+    static V    Mul   (V a, V b                ) { return _mm256_mul_pd(a, b);                         }
+    static V    Div   (V a, V b                ) { return _mm256_div_pd(a, b);                         }
+    static V    Floor (V a                     ) { return _mm256_round_pd(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static V    Abs   (V a                     ) { return _mm256_andnot_pd(_mm256_set1_pd(-0.), a);    } // clear the sign bit
+
+    static M    Ge    (V a, V b                ) { return _mm256_cmp_pd(a, b, _CMP_GE_OQ);             }
+    static M    Lt    (V a, V b                ) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ);             }
+    static M    Eq    (V a, V b                ) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ);             }
+
+    static M    And   (M a, M b                ) { return _mm256_and_pd   (a, b);                      }
+    static M    AndNot(M a, M b                ) { return _mm256_andnot_pd(a, b);                      }
+    static V    Select(M m, V a, V b           ) { return _mm256_blendv_pd(b, a, m);                   }
+};
+#endif
+
+// ==========================================================================
+#if defined(__ARM_NEON) && defined(__aarch64__)
+// NEON implementation (AArch64 only - ARMv7 NEON has no double-precision lanes)
+struct CircSimdNEON
+{
+    using V = float64x2_t;
+    using M = uint64x2_t ;
+
+    static constexpr size_t N = 2;
+
+    static V    Load  (const double* p         ) { return vld1q_f64(p);                                }
+    static void Store (double* p, V a          ) { vst1q_f64(p, a);                                    }
+    static V    Set   (double r                ) { return vdupq_n_f64(r);                              }
+
+    static V    Add   (V a, V b                ) { return vaddq_f64(a, b);                             }
+    static V    Sub   (V a, V b                ) { return vsubq_f64(a, b);                             }
+    static V    Mul   (V a, V b                ) { return vmulq_f64(a, b);                             }
+    static V    Div   (V a, V b                ) { return vdivq_f64(a, b);                             }
+    static V    Floor (V a                     ) { return vrndmq_f64(a);                               }
+    static V    Abs   (V a                     ) { return vabsq_f64(a);                                }
+
+    static M    Ge    (V a, V b                ) { return vcgeq_f64(a, b);                             }
+    static M    Lt    (V a, V b                ) { return vcltq_f64(a, b);                             }
+    static M    Eq    (V a, V b                ) { return vceqq_f64(a, b);                             }
+
+    static M    And   (M a, M b                ) { return vandq_u64(a, b);                             }
+    static M    AndNot(M a, M b                ) { return vbicq_u64(b, a);                             } // b and not a
+    static V    Select(M m, V a, V b           ) { return vbslq_f64(m, a, b);                          }
+};
+#endif
+
+// ==========================================================================
+// the widest implementation enabled by the compiler flags
+#if   defined(__AVX512F__)
+    using CircSimdNative = CircSimdAVX512;
+#elif defined(__AVX2__)
+    using CircSimdNative = CircSimdAVX2;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    using CircSimdNative = CircSimdNEON;
+#else
+    using CircSimdNative = CircSimdScalar;
+#endif
+
+// ==========================================================================
+// apply a kernel to [0,n)
+// Kernel is called as Kernel(Ops(), i) - processes Ops::N elements starting at i
+// sample use: CircSimdLoop(n, [&](auto ops, size_t i) { using Ops = decltype(ops); Ops::Store(&p[i], Ops::Add(Ops::Load(&p[i]), Ops::Set(1.))); });
+template<typename Kernel>
+inline void CircSimdLoop(size_t n, Kernel&& K)
+{
+    size_t i = 0;
+
+    if constexpr (CircSimdNative::N > 1)
+        for (; i + CircSimdNative::N <= n; i += CircSimdNative::N)
+            K(CircSimdNative(), i);
+
+    for (; i < n; ++i)
+        K(CircSimdScalar(), i);
+}
@@ -1,482 +1,4082 @@
-// ==========================================================================
-// Copyright (C) 2011 Lior Kogan (koganlior1@gmail.com)
-// ==========================================================================
-// classes defined here:
-// CircAverage            - calculate average set of circular values
-// WeightedCircAverage    - calculate weighted-average set of circular values
-// CAvrgSampledCircSignal - estimate the average of a sampled continuous-time circular signal, using circular linear interpolation
-// CircMedian             - calculate median set of circular values
-// ==========================================================================
-
-#pragma once
-
-#include <cmath>
-#include <assert.h>
-#include <set>
-#include <vector>
-#include <algorithm>    // sort
-
-#include "CircHelper.h" // Sqr
-
-using namespace std;
-
-// ==========================================================================
-// calculate average set of circular values
-// return set of average values
-// T is a circular value type defined with the CircValTypeDef macro
-template<typename T>
-set<CircVal<T>> CircAverage(vector<CircVal<T>> const& A)
-{
-    // ----------------------------------------------
-    // all vars: UnsignedDegRange [0,360)
-    double          fSum           = 0.; // of all elements of A
-    double          fSumSqr        = 0.; // of all elements of A
-    double          fMinSumSqrDiff     ; // minimal sum of squares of differences
-    vector<double>  LowerAngles        ; // ascending   [  0,180)
-    vector<double>  UpperAngles        ; // descending  (360,180)
-    double          fTestAvrg          ;
-    vector<double>  MinAvrgVals        ; // results set
-
-    // ----------------------------------------------
-    // local functions - implemented as lambdas
-    // ----------------------------------------------
-
-    // calc sum(dist(180, Bi)^2) - all values are in set B
-    // dist(180,Bi)= |180-Bi|
-    // sum(dist(x, Bi)^2) = sum((180-Bi)^2) = sum(180^2-2*180*Bi + Bi^2) = 180^2*A.size - 360*sum(Ai) + sum(Ai^2)
-    auto SumSqr = [&]() -> double
-    {
-        return 32400.*A.size() - 360.*fSum + fSumSqr;
-    };
-
-    // calc sum(dist(x, Ai)^2). A=B+C; set D is empty
-    // dist(x,Bi)= |x-Bi|
-    // dist(x,Ci)= 360-(Ci-x)
-    // sum(dist(x, Bi)^2)= sum(     (x-Bi) ^2)= sum(        Bi^2 + x^2                      - 2*Bi*x)
-    // sum(dist(x, Ci)^2)= sum((360-(Ci-x))^2)= sum(360^2 + Ci^2 + x^2 - 2*360*Ci + 2*360*x - 2*Ci*x)
-    // sum(dist(x, Bi)^2) + sum(dist(x, Ci)^2) = nCountC*360^2 + sum(Ai^2) + nCountA*x^2 - 2*360*sum(Ci) + nCountC*2*360*x - 2*x*sum(Ai)
-    auto SumSqrC = [&](double x, size_t nCountC, double fSumC) -> double
-    {
-        return x*(A.size()*x - 2*fSum) + fSumSqr - 2*360.*fSumC + nCountC*( 2*360.*x + 360.*360.);
-    };
-
-    // calc sum(dist(x, Ai)^2). A=B+D; set C is empty
-    // dist(x,Bi)= |x-Bi|
-    // dist(x,Di)= 360-(x-Di)
-    // sum(dist(x,Bi)^2)= sum(    (x-Bi)^2)= sum(        Bi^2 + x^2                      - 2*Bi*x)
-    // sum(dist(x,Di)^2)= sum(360-(x-Di)^2)= sum(360^2 + Di^2 + x^2 + 2*360*Di - 2*360*x - 2*Di*x)
-    // sum(dist(x, Bi)^2) + sum(dist(x, Di)^2) = nCountD*360^2 + sum(Ai^2) + nCountA*x^2 + 2*360*sum(Di) - nCountD*2*360*x - 2*x*sum(Ai)
-    auto SumSqrD = [&](double x, size_t nCountD, double fSumD) -> double
-    {
-        return x * (A.size()*x - 2*fSum) + fSumSqr + 2*360.*fSumD + nCountD*(-2*360.*x + 360.*360.);
-    };
-
-    // update MinAvrgAngles if lower/equal fMinSumSqrDiff found
-    auto TestSum = [&](double fTestAvrg, double fTestSumDiffSqr) -> void
-    {
-        if (fTestSumDiffSqr < fMinSumSqrDiff)
-        {
-            MinAvrgVals.clear();
-            MinAvrgVals.emplace_back(fTestAvrg);
-            fMinSumSqrDiff = fTestSumDiffSqr;
-        }
-        else if (fTestSumDiffSqr == fMinSumSqrDiff)
-            MinAvrgVals.emplace_back(fTestAvrg);
-    };
-
-    // ----------------------------------------------
-    for (const auto& a : A)
-    {
-        double v = CircVal<UnsignedDegRange>(a); // convert to [0.360)
-        fSum    +=     v ;
-        fSumSqr += Sqr(v);
-             if (v < 180.) LowerAngles.emplace_back(v);
-        else if (v > 180.) UpperAngles.emplace_back(v);
-    }
-
-    sort(LowerAngles.begin(), LowerAngles.end()                   ); // ascending   [  0,180)
-    sort(UpperAngles.begin(), UpperAngles.end(), greater<double>()); // descending  (360,180)
-
-    // ----------------------------------------------
-    // start with avrg= 180, sets c,d are empty
-    // ----------------------------------------------
-    MinAvrgVals.clear();
-    MinAvrgVals.emplace_back(180.);
-    fMinSumSqrDiff = SumSqr();
-
-    // ----------------------------------------------
-    // average in (180,360), set D: values in range [0,avrg-180)
-    // ----------------------------------------------
-    double fLowerBound = 0.; // of current sector
-    double fSumD       = 0.; // of elements of set D
-
-    auto iter = LowerAngles.begin();
-    for (size_t d = 0; d < LowerAngles.size(); ++d)
-    {
-        // 1st  iteration : average in (                 180, lowerAngles[0]+180]
-        // next iterations: average in (lowerAngles[i-1]+180, lowerAngles[i]+180]
-        // set D          : lowerAngles[0..d]
-
-        fTestAvrg = (fSum + 360.*d)/A.size(); // average for sector, that minimizes SumDiffSqr
-
-        if ((fTestAvrg > fLowerBound+180.) && (fTestAvrg <= *iter+180.))  // if fTestAvrg is within sector
-            TestSum(fTestAvrg, SumSqrD(fTestAvrg, d, fSumD));             // check if fTestAvrg generates lower SumSqr
-
-        fLowerBound  = *iter      ;
-        fSumD       += fLowerBound;
-        ++iter;
-    }
-
-    // last sector : average in [lowerAngles[lastIdx]+180, 360)
-    fTestAvrg = (fSum + 360.*LowerAngles.size())/A.size(); // average for sector, that minimizes SumDiffSqr
-
-    if ((fTestAvrg < 360.) && (fTestAvrg > fLowerBound))                   // if fTestAvrg is within sector
-        TestSum(fTestAvrg, SumSqrD(fTestAvrg, LowerAngles.size(), fSumD)); // check if fTestAvrg generates lower SumSqr
-
-    // ----------------------------------------------
-    // average in [0,180); set C: values in range (avrg+180, 360)
-    // ----------------------------------------------
-    double fUpperBound = 360.; // of current sector
-    double fSumC       =   0.; // of elements of set C
-
-    iter = UpperAngles.begin();
-    for (size_t c = 0; c < UpperAngles.size(); ++c)
-    {
-        // 1st  iteration : average in [upperAngles[0]-180, 360                 )
-        // next iterations: average in [upperAngles[i]-180, upperAngles[i-1]-180)
-        // set C          : upperAngles[0..c]  (descendingly sorted)
-
-        fTestAvrg = (fSum - 360.*c)/A.size(); // average for sector, that minimizes SumDiffSqr
-
-        if ((fTestAvrg >= *iter-180.) && (fTestAvrg < fUpperBound-180.))   // if fTestAvrg is within sector
-            TestSum(fTestAvrg, SumSqrC(fTestAvrg, c, fSumC));              // check if fTestAvrg generates lower SumSqr
-
-        fUpperBound  = *iter      ;
-        fSumC       += fUpperBound;
-        ++iter;
-    }
-
-    // last sector : average in [0, upperAngles[lastIdx]-180)
-    fTestAvrg = (fSum - 360.*UpperAngles.size())/A.size(); // average for sector, that minimizes SumDiffSqr
-
-    if ((fTestAvrg >= 0.) && (fTestAvrg < fUpperBound))                    // if fTestAvrg is within sector
-        TestSum(fTestAvrg, SumSqrC(fTestAvrg, UpperAngles.size(), fSumC)); // check if fTestAvrg generates lower SumSqr
-
-    // ----------------------------------------------
-    set<CircVal<T>> MinAvrgCircVals;
-    for (const auto& v : MinAvrgVals)
-        MinAvrgCircVals.emplace(CircVal<UnsignedDegRange>(v)); // convert from [0.360)
-
-    return MinAvrgCircVals;
-}
-
-// ==========================================================================
-// calculate average set of circular values
-// return set of average values
-// T is a circular value type defined with the CircValTypeDef macro
-template<typename T>
-set<CircVal<T>> CircAverage2(vector<CircVal<T>> const& A)
-{
-    const size_t   count         = A.size();
-    double         fSum          = 0.      ; // of all elements of Angles
-    double         fSumSqr       = 0.      ; // of all elements of Angles
-    vector<double> Angles(count)           ; // UnsignedDegRange [0,360), ascendingly sorted
-
-    for (size_t i = 0; i<count; ++i)
-    {
-        Angles[i]  = CircVal<UnsignedDegRange>(A[i]); // convert to [0,360)
-        fSum      +=     Angles[i] ;
-        fSumSqr   += Sqr(Angles[i]);
-    }
-
-    sort(Angles.begin(), Angles.end()); // ascending
-
-    // ----------------------------------------------
-    // calc sum of squares of differences for the initial order
-    double fMinSumSqrDiff = fSumSqr - Sqr(fSum)/count;
-    vector<size_t> MinShiftIdx = {0}; // indices of shift with minimal avrg
-
-    // calc sum for each order, and test if new minimum found
-    for (size_t i = 1; i<count; ++i)
-    {
-        fSumSqr += 720.*Angles[i-1];
-        const double fTestSumDiffSqr = fSumSqr + 360.*360.*i - Sqr(fSum+360.*i)/count;
-
-        if (fTestSumDiffSqr < fMinSumSqrDiff)       // new minimum found?
-        {                                                               
-            MinShiftIdx    = {i};
-            fMinSumSqrDiff = fTestSumDiffSqr;
-        }
-        else if (fTestSumDiffSqr == fMinSumSqrDiff) // same minimum?
-            MinShiftIdx.emplace_back(i);
-    }
-
-    // ----------------------------------------------
-    set<CircVal<T>> MinAvrgCircVals;
-    for (const auto& i : MinShiftIdx)
-        MinAvrgCircVals.emplace(CircVal<UnsignedDegRange>((fSum+360.*i) / count)); // avrg from shift index
-
-    return MinAvrgCircVals;
-}
-
-// ==========================================================================
-// calculate weighted-average set of circular values
-// return set of average values
-// T is a circular value type defined with the CircValTypeDef macro
-template<typename T>
-set<CircVal<T>> WeightedCircAverage(vector<pair<CircVal<T>,double>> const& A) // vector <value,weight>
-{
-    set<CircVal<T>>              MinAvrgVals        ; // results set
-
-    // ----------------------------------------------
-    // all vars: UnsignedDegRange [0,360)
-    double                       fASumW         = 0.; // sum(Wi     ) of all elements of A
-    double                       fASumWA        = 0.; // sum(Wi*Ai  ) of all elements of A
-    double                       fASumWA2       = 0.; // sum(Wi*Ai^2) of all elements of A
-    double                       fMinSumSqrDiff     ; // minimal sum of squares of differences
-    vector<pair<double, double>> LowerAngles        ; // ascending   [  0,180)  <angle,weight>
-    vector<pair<double, double>> UpperAngles        ; // descending  (360,180)  <angle,weight>
-    double                       fTestAvrg          ;
-
-    // ----------------------------------------------
-    // local functions - implemented as lambdas
-    // ----------------------------------------------
-
-    // calc sum(Wi*dist(180, Bi)^2) - all values are in set B
-    // dist(180,Bi)= |180-Bi|
-    // sum(Wi*dist(x, Bi)^2) = sum(Wi*(180-Bi)^2) = sum(Wi*(180^2-2*180*Bi + Bi^2)) = 180^2*fSumW - 360*sum(Wi*Ai) + sum(Wi*Ai^2)
-    auto SumSqr = [&]() -> double
-    {
-        return 32400.*fASumW - 360.*fASumWA + fASumWA2;
-    };
-
-    // calc sum(Wi*dist(x, Ai)^2). A=B+C; set D is empty
-    // dist(x,Bi)= |x-Bi|
-    // dist(x,Ci)= 360-(Ci-x)
-    // sum(Wi*dist(x,Bi)^2)= sum(Wi*(     (x-Bi) ^2))= sum(Wi*(        Bi^2 + x^2                      - 2*Bi*x)) +
-    // sum(Wi*dist(x,Ci)^2)= sum(Wi*((360-(Ci-x))^2))= sum(Wi*(360^2 + Ci^2 + x^2 - 2*360*Ci + 2*360*x - 2*Ci*x))
-    //                                                 ==========================================================
-    //                                                 sum(Wi*(        Ai^2 + x^2                      - 2*Ai*x))
-    auto SumSqrC = [&](double x      ,
-                       double fCSumW ,            // sum(Wi   ) of all elements of C
-                       double fCSumWC ) -> double // sum(Wi*Ci) of all elements of C
-    {
-        return fASumWA2 + x*x*fASumW -2*x*fASumWA - 720*fCSumWC + (129600+720*x)*fCSumW;
-    };
-
-    // calc sum(Wi*dist(x, Ai)^2). A=B+D; set C is empty
-    // dist(x,Bi)= |x-Bi|
-    // dist(x,Di)= 360-(x-Di)
-    // sum(Wi*dist(x,Bi)^2)= sum(Wi*(     (x-Bi) ^2))= sum(Wi*(        Bi^2 + x^2                      - 2*Bi*x))
-    // sum(Wi*dist(x,Di)^2)= sum(Wi*((360-(x-Di))^2))= sum(Wi*(360^2 + Di^2 + x^2 + 2*360*Di - 2*360*x - 2*Di*x))
-    //                                                 ==========================================================
-    //                                                 sum(Wi*(        Ai^2 + x^2                      - 2*Ai*x))
-    auto SumSqrD = [&](double x      ,
-                       double fDSumW ,            // sum(Wi   ) of all elements of D
-                       double fDSumWD ) -> double // sum(Wi*Di) of all elements of D
-    {
-        return fASumWA2 + x*x*fASumW -2*x*fASumWA + 720*fDSumWD + (129600-720*x)*fDSumW;
-    };
-
-    // update MinAvrgAngles if lower/equal fMinSumSqrDiff found
-    auto TestSum = [&](double fTestAvrg, double fTestSumDiffSqr) -> void
-    {
-        if (fTestSumDiffSqr < fMinSumSqrDiff)
-        {
-            MinAvrgVals.clear();
-            MinAvrgVals.emplace(CircVal<UnsignedDegRange>(fTestAvrg));
-            fMinSumSqrDiff= fTestSumDiffSqr;
-        }
-        else if (fTestSumDiffSqr == fMinSumSqrDiff)
-            MinAvrgVals.emplace(CircVal<UnsignedDegRange>(fTestAvrg));
-    };
-
-    // ----------------------------------------------
-    for (const auto& a : A)
-    {
-        double v  = CircVal<UnsignedDegRange>(a.first); // convert to [0.360)
-        double w  = a.second;                           // weight
-        fASumW   += w    ;
-        fASumWA  += w*v  ;
-        fASumWA2  = w*v*v;
-
-             if (v < 180.) LowerAngles.emplace_back(pair<double,double>(v,w));
-        else if (v > 180.) UpperAngles.emplace_back(pair<double,double>(v,w));
-    }
-
-    sort(LowerAngles.begin(), LowerAngles.end()                                ); // ascending   [  0,180)
-    sort(UpperAngles.begin(), UpperAngles.end(), greater<pair<double,double>>()); // descending  (360,180)
-
-    // ----------------------------------------------
-    // start with avrg= 180, sets c,d are empty
-    // ----------------------------------------------
-    MinAvrgVals.clear();
-    MinAvrgVals.emplace(CircVal<UnsignedDegRange>(180.));
-    fMinSumSqrDiff = SumSqr();
-
-    // ----------------------------------------------
-    // average in (180,360), set D: values in range [0,avrg-180)
-    // ----------------------------------------------
-    double fLowerBound = 0.; // of current sector
-    double fDSumW      = 0.; // sum(Wi   ) of all elements of D
-    double fDSumWD     = 0.; // sum(Wi*Di) of all elements of D
-
-    auto iter = LowerAngles.begin();
-    for (size_t d = 0; d < LowerAngles.size(); ++d)
-    {
-        // 1st  iteration : average in (                 180, lowerAngles[0]+180]
-        // next iterations: average in (lowerAngles[i-1]+180, lowerAngles[i]+180]
-        // set D          : lowerAngles[0..d]
-
-        fTestAvrg = (fASumWA + 360.*fDSumW)/fASumW; // average for sector, that minimizes SumDiffSqr
-
-        if ((fTestAvrg > fLowerBound+180.) && (fTestAvrg <= (*iter).first+180.)) // if fTestAvrg is within sector
-            TestSum(fTestAvrg, SumSqrD(fTestAvrg, fDSumW, fDSumWD));             // check if fTestAvrg generates lower SumSqr
-
-        fLowerBound  = (*iter).first                 ;
-        fDSumW      += (*iter).second                ;
-        fDSumWD     += (*iter).second * (*iter).first;
-        ++iter;
-    }
-
-    // last sector : average in [lowerAngles[lastIdx]+180, 360)
-    fTestAvrg = (fASumWA + 360.*fDSumW)/fASumW; // average for sector, that minimizes SumDiffSqr
-
-    if ((fTestAvrg < 360.) && (fTestAvrg > fLowerBound))                         // if fTestAvrg is within sector
-        TestSum(fTestAvrg, SumSqrD(fTestAvrg, fDSumW, fDSumWD));                 // check if fTestAvrg generates lower SumSqr
-
-    // ----------------------------------------------
-    // average in [0,180); set C: values in range (avrg+180, 360)
-    // ----------------------------------------------
-    double fUpperBound = 360.; // of current sector
-    double fCSumW      =   0.; // sum(Wi   ) of all elements of C
-    double fCSumWC     =   0.; // sum(Wi*Ci) of all elements of C
-
-    iter = UpperAngles.begin();
-    for (size_t c = 0; c < UpperAngles.size(); ++c)
-    {
-        // 1st  iteration : average in [upperAngles[0]-180, 360                 )
-        // next iterations: average in [upperAngles[i]-180, upperAngles[i-1]-180)
-        // set C          : upperAngles[0..c]  (descendingly sorted)
-
-        fTestAvrg = (fASumWA - 360.*fCSumW)/fASumW; // average for sector, that minimizes SumDiffSqr
-
-        if ((fTestAvrg >= (*iter).first-180.) && (fTestAvrg < fUpperBound-180.)) // if fTestAvrg is within sector
-            TestSum(fTestAvrg, SumSqrC(fTestAvrg, fCSumW, fCSumWC));             // check if fTestAvrg generates lower SumSqr
-
-        fUpperBound  = (*iter).first                 ;
-        fCSumW      += (*iter).second                ;
-        fCSumWC     += (*iter).second * (*iter).first;
-        ++iter;
-    }
-
-    // last sector : average in [0, upperAngles[lastIdx]-180)
-    fTestAvrg = (fASumWA - 360.*fCSumW)/fASumW; // average for sector, that minimizes SumDiffSqr
-
-    if ((fTestAvrg >= 0.) && (fTestAvrg < fUpperBound))                          // if fTestAvrg is within sector
-        TestSum(fTestAvrg, SumSqrC(fTestAvrg, fCSumW, fCSumWC));                 // check if fTestAvrg generates lower SumSqr
-
-    // ----------------------------------------------
-    return MinAvrgVals;
-}
-
-// ==========================================================================
-// estimate the average of a sampled continuous-time circular signal, using circular linear interpolation
-// T is a circular value type defined with the CircValTypeDef macro
-template<typename T>
-class CAvrgSampledCircSignal
-{
-    size_t                           m_nSamples ;
-    CircVal<T>                       m_PrevC    ; // previous value
-    double                           m_fPrevTime; // previous time
-    vector<pair<CircVal<T>, double>> m_Intervals; // vector of (avrg,weight) for each interval
-
-public:
-    CAvrgSampledCircSignal()
-    {
-        m_nSamples = 0;
-    }
-
-    void AddMeasurement(CircVal<T> C, double fTime)
-    {
-        if (m_nSamples)
-        {
-            assert(fTime > m_fPrevTime);
-
-            double fIntervalAvrg   = CircVal<T>::Wrap((double)m_PrevC + CircVal<T>::Sdist(m_PrevC, C) / 2.);
-            double fIntervalWeight = fTime - m_fPrevTime                                                   ;
-            m_Intervals.emplace_back(fIntervalAvrg, fIntervalWeight);
-        }
-
-        m_PrevC     = C    ;
-        m_fPrevTime = fTime;
-        ++m_nSamples;
-    }
-
-    // calculate the weighted average for all intervals
-    bool GetAvrg(CircVal<T>& Avrg)
-    {
-        switch (m_nSamples)
-        {
-        case 0:
-            Avrg = CircVal<T>::GetZ();
-            return false;
-
-        case 1:
-            Avrg = m_PrevC;
-            return true;
-
-        default:
-            Avrg = *WeightedCircAverage(m_Intervals).begin();
-            return true;
-        }
-    }
-};
-
-// ==========================================================================
-// calculate median set of circular values
-// return set of median values
-// T is a circular value type defined with the CircValTypeDef macro
-template<typename T>
-set<CircVal<T>> CircMedian(vector<CircVal<T>> const& A)
-{
-    set <CircVal<T>> X;           // results set
-
-    // ----------------------------------------------
-    set<CircVal<T>> B;
-    if (A.size() % 2 == 0)        // even number of values
-    {
-        auto S = A;
-        sort(S.begin(), S.end()); // A, sorted
-
-        for (size_t m = 0; m < S.size(); ++m)
-        {
-            size_t n = m+1; if (n == S.size()) n = 0;
-            double d = CircVal<T>::Sdist(S[m], S[n]);
-
-            // insert average set of each two circular-consecutive values
-            B.emplace((double)S[m] + d / 2.);
-            if (d == -CircVal<T>::GetR() / 2.)
-                B.emplace((double)S[n] + d / 2.);
-        }
-    }
-    else                          // odd number of values
-        for (size_t m = 0; m < A.size(); ++m)
-            B.emplace(A[m]);      // convert vector to set - remove duplicates
-
-    // ----------------------------------------------
-    double fMinSum = numeric_limits<double>::max();
-
-    for (const auto& b : B)
-    {
-        double fSum = 0.;         // sum(|Sdist(a, b)|)
-        for (const auto& a : A)
-            fSum += abs(CircVal<T>::Sdist(b, a));
-
-             if (fSum == fMinSum)              X.emplace(b);
-        else if (fSum <  fMinSum) { X.clear(); X.emplace(b); fMinSum = fSum; }
-    }
-
-    // ----------------------------------------------
-    return X;
-}
+// ==========================================================================
+// Copyright (C) 2011 Lior Kogan (koganlior1@gmail.com)
+// ==========================================================================
+// classes defined here:
+// CircStatWorkspace      - reusable scratch buffers for the CircStat functions
+// CircAverage            - calculate average set of circular values
+// CircAverageAccumulator - incremental calculation of the average set of circular values
+// WeightedCircAverage    - calculate weighted-average set of circular values
+// CircAverageSummary     - mergeable, serializable partial result of CircAverage (WeightedCircAverageSummary: of WeightedCircAverage)
+// CAvrgSampledCircSignal - estimate the average of a sampled continuous-time circular signal, using circular linear interpolation
+// CircMedian             - calculate median set of circular values
+// WeightedCircMedian     - calculate weighted-median set of circular values
+// CMedianSampledCircSignal - weighted median of the samples of a sliding window of a sampled circular signal
+// CircHistogram          - approximate (single pass) and exact (two passes) statistics of huge streams, in O(bins) memory
+// CircStatTester         - tester for CircStat functions
+// CircHistogramTester    - tester for CircHistogram
+// CircAverageSummaryTester - tester for CircAverageSummary, WeightedCircAverageSummary
+// CircInstrumentTester   - tester for the instrumentation of the CircStat functions (CircInstrument.h)
+// ==========================================================================
+
+// DRNadler 14-Oct-2026: Add WeightedCircMedian and CMedianSampledCircSignal.
+
+// DRNadler 14-Oct-2026: The sweeps run in the units of T, with no UnsignedDegRange round-trip (CircSweepConst).
+
+// DRNadler 14-Oct-2026: Convert the values by CircConvert.
+
+// DRNadler 14-Oct-2026: Optional instrumentation of the hot paths (CircInstrument.h).
+
+// DRNadler 14-Oct-2026: CAvrgSampledCircSignal: sin and cos of the interval averages by sincos.
+
+// DRNadler 14-Oct-2026: Add CircAverageSummary, WeightedCircAverageSummary.
+
+// DRNadler 14-Oct-2026: Add CircHistogram.
+
+// DRNadler 14-Oct-2026: Accept circular values of any storage type; the statistics are computed in double.
+
+// DRNadler 14-Oct-2026: Sort by RadixSort for large inputs (SortValues, SortWeighted).
+
+// DRNadler 14-Oct-2026: Add the Window and Running modes of CAvrgSampledCircSignal.
+
+// DRNadler 14-Oct-2026: Add WeightedCircAverage over separate value and weight spans.
+
+// DRNadler 14-Oct-2026: Accept CircValFixed values (the CircValue concept).
+
+// DRNadler 14-Oct-2026: Add CircAverage2 overloads taking an execution policy.
+
+// DRNadler 14-Oct-2026: Add CircStatWorkspace, and overloads over spans that write to an output iterator - no
+// allocations once the workspace has grown.
+
+// DRNadler 14-Oct-2026: Add CircAverageAccumulator.
+
+// DRNadler 14-Oct-2026: Sweep-based CircMedian: O(n log n).
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>      // uint64_t
+#include <assert.h>
+#include <set>
+#include <deque>
+#include <vector>
+#include <algorithm>    // sort
+#include <numeric>      // reduce
+#include <execution>    // execution policies
+#include <iterator>     // make_reverse_iterator, inserter
+#include <span>
+#include <bit>          // bit_cast
+#include <stdexcept>    // invalid_argument
+#include <random>       // CircAverageAccumulator, CircStatTester
+
+#include "CircHelper.h"   // Sqr, SortValues, RadixSort, AddCompensated, ExactSum128
+#include "CircInstrument.h" // CIRC_PHASE_START, CIRC_COUNT
+#include "CircVal.h"      // CircVal, CircConvert
+#include "CircValFixed.h" // CircValFixed - CircStatTester
+
+using namespace std;
+
+// the functions accept circular values of any storage type - CircVal<T, float>, CircVal<T, long double>, CircValFixed.
+// the statistics are computed in double: float values are accumulated without loss, long double values are rounded
+// to double. the overloads that return a set return values of the storage type of their input
+
+// ==========================================================================
+// reusable scratch buffers for the CircStat functions
+// the overloads that take a workspace allocate nothing once the buffers have grown to the input size.
+// a workspace may be reused for any function and any circular-value type, but not concurrently.
+struct CircStatWorkspace
+{
+    vector<double>               Angles      ; // converted / sorted values
+    vector<double>               LowerAngles ; // CircAverage        : ascending   [L,M)
+    vector<double>               UpperAngles ; // CircAverage        : descending  (H,M)
+    vector<pair<double, double>> LowerWAngles; // WeightedCircAverage: ascending   [L,M)  <angle,weight>
+    vector<pair<double, double>> UpperWAngles; // WeightedCircAverage: descending  (H,M)  <angle,weight>
+    vector<double>               Candidates  ; // CircMedian, WeightedCircMedian: candidate medians
+    vector<double>               PrefixSums  ; // CircMedian         : prefix sums of sorted values       CircAverage2 (parallel): sum of squares for each shift
+    vector<double>               SweepSums   ; // CircMedian         : swept sum for each candidate       CircAverage2 (parallel): sum of squares of differences for each shift
+    vector<size_t>               MinShiftIdx ; // CircAverage2       : indices of shift with minimal avrg
+    vector<double>               SortedVals  ; // WeightedCircAverage, WeightedCircMedian: sorted values
+    vector<double>               SortedWghts ; // WeightedCircAverage, WeightedCircMedian: weights, in the same order
+    vector<double>               RadixTmpK   ; // RadixSort scratch - keys
+    vector<double>               RadixTmpV   ; // RadixSort scratch - payloads
+    vector<double>               PrefixSums2 ; // WeightedCircAverage (spans), WeightedCircMedian: prefix sums of Wi*Ai (PrefixSums: of Wi, WeightedCircAverage SweepSums: sum of each sector)
+    vector<double>               PrefixComps ; // CircMedian, WeightedCircMedian: compensations of PrefixSums
+    vector<double>               PrefixComps2; // WeightedCircMedian: compensations of PrefixSums2
+    vector<double>               Results     ; // results set, before conversion
+};
+
+// ==========================================================================
+// write a results set: sort, remove duplicates and copy to Out as circular values
+// Vals are values in the range of T
+template<typename T, typename OutIter>
+OutIter CopyResultSet(vector<double>& Vals, OutIter Out)
+{
+    sort(Vals.begin(), Vals.end());
+    Vals.erase(unique(Vals.begin(), Vals.end()), Vals.end());
+
+    for (const auto& v : Vals)
+        *Out++ = CircVal<T>(v);
+
+    return Out;
+}
+
+// ==========================================================================
+// sort values in increasing order, with their weights as payloads; weights of equal values in increasing order -
+// the same order as sorting <value,weight> pairs. RadixSort of the values, then std::sort of the weights of each run
+// of equal values
+inline void SortWeighted(span<double> K, span<double> P, CircStatWorkspace& W)
+{
+    RadixSort(K, P, W.RadixTmpK, W.RadixTmpV);
+
+    for (size_t i = 0, j; i < K.size(); i = j)
+    {
+        for (j = i + 1; j < K.size() && K[j] == K[i]; ++j);
+        if (j - i > 1)
+            sort(P.begin() + i, P.begin() + j);
+    }
+}
+
+// sort <value,weight> pairs in increasing order: std::sort for small inputs, SortWeighted otherwise
+inline void SortWeighted(vector<pair<double, double>>& A, CircStatWorkspace& W)
+{
+    if (A.size() < RadixSortMinSize)
+    {
+        sort(A.begin(), A.end());
+        return;
+    }
+
+    vector<double>& K = W.SortedVals ;
+    vector<double>& P = W.SortedWghts;
+    K.resize(A.size());
+    P.resize(A.size());
+    for (size_t i = 0; i < A.size(); ++i)
+    {
+        K[i] = A[i].first ;
+        P[i] = A[i].second;
+    }
+
+    SortWeighted(span<double>(K), span<double>(P), W);
+
+    for (size_t i = 0; i < A.size(); ++i)
+        A[i] = { K[i], P[i] };
+}
+
+// ==========================================================================
+// range constants of the sector sweeps, in the units of T - the sweeps run in the range of T itself, with no
+// conversion of the values. the sweeps are described in terms of L, M = L+R/2 and H - e.g. 0, 180 and 360 for
+// UnsignedDegRange
+template<typename T>
+struct CircSweepConst
+{
+    static constexpr double L   = T::L          ; // lower bound of the range
+    static constexpr double H   = T::H          ; // upper bound of the range
+    static constexpr double R   = T::R          ; // range
+    static constexpr double R_2 = T::R_2        ; // half range
+    static constexpr double M   = T::L + T::R_2 ; // middle of the range - first candidate average
+    static constexpr double R2  = T::R * T::R   ; // R^2
+};
+
+// ==========================================================================
+// the sums of CircAverage as fixed-point integers: exact, so they depend only on the values - not on their order,
+// nor on values added and removed since (CircAverageAccumulator). the sweep, the accumulator and CircAverage get
+// bit-identical sums of the same values.
+// a value of T is |v| < 2^E: it is truncated to a multiple of 2^(E-62), its square to a multiple of 2^(2E-62) -
+// 9 bits finer than the ulp of the largest values of the range
+template<typename T>
+struct CircFixedSums
+{
+    static constexpr int E = []
+    {
+        const double fMax = __max(T::L < 0 ? -T::L : T::L, T::H < 0 ? -T::H : T::H);
+        int e = 0;
+        for (double p = 1.; p <= fMax; p *= 2)
+            ++e;
+        return e;
+    }();
+
+    static constexpr double Pow2(int e) { return e < 0 ? 1. / Pow2(-e) : e == 0 ? 1. : 2. * Pow2(e - 1); }
+
+    static constexpr double S1 = Pow2(62 -     E); // scale of the values
+    static constexpr double S2 = Pow2(62 - 2 * E); // scale of the squares
+
+    static int64_t Val   (double v) { return static_cast<int64_t>(    v  * S1); } // truncated: inline
+    static int64_t ValSqr(double v) { return static_cast<int64_t>(Sqr(v) * S2); }
+
+    static double  Sum   (const ExactSum128& s) { return s.ToDouble() / S1; } // sum of values
+    static double  SumSqr(const ExactSum128& s) { return s.ToDouble() / S2; } // sum of squares
+};
+
+// ==========================================================================
+// the candidate averages of the sectors of CircAverage and their sums of squared distances - shared by the sector
+// sweep (CircAverageSweep) and the sector search of CircAverageAccumulator, so both calculate bit-identical results
+// from bit-identical sums
+// all values: the range of T [L,H), M = L+R/2 - see CircSweepConst
+// count              - number of values (including values equal to M)
+// fSum, fSumSqr      - sum and sum of squares of all values
+// MinAvrgVals        - returns set of average values in [L,H)
+template<typename T>
+struct CircAverageSectors
+{
+    using K = CircSweepConst<T>;
+
+    size_t          count         ;
+    double          fSum          ;
+    double          fSumSqr       ;
+    vector<double>& MinAvrgVals   ;
+    double          fMinSumSqrDiff; // minimal sum of squares of differences
+
+    // start with avrg= M, sets c,d are empty
+    CircAverageSectors(size_t count, double fSum, double fSumSqr, vector<double>& MinAvrgVals)
+        : count(count), fSum(fSum), fSumSqr(fSumSqr), MinAvrgVals(MinAvrgVals)
+    {
+        MinAvrgVals.clear();
+        MinAvrgVals.emplace_back(K::M);
+        fMinSumSqrDiff = SumSqr();
+    }
+
+    // average for sector with d values in set D / c values in set C, that minimizes SumDiffSqr
+    double AvrgD(size_t d) const { return (fSum + K::R*d)/count; }
+    double AvrgC(size_t c) const { return (fSum - K::R*c)/count; }
+
+    // calc sum(dist(M, Bi)^2) - all values are in set B
+    // dist(M,Bi)= |M-Bi|
+    // sum(dist(x, Bi)^2) = sum((M-Bi)^2) = sum(M^2-2*M*Bi + Bi^2) = M^2*count - 2*M*sum(Ai) + sum(Ai^2)
+    double SumSqr() const
+    {
+        return K::M*K::M*count - 2*K::M*fSum + fSumSqr;
+    }
+
+    // calc sum(dist(x, Ai)^2). A=B+C; set D is empty
+    // dist(x,Bi)= |x-Bi|
+    // dist(x,Ci)= R-(Ci-x)
+    // sum(dist(x, Bi)^2)= sum(     (x-Bi) ^2)= sum(        Bi^2 + x^2                      - 2*Bi*x)
+    // sum(dist(x, Ci)^2)= sum((R-(Ci-x))^2)= sum(R^2 + Ci^2 + x^2 - 2*R*Ci + 2*R*x - 2*Ci*x)
+    // sum(dist(x, Bi)^2) + sum(dist(x, Ci)^2) = nCountC*R^2 + sum(Ai^2) + nCountA*x^2 - 2*R*sum(Ci) + nCountC*2*R*x - 2*x*sum(Ai)
+    double SumSqrC(double x, size_t nCountC, double fSumC) const
+    {
+        return x*(count*x - 2*fSum) + fSumSqr - 2*K::R*fSumC + nCountC*( 2*K::R*x + K::R2);
+    }
+
+    // calc sum(dist(x, Ai)^2). A=B+D; set C is empty
+    // dist(x,Bi)= |x-Bi|
+    // dist(x,Di)= R-(x-Di)
+    // sum(dist(x,Bi)^2)= sum(    (x-Bi)^2)= sum(        Bi^2 + x^2                      - 2*Bi*x)
+    // sum(dist(x,Di)^2)= sum(R-(x-Di)^2)= sum(R^2 + Di^2 + x^2 + 2*R*Di - 2*R*x - 2*Di*x)
+    // sum(dist(x, Bi)^2) + sum(dist(x, Di)^2) = nCountD*R^2 + sum(Ai^2) + nCountA*x^2 + 2*R*sum(Di) - nCountD*2*R*x - 2*x*sum(Ai)
+    double SumSqrD(double x, size_t nCountD, double fSumD) const
+    {
+        return x * (count*x - 2*fSum) + fSumSqr + 2*K::R*fSumD + nCountD*(-2*K::R*x + K::R2);
+    }
+
+    // update MinAvrgAngles if lower/equal fMinSumSqrDiff found
+    void TestSum(double fTestAvrg, double fTestSumDiffSqr)
+    {
+        if (fTestSumDiffSqr < fMinSumSqrDiff)
+        {
+            MinAvrgVals.clear();
+            MinAvrgVals.emplace_back(fTestAvrg);
+            fMinSumSqrDiff = fTestSumDiffSqr;
+        }
+        else if (fTestSumDiffSqr == fMinSumSqrDiff)
+        {
+            CIRC_COUNT(CircSite::CircAverage, Ties, 1);
+            MinAvrgVals.emplace_back(fTestAvrg);
+        }
+    }
+};
+
+// ==========================================================================
+// the sector sweep of CircAverage
+// all values: the range of T [L,H), M = L+R/2 - see CircSweepConst
+// count              - number of values (including values equal to M)
+// fSum, fSumSqr      - sum and sum of squares of all values
+// [LowerB, LowerE)   - values in [L,M), ascending
+// [UpperB, UpperE)   - values in (H,M), descending
+// MinAvrgVals        - returns set of average values in [L,H)
+// the sums of the sectors are exact (CircFixedSums): the results of CircAverage and CircAverageAccumulator are identical
+template<typename T, typename LowerIter, typename UpperIter>
+void CircAverageSweep(size_t count, double fSum, double fSumSqr,
+                      LowerIter LowerB, LowerIter LowerE,
+                      UpperIter UpperB, UpperIter UpperE,
+                      vector<double>& MinAvrgVals)
+{
+    using K     = CircSweepConst<T>;
+    using Fixed = CircFixedSums <T>;
+
+    double          fTestAvrg          ;
+
+    // ----------------------------------------------
+    // start with avrg= M, sets c,d are empty
+    // ----------------------------------------------
+    CircAverageSectors<T> S(count, fSum, fSumSqr, MinAvrgVals);
+
+    // ----------------------------------------------
+    // average in (M,H), set D: values in range [L,avrg-R/2)
+    // ----------------------------------------------
+    double      fLowerBound = K::L; // of current sector
+    ExactSum128 SumD              ; // of elements of set D
+
+    size_t d = 0;
+    for (auto iter = LowerB; iter != LowerE; ++iter, ++d)
+    {
+        // 1st  iteration : average in (                   M, lowerAngles[0]+R/2]
+        // next iterations: average in (lowerAngles[i-1]+R/2, lowerAngles[i]+R/2]
+        // set D          : lowerAngles[0..d]
+
+        fTestAvrg = S.AvrgD(d); // average for sector, that minimizes SumDiffSqr
+
+        if ((fTestAvrg > fLowerBound+K::R_2) && (fTestAvrg <= *iter+K::R_2))        // if fTestAvrg is within sector
+            S.TestSum(fTestAvrg, S.SumSqrD(fTestAvrg, d, Fixed::Sum(SumD)));         // check if fTestAvrg generates lower SumSqr
+
+        fLowerBound = *iter;
+        SumD.Add(Fixed::Val(fLowerBound));
+    }
+
+    // last sector : average in [lowerAngles[lastIdx]+R/2, H)
+    fTestAvrg = S.AvrgD(d); // average for sector, that minimizes SumDiffSqr
+
+    if ((fTestAvrg < K::H) && (fTestAvrg > fLowerBound))                           // if fTestAvrg is within sector
+        S.TestSum(fTestAvrg, S.SumSqrD(fTestAvrg, d, Fixed::Sum(SumD)));             // check if fTestAvrg generates lower SumSqr
+
+    // ----------------------------------------------
+    // average in [L,M); set C: values in range (avrg+R/2, H)
+    // ----------------------------------------------
+    double      fUpperBound = K::H; // of current sector
+    ExactSum128 SumC              ; // of elements of set C
+
+    size_t c = 0;
+    for (auto iter = UpperB; iter != UpperE; ++iter, ++c)
+    {
+        // 1st  iteration : average in [upperAngles[0]-R/2, H                   )
+        // next iterations: average in [upperAngles[i]-R/2, upperAngles[i-1]-R/2)
+        // set C          : upperAngles[0..c]  (descendingly sorted)
+
+        fTestAvrg = S.AvrgC(c); // average for sector, that minimizes SumDiffSqr
+
+        if ((fTestAvrg >= *iter-K::R_2) && (fTestAvrg < fUpperBound-K::R_2))        // if fTestAvrg is within sector
+            S.TestSum(fTestAvrg, S.SumSqrC(fTestAvrg, c, Fixed::Sum(SumC)));         // check if fTestAvrg generates lower SumSqr
+
+        fUpperBound = *iter;
+        SumC.Add(Fixed::Val(fUpperBound));
+    }
+
+    // last sector : average in [L, upperAngles[lastIdx]-R/2)
+    fTestAvrg = S.AvrgC(c); // average for sector, that minimizes SumDiffSqr
+
+    if ((fTestAvrg >= K::L) && (fTestAvrg < fUpperBound))                          // if fTestAvrg is within sector
+        S.TestSum(fTestAvrg, S.SumSqrC(fTestAvrg, c, Fixed::Sum(SumC)));             // check if fTestAvrg generates lower SumSqr
+}
+
+// ==========================================================================
+// calculate average set of circular values
+// write set of average values (ascending, no duplicates) to Out. return Out past the last written value
+// T is a circular value type defined with the CircValTypeDef macro
+// C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+template<CircValue C, typename OutIter, typename T = typename C::CircType>
+OutIter CircAverage(span<const C> A, CircStatWorkspace& W, OutIter Out)
+{
+    // ----------------------------------------------
+    // all vars: the range of T [L,H) - see CircSweepConst
+    constexpr double M = CircSweepConst<T>::M;
+    using Fixed        = CircFixedSums<T>;
+
+    ExactSum128     Sum                           ; // of all elements of A
+    ExactSum128     SumSqr                        ; // of all elements of A
+    vector<double>& LowerAngles    = W.LowerAngles; // ascending   [L,M)
+    vector<double>& UpperAngles    = W.UpperAngles; // descending  (H,M)
+
+    CIRC_PHASE_START(CircSite::CircAverage, Convert);
+    CIRC_COUNT(CircSite::CircAverage, Elements, A.size());
+
+    LowerAngles.clear();
+    UpperAngles.clear();
+
+    // ----------------------------------------------
+    for (const auto& a : A)
+    {
+        const double v = CircVal<T>(a);
+        Sum   .Add(Fixed::Val   (v));
+        SumSqr.Add(Fixed::ValSqr(v));
+             if (v < M) LowerAngles.emplace_back(v);
+        else if (v > M) UpperAngles.emplace_back(v);
+    }
+
+    CIRC_PHASE_NEXT(Sort);
+    SortValues(LowerAngles, W.RadixTmpK);                             // ascending   [L,M)
+    SortValues(UpperAngles, W.RadixTmpK);
+    reverse(UpperAngles.begin(), UpperAngles.end());                  // descending  (H,M)
+
+    CIRC_PHASE_NEXT(Sweep);
+    CircAverageSweep<T>(A.size(), Fixed::Sum(Sum), Fixed::SumSqr(SumSqr),
+                        LowerAngles.begin(), LowerAngles.end(),
+                        UpperAngles.begin(), UpperAngles.end(),
+                        W.Results);
+
+    // ----------------------------------------------
+    CIRC_PHASE_NEXT(Result);
+    return CopyResultSet<T>(W.Results, Out);
+}
+
+// calculate average set of circular values
+// return set of average values
+// T is a circular value type defined with the CircValTypeDef macro
+// C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+template<CircValue C, typename T = typename C::CircType>
+set<CircVal<T, CircValueStorage_t<C>>> CircAverage(vector<C> const& A)
+{
+    CircStatWorkspace                      W;
+    set<CircVal<T, CircValueStorage_t<C>>> MinAvrgCircVals;
+    CircAverage(span<const C>(A), W, inserter(MinAvrgCircVals, MinAvrgCircVals.end()));
+    return MinAvrgCircVals;
+}
+
+// ==========================================================================
+// incremental calculation of the average set of circular values
+// keeps the values in an order-statistics tree (a treap), with the number and the exact sum (CircFixedSums) of the
+// values of each subtree - so Add, Remove, the rank of a value and the sum of the k lowest values are O(log n).
+// GetAvrg doesn't sweep all sectors: the candidate average of sector d (d values in set D) is within its sector iff
+// exactly d values are below the candidate less R/2 - a fixed point of a nondecreasing function of d. the fixed
+// points within a range of sectors are within the image of its ends, so GetAvrg bisects the ranges of sectors that
+// intersect their image, and skips all others. O(log^2 n) when the values are concentrated; at worst - values evenly
+// spread around the circle, each sector a local minimum - O(n log n).
+// the sums and the calculations of each sector are those of CircAverage (CircAverageSectors): the result set is
+// identical to CircAverage of the same values, whatever the order of additions and removals.
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T>
+class CircAverageAccumulator
+{
+    using K     = CircSweepConst<T>;
+    using Fixed = CircFixedSums <T>;
+
+    // all vars: the range of T [L,H)
+    struct Node
+    {
+        double      v   ; // value
+        int64_t     m   ; // Fixed::Val(v)
+        uint32_t    l, r; // subtrees of lower / higher-or-equal values. 0: empty
+        uint32_t    prio; // heap priority - random
+        size_t      n   ; // number of values in subtree
+        ExactSum128 s   ; // sum of m of subtree
+    };
+
+    vector<Node>     m_Nodes ; // [0]: empty subtree
+    vector<uint32_t> m_Free  ; // indices of removed nodes
+    uint32_t         m_Root  ;
+    ExactSum128      m_SumSqr; // of Fixed::ValSqr of all values
+    minstd_rand      m_Rand  ; // priorities
+
+    void Update(uint32_t t)
+    {
+        Node& x = m_Nodes[t];
+        x.n = m_Nodes[x.l].n + 1 + m_Nodes[x.r].n;
+        x.s = m_Nodes[x.l].s;
+        x.s.Add(x.m);
+        x.s.Add(m_Nodes[x.r].s);
+    }
+
+    uint32_t Merge(uint32_t a, uint32_t b) // all values of a <= all values of b
+    {
+        if (!a || !b)
+            return a | b;
+
+        if (m_Nodes[a].prio > m_Nodes[b].prio)
+        {
+            m_Nodes[a].r = Merge(m_Nodes[a].r, b);
+            Update(a);
+            return a;
+        }
+
+        m_Nodes[b].l = Merge(a, m_Nodes[b].l);
+        Update(b);
+        return b;
+    }
+
+    void Split(uint32_t t, double v, uint32_t& a, uint32_t& b) // a: values < v, b: values >= v
+    {
+        if (!t)
+        {
+            a = b = 0;
+            return;
+        }
+
+        if (m_Nodes[t].v < v) { Split(m_Nodes[t].r, v, m_Nodes[t].r, b); a = t; }
+        else                  { Split(m_Nodes[t].l, v, a, m_Nodes[t].l); b = t; }
+        Update(t);
+    }
+
+    uint32_t PopFirst(uint32_t& t) // detach the node of the lowest value of t (not empty)
+    {
+        uint32_t f;
+        if (!m_Nodes[t].l)
+        {
+            f = t;
+            t = m_Nodes[t].r;
+        }
+        else
+        {
+            f = PopFirst(m_Nodes[t].l);
+            Update(t);
+        }
+        return f;
+    }
+
+    // number of lowest values for which P is true - P is true for the values below some bound
+    template<typename Pred>
+    size_t CountIf(Pred P) const
+    {
+        size_t k = 0;
+        for (uint32_t t = m_Root; t; )
+        {
+            const Node& x = m_Nodes[t];
+            if (P(x.v)) { k += m_Nodes[x.l].n + 1; t = x.r; }
+            else        {                          t = x.l; }
+        }
+        return k;
+    }
+
+    // exact sum of the k lowest values
+    ExactSum128 SumLowest(size_t k) const
+    {
+        ExactSum128 s;
+        for (uint32_t t = m_Root; k; )
+        {
+            const Node& x = m_Nodes[t];
+            if (k <= m_Nodes[x.l].n)
+                t = x.l;
+            else
+            {
+                s.Add(m_Nodes[x.l].s);
+                s.Add(x.m);
+                k -= m_Nodes[x.l].n + 1;
+                t  = x.r;
+            }
+        }
+        return s;
+    }
+
+    // k-th lowest value (from 0)
+    double Nth(size_t k) const
+    {
+        for (uint32_t t = m_Root; ; )
+        {
+            const Node& x = m_Nodes[t];
+                 if (k <  m_Nodes[x.l].n) t = x.l;
+            else if (k == m_Nodes[x.l].n) return x.v;
+            else                        { k -= m_Nodes[x.l].n + 1; t = x.r; }
+        }
+    }
+
+    // call Report(d) for each d in [a,b] for which F(d) == d. F is nondecreasing; fa= F(a), fb= F(b)
+    // d= F(d) implies F(a) <= d <= F(b): only [max(a,fa), min(b,fb)] may contain fixed points
+    template<typename Func, typename ReportFunc>
+    static void FixedPoints(size_t a, size_t b, size_t fa, size_t fb, Func F, ReportFunc Report)
+    {
+        const size_t lo = __max(a, fa);
+        const size_t hi = __min(b, fb);
+        if (lo > hi)
+            return;
+
+        if (lo != a) { a = lo; fa = F(a); }
+        if (hi != b) { b = hi; fb = F(b); }
+
+        if (a == b)
+        {
+            if (fa == a)
+                Report(a);
+            return;
+        }
+
+        const size_t mid = a + (b - a)/2;
+        FixedPoints(a      , mid, fa        , F(mid), F, Report);
+        FixedPoints(mid + 1, b  , F(mid + 1), fb    , F, Report);
+    }
+
+public:
+    CircAverageAccumulator()
+    {
+        Clear();
+    }
+
+    void Clear()
+    {
+        m_Nodes.assign(1, Node{});
+        m_Free.clear();
+        m_Root   = 0 ;
+        m_SumSqr = {};
+    }
+
+    size_t Size() const
+    {
+        return m_Nodes[m_Root].n;
+    }
+
+    void Add(const CircVal<T>& c)
+    {
+        const double v = c;
+
+        uint32_t t;
+        if (m_Free.empty())
+        {
+            t = static_cast<uint32_t>(m_Nodes.size());
+            m_Nodes.emplace_back();
+        }
+        else
+        {
+            t = m_Free.back();
+            m_Free.pop_back();
+        }
+
+        m_Nodes[t] = { v, Fixed::Val(v), 0, 0, static_cast<uint32_t>(m_Rand()), 1, {} };
+        m_Nodes[t].s.Add(m_Nodes[t].m);
+
+        uint32_t a, b;
+        Split(m_Root, v, a, b);
+        m_Root = Merge(Merge(a, t), b);
+        m_SumSqr.Add(Fixed::ValSqr(v));
+    }
+
+    // remove a single occurrence of c. return false if not found
+    bool Remove(const CircVal<T>& c)
+    {
+        const double v = c;
+
+        uint32_t a, b;
+        Split(m_Root, v, a, b);
+
+        uint32_t t = b;
+        while (t && m_Nodes[t].l)
+            t = m_Nodes[t].l;
+
+        const bool bFound = t && m_Nodes[t].v == v; // lowest value >= v
+        if (bFound)
+        {
+            m_Free.emplace_back(PopFirst(b));
+            m_SumSqr.Add(-Fixed::ValSqr(v));
+        }
+
+        m_Root = Merge(a, b);
+        return bFound;
+    }
+
+    // return set of average values
+    set<CircVal<T>> GetAvrg() const
+    {
+        set<CircVal<T>> MinAvrgCircVals;
+        const size_t    n = Size();
+        if (!n)
+            return MinAvrgCircVals;
+
+        const ExactSum128& Sum = m_Nodes[m_Root].s;
+        const size_t       nL  =     CountIf([](double v) { return v <  K::M; }); // values in [L,M)
+        const size_t       nU  = n - CountIf([](double v) { return v <= K::M; }); // values in (M,H)
+
+        // start with avrg= M, sets c,d are empty
+        vector<double>        MinAvrgVals;
+        CircAverageSectors<T> S(n, Fixed::Sum(Sum), Fixed::SumSqr(m_SumSqr), MinAvrgVals);
+
+        // ----------------------------------------------
+        // average in (M,H), set D: the d lowest values. sector d < nL: (lower[d-1]+R/2, lower[d]+R/2]
+        // within its sector iff F(d) == d - F(d): number of lower values v for which v+R/2 < AvrgD(d)
+        // ----------------------------------------------
+        auto TestD = [&](size_t d)
+        {
+            const double fTestAvrg = S.AvrgD(d);
+            S.TestSum(fTestAvrg, S.SumSqrD(fTestAvrg, d, Fixed::Sum(SumLowest(d))));
+        };
+
+        auto FD = [&](size_t d)
+        {
+            const double fTestAvrg = S.AvrgD(d);
+            return CountIf([=](double v) { return v < K::M && v+K::R_2 < fTestAvrg; });
+        };
+
+        if (nL)
+            FixedPoints(0, nL - 1, FD(0), FD(nL - 1), FD, [&](size_t d) { if (d || S.AvrgD(0) > K::L+K::R_2) TestD(d); });
+
+        // last sector : average in (lower[nL-1], H) - the sweep of CircAverage
+        const double fLowerBound = nL ? Nth(nL - 1) : K::L;
+        if ((S.AvrgD(nL) < K::H) && (S.AvrgD(nL) > fLowerBound))
+            TestD(nL);
+
+        // ----------------------------------------------
+        // average in [L,M), set C: the c highest values. sector c < nU: [upper[c]-R/2, upper[c-1]-R/2)
+        // within its sector iff F(c) == c - F(c): number of upper values v for which v-R/2 > AvrgC(c)
+        // ----------------------------------------------
+        auto TestC = [&](size_t c)
+        {
+            ExactSum128 SumC = Sum;
+            SumC.Sub(SumLowest(n - c));
+
+            const double fTestAvrg = S.AvrgC(c);
+            S.TestSum(fTestAvrg, S.SumSqrC(fTestAvrg, c, Fixed::Sum(SumC)));
+        };
+
+        auto FC = [&](size_t c)
+        {
+            const double fTestAvrg = S.AvrgC(c);
+            return n - CountIf([=](double v) { return !(v > K::M && v-K::R_2 > fTestAvrg); });
+        };
+
+        if (nU)
+            FixedPoints(0, nU - 1, FC(0), FC(nU - 1), FC, [&](size_t c) { if (c || S.AvrgC(0) < K::H-K::R_2) TestC(c); });
+
+        // last sector : average in [L, upper[nU-1]) - the sweep of CircAverage
+        const double fUpperBound = nU ? Nth(n - nU) : K::H;
+        if ((S.AvrgC(nU) >= K::L) && (S.AvrgC(nU) < fUpperBound))
+            TestC(nU);
+
+        for (const auto& v : MinAvrgVals)
+            MinAvrgCircVals.emplace(v);
+
+        return MinAvrgCircVals;
+    }
+};
+
+// ==========================================================================
+// calculate average set of circular values
+// write set of average values (ascending, no duplicates) to Out. return Out past the last written value
+// T is a circular value type defined with the CircValTypeDef macro
+// C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+template<CircValue C, typename OutIter, typename T = typename C::CircType>
+OutIter CircAverage2(span<const C> A, CircStatWorkspace& W, OutIter Out)
+{
+    constexpr double R = T::R;
+
+    const size_t    count         = A.size() ;
+    double          fSum          = 0.       ; // of all elements of Angles
+    double          fSumSqr       = 0.       ; // of all elements of Angles
+    vector<double>& Angles        = W.Angles ; // the range of T [L,H), ascendingly sorted
+
+    CIRC_PHASE_START(CircSite::CircAverage2, Convert);
+    CIRC_COUNT(CircSite::CircAverage2, Elements, count);
+
+    Angles.resize(count);
+    CircConvert<T, T>::Apply(A, span<double>(Angles)); // a copy of CircVal<T> values
+
+    for (const double v : Angles)
+    {
+        fSum    +=     v ;
+        fSumSqr += Sqr(v);
+    }
+
+    CIRC_PHASE_NEXT(Sort);
+    SortValues(Angles, W.RadixTmpK); // ascending
+
+    // ----------------------------------------------
+    // calc sum of squares of differences for the initial order
+    CIRC_PHASE_NEXT(Sweep);
+    CIRC_COUNT(CircSite::CircAverage2, Candidates, count);
+    double          fMinSumSqrDiff = fSumSqr - Sqr(fSum)/count;
+    vector<size_t>& MinShiftIdx    = W.MinShiftIdx; // indices of shift with minimal avrg
+
+    MinShiftIdx.assign(1, 0);
+
+    // calc sum for each order, and test if new minimum found
+    for (size_t i = 1; i<count; ++i)
+    {
+        fSumSqr += 2*R*Angles[i-1];
+        const double fTestSumDiffSqr = fSumSqr + R*R*i - Sqr(fSum+R*i)/count;
+
+        if (fTestSumDiffSqr < fMinSumSqrDiff)       // new minimum found?
+        {                                                               
+            MinShiftIdx.assign(1, i);
+            fMinSumSqrDiff = fTestSumDiffSqr;
+        }
+        else if (fTestSumDiffSqr == fMinSumSqrDiff) // same minimum?
+        {
+            CIRC_COUNT(CircSite::CircAverage2, Ties, 1);
+            MinShiftIdx.emplace_back(i);
+        }
+    }
+
+    // ----------------------------------------------
+    CIRC_PHASE_NEXT(Result);
+    W.Results.clear();
+    for (const auto& i : MinShiftIdx)
+        W.Results.emplace_back(CircVal<T>((fSum+R*i) / count)); // avrg from shift index
+
+    return CopyResultSet<T>(W.Results, Out);
+}
+
+// calculate average set of circular values
+// return set of average values
+// T is a circular value type defined with the CircValTypeDef macro
+// C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+template<CircValue C, typename T = typename C::CircType>
+set<CircVal<T, CircValueStorage_t<C>>> CircAverage2(vector<C> const& A)
+{
+    CircStatWorkspace                      W;
+    set<CircVal<T, CircValueStorage_t<C>>> MinAvrgCircVals;
+    CircAverage2(span<const C>(A), W, inserter(MinAvrgCircVals, MinAvrgCircVals.end()));
+    return MinAvrgCircVals;
+}
+
+// ==========================================================================
+// calculate average set of circular values - using an execution policy (e.g. std::execution::par)
+// write set of average values (ascending, no duplicates) to Out. return Out past the last written value
+// the sort, the sum of squares of differences for each shift and the minimum search run under the policy.
+// the conversion (a CircConvert copy), the sums and the sum of squares for each shift run sequentially, the sums in the
+// same order as the serial version, since a re-associated (parallel) scan would round differently and could change the
+// set of ties.
+// the result set is identical to the serial version.
+// T is a circular value type defined with the CircValTypeDef macro
+// C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+template<typename ExecutionPolicy, CircValue C, typename OutIter, typename T = typename C::CircType>
+    requires is_execution_policy_v<remove_cvref_t<ExecutionPolicy>>
+OutIter CircAverage2(ExecutionPolicy&& Policy, span<const C> A, CircStatWorkspace& W, OutIter Out)
+{
+    constexpr double R = T::R;
+
+    const size_t    count         = A.size()    ;
+    double          fSum          = 0.          ; // of all elements of Angles
+    double          fSumSqr       = 0.          ; // of all elements of Angles
+    vector<double>& Angles        = W.Angles    ; // the range of T [L,H), ascendingly sorted
+    vector<double>& SumSqr        = W.PrefixSums; // sum of squares for each shift
+    vector<double>& SumSqrDiff    = W.SweepSums ; // sum of squares of differences for each shift
+
+    CIRC_PHASE_START(CircSite::CircAverage2, Convert);
+    CIRC_COUNT(CircSite::CircAverage2, Elements, count);
+
+    W.Results.clear();
+    if (count == 0)
+        return Out;
+
+    Angles    .resize(count);
+    SumSqr    .resize(count);
+    SumSqrDiff.resize(count);
+
+    CircConvert<T, T>::Apply(A, span<double>(Angles)); // a copy of CircVal<T> values
+
+    for (const auto& v : Angles) // in the order of A
+    {
+        fSum    +=     v ;
+        fSumSqr += Sqr(v);
+    }
+
+    CIRC_PHASE_NEXT(Sort);
+    sort(Policy, Angles.begin(), Angles.end()); // ascending
+
+    // ----------------------------------------------
+    // calc sum of squares for each order
+    CIRC_PHASE_NEXT(Sweep);
+    CIRC_COUNT(CircSite::CircAverage2, Candidates, count);
+    SumSqr    [0] = fSumSqr;
+    SumSqrDiff[0] = 0.     ; // shift index, replaced below by the sum of squares of differences
+    for (size_t i = 1; i<count; ++i)
+    {
+        SumSqr    [i] = SumSqr[i-1] + 2*R*Angles[i-1];
+        SumSqrDiff[i] = double(i);
+    }
+
+    // calc sum of squares of differences for each order
+    // the shift index is passed as an element of the second input range - a parallel algorithm may pass a copy of an
+    // element, so it cannot be derived from its address; a views::iota range does not meet the iterator requirements
+    // of the parallel algorithms
+    transform(Policy, SumSqr.begin(), SumSqr.end(), SumSqrDiff.begin(), SumSqrDiff.begin(), [&](double fShiftSumSqr, double i) -> double
+    {
+        return fShiftSumSqr + R*R*i - Sqr(fSum+R*i)/count;
+    });
+
+    const double fMinSumSqrDiff = reduce(Policy, SumSqrDiff.begin(), SumSqrDiff.end(), numeric_limits<double>::infinity(),
+                                         [](double a, double b) { return __min(a, b); });
+
+    // ----------------------------------------------
+    CIRC_PHASE_NEXT(Result);
+    for (size_t i = 0; i<count; ++i)
+        if (SumSqrDiff[i] == fMinSumSqrDiff) // indices of shift with minimal avrg
+            W.Results.emplace_back(CircVal<T>((fSum+R*i) / count)); // avrg from shift index
+
+    CIRC_COUNT(CircSite::CircAverage2, Ties, W.Results.size() - 1);
+
+    return CopyResultSet<T>(W.Results, Out);
+}
+
+// calculate average set of circular values - using an execution policy (e.g. std::execution::par)
+// return set of average values
+// T is a circular value type defined with the CircValTypeDef macro
+// C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+template<typename ExecutionPolicy, CircValue C, typename T = typename C::CircType>
+    requires is_execution_policy_v<remove_cvref_t<ExecutionPolicy>>
+set<CircVal<T, CircValueStorage_t<C>>> CircAverage2(ExecutionPolicy&& Policy, vector<C> const& A)
+{
+    CircStatWorkspace                      W;
+    set<CircVal<T, CircValueStorage_t<C>>> MinAvrgCircVals;
+    CircAverage2(Policy, span<const C>(A), W, inserter(MinAvrgCircVals, MinAvrgCircVals.end()));
+    return MinAvrgCircVals;
+}
+
+// ==========================================================================
+// the sector sweep of WeightedCircAverage
+// all values: the range of T [L,H), M = L+R/2 - see CircSweepConst
+// fASumW, fASumWA, fASumWA2 - sum(Wi), sum(Wi*Ai), sum(Wi*Ai^2) of all values
+// [LowerB, LowerE)          - <value,weight> of values in [L,M), ascending
+// [UpperB, UpperE)          - <value,weight> of values in (H,M), descending
+// MinAvrgVals               - returns set of average values in [L,H)
+template<typename T, typename LowerIter, typename UpperIter>
+void WeightedCircAverageSweep(double fASumW, double fASumWA, double fASumWA2,
+                              LowerIter LowerB, LowerIter LowerE,
+                              UpperIter UpperB, UpperIter UpperE,
+                              vector<double>& MinAvrgVals)
+{
+    using K = CircSweepConst<T>;
+
+    double fMinSumSqrDiff; // minimal sum of squares of differences
+    double fTestAvrg     ;
+
+    // ----------------------------------------------
+    // local functions - implemented as lambdas
+    // ----------------------------------------------
+
+    // calc sum(Wi*dist(M, Bi)^2) - all values are in set B
+    // dist(M,Bi)= |M-Bi|
+    // sum(Wi*dist(x, Bi)^2) = sum(Wi*(M-Bi)^2) = sum(Wi*(M^2-2*M*Bi + Bi^2)) = M^2*fSumW - 2*M*sum(Wi*Ai) + sum(Wi*Ai^2)
+    auto SumSqr = [&]() -> double
+    {
+        return K::M*K::M*fASumW - 2*K::M*fASumWA + fASumWA2;
+    };
+
+    // calc sum(Wi*dist(x, Ai)^2). A=B+C; set D is empty
+    // dist(x,Bi)= |x-Bi|
+    // dist(x,Ci)= R-(Ci-x)
+    // sum(Wi*dist(x,Bi)^2)= sum(Wi*(     (x-Bi) ^2))= sum(Wi*(        Bi^2 + x^2                      - 2*Bi*x)) +
+    // sum(Wi*dist(x,Ci)^2)= sum(Wi*((R-(Ci-x))^2))= sum(Wi*(R^2 + Ci^2 + x^2 - 2*R*Ci + 2*R*x - 2*Ci*x))
+    //                                                 ==========================================================
+    //                                                 sum(Wi*(        Ai^2 + x^2                      - 2*Ai*x))
+    auto SumSqrC = [&](double x      ,
+                       double fCSumW ,            // sum(Wi   ) of all elements of C
+                       double fCSumWC ) -> double // sum(Wi*Ci) of all elements of C
+    {
+        return fASumWA2 + x*x*fASumW -2*x*fASumWA - 2*K::R*fCSumWC + (K::R2+2*K::R*x)*fCSumW;
+    };
+
+    // calc sum(Wi*dist(x, Ai)^2). A=B+D; set C is empty
+    // dist(x,Bi)= |x-Bi|
+    // dist(x,Di)= R-(x-Di)
+    // sum(Wi*dist(x,Bi)^2)= sum(Wi*(     (x-Bi) ^2))= sum(Wi*(        Bi^2 + x^2                      - 2*Bi*x))
+    // sum(Wi*dist(x,Di)^2)= sum(Wi*((R-(x-Di))^2))= sum(Wi*(R^2 + Di^2 + x^2 + 2*R*Di - 2*R*x - 2*Di*x))
+    //                                                 ==========================================================
+    //                                                 sum(Wi*(        Ai^2 + x^2                      - 2*Ai*x))
+    auto SumSqrD = [&](double x      ,
+                       double fDSumW ,            // sum(Wi   ) of all elements of D
+                       double fDSumWD ) -> double // sum(Wi*Di) of all elements of D
+    {
+        return fASumWA2 + x*x*fASumW -2*x*fASumWA + 2*K::R*fDSumWD + (K::R2-2*K::R*x)*fDSumW;
+    };
+
+    // update MinAvrgAngles if lower/equal fMinSumSqrDiff found
+    auto TestSum = [&](double fTestAvrg, double fTestSumDiffSqr) -> void
+    {
+        if (fTestSumDiffSqr < fMinSumSqrDiff)
+        {
+            MinAvrgVals.clear();
+            MinAvrgVals.emplace_back(CircVal<T>::Wrap(fTestAvrg));
+            fMinSumSqrDiff= fTestSumDiffSqr;
+        }
+        else if (fTestSumDiffSqr == fMinSumSqrDiff)
+        {
+            CIRC_COUNT(CircSite::WeightedCircAverage, Ties, 1);
+            MinAvrgVals.emplace_back(CircVal<T>::Wrap(fTestAvrg));
+        }
+    };
+
+    // ----------------------------------------------
+    // start with avrg= M, sets c,d are empty
+    // ----------------------------------------------
+    MinAvrgVals.clear();
+    MinAvrgVals.emplace_back(K::M);
+    fMinSumSqrDiff = SumSqr();
+
+    // ----------------------------------------------
+    // average in (M,H), set D: values in range [L,avrg-R/2)
+    // ----------------------------------------------
+    double fLowerBound = K::L; // of current sector
+    double fDSumW      = 0.  ; // sum(Wi   ) of all elements of D
+    double fDSumWD     = 0.  ; // sum(Wi*Di) of all elements of D
+
+    for (auto iter = LowerB; iter != LowerE; ++iter)
+    {
+        // 1st  iteration : average in (                   M, lowerAngles[0]+R/2]
+        // next iterations: average in (lowerAngles[i-1]+R/2, lowerAngles[i]+R/2]
+        // set D          : lowerAngles[0..d]
+
+        fTestAvrg = (fASumWA + K::R*fDSumW)/fASumW; // average for sector, that minimizes SumDiffSqr
+
+        if ((fTestAvrg > fLowerBound+K::R_2) && (fTestAvrg <= (*iter).first+K::R_2)) // if fTestAvrg is within sector
+            TestSum(fTestAvrg, SumSqrD(fTestAvrg, fDSumW, fDSumWD));             // check if fTestAvrg generates lower SumSqr
+
+        fLowerBound  = (*iter).first                 ;
+        fDSumW      += (*iter).second                ;
+        fDSumWD     += (*iter).second * (*iter).first;
+    }
+
+    // last sector : average in [lowerAngles[lastIdx]+R/2, H)
+    fTestAvrg = (fASumWA + K::R*fDSumW)/fASumW; // average for sector, that minimizes SumDiffSqr
+
+    if ((fTestAvrg < K::H) && (fTestAvrg > fLowerBound))                         // if fTestAvrg is within sector
+        TestSum(fTestAvrg, SumSqrD(fTestAvrg, fDSumW, fDSumWD));                 // check if fTestAvrg generates lower SumSqr
+
+    // ----------------------------------------------
+    // average in [L,M); set C: values in range (avrg+R/2, H)
+    // ----------------------------------------------
+    double fUpperBound = K::H; // of current sector
+    double fCSumW      = 0.  ; // sum(Wi   ) of all elements of C
+    double fCSumWC     = 0.  ; // sum(Wi*Ci) of all elements of C
+
+    for (auto iter = UpperB; iter != UpperE; ++iter)
+    {
+        // 1st  iteration : average in [upperAngles[0]-R/2, H                   )
+        // next iterations: average in [upperAngles[i]-R/2, upperAngles[i-1]-R/2)
+        // set C          : upperAngles[0..c]  (descendingly sorted)
+
+        fTestAvrg = (fASumWA - K::R*fCSumW)/fASumW; // average for sector, that minimizes SumDiffSqr
+
+        if ((fTestAvrg >= (*iter).first-K::R_2) && (fTestAvrg < fUpperBound-K::R_2)) // if fTestAvrg is within sector
+            TestSum(fTestAvrg, SumSqrC(fTestAvrg, fCSumW, fCSumWC));             // check if fTestAvrg generates lower SumSqr
+
+        fUpperBound  = (*iter).first                 ;
+        fCSumW      += (*iter).second                ;
+        fCSumWC     += (*iter).second * (*iter).first;
+    }
+
+    // last sector : average in [L, upperAngles[lastIdx]-R/2)
+    fTestAvrg = (fASumWA - K::R*fCSumW)/fASumW; // average for sector, that minimizes SumDiffSqr
+
+    if ((fTestAvrg >= K::L) && (fTestAvrg < fUpperBound))                        // if fTestAvrg is within sector
+        TestSum(fTestAvrg, SumSqrC(fTestAvrg, fCSumW, fCSumWC));                 // check if fTestAvrg generates lower SumSqr
+}
+
+// ==========================================================================
+// calculate weighted-average set of circular values
+// write set of average values (ascending, no duplicates) to Out. return Out past the last written value
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T, typename OutIter>
+OutIter WeightedCircAverage(span<const pair<CircVal<T>,double>> A, CircStatWorkspace& W, OutIter Out) // span <value,weight>
+{
+    // ----------------------------------------------
+    // all vars: the range of T [L,H) - see CircSweepConst
+    constexpr double M = CircSweepConst<T>::M;
+
+    vector<double>&               MinAvrgVals    = W.Results     ; // results set
+    double                        fASumW         = 0.            ; // sum(Wi     ) of all elements of A
+    double                        fASumWA        = 0.            ; // sum(Wi*Ai  ) of all elements of A
+    double                        fASumWA2       = 0.            ; // sum(Wi*Ai^2) of all elements of A
+    vector<pair<double, double>>& LowerAngles    = W.LowerWAngles; // ascending   [L,M)  <angle,weight>
+    vector<pair<double, double>>& UpperAngles    = W.UpperWAngles; // descending  (H,M)  <angle,weight>
+
+    CIRC_PHASE_START(CircSite::WeightedCircAverage, Convert);
+    CIRC_COUNT(CircSite::WeightedCircAverage, Elements, A.size());
+
+    LowerAngles.clear();
+    UpperAngles.clear();
+
+    // ----------------------------------------------
+    for (const auto& a : A)
+    {
+        double v  = a.first ; // value
+        double w  = a.second; // weight
+        fASumW   += w    ;
+        fASumWA  += w*v  ;
+        fASumWA2 += w*v*v;
+
+             if (v < M) LowerAngles.emplace_back(pair<double,double>(v,w));
+        else if (v > M) UpperAngles.emplace_back(pair<double,double>(v,w));
+    }
+
+    CIRC_PHASE_NEXT(Sort);
+    SortWeighted(LowerAngles, W);                                                  // ascending   [L,M)
+    SortWeighted(UpperAngles, W);
+    reverse(UpperAngles.begin(), UpperAngles.end());                               // descending  (H,M)
+
+    // ----------------------------------------------
+    CIRC_PHASE_NEXT(Sweep);
+    WeightedCircAverageSweep<T>(fASumW, fASumWA, fASumWA2,
+                                LowerAngles.begin(), LowerAngles.end(),
+                                UpperAngles.begin(), UpperAngles.end(),
+                                MinAvrgVals);
+
+    // ----------------------------------------------
+    CIRC_PHASE_NEXT(Result);
+    return CopyResultSet<T>(MinAvrgVals, Out);
+}
+
+// calculate weighted-average set of circular values
+// return set of average values
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T>
+set<CircVal<T>> WeightedCircAverage(vector<pair<CircVal<T>,double>> const& A) // vector <value,weight>
+{
+    CircStatWorkspace W;
+    set<CircVal<T>>   MinAvrgVals;
+    WeightedCircAverage(span<const pair<CircVal<T>,double>>(A), W, inserter(MinAvrgVals, MinAvrgVals.end()));
+    return MinAvrgVals;
+}
+
+// calculate weighted-average set of circular values - values and weights in separate spans (structure of arrays)
+// write set of average values (ascending, no duplicates) to Out. return Out past the last written value
+// T is a circular value type defined with the CircValTypeDef macro
+// C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+// A - values, Wt - weights; same size
+//
+// same results as the <value,weight> overload: the values and weights are kept in contiguous arrays, and sorted by
+// a radix sort on the bits of the values (see SortWeighted); the sums of each sector are prefix scans of these arrays,
+// and the candidate average of every sector is evaluated in a branch-free loop, which the compiler can vectorize
+template<CircValue C, typename OutIter, typename T = typename C::CircType>
+OutIter WeightedCircAverage(span<const C> A, span<const double> Wt, CircStatWorkspace& W, OutIter Out)
+{
+    assert(A.size() == Wt.size());
+
+    // ----------------------------------------------
+    // all vars: the range of T [L,H) - see CircSweepConst
+    using K = CircSweepConst<T>;
+
+    const size_t    n           = A.size()     ;
+    vector<double>& SortedV     = W.SortedVals ; // values in [L,M) ascending, then values in (H,M) descending
+    vector<double>& SortedW     = W.SortedWghts; // weights - in the same order
+    vector<double>& PrefixW     = W.PrefixSums ; // PrefixW [i] = sum(Wi   ) of SortedV[0..i) - per part
+    vector<double>& PrefixWV    = W.PrefixSums2; // PrefixWV[i] = sum(Wi*Vi) of SortedV[0..i) - per part
+    vector<double>& SectorSum   = W.SweepSums  ; // sum(Wi*dist(x, Ai)^2) of each sector's candidate x; infinity if x is not within sector
+    vector<double>& MinAvrgVals = W.Results    ; // results set
+
+    double fASumW   = 0.; // sum(Wi     ) of all elements of A
+    double fASumWA  = 0.; // sum(Wi*Ai  ) of all elements of A
+    double fASumWA2 = 0.; // sum(Wi*Ai^2) of all elements of A
+
+    CIRC_PHASE_START(CircSite::WeightedCircAverage, Convert);
+    CIRC_COUNT(CircSite::WeightedCircAverage, Elements, n);
+
+    SortedV.resize(n);
+    SortedW.resize(n);
+    size_t nLower = 0; // [0,nLower): values in [L,M)
+    size_t nUpper = n; // [nUpper,n): values in (H,M)
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double v = CircVal<T>(A[i]);
+        const double w = Wt[i];
+        fASumW   += w    ;
+        fASumWA  += w*v  ;
+        fASumWA2 += w*v*v;
+
+             if (v < K::M) { SortedV[nLower  ] = v; SortedW[nLower++] = w; }
+        else if (v > K::M) { SortedV[--nUpper] = v; SortedW[nUpper  ] = w; }
+    }
+
+    // remove the gap of the values equal to M
+    SortedV.erase(SortedV.begin() + nLower, SortedV.begin() + nUpper);
+    SortedW.erase(SortedW.begin() + nLower, SortedW.begin() + nUpper);
+    nUpper = SortedV.size() - nLower;
+
+    // sort each part, with the weights as payloads - the same order as sorting <value,weight> pairs
+    auto SortPart = [&](size_t b, size_t e)
+    {
+        SortWeighted(span<double>(SortedV.data() + b, e - b), span<double>(SortedW.data() + b, e - b), W);
+    };
+
+    CIRC_PHASE_NEXT(Sort);
+    SortPart(0, nLower);                                                                               // ascending   [L,M)
+    SortPart(nLower, SortedV.size());
+    reverse(SortedV.begin() + nLower, SortedV.end());                                                  // descending  (H,M)
+    reverse(SortedW.begin() + nLower, SortedW.end());
+
+    // exclusive prefix scans, restarted at nLower: sector d of each part includes the values [0,d) of the part
+    CIRC_PHASE_NEXT(Sweep);
+    PrefixW .resize(SortedV.size() + 2);
+    PrefixWV.resize(SortedV.size() + 2);
+
+    auto Scan = [&](size_t b, size_t e, size_t p) // values [b,e) to prefix [p, p+e-b]
+    {
+        PrefixW [p] = 0.;
+        PrefixWV[p] = 0.;
+        for (size_t i = b; i < e; ++i, ++p)
+        {
+            PrefixW [p+1] = PrefixW [p] + SortedW[i]             ;
+            PrefixWV[p+1] = PrefixWV[p] + SortedW[i] * SortedV[i];
+        }
+    };
+
+    Scan(0     , nLower     , 0         ); // lower part: prefix [0       , nLower         ]
+    Scan(nLower, SortedV.size(), nLower + 1); // upper part: prefix [nLower+1, nLower+1+nUpper]
+
+    // ----------------------------------------------
+    // sum(Wi*dist(x, Ai)^2) - see the <value,weight> overload
+    const double fInf = numeric_limits<double>::infinity();
+
+    SectorSum.resize(SortedV.size() + 2);
+    double* const SumD = SectorSum.data()             ; // [0,nLower]: average in (M,H), set D: values in range [L,avrg-R/2)
+    double* const SumC = SectorSum.data() + nLower + 1; // [0,nUpper]: average in [L,M), set C: values in range (avrg+R/2,H)
+
+    // average in (M,H); sector d: (lowerAngles[d-1]+R/2, lowerAngles[d]+R/2]
+    for (size_t d = 0; d < nLower; ++d)
+    {
+        const double fDSumW  = PrefixW [d];
+        const double fDSumWD = PrefixWV[d];
+        const double x       = (fASumWA + K::R*fDSumW)/fASumW;
+        const double fLower  = d ? SortedV[d-1] : K::L;
+
+        const bool   bIn     = (x > fLower+K::R_2) & (x <= SortedV[d]+K::R_2);
+        SumD[d] = bIn ? fASumWA2 + x*x*fASumW -2*x*fASumWA + 2*K::R*fDSumWD + (K::R2-2*K::R*x)*fDSumW : fInf;
+    }
+
+    // average in (M,H); last sector: [lowerAngles[lastIdx]+R/2, H)
+    {
+        const double fDSumW  = PrefixW [nLower];
+        const double fDSumWD = PrefixWV[nLower];
+        const double x       = (fASumWA + K::R*fDSumW)/fASumW;
+        const double fLower  = nLower ? SortedV[nLower-1] : K::L;
+
+        const bool   bIn     = (x < K::H) && (x > fLower);
+        SumD[nLower] = bIn ? fASumWA2 + x*x*fASumW -2*x*fASumWA + 2*K::R*fDSumWD + (K::R2-2*K::R*x)*fDSumW : fInf;
+    }
+
+    // average in [L,M); sector c: [upperAngles[c]-R/2, upperAngles[c-1]-R/2)
+    const double* const UpperV   = SortedV .data() + nLower    ;
+    const double* const UpperPW  = PrefixW .data() + nLower + 1;
+    const double* const UpperPWV = PrefixWV.data() + nLower + 1;
+
+    for (size_t c = 0; c < nUpper; ++c)
+    {
+        const double fCSumW  = UpperPW [c];
+        const double fCSumWC = UpperPWV[c];
+        const double x       = (fASumWA - K::R*fCSumW)/fASumW;
+        const double fUpper  = c ? UpperV[c-1] : K::H;
+
+        const bool   bIn     = (x >= UpperV[c]-K::R_2) & (x < fUpper-K::R_2);
+        SumC[c] = bIn ? fASumWA2 + x*x*fASumW -2*x*fASumWA - 2*K::R*fCSumWC + (K::R2+2*K::R*x)*fCSumW : fInf;
+    }
+
+    // average in [L,M); last sector: [L, upperAngles[lastIdx]-R/2)
+    {
+        const double fCSumW  = UpperPW [nUpper];
+        const double fCSumWC = UpperPWV[nUpper];
+        const double x       = (fASumWA - K::R*fCSumW)/fASumW;
+        const double fUpper  = nUpper ? UpperV[nUpper-1] : K::H;
+
+        const bool   bIn     = (x >= K::L) && (x < fUpper);
+        SumC[nUpper] = bIn ? fASumWA2 + x*x*fASumW -2*x*fASumWA - 2*K::R*fCSumWC + (K::R2+2*K::R*x)*fCSumW : fInf;
+    }
+
+    // ----------------------------------------------
+    // avrg= M, sets c,d are empty; then the minimum of all sectors
+    const double fSumSqr        = K::M*K::M*fASumW - 2*K::M*fASumWA + fASumWA2;
+    const double fMinSumSqrDiff = __min(fSumSqr, *min_element(SectorSum.begin(), SectorSum.begin() + nLower + nUpper + 2));
+
+    MinAvrgVals.clear();
+    if (fSumSqr == fMinSumSqrDiff)
+        MinAvrgVals.emplace_back(K::M);
+
+    for (size_t d = 0; d <= nLower; ++d)
+        if (SumD[d] == fMinSumSqrDiff)
+            MinAvrgVals.emplace_back(CircVal<T>::Wrap((fASumWA + K::R*PrefixW[d])/fASumW));
+
+    for (size_t c = 0; c <= nUpper; ++c)
+        if (SumC[c] == fMinSumSqrDiff)
+            MinAvrgVals.emplace_back(CircVal<T>::Wrap((fASumWA - K::R*UpperPW[c])/fASumW));
+
+    CIRC_COUNT(CircSite::WeightedCircAverage, Ties, MinAvrgVals.size() - 1);
+
+    // ----------------------------------------------
+    CIRC_PHASE_NEXT(Result);
+    return CopyResultSet<T>(MinAvrgVals, Out);
+}
+
+// calculate weighted-average set of circular values - values and weights in separate vectors
+// return set of average values
+// T is a circular value type defined with the CircValTypeDef macro
+template<CircValue C, typename T = typename C::CircType>
+set<CircVal<T, CircValueStorage_t<C>>> WeightedCircAverage(vector<C> const& A, vector<double> const& Wt)
+{
+    CircStatWorkspace                      W;
+    set<CircVal<T, CircValueStorage_t<C>>> MinAvrgVals;
+    WeightedCircAverage(span<const C>(A), span<const double>(Wt), W, inserter(MinAvrgVals, MinAvrgVals.end()));
+    return MinAvrgVals;
+}
+
+// ==========================================================================
+// mergeable partial result of CircAverage / WeightedCircAverage - for data sharded across threads or nodes
+// each shard summarizes its values; summaries are combined by Merge (associative and commutative), and shipped
+// between nodes in a compact binary wire format (Serialize / Deserialize) - so the reduction may run as a tree.
+//
+// exact mode (nBins = 0): keeps the values (and weights) as a sorted run; Merge merges the sorted runs - O(n).
+// GetAvrg runs the sector sweep of CircAverage / WeightedCircAverage over the run, with the sums computed from the
+// sorted run: the result depends only on the values - not on the sharding or the order of merges - and equals
+// CircAverage / WeightedCircAverage up to rounding of the sums.
+// approximate mode (nBins > 0): keeps the weight and the weighted sum of the values of each of nBins equal bins -
+// O(bins) memory and wire size. GetAvrg is the weighted average of the bin means (see CircHistogram), typically within
+// GetAvrgErrorEstimate() (and one bin) of the exact average - an estimate for concentrated values, not a bound.
+//
+// wire format (little-endian, IEEE-754 doubles):
+// "CAS" | version: 1 byte | flags: 1 byte (bit 0: weighted, bit 1: approximate) | nBins: uint32 | nItems: uint64 | items
+// exact mode items      : value [L,H) of T (weighted: value, weight)  - doubles, ascending
+// approximate mode items: bin: uint32 | weight: double | sum(weight*(value - lower bound of bin)): double - non-empty bins,
+//                         ascending. nBins <= MaxBins
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T, bool bWeighted>
+class CircAverageSummaryT
+{
+    // all values: the range of T [L,H)
+    using Item = conditional_t<bWeighted, pair<double, double>, double>; // value (weighted: <value,weight>)
+
+    struct Bin
+    {
+        double fW    = 0.; // sum of weights
+        double fWA   = 0.; // sum of weight*(value - lower bound of bin)
+        double fComp = 0.; // compensation of fWA
+    };
+
+    size_t       m_nBins; // 0: exact mode
+    vector<Item> m_Items; // exact mode      : ascending
+    vector<Bin>  m_Bins ; // approximate mode
+
+    static double Val(const Item& i) { if constexpr (bWeighted) return i.first ; else return i; }
+    static double Wgt(const Item& i) { if constexpr (bWeighted) return i.second; else return 1.; }
+
+    double GetBinWidth()           const { return T::R / m_nBins; }
+    double GetBinLower(size_t b  ) const { return T::L + b * GetBinWidth(); }
+    size_t GetBin     (double v  ) const { return min<size_t>((size_t)((v - T::L) / GetBinWidth()), m_nBins - 1); }
+    double GetBinMean (size_t b  ) const { return GetBinLower(b) + std::clamp(m_Bins[b].fWA / m_Bins[b].fW, 0., GetBinWidth()); }
+
+    void AddItem(double v, double w)
+    {
+        const size_t b = GetBin(v);
+        m_Bins[b].fW += w;
+        AddCompensated(m_Bins[b].fWA, m_Bins[b].fComp, w * (v - GetBinLower(b)));
+    }
+
+    // append/read n bytes of x, little-endian
+    static void Put(vector<uint8_t>& Buf, uint64_t x, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            Buf.push_back(static_cast<uint8_t>(x >> (8 * i)));
+    }
+
+    static uint64_t Get(span<const uint8_t> Buf, size_t& nPos, size_t n)
+    {
+        if (Buf.size() < nPos + n)
+            throw std::invalid_argument("truncated CircAverageSummary wire format");
+
+        uint64_t x = 0;
+        for (size_t i = 0; i < n; ++i)
+            x |= uint64_t(Buf[nPos++]) << (8 * i);
+        return x;
+    }
+
+    static void   PutDouble(vector<uint8_t>& Buf, double f) { Put(Buf, bit_cast<uint64_t>(f), 8); }
+    static double GetDouble(span<const uint8_t> Buf, size_t& nPos) { return bit_cast<double>(Get(Buf, nPos, 8)); }
+
+    static constexpr uint8_t Version = 2; // 2: values in the range of T. 1: values in [0,360)
+
+public:
+    // max number of bins of a summary read by Deserialize - bounds the allocation for a buffer from an untrusted source
+    static constexpr size_t MaxBins = size_t(1) << 20;
+
+    explicit CircAverageSummaryT(size_t nBins = 0) : m_nBins(nBins), m_Bins(nBins)
+    {
+    }
+
+    bool   IsExact () const { return m_nBins == 0; }
+    size_t GetBins () const { return m_nBins;      }
+
+    // number of items kept: values (exact mode) or non-empty bins (approximate mode)
+    size_t GetItems() const
+    {
+        return IsExact() ? m_Items.size() : (size_t)count_if(m_Bins.begin(), m_Bins.end(), [](const Bin& b) { return b.fW != 0.; });
+    }
+
+    // ----------------------------------------------
+    // a single value is inserted into the sorted run in exact mode - O(n); add spans of values where possible
+    void Add(const CircVal<T>& c) requires (!bWeighted)
+    {
+        const double v = c;
+        if (IsExact())
+            m_Items.insert(upper_bound(m_Items.begin(), m_Items.end(), v), v);
+        else
+            AddItem(v, 1.);
+    }
+
+    void Add(const CircVal<T>& c, double w) requires bWeighted
+    {
+        const Item i(c, w);
+        if (IsExact())
+            m_Items.insert(upper_bound(m_Items.begin(), m_Items.end(), i), i);
+        else
+            AddItem(i.first, w);
+    }
+
+    // add the values of A - sorted as a run, and merged
+    // C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+    template<CircValue C>
+    void Add(span<const C> A) requires (!bWeighted)
+    {
+        CircAverageSummaryT S(m_nBins);
+        if (IsExact())
+        {
+            S.m_Items.resize(A.size());
+            CircConvert<T, T>::Apply(A, span<double>(S.m_Items));
+
+            vector<double> Tmp;
+            SortValues(S.m_Items, Tmp);
+        }
+        else
+            for (const auto& a : A)
+                S.AddItem(CircVal<T>(a), 1.);
+
+        Merge(S);
+    }
+
+    // add the values of A, with weights Wt; same size
+    template<CircValue C>
+    void Add(span<const C> A, span<const double> Wt) requires bWeighted
+    {
+        assert(A.size() == Wt.size());
+
+        CircAverageSummaryT S(m_nBins);
+        if (IsExact())
+        {
+            vector<double> K(A.size());
+            vector<double> P(Wt.begin(), Wt.end());
+            CircConvert<T, T>::Apply(A, span<double>(K));
+
+            CircStatWorkspace W;
+            SortWeighted(span<double>(K), span<double>(P), W);
+
+            S.m_Items.resize(A.size());
+            for (size_t i = 0; i < A.size(); ++i)
+                S.m_Items[i] = { K[i], P[i] };
+        }
+        else
+            for (size_t i = 0; i < A.size(); ++i)
+                S.AddItem(CircVal<T>(A[i]), Wt[i]);
+
+        Merge(S);
+    }
+
+    // add the values of summary S, of the same mode (and number of bins)
+    // throws std::invalid_argument for a summary of another mode or number of bins
+    void Merge(const CircAverageSummaryT& S)
+    {
+        if (S.m_nBins != m_nBins)
+            throw std::invalid_argument("CircAverageSummary of another mode or number of bins");
+
+        if (IsExact())
+        {
+            const size_t n = m_Items.size();
+            m_Items.insert(m_Items.end(), S.m_Items.begin(), S.m_Items.end());
+            inplace_merge(m_Items.begin(), m_Items.begin() + n, m_Items.end());
+        }
+        else
+            for (size_t b = 0; b < m_nBins; ++b)
+            {
+                m_Bins[b].fW += S.m_Bins[b].fW;
+                AddCompensated(m_Bins[b].fWA, m_Bins[b].fComp, S.m_Bins[b].fWA);
+                m_Bins[b].fComp += S.m_Bins[b].fComp;
+            }
+    }
+
+    // ----------------------------------------------
+    // return set of average values
+    set<CircVal<T>> GetAvrg() const
+    {
+        constexpr double M = CircSweepConst<T>::M;
+
+        vector<double> MinAvrgVals;
+
+        if (IsExact())
+        {
+            if (m_Items.empty())
+                return {};
+
+            double fSumW  = 0., fSumWComp  = 0.; // sum(Wi     )
+            double fSumWA = 0., fSumWAComp = 0.; // sum(Wi*Ai  )
+            double fSumWA2= 0., fSumWA2Comp= 0.; // sum(Wi*Ai^2)
+            for (const auto& i : m_Items)
+            {
+                AddCompensated(fSumW  , fSumWComp  , Wgt(i)                 );
+                AddCompensated(fSumWA , fSumWAComp , Wgt(i) *     Val(i)    );
+                AddCompensated(fSumWA2, fSumWA2Comp, Wgt(i) * Sqr(Val(i))   );
+            }
+
+            const auto iLower = lower_bound(m_Items.begin(), m_Items.end(), M, [](const Item& i, double v) { return Val(i) < v; }); // end of [L,M)
+            const auto iUpper = upper_bound(m_Items.begin(), m_Items.end(), M, [](double v, const Item& i) { return v < Val(i); }); // end of [M,M]
+
+            if constexpr (bWeighted)
+                WeightedCircAverageSweep<T>(fSumW + fSumWComp, fSumWA + fSumWAComp, fSumWA2 + fSumWA2Comp,
+                                            m_Items.begin() , iLower                       ,
+                                            m_Items.rbegin(), make_reverse_iterator(iUpper),
+                                            MinAvrgVals);
+            else
+                CircAverageSweep<T>(m_Items.size(), fSumWA + fSumWAComp, fSumWA2 + fSumWA2Comp,
+                                    m_Items.begin() , iLower                       ,
+                                    m_Items.rbegin(), make_reverse_iterator(iUpper),
+                                    MinAvrgVals);
+        }
+        else
+        {
+            // the bin means, weighted
+            vector<pair<double, double>> Lower, Upper; // ascending [L,M), descending (H,M)
+            double fSumW = 0., fSumWA = 0., fSumWA2 = 0.;
+            for (size_t b = 0; b < m_nBins; ++b)
+                if (m_Bins[b].fW != 0.)
+                {
+                    const double v = GetBinMean(b), w = m_Bins[b].fW;
+                    fSumW   += w    ;
+                    fSumWA  += w*v  ;
+                    fSumWA2 += w*v*v;
+
+                         if (v < M) Lower.emplace_back(v, w);
+                    else if (v > M) Upper.emplace_back(v, w);
+                }
+
+            if (fSumW == 0.)
+                return {};
+
+            reverse(Upper.begin(), Upper.end());
+            WeightedCircAverageSweep<T>(fSumW, fSumWA, fSumWA2,
+                                        Lower.begin(), Lower.end(),
+                                        Upper.begin(), Upper.end(),
+                                        MinAvrgVals);
+        }
+
+        return set<CircVal<T>>(MinAvrgVals.begin(), MinAvrgVals.end());
+    }
+
+    // estimate of the distance between the approximate and the exact average (0 in exact mode), in units of T
+    // see CircHistogram::GetAvrgErrorEstimate: R * (weight of the bins within one bin of the antipodes) / (total weight)
+    double GetAvrgErrorEstimate() const
+    {
+        if (IsExact())
+            return 0.;
+
+        double fSumW = 0., fNearW = 0.;
+        vector<bool> Near(m_nBins);
+        for (const auto& a : GetAvrg())
+        {
+            const size_t b = GetBin(~a); // antipode
+            Near[b] = Near[(b + 1) % m_nBins] = Near[(b + m_nBins - 1) % m_nBins] = true;
+        }
+
+        for (size_t b = 0; b < m_nBins; ++b)
+        {
+            fSumW += m_Bins[b].fW;
+            if (Near[b])
+                fNearW += m_Bins[b].fW;
+        }
+
+        return fSumW == 0. ? 0. : T::R * fNearW / fSumW;
+    }
+
+    // ----------------------------------------------
+    // append the wire format of the summary to Buf
+    void Serialize(vector<uint8_t>& Buf) const
+    {
+        Buf.insert(Buf.end(), { 'C', 'A', 'S', Version, static_cast<uint8_t>((bWeighted ? 1 : 0) | (IsExact() ? 0 : 2)) });
+        Put(Buf, m_nBins    , 4);
+        Put(Buf, GetItems(), 8);
+
+        if (IsExact())
+            for (const auto& i : m_Items)
+            {
+                            PutDouble(Buf, Val(i));
+                if constexpr (bWeighted)
+                            PutDouble(Buf, Wgt(i));
+            }
+        else
+            for (size_t b = 0; b < m_nBins; ++b)
+                if (m_Bins[b].fW != 0.)
+                {
+                    Put      (Buf, b, 4);
+                    PutDouble(Buf, m_Bins[b].fW                    );
+                    PutDouble(Buf, m_Bins[b].fWA + m_Bins[b].fComp);
+                }
+    }
+
+    // read a summary from the wire format at Buf[nPos]; advance nPos past it
+    // throws std::invalid_argument for a malformed or truncated buffer, or a summary of another kind: more than MaxBins
+    // bins, values out of the range of T or unsorted, bins out of range or not ascending (e.g. duplicates), NaN,
+    // infinite or negative weights and sums
+    static CircAverageSummaryT Deserialize(span<const uint8_t> Buf, size_t& nPos)
+    {
+        if (Get(Buf, nPos, 1) != 'C' || Get(Buf, nPos, 1) != 'A' || Get(Buf, nPos, 1) != 'S' || Get(Buf, nPos, 1) != Version)
+            throw std::invalid_argument("invalid CircAverageSummary wire format");
+
+        const uint64_t nFlags  = Get(Buf, nPos, 1);
+        const uint64_t nBins   = Get(Buf, nPos, 4);
+        const uint64_t nItems  = Get(Buf, nPos, 8);
+        if ((nFlags & 1) != (bWeighted ? 1 : 0) || ((nFlags & 2) != 0) != (nBins != 0) || nFlags > 3)
+            throw std::invalid_argument("CircAverageSummary wire format of another kind");
+        if (nBins > MaxBins)
+            throw std::invalid_argument("too many CircAverageSummary bins");
+
+        const size_t nItemSize = nBins ? 20 : (bWeighted ? 16 : 8); // bytes per item
+        if ((Buf.size() - nPos) / nItemSize < nItems)
+            throw std::invalid_argument("truncated CircAverageSummary wire format");
+
+        CircAverageSummaryT S(nBins);
+        if (S.IsExact())
+        {
+            S.m_Items.resize(nItems);
+            for (auto& i : S.m_Items)
+            {
+                if constexpr (bWeighted)
+                {
+                    i.first  = GetDouble(Buf, nPos);
+                    i.second = GetDouble(Buf, nPos);
+                }
+                else
+                    i = GetDouble(Buf, nPos);
+
+                if (!(Val(i) >= T::L && Val(i) < T::H))
+                    throw std::invalid_argument("invalid CircAverageSummary value");
+                if (!(isfinite(Wgt(i)) && Wgt(i) >= 0.))
+                    throw std::invalid_argument("invalid CircAverageSummary weight");
+            }
+
+            if (!is_sorted(S.m_Items.begin(), S.m_Items.end()))
+                throw std::invalid_argument("unsorted CircAverageSummary values");
+        }
+        else
+            for (uint64_t k = 0, nPrev = 0; k < nItems; ++k)
+            {
+                const uint64_t b = Get(Buf, nPos, 4);
+                if (b >= nBins || (k > 0 && b <= nPrev)) // out of range, or not ascending - e.g. a duplicate
+                    throw std::invalid_argument("invalid CircAverageSummary bin");
+                nPrev = b;
+
+                S.m_Bins[b].fW  = GetDouble(Buf, nPos);
+                S.m_Bins[b].fWA = GetDouble(Buf, nPos);
+                if (!(isfinite(S.m_Bins[b].fW ) && S.m_Bins[b].fW  >  0.) ||
+                    !(isfinite(S.m_Bins[b].fWA) && S.m_Bins[b].fWA >= 0.))
+                    throw std::invalid_argument("invalid CircAverageSummary bin weight");
+            }
+
+        return S;
+    }
+
+    // read a summary from the wire format of a whole buffer
+    static CircAverageSummaryT Deserialize(span<const uint8_t> Buf)
+    {
+        size_t nPos = 0;
+        CircAverageSummaryT S = Deserialize(Buf, nPos);
+        if (nPos != Buf.size())
+            throw std::invalid_argument("trailing bytes after CircAverageSummary wire format");
+        return S;
+    }
+};
+
+template<typename T> using CircAverageSummary         = CircAverageSummaryT<T, false>; // summary of CircAverage
+template<typename T> using WeightedCircAverageSummary = CircAverageSummaryT<T, true >; // summary of WeightedCircAverage
+
+// ==========================================================================
+// estimate the average of a sampled continuous-time circular signal, using circular linear interpolation
+// T is a circular value type defined with the CircValTypeDef macro
+//
+// the signal between consecutive samples is an interval, whose average is its circular mid-point, and whose weight
+// is its duration. the estimate is the weighted average of the intervals. modes:
+// Exact   - (default) keeps all intervals; GetAvrg calculates their WeightedCircAverage: O(n log n). memory: O(n)
+// Window  - keeps only the intervals that end within the last fWindow time units - in time order, and ordered by
+//           <avrg,weight> - with compensated sums; GetAvrg runs the sector sweep over the ordered intervals: O(m), no
+//           sorting. memory: O(m), m is the number of samples per window
+// Running - keeps only the weighted sum of the intervals' unit vectors: AddMeasurement and GetVectorMean are O(1).
+//           memory: O(1). not an average: GetVectorMean is the mean direction of the intervals, which minimizes
+//           sum(Wi*(1-cos(x-Ai))) rather than sum(Wi*dist(x,Ai)^2) - identical to the average for symmetric signals, and
+//           close to it for concentrated ones. GetAvrg is not available in this mode
+template<typename T>
+class CAvrgSampledCircSignal
+{
+public:
+    enum class Mode { Exact, Window, Running };
+
+private:
+    struct Interval
+    {
+        double fAvrg   ; // the range of T [L,H)
+        double fWeight ;
+        double fEndTime;
+    };
+
+    Mode                             m_eMode      ;
+    double                           m_fWindow    ; // Window  : window duration
+    size_t                           m_nSamples   ;
+    CircVal<T>                       m_PrevC      ; // previous value
+    double                           m_fPrevTime  ; // previous time
+
+    vector<CircVal<T>>               m_Avrgs      ; // Exact   : avrg   of each interval
+    vector<double>                   m_Weights    ; // Exact   : weight of each interval
+    CircStatWorkspace                m_W          ; // Exact   : reused by GetAvrg
+    vector<CircVal<T>>               m_Res        ; // Exact   : reused by GetAvrg
+
+    deque<Interval>                  m_Window     ; // Window  : intervals, in time order
+    multiset<pair<double, double>>   m_Sorted     ; // Window  : <avrg,weight> of the intervals, ascending
+    double                           m_fSumW      ; // Window  : sum(Wi     ) of the intervals
+    double                           m_fSumWComp  ; //           compensation of m_fSumW
+    double                           m_fSumWA     ; // Window  : sum(Wi*Ai  ) of the intervals
+    double                           m_fSumWAComp ; //           compensation of m_fSumWA
+    double                           m_fSumWA2    ; // Window  : sum(Wi*Ai^2) of the intervals
+    double                           m_fSumWA2Comp; //           compensation of m_fSumWA2
+
+    double                           m_fSumCos    ; // Running : sum(Wi*cos(Ai))
+    double                           m_fSumSin    ; // Running : sum(Wi*sin(Ai))
+
+    // Window: add (sign=1) or remove (sign=-1) an interval to/from the sums
+    void AddToSums(const Interval& I, double sign)
+    {
+        const double v = I.fAvrg  ;
+        const double w = I.fWeight;
+        AddCompensated(m_fSumW  , m_fSumWComp  , sign * w    );
+        AddCompensated(m_fSumWA , m_fSumWAComp , sign * w*v  );
+        AddCompensated(m_fSumWA2, m_fSumWA2Comp, sign * w*v*v);
+    }
+
+public:
+    // fWindow: duration of the window (Window mode only)
+    explicit CAvrgSampledCircSignal(Mode eMode = Mode::Exact, double fWindow = 0.)
+    {
+        assert(eMode != Mode::Window || fWindow > 0.);
+
+        m_eMode    = eMode  ;
+        m_fWindow  = fWindow;
+        m_nSamples = 0      ;
+
+        m_fSumW    = m_fSumWComp  = 0.;
+        m_fSumWA   = m_fSumWAComp = 0.;
+        m_fSumWA2  = m_fSumWA2Comp= 0.;
+        m_fSumCos  = m_fSumSin    = 0.;
+    }
+
+    void AddMeasurement(CircVal<T> C, double fTime)
+    {
+        if (m_nSamples)
+        {
+            assert(fTime > m_fPrevTime);
+
+            double fIntervalAvrg   = CircVal<T>::Wrap((double)m_PrevC + CircVal<T>::Sdist(m_PrevC, C) / 2.);
+            double fIntervalWeight = fTime - m_fPrevTime                                                   ;
+
+            switch (m_eMode)
+            {
+            case Mode::Exact:
+                m_Avrgs  .emplace_back(fIntervalAvrg  );
+                m_Weights.emplace_back(fIntervalWeight);
+                break;
+
+            case Mode::Window:
+            {
+                const Interval I = { fIntervalAvrg, fIntervalWeight, fTime };
+                m_Window.push_back(I);
+                m_Sorted.emplace(I.fAvrg, I.fWeight);
+                AddToSums(I, 1.);
+
+                // evict the intervals that end before the window
+                while (m_Window.front().fEndTime <= fTime - m_fWindow)
+                {
+                    const Interval& J = m_Window.front();
+                    m_Sorted.erase(m_Sorted.find(pair<double, double>(J.fAvrg, J.fWeight)));
+                    AddToSums(J, -1.);
+                    m_Window.pop_front();
+                }
+                break;
+            }
+
+            case Mode::Running:
+            {
+                const auto [fSin, fCos] = sincos(CircVal<T>(fIntervalAvrg));
+                m_fSumCos += fIntervalWeight * fCos;
+                m_fSumSin += fIntervalWeight * fSin;
+                break;
+            }
+            }
+        }
+
+        m_PrevC     = C    ;
+        m_fPrevTime = fTime;
+        ++m_nSamples;
+    }
+
+    // number of intervals kept in memory
+    size_t GetIntervals() const
+    {
+        switch (m_eMode)
+        {
+        case Mode::Exact : return m_Avrgs .size();
+        case Mode::Window: return m_Window.size();
+        default          : return 0;
+        }
+    }
+
+    // calculate the weighted average for all intervals (Window mode: for the intervals of the window)
+    // Exact and Window modes only - Running mode: see GetVectorMean
+    bool GetAvrg(CircVal<T>& Avrg)
+    {
+        assert(m_eMode != Mode::Running);
+
+        if (m_eMode == Mode::Running)
+        {
+            Avrg = CircVal<T>::GetZ();
+            return false;
+        }
+
+        switch (m_nSamples)
+        {
+        case 0:
+            Avrg = CircVal<T>::GetZ();
+            return false;
+
+        case 1:
+            Avrg = m_PrevC;
+            return true;
+        }
+
+        switch (m_eMode)
+        {
+        case Mode::Exact:
+            m_Res.clear();
+            WeightedCircAverage(span<const CircVal<T>>(m_Avrgs), span<const double>(m_Weights), m_W, back_inserter(m_Res));
+            Avrg = m_Res.front(); // lowest of the average set
+            return true;
+
+        case Mode::Window:
+        {
+            const double fInf   = numeric_limits<double>::infinity();
+            const double M      = CircSweepConst<T>::M;
+            const auto   iLower = m_Sorted.lower_bound(pair<double, double>(M, -fInf)); // end of [L,M)
+            const auto   iUpper = m_Sorted.upper_bound(pair<double, double>(M,  fInf)); // end of [M,M]
+
+            vector<double>& MinAvrgVals = m_W.Results;
+            WeightedCircAverageSweep<T>(m_fSumW + m_fSumWComp, m_fSumWA + m_fSumWAComp, m_fSumWA2 + m_fSumWA2Comp,
+                                        m_Sorted.begin() , iLower                       ,
+                                        m_Sorted.rbegin(), make_reverse_iterator(iUpper),
+                                        MinAvrgVals);
+
+            Avrg = *min_element(MinAvrgVals.begin(), MinAvrgVals.end()); // lowest of the average set - the values are wrapped
+            return true;
+        }
+
+        default:
+            return false;
+        }
+    }
+
+    // the weighted mean direction of all intervals: O(1). Running mode only - see above
+    bool GetVectorMean(CircVal<T>& Mean) const
+    {
+        assert(m_eMode == Mode::Running);
+
+        if (m_eMode != Mode::Running || m_nSamples == 0)
+        {
+            Mean = CircVal<T>::GetZ();
+            return false;
+        }
+
+        if (m_nSamples == 1)
+            Mean = m_PrevC;
+        else
+            Mean = CircVal<SignedRadRange>(atan2(m_fSumSin, m_fSumCos));
+        return true;
+    }
+};
+
+// ==========================================================================
+// maximal number of near-minimal candidates which CircMedian and WeightedCircMedian re-evaluate directly, O(n) each
+inline constexpr size_t CircMedianMaxRefined = 32;
+
+// calculate median set of circular values
+// write set of median values (ascending, no duplicates) to Out. return Out past the last written value
+// T is a circular value type defined with the CircValTypeDef macro
+// C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+//
+// the median minimizes sum(|Sdist(x, Ai)|). candidates are the values of A
+// (odd count) or the circular mid-points of consecutive values (even count).
+// the sum is computed for all candidates in a single sweep over the sorted
+// values, using prefix sums: O(n log n) instead of O(n^2).
+// since the swept sums are rounded differently than the direct sums, every
+// candidate whose swept sum is within the rounding-error bound of the minimum
+// is re-evaluated directly, so that the result set (ties included) is
+// identical to CircMedianBruteForce.
+// more than CircMedianMaxRefined such candidates are a flat part of the sum
+// (evenly spaced or quantized values), where the direct sums differ by their
+// rounding errors only. these candidates are compared by their sums from the
+// compensated prefix sums, accurate to about eps^2 - O(1) each, so that the
+// refinement stays O(n). the result set is then the set of medians of the
+// exact sums - identical to CircMedianBruteForce when the values are integers.
+// for non-integer values it may differ: CircMedianBruteForce picks the ties of
+// the rounding errors of its direct sums. each median is then within those
+// rounding errors (about n*eps of the sum) of the brute-force minimum
+template<CircValue C, typename OutIter, typename T = typename C::CircType>
+OutIter CircMedian(span<const C> A, CircStatWorkspace& W, OutIter Out)
+{
+    vector<double>& X = W.Results;      // results set
+    X.clear();
+
+    const size_t n = A.size();
+    if (n == 0)
+        return Out;
+
+    CIRC_PHASE_START(CircSite::CircMedian, Convert);
+    CIRC_COUNT(CircSite::CircMedian, Elements, n);
+
+    // ----------------------------------------------
+    vector<double>& S = W.Angles;       // A, ascendingly sorted
+    S.resize(n);
+    for (size_t i = 0; i < n; ++i)
+        S[i] = CircVal<T>(A[i]);
+
+    CIRC_PHASE_NEXT(Sort);
+    SortValues(S, W.RadixTmpK);
+
+    // ----------------------------------------------
+    CIRC_PHASE_NEXT(Sweep);
+    vector<double>& B = W.Candidates;   // candidates, ascendingly sorted, no duplicates
+    B.clear();
+
+    if (n % 2 == 0)                     // even number of values
+    {
+        for (size_t m = 0; m < n; ++m)
+        {
+            size_t k = m+1; if (k == n) k = 0;
+            double d = CircVal<T>::Sdist(S[m], S[k]);
+
+            // insert average set of each two circular-consecutive values
+            B.emplace_back(CircVal<T>::Wrap(S[m] + d / 2.));
+            if (d == -CircVal<T>::GetR() / 2.)
+                B.emplace_back(CircVal<T>::Wrap(S[k] + d / 2.));
+        }
+
+        SortValues(B, W.RadixTmpK);
+    }
+    else                                // odd number of values
+        B.assign(S.begin(), S.end());
+
+    B.erase(unique(B.begin(), B.end()), B.end());
+    CIRC_COUNT(CircSite::CircMedian, Candidates, B.size());
+
+    // ----------------------------------------------
+    // prefix sums of the sorted values: P[i] + PC[i] = S[0] + ... + S[i-1]
+    // compensated (Neumaier) summation - P[i] + PC[i] is accurate to a single rounding, the pair to about eps^2
+    vector<double>& P  = W.PrefixSums ;
+    vector<double>& PC = W.PrefixComps;
+    P .resize(n+1);
+    PC.resize(n+1);
+    P[0] = PC[0] = 0.;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        P[i+1] = P[i]; PC[i+1] = PC[i];
+        AddCompensated(P[i+1], PC[i+1], S[i]);
+    }
+
+    auto Pv = [&](size_t i) { return P[i] + PC[i]; };
+
+    // sweep the candidates (ascending). for candidate b, the sorted values are split into 4 sectors:
+    // [0  ,lo ): S[i] <  b-R/2   dist = S[i]+R-b
+    // [lo ,mid): S[i] <  b       dist = b-S[i]
+    // [mid,hi ): S[i] <= b+R/2   dist = S[i]-b
+    // [hi ,n  ):                 dist = b+R-S[i]
+    // all sector bounds are non-decreasing as b increases
+    const double R  = CircVal<T>::GetR();
+    const double R2 = R / 2.;
+
+    vector<double>& fSweepSum    = W.SweepSums; // sum(|Sdist(b, Ai)|) for each candidate
+    double          fMinSweepSum = numeric_limits<double>::max();
+    fSweepSum.resize(B.size());
+
+    size_t lo = 0, mid = 0, hi = 0;
+    for (size_t j = 0; j < B.size(); ++j)
+    {
+        const double b = B[j];
+        while (lo  < n && S[lo ] <  b - R2) ++lo ;
+        while (mid < n && S[mid] <  b     ) ++mid;
+        while (hi  < n && S[hi ] <= b + R2) ++hi ;
+
+        fSweepSum[j] =  Pv(lo)            + lo      * (R - b)
+                     + (mid - lo) * b    - (Pv(mid) - Pv(lo))
+                     + (Pv(hi) - Pv(mid)) - (hi - mid) * b
+                     + (n - hi) * (b + R) - (Pv(n) - Pv(hi));
+
+        fMinSweepSum = __min(fMinSweepSum, fSweepSum[j]);
+    }
+
+    // bound of the rounding errors of both the swept sums and the direct sums:
+    // direct sum of n non-negative terms: n*eps/2*sum + eps*M per term; swept sum: a few roundings of n*M
+    const double fEps = numeric_limits<double>::epsilon();
+    const double M    = __max(abs(CircVal<T>::GetL()), abs(CircVal<T>::GetH())) + R;
+    const double fTol = (n + 2) * fEps * fMinSweepSum + 16. * n * fEps * M;
+
+    // ----------------------------------------------
+    // re-evaluate the near-minimal candidates exactly as CircMedianBruteForce does
+    CIRC_PHASE_NEXT(Refine);
+    double fMinSum = numeric_limits<double>::max();
+
+    const size_t nNear = count_if(fSweepSum.begin(), fSweepSum.end(), [&](double f) { return f <= fMinSweepSum + fTol; });
+    if (nNear > CircMedianMaxRefined)
+    {
+        // a flat part of the sum: 2P[lo] - 2P[mid] + 2P[hi] - P[n] + (n-2lo+2mid-2hi)*b + (n+lo-hi)*R, summed by
+        // the prefix sums and their compensations, and the exact products
+        for (size_t j = 0; j < B.size(); ++j)
+        {
+            if (fSweepSum[j] > fMinSweepSum + fTol)
+                continue;
+
+            const double b   = B[j];
+            const size_t lo  = lower_bound(S.begin(), S.end(), b - R2) - S.begin();
+            const size_t mid = lower_bound(S.begin(), S.end(), b     ) - S.begin();
+            const size_t hi  = upper_bound(S.begin(), S.end(), b + R2) - S.begin();
+
+            const double kb = (double)n - 2.*lo + 2.*mid - 2.*hi, pb = kb * b, eb = fma(kb, b, -pb);
+            const double kr = (double)n +    lo -    hi         , pr = kr * R, er = fma(kr, R, -pr);
+
+            double fSum = 0., fComp = 0.;
+            for (const double x : { 2.*P[lo], 2.*PC[lo], -2.*P[mid], -2.*PC[mid], 2.*P[hi], 2.*PC[hi], -P[n], -PC[n], pb, eb, pr, er })
+                AddCompensated(fSum, fComp, x);
+            fSum += fComp;
+
+                 if (fSum == fMinSum) { CIRC_COUNT(CircSite::CircMedian, Ties, 1); X.emplace_back(b); }
+            else if (fSum <  fMinSum) { X.clear(); X.emplace_back(b); fMinSum = fSum; }
+        }
+    }
+    else
+        for (size_t j = 0; j < B.size(); ++j)
+        {
+            if (fSweepSum[j] > fMinSweepSum + fTol)
+                continue;
+
+            CIRC_COUNT(CircSite::CircMedian, Refined, 1);
+            double fSum = 0.;           // sum(|Sdist(a, b)|)
+            for (const auto& a : A)
+                fSum += abs(CircVal<T>::Sdist(B[j], a));
+
+                 if (fSum == fMinSum) { CIRC_COUNT(CircSite::CircMedian, Ties, 1); X.emplace_back(B[j]); }
+            else if (fSum <  fMinSum) { X.clear(); X.emplace_back(B[j]); fMinSum = fSum; }
+        }
+
+    // ----------------------------------------------
+    CIRC_PHASE_NEXT(Result);
+    return CopyResultSet<T>(X, Out);
+}
+
+// calculate median set of circular values
+// return set of median values
+// T is a circular value type defined with the CircValTypeDef macro
+// C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+template<CircValue C, typename T = typename C::CircType>
+set<CircVal<T, CircValueStorage_t<C>>> CircMedian(vector<C> const& A)
+{
+    CircStatWorkspace                      W;
+    set<CircVal<T, CircValueStorage_t<C>>> X;
+    CircMedian(span<const C>(A), W, inserter(X, X.end()));
+    return X;
+}
+
+// ==========================================================================
+// calculate weighted-median set of circular values
+// write set of weighted-median values (ascending, no duplicates) to Out. return Out past the last written value
+// T is a circular value type defined with the CircValTypeDef macro
+// C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+// Wt are the (non-negative) weights of A
+//
+// the weighted median minimizes sum(Wi*|Sdist(x, Ai)|). the sum is piecewise linear in x, and its minimum is attained
+// at a value, or - when the weights on both sides are balanced - on the whole arc between two circular-consecutive
+// values. candidates are the values, and the circular mid-points of consecutive values (as in CircMedian); the result
+// is the set of minimal candidates, so a minimal arc contributes its end values and its mid-point. for an odd count of
+// unit weights, the same set as CircMedian when the sums are exact (rounded sums may resolve near-ties differently).
+// same single sweep and exact re-evaluation as CircMedian, with prefix sums of Wi and Wi*Ai: O(n log n). the result
+// set (ties included) is identical to WeightedCircMedianBruteForce. beyond CircMedianMaxRefined near-minimal
+// candidates, the set of medians of the exact sums, as in CircMedian - identical for integer values and weights; for
+// non-integer ones, each median is within the rounding errors of the brute-force minimum, and the set may differ
+template<CircValue C, typename OutIter, typename T = typename C::CircType>
+OutIter WeightedCircMedian(span<const C> A, span<const double> Wt, CircStatWorkspace& W, OutIter Out)
+{
+    assert(A.size() == Wt.size());
+
+    vector<double>& X = W.Results;      // results set
+    X.clear();
+
+    const size_t n = A.size();
+    if (n == 0)
+        return Out;
+
+    CIRC_PHASE_START(CircSite::WeightedCircMedian, Convert);
+    CIRC_COUNT(CircSite::WeightedCircMedian, Elements, n);
+
+    // ----------------------------------------------
+    vector<double>& S = W.SortedVals ;  // A, ascendingly sorted
+    vector<double>& P = W.SortedWghts;  // weights, in the same order
+    S.resize(n);
+    P.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert(Wt[i] >= 0.);
+        S[i] = CircVal<T>(A[i]);
+        P[i] = Wt[i];
+    }
+
+    CIRC_PHASE_NEXT(Sort);
+    SortWeighted(span<double>(S), span<double>(P), W);
+
+    // merge equal values: u distinct values, with the sum of their weights
+    size_t u = 0;
+    for (size_t i = 0; i < n; ++i)
+        if (u > 0 && S[i] == S[u-1]) P[u-1] += P[i];
+        else                       { S[u] = S[i]; P[u] = P[i]; ++u; }
+
+    // ----------------------------------------------
+    CIRC_PHASE_NEXT(Sweep);
+    vector<double>& B = W.Candidates;   // candidates, ascendingly sorted, no duplicates
+    B.assign(S.begin(), S.begin() + u);
+
+    if (u > 1)
+        for (size_t m = 0; m < u; ++m)
+        {
+            size_t k = m+1; if (k == u) k = 0;
+            double d = CircVal<T>::Sdist(S[m], S[k]);
+
+            // insert average set of each two circular-consecutive values
+            B.emplace_back(CircVal<T>::Wrap(S[m] + d / 2.));
+            if (d == -CircVal<T>::GetR() / 2.)
+                B.emplace_back(CircVal<T>::Wrap(S[k] + d / 2.));
+        }
+
+    SortValues(B, W.RadixTmpK);
+    B.erase(unique(B.begin(), B.end()), B.end());
+    CIRC_COUNT(CircSite::WeightedCircMedian, Candidates, B.size());
+
+    // ----------------------------------------------
+    // prefix sums of the sorted values: PW[i] + PWC[i] = W[0] + ... + W[i-1], PWS[i] + PWSC[i] = W[0]*S[0] + ... + W[i-1]*S[i-1]
+    // compensated (Neumaier) summation of the exact products - each prefix sum is accurate to a single rounding, the pair to about eps^2
+    vector<double>& PW   = W.PrefixSums  ;
+    vector<double>& PWS  = W.PrefixSums2 ;
+    vector<double>& PWC  = W.PrefixComps ;
+    vector<double>& PWSC = W.PrefixComps2;
+    PW  .resize(u+1);
+    PWS .resize(u+1);
+    PWC .resize(u+1);
+    PWSC.resize(u+1);
+    PW[0] = PWS[0] = PWC[0] = PWSC[0] = 0.;
+
+    double fMaxW = 0.; // maximal weight
+    for (size_t i = 0; i < u; ++i)
+    {
+        const double ws = P[i] * S[i];
+        PW [i+1] = PW [i]; PWC [i+1] = PWC [i];
+        PWS[i+1] = PWS[i]; PWSC[i+1] = PWSC[i] + fma(P[i], S[i], -ws);
+        AddCompensated(PW [i+1], PWC [i+1], P[i]);
+        AddCompensated(PWS[i+1], PWSC[i+1], ws  );
+        fMaxW = __max(fMaxW, P[i]);
+    }
+
+    auto PWv  = [&](size_t i) { return PW [i] + PWC [i]; };
+    auto PWSv = [&](size_t i) { return PWS[i] + PWSC[i]; };
+
+    // sweep the candidates (ascending) - the sectors of CircMedian, each value weighted:
+    // [0  ,lo ): S[i] <  b-R/2   dist = S[i]+R-b
+    // [lo ,mid): S[i] <  b       dist = b-S[i]
+    // [mid,hi ): S[i] <= b+R/2   dist = S[i]-b
+    // [hi ,u  ):                 dist = b+R-S[i]
+    const double R  = CircVal<T>::GetR();
+    const double R2 = R / 2.;
+
+    vector<double>& fSweepSum    = W.SweepSums; // sum(Wi*|Sdist(b, Ai)|) for each candidate
+    double          fMinSweepSum = numeric_limits<double>::max();
+    fSweepSum.resize(B.size());
+
+    size_t lo = 0, mid = 0, hi = 0;
+    for (size_t j = 0; j < B.size(); ++j)
+    {
+        const double b = B[j];
+        while (lo  < u && S[lo ] <  b - R2) ++lo ;
+        while (mid < u && S[mid] <  b     ) ++mid;
+        while (hi  < u && S[hi ] <= b + R2) ++hi ;
+
+        fSweepSum[j] =  PWSv(lo)             + PWv(lo)             * (R - b)
+                     + (PWv (mid) - PWv (lo)) * b - (PWSv(mid) - PWSv(lo))
+                     + (PWSv(hi ) - PWSv(mid)) - (PWv (hi ) - PWv (mid)) * b
+                     + (PWv (u  ) - PWv (hi)) * (b + R) - (PWSv(u) - PWSv(hi));
+
+        fMinSweepSum = __min(fMinSweepSum, fSweepSum[j]);
+    }
+
+    // bound of the rounding errors of both the swept sums and the direct sums - the bound of CircMedian, for terms
+    // of at most fMaxW*M
+    const double fEps = numeric_limits<double>::epsilon();
+    const double M    = __max(abs(CircVal<T>::GetL()), abs(CircVal<T>::GetH())) + R;
+    const double fTol = (n + 2) * fEps * fMinSweepSum + 16. * n * fEps * M * fMaxW;
+
+    // ----------------------------------------------
+    // re-evaluate the near-minimal candidates exactly as WeightedCircMedianBruteForce does
+    CIRC_PHASE_NEXT(Refine);
+    double fMinSum = numeric_limits<double>::max();
+
+    const size_t nNear = count_if(fSweepSum.begin(), fSweepSum.end(), [&](double f) { return f <= fMinSweepSum + fTol; });
+    if (nNear > CircMedianMaxRefined)
+    {
+        // a flat part of the sum - see CircMedian: 2PWS[lo] - 2PWS[mid] + 2PWS[hi] - PWS[u] + (PW[u]-2PW[lo]+2PW[mid]-2PW[hi])*b
+        // + (PW[u]+PW[lo]-PW[hi])*R, summed by the prefix sums and their compensations, and the exact products
+        for (size_t j = 0; j < B.size(); ++j)
+        {
+            if (fSweepSum[j] > fMinSweepSum + fTol)
+                continue;
+
+            const double b   = B[j];
+            const size_t lo  = lower_bound(S.begin(), S.begin() + u, b - R2) - S.begin();
+            const size_t mid = lower_bound(S.begin(), S.begin() + u, b     ) - S.begin();
+            const size_t hi  = upper_bound(S.begin(), S.begin() + u, b + R2) - S.begin();
+
+            double kb = 0., kbComp = 0.; // coefficient of b
+            for (const double x : { PW[u], PWC[u], -2.*PW[lo], -2.*PWC[lo], 2.*PW[mid], 2.*PWC[mid], -2.*PW[hi], -2.*PWC[hi] })
+                AddCompensated(kb, kbComp, x);
+
+            double kr = 0., krComp = 0.; // coefficient of R
+            for (const double x : { PW[u], PWC[u], PW[lo], PWC[lo], -PW[hi], -PWC[hi] })
+                AddCompensated(kr, krComp, x);
+
+            const double pb = kb * b, eb = fma(kb, b, -pb);
+            const double pr = kr * R, er = fma(kr, R, -pr);
+
+            double fSum = 0., fComp = 0.;
+            for (const double x : { 2.*PWS[lo], 2.*PWSC[lo], -2.*PWS[mid], -2.*PWSC[mid], 2.*PWS[hi], 2.*PWSC[hi], -PWS[u], -PWSC[u],
+                                    pb, eb, kbComp * b, pr, er, krComp * R })
+                AddCompensated(fSum, fComp, x);
+            fSum += fComp;
+
+                 if (fSum == fMinSum) { CIRC_COUNT(CircSite::WeightedCircMedian, Ties, 1); X.emplace_back(b); }
+            else if (fSum <  fMinSum) { X.clear(); X.emplace_back(b); fMinSum = fSum; }
+        }
+    }
+    else
+        for (size_t j = 0; j < B.size(); ++j)
+        {
+            if (fSweepSum[j] > fMinSweepSum + fTol)
+                continue;
+
+            CIRC_COUNT(CircSite::WeightedCircMedian, Refined, 1);
+            double fSum = 0.;           // sum(Wi*|Sdist(b, Ai)|)
+            for (size_t i = 0; i < n; ++i)
+                fSum += Wt[i] * abs(CircVal<T>::Sdist(B[j], A[i]));
+
+                 if (fSum == fMinSum) { CIRC_COUNT(CircSite::WeightedCircMedian, Ties, 1); X.emplace_back(B[j]); }
+            else if (fSum <  fMinSum) { X.clear(); X.emplace_back(B[j]); fMinSum = fSum; }
+        }
+
+    // ----------------------------------------------
+    CIRC_PHASE_NEXT(Result);
+    return CopyResultSet<T>(X, Out);
+}
+
+// calculate weighted-median set of circular values
+// return set of weighted-median values
+// T is a circular value type defined with the CircValTypeDef macro
+// C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+template<CircValue C, typename T = typename C::CircType>
+set<CircVal<T, CircValueStorage_t<C>>> WeightedCircMedian(vector<C> const& A, vector<double> const& Wt)
+{
+    CircStatWorkspace                      W;
+    set<CircVal<T, CircValueStorage_t<C>>> X;
+    WeightedCircMedian(span<const C>(A), span<const double>(Wt), W, inserter(X, X.end()));
+    return X;
+}
+
+// ==========================================================================
+// calculate median set of circular values - by testing each candidate against all values: O(n^2)
+// return set of median values
+// identical to CircMedian. kept as reference implementation for testing and benchmarking
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T>
+set<CircVal<T>> CircMedianBruteForce(vector<CircVal<T>> const& A)
+{
+    set <CircVal<T>> X;           // results set
+
+    // ----------------------------------------------
+    set<CircVal<T>> B;
+    if (A.size() % 2 == 0)        // even number of values
+    {
+        auto S = A;
+        sort(S.begin(), S.end()); // A, sorted
+
+        for (size_t m = 0; m < S.size(); ++m)
+        {
+            size_t n = m+1; if (n == S.size()) n = 0;
+            double d = CircVal<T>::Sdist(S[m], S[n]);
+
+            // insert average set of each two circular-consecutive values
+            B.emplace((double)S[m] + d / 2.);
+            if (d == -CircVal<T>::GetR() / 2.)
+                B.emplace((double)S[n] + d / 2.);
+        }
+    }
+    else                          // odd number of values
+        for (size_t m = 0; m < A.size(); ++m)
+            B.emplace(A[m]);      // convert vector to set - remove duplicates
+
+    // ----------------------------------------------
+    double fMinSum = numeric_limits<double>::max();
+
+    for (const auto& b : B)
+    {
+        double fSum = 0.;         // sum(|Sdist(a, b)|)
+        for (const auto& a : A)
+            fSum += abs(CircVal<T>::Sdist(b, a));
+
+             if (fSum == fMinSum)              X.emplace(b);
+        else if (fSum <  fMinSum) { X.clear(); X.emplace(b); fMinSum = fSum; }
+    }
+
+    // ----------------------------------------------
+    return X;
+}
+
+// ==========================================================================
+// calculate weighted-median set of circular values - by testing each candidate against all values: O(n^2)
+// return set of weighted-median values
+// identical to WeightedCircMedian. kept as reference implementation for testing and benchmarking
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T>
+set<CircVal<T>> WeightedCircMedianBruteForce(vector<CircVal<T>> const& A, vector<double> const& Wt)
+{
+    set <CircVal<T>> X;           // results set
+
+    // ----------------------------------------------
+    set<CircVal<T>>          B(A.begin(), A.end()); // candidates: the values (no duplicates), and their mid-points
+    const vector<CircVal<T>> S(B.begin(), B.end()); // distinct values, sorted
+
+    for (size_t m = 0; S.size() > 1 && m < S.size(); ++m)
+    {
+        size_t n = m+1; if (n == S.size()) n = 0;
+        double d = CircVal<T>::Sdist(S[m], S[n]);
+
+        // insert average set of each two circular-consecutive values
+        B.emplace((double)S[m] + d / 2.);
+        if (d == -CircVal<T>::GetR() / 2.)
+            B.emplace((double)S[n] + d / 2.);
+    }
+
+    // ----------------------------------------------
+    double fMinSum = numeric_limits<double>::max();
+
+    for (const auto& b : B)
+    {
+        double fSum = 0.;         // sum(Wi*|Sdist(b, Ai)|)
+        for (size_t i = 0; i < A.size(); ++i)
+            fSum += Wt[i] * abs(CircVal<T>::Sdist(b, A[i]));
+
+             if (fSum == fMinSum)              X.emplace(b);
+        else if (fSum <  fMinSum) { X.clear(); X.emplace(b); fMinSum = fSum; }
+    }
+
+    // ----------------------------------------------
+    return X;
+}
+
+// ==========================================================================
+// weighted median of the samples of a sliding window of a sampled circular signal
+// T is a circular value type defined with the CircValTypeDef macro
+//
+// the window keeps the samples in time order; the oldest samples (front) are evicted when they are older than
+// fWindow time units or when there are more than nMaxSamples samples, and samples can also be evicted from the front
+// or the back explicitly, by time or by count.
+// the median M is tracked incrementally: the samples are split into two ordered half circles around M - the samples
+// behind M (M-R/2, M] and the samples ahead of M (M, M+R/2] - with the sums of their weights. after a sample is added
+// or evicted, M moves to the next sample ahead or to the previous one while sum(Wi*|Sdist(x, Ai)|) decreases - its
+// change is the slope at M (the difference of the two sums) times the distance, corrected for the samples whose
+// opposite point is crossed - and the samples that cross M or its opposite point move between the half circles:
+// O(log n) per sample, when M moves by a few samples. in the worst case M moves across the window: O(n) steps, each
+// O(log n) and the samples whose opposite point it crosses - O(n) per update or more, n the samples of the window.
+// the tracked median is a value of the window at which the sum is locally minimal - one of the weighted-median set
+// when the samples of the window lie within a half circle (the sum is convex there), the typical case of a filtered
+// heading. GetMedian returns it then: O(log n). otherwise - a local minimum need not be a global one - GetMedian
+// returns the value of the weighted-median set of the window (WeightedCircMedian) nearest to it: O(n log n).
+// GetMedianSet calculates the exact weighted-median set of the window (WeightedCircMedian): O(n log n).
+// AddMeasurement and GetMedian are used as AddMeasurement and GetAvrg of CAvrgSampledCircSignal
+template<typename T>
+class CMedianSampledCircSignal
+{
+    using Key  = pair<double, double>; // <value,weight>
+    using Keys = multiset<Key>;
+
+    struct Sample
+    {
+        double fVal   ; // the range of T [L,H)
+        double fWeight;
+        double fTime  ;
+    };
+
+    // the samples of a half circle around the median
+    struct HalfCircle
+    {
+        Keys   Vals     ; // <value,weight>, ascending
+        double fSumW    ; // sum of the weights
+        double fSumWComp; // compensation of fSumW
+
+        HalfCircle() : fSumW(0.), fSumWComp(0.) {}
+
+        double SumW() const { return fSumW + fSumWComp; }
+
+        void Insert(const Key& k)
+        {
+            Vals.insert(k);
+            AddCompensated(fSumW, fSumWComp, k.second);
+        }
+
+        Keys::iterator Erase(Keys::iterator it)
+        {
+            AddCompensated(fSumW, fSumWComp, -it->second);
+            it = Vals.erase(it);
+            if (Vals.empty())
+                fSumW = fSumWComp = 0.;
+            return it;
+        }
+    };
+
+    static constexpr double fInf = numeric_limits<double>::infinity();
+
+    double                           m_fWindow    ; // window duration
+    size_t                           m_nMaxSamples; // window: max number of samples
+    deque<Sample>                    m_Window     ; // samples, in time order
+    HalfCircle                       m_Behind     ; // samples in (M-R/2, M]
+    HalfCircle                       m_Ahead      ; // samples in (M, M+R/2]
+    double                           m_fMedian    ; // M: the tracked median
+
+    CircStatWorkspace                m_W          ; // GetMedianSet: reused by WeightedCircMedian
+    vector<CircVal<T>>               m_Vals       ; // GetMedianSet: values  of the window
+    vector<double>                   m_Wghts      ; // GetMedianSet: weights of the window
+    vector<CircVal<T>>               m_MedSet     ; // GetMedian   : the weighted-median set of a window wider than a half circle
+
+    // v is ahead of c: Sdist(c, v) in (0, R/2), or v is opposite to c
+    static bool IsAhead(double v, double c)
+    {
+        const double d = CircVal<T>::Sdist(c, v);
+        return d > 0. || d == -T::R_2;
+    }
+
+    // circular iteration over the values of a half circle, ascending. K is not empty
+    static Keys::iterator Next  (Keys& K, Keys::iterator it) { return ++it == K.end() ? K.begin() : it; }                                          // next value
+    static Keys::iterator Prev  (Keys& K, Keys::iterator it) { return --(it == K.begin() ? K.end() : it); }                                        // previous value
+    static Keys::iterator After (Keys& K, double c)          { auto it = K.upper_bound(Key(c, fInf)); return it == K.end() ? K.begin() : it; } // first value after c
+    static Keys::iterator Before(Keys& K, double c)          { return Prev(K, K.lower_bound(Key(c, -fInf))); }                                 // last value before c
+
+    // move the samples of From to To while they are (bAhead) / are not (!bAhead) ahead of M - starting at the first
+    // value after cPrev (bForward), or at the last value at or before cPrev (!bForward)
+    void MoveWhile(HalfCircle& From, HalfCircle& To, bool bAhead, bool bForward, double cPrev)
+    {
+        if (From.Vals.empty())
+            return;
+
+        auto it = bForward ? After(From.Vals, cPrev) : Prev(From.Vals, From.Vals.upper_bound(Key(cPrev, fInf)));
+        while (IsAhead(it->first, m_fMedian) == bAhead)
+        {
+            To.Insert(*it);
+            it = From.Erase(it);
+            if (From.Vals.empty())
+                return;
+
+            it = bForward ? (it == From.Vals.end() ? From.Vals.begin() : it) : Prev(From.Vals, it);
+        }
+    }
+
+    // move M to c, and the samples that cross M or its opposite point between the half circles
+    // forward: the far end of Behind becomes ahead, then the near end of Ahead becomes behind. backward: the far end
+    // of Ahead becomes behind, then the near end of Behind becomes ahead
+    void MoveMedian(double c)
+    {
+        const double cPrev = m_fMedian;
+        const double d     = CircVal<T>::Sdist(cPrev, c);
+        m_fMedian = c;
+
+        if (d > 0. || d == -T::R_2)
+        {
+            MoveWhile(m_Behind, m_Ahead , true , true , cPrev);
+            MoveWhile(m_Ahead , m_Behind, false, true , cPrev);
+        }
+        else
+        {
+            MoveWhile(m_Ahead , m_Behind, false, false, cPrev);
+            MoveWhile(m_Behind, m_Ahead , true , false, cPrev);
+        }
+    }
+
+    // forward distance from M to v: [0,R)
+    double Fwd(double v) const
+    {
+        const double d = CircVal<T>::Sdist(m_fMedian, v);
+        return d < 0. ? d + T::R : d;
+    }
+
+    // change of the sum when M moves forward by d to the next sample ahead: the slope ahead of M (sum of Behind - sum
+    // of Ahead), and -2*w*(d-x) for each sample behind whose opposite point is crossed at x < d
+    double SumChangeAhead(double d)
+    {
+        double f = (m_Behind.SumW() - m_Ahead.SumW()) * d;
+
+        if (m_Behind.Vals.empty())
+            return f;
+
+        auto it = After(m_Behind.Vals, m_fMedian); // the farthest samples behind first
+        for (size_t k = m_Behind.Vals.size(); k-- && it->first != m_fMedian; it = Next(m_Behind.Vals, it))
+        {
+            const double x = Fwd(it->first) - T::R_2;
+            if (x >= d)
+                break;
+            f -= 2. * it->second * (d - x);
+        }
+        return f;
+    }
+
+    // change of the sum when M moves backward by d to the previous sample: the slope behind of M (the slope ahead
+    // - 2*(weight at M) + 2*(weight opposite to M)), and -2*w*(d-x) for each sample ahead whose opposite point is
+    // crossed at x < d
+    double SumChangeBehind(double d)
+    {
+        double fSlope = m_Behind.SumW() - m_Ahead.SumW();
+        for (auto it = m_Behind.Vals.lower_bound(Key(m_fMedian, -fInf)); it != m_Behind.Vals.end() && it->first == m_fMedian; ++it)
+            fSlope -= 2. * it->second;
+
+        double f = 0.;
+        auto   it = m_Ahead.Vals.empty() ? m_Ahead.Vals.end() : Before(m_Ahead.Vals, m_fMedian); // the farthest samples ahead first
+        for (size_t k = m_Ahead.Vals.size(); k--; it = Prev(m_Ahead.Vals, it))
+        {
+            const double x = T::R_2 - Fwd(it->first);
+            if (x == 0.)
+                fSlope += 2. * it->second;           // opposite to M
+            else if (x < d)
+                f -= 2. * it->second * (d - x);
+            else
+                break;
+        }
+        return f - fSlope * d;
+    }
+
+    // move M to the next sample ahead or to the previous sample while the sum decreases, until the sum at M is not
+    // greater than at both - a local minimum, since between consecutive samples the sum is concave.
+    // the sum decreases in each step - at most one step per sample, and one more if M is not a sample (evicted)
+    void Rebalance()
+    {
+        for (size_t nSteps = m_Window.size() + 1; nSteps--;)
+        {
+            if (m_Window.empty())
+                return;
+
+            // next sample: the first one ahead of M
+            const bool   bNext       = !m_Ahead.Vals.empty();
+            const double fNext       = bNext ? After(m_Ahead.Vals, m_fMedian)->first : m_fMedian;
+            const double fNextChange = bNext ? SumChangeAhead(Fwd(fNext))             : fInf;
+
+            // previous sample: the last one behind M, or - if all the samples behind are at M - the farthest ahead
+            double fPrev = m_fMedian;
+            if (!m_Behind.Vals.empty())
+                fPrev = Before(m_Behind.Vals, m_fMedian)->first;
+            if (fPrev == m_fMedian && !m_Ahead.Vals.empty())
+                fPrev = Before(m_Ahead.Vals, m_fMedian)->first;
+
+            const bool   bPrev       = fPrev != m_fMedian;
+            const double fPrevChange = bPrev ? SumChangeBehind(T::R - Fwd(fPrev)) : fInf;
+
+            // M is not a sample: move to the neighbor with the lower sum
+            const bool bAtSample = IsAtSample();
+                 if (bNext && (fNextChange < 0. || !bAtSample) && fNextChange <= fPrevChange) MoveMedian(fNext);
+            else if (bPrev && (fPrevChange < 0. || !bAtSample)                              ) MoveMedian(fPrev);
+            else
+                return;
+        }
+    }
+
+    // the samples of the window lie within a half circle: the arc from the farthest sample behind M to the farthest
+    // sample ahead of M is not longer than R/2
+    bool IsWithinHalfCircle() const
+    {
+        double fArc = 0.;
+        if (!m_Behind.Vals.empty())
+        {
+            auto it = m_Behind.Vals.upper_bound(Key(m_fMedian, fInf)); // the farthest sample behind: the first after M
+            if (it == m_Behind.Vals.end())
+                it = m_Behind.Vals.begin();
+            if (it->first != m_fMedian)
+                fArc += T::R - Fwd(it->first);
+        }
+
+        if (!m_Ahead.Vals.empty())
+        {
+            auto it = m_Ahead.Vals.lower_bound(Key(m_fMedian, -fInf)); // the farthest sample ahead: the last before M
+            if (it == m_Ahead.Vals.begin())
+                it = m_Ahead.Vals.end();
+            fArc += Fwd((--it)->first);
+        }
+
+        return fArc <= T::R_2;
+    }
+
+    // a sample is at M
+    bool IsAtSample() const
+    {
+        const auto it = m_Behind.Vals.lower_bound(Key(m_fMedian, -fInf));
+        return it != m_Behind.Vals.end() && it->first == m_fMedian;
+    }
+
+    void Insert(const Sample& S)
+    {
+        (IsAhead(S.fVal, m_fMedian) ? m_Ahead : m_Behind).Insert(Key(S.fVal, S.fWeight));
+    }
+
+    // the sample is in the half circle of its Sdist from M - or, rounded at the opposite point, in the other one
+    void Erase(const Sample& S)
+    {
+        const Key   k  = Key(S.fVal, S.fWeight);
+        HalfCircle* H  = IsAhead(S.fVal, m_fMedian) ? &m_Ahead : &m_Behind;
+        auto        it = H->Vals.find(k);
+        if (it == H->Vals.end())
+        {
+            H  = (H == &m_Ahead) ? &m_Behind : &m_Ahead;
+            it = H->Vals.find(k);
+        }
+
+        assert(it != H->Vals.end());
+        H->Erase(it);
+    }
+
+    void EvictOld(double fTime)
+    {
+        while (!m_Window.empty() && (m_Window.size() > m_nMaxSamples || m_Window.front().fTime <= fTime - m_fWindow))
+        {
+            Erase(m_Window.front());
+            m_Window.pop_front();
+        }
+    }
+
+public:
+    // fWindow    : duration of the window
+    // nMaxSamples: max number of samples in the window
+    explicit CMedianSampledCircSignal(double fWindow = numeric_limits<double>::infinity(), size_t nMaxSamples = numeric_limits<size_t>::max())
+    {
+        assert(fWindow > 0. && nMaxSamples > 0);
+
+        m_fWindow     = fWindow    ;
+        m_nMaxSamples = nMaxSamples;
+        m_fMedian     = CircVal<T>::GetZ();
+    }
+
+    // add a sample, weighted by fWeight, and evict the samples that leave the window
+    void AddMeasurement(CircVal<T> C, double fTime, double fWeight = 1.)
+    {
+        assert(m_Window.empty() || fTime > m_Window.back().fTime);
+        assert(fWeight >= 0.);
+
+        const Sample S = { (double)C, fWeight, fTime };
+        if (m_Window.empty())
+            m_fMedian = S.fVal;
+
+        m_Window.push_back(S);
+        Insert(S);
+        EvictOld(fTime);
+        Rebalance();
+    }
+
+    // evict the n oldest samples (left of the window)
+    void PopFront(size_t n = 1)
+    {
+        for (; n && !m_Window.empty(); --n)
+        {
+            Erase(m_Window.front());
+            m_Window.pop_front();
+        }
+        Rebalance();
+    }
+
+    // evict the n newest samples (right of the window)
+    void PopBack(size_t n = 1)
+    {
+        for (; n && !m_Window.empty(); --n)
+        {
+            Erase(m_Window.back());
+            m_Window.pop_back();
+        }
+        Rebalance();
+    }
+
+    // evict the samples at or before fTime (left of the window)
+    void EvictFront(double fTime)
+    {
+        while (!m_Window.empty() && m_Window.front().fTime <= fTime)
+        {
+            Erase(m_Window.front());
+            m_Window.pop_front();
+        }
+        Rebalance();
+    }
+
+    // evict the samples at or after fTime (right of the window)
+    void EvictBack(double fTime)
+    {
+        while (!m_Window.empty() && m_Window.back().fTime >= fTime)
+        {
+            Erase(m_Window.back());
+            m_Window.pop_back();
+        }
+        Rebalance();
+    }
+
+    // number of samples in the window
+    size_t GetSamples() const
+    {
+        return m_Window.size();
+    }
+
+    // a weighted median of the window: the tracked median if the samples lie within a half circle - O(log n);
+    // otherwise the value of the weighted-median set nearest to it - O(n log n). see above
+    bool GetMedian(CircVal<T>& Med)
+    {
+        if (m_Window.empty())
+        {
+            Med = CircVal<T>::GetZ();
+            return false;
+        }
+
+        Med = m_fMedian;
+        if (IsWithinHalfCircle())
+            return true;
+
+        m_MedSet.clear();
+        GetMedianSet(back_inserter(m_MedSet));
+        Med = m_MedSet.front();
+        for (const auto& c : m_MedSet)
+            if (abs(CircVal<T>::Sdist(m_fMedian, c)) < abs(CircVal<T>::Sdist(m_fMedian, Med)))
+                Med = c;
+
+        return true;
+    }
+
+    // calculate the weighted-median set of the window: write it (ascending, no duplicates) to Out, return Out past the
+    // last written value
+    template<typename OutIter>
+    OutIter GetMedianSet(OutIter Out)
+    {
+        m_Vals .clear();
+        m_Wghts.clear();
+        for (const auto& S : m_Window)
+        {
+            m_Vals .emplace_back(S.fVal   );
+            m_Wghts.emplace_back(S.fWeight);
+        }
+
+        return WeightedCircMedian(span<const CircVal<T>>(m_Vals), span<const double>(m_Wghts), m_W, Out);
+    }
+};
+
+// ==========================================================================
+// circular histogram: approximate average, median and quantiles of a huge stream of circular values, in O(bins) memory
+// the values are counted in nBins equal bins over [L,H); each bin also keeps the (compensated) sum of its values.
+// histograms of the same number of bins are mergeable - e.g. one histogram per thread or node, merged by Merge.
+//
+// approximate results - a single pass over the values:
+// GetAvrg and GetMedian represent the values of each bin by their mean. a bin that lies entirely on one side of a
+// candidate contributes exactly (the average: up to a constant), so only the bins containing the candidate (median)
+// and its antipode (both) add error. the error estimates (GetAvrgErrorEstimate, GetMedianErrorEstimate) are derived
+// from the bin width and the bin counts. they are not bounds: they consider only the minimum found, so they hold for
+// concentrated values (e.g. within a quarter circle), but not when a distant local minimum is nearly tied with it -
+// then the approximate result may be on the other side of the circle.
+// GetQuantile interpolates within a bin - its error is below the bin width.
+//
+// exact results - a second pass over the values:
+// GetAvrgBins, GetMedianBins, GetQuantileBins return the bins whose values (residents) are needed. collect them by
+// CollectResidents, then GetAvrgExact, GetMedianExact, GetQuantileExact run the exact algorithms on the residents
+// only, and represent all other bins by their means. the results equal those of CircAverage and CircMedian on all the
+// values, up to rounding of the sums.
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T>
+class CircHistogram
+{
+    struct Bin
+    {
+        uint64_t nCount = 0 ; // number of values
+        double   fSum   = 0.; // sum of (value - lower bound of bin)
+        double   fComp  = 0.; // compensation of fSum
+    };
+
+    vector<Bin> m_Bins  ;
+    double      m_fWidth; // bin width
+    uint64_t    m_nCount; // number of values
+
+    // ----------------------------------------------
+    size_t Next(size_t b, size_t k = 1) const { return (b + k                  ) % m_Bins.size(); } // k bins after  b, circularly
+    size_t Prev(size_t b, size_t k = 1) const { return (b + m_Bins.size() - k) % m_Bins.size(); } // k bins before b, circularly
+
+    // sum of counts of the k bins after b
+    uint64_t CountAfter(size_t b, size_t k) const
+    {
+        uint64_t n = 0;
+        for (size_t i = 1; i <= k; ++i)
+            n += m_Bins[Next(b, i)].nCount;
+        return n;
+    }
+
+    // mark the bins within fDist of c
+    void MarkNear(double c, double fDist, vector<bool>& Bins) const
+    {
+        const size_t b = GetBin(CircVal<T>(c));
+        const size_t k = (size_t)ceil(fDist / m_fWidth);
+        for (size_t i = 0; i <= k && i < m_Bins.size(); ++i)
+            Bins[Next(b, i)] = Bins[Prev(b, i)] = true;
+    }
+
+    // candidates of minimal sum(Wt[i]*|Sdist(b, X[i])|) - written to Res
+    // X - points, ascending, with weights Wt; B - candidates, ascending
+    // the sweep of CircMedian, with weights: the swept sums select the near-minimal candidates, which are re-evaluated
+    // directly
+    static void MinSumCandidates(vector<double> const& X, vector<double> const& Wt, vector<double> const& B, vector<double>& Res)
+    {
+        Res.clear();
+        const size_t n = X.size();
+
+        // prefix sums of the weights and of the weighted points
+        vector<double> PW(n+1), PX(n+1);
+        PW[0] = PX[0] = 0.;
+
+        double fCompW = 0., fCompX = 0.;
+        for (size_t i = 0; i < n; ++i)
+        {
+            PW[i+1] = PW[i]; AddCompensated(PW[i+1], fCompW, Wt[i]       );
+            PX[i+1] = PX[i]; AddCompensated(PX[i+1], fCompX, Wt[i] * X[i]);
+        }
+        PW[n] += fCompW;
+        PX[n] += fCompX;
+
+        // sectors of candidate b - see CircMedian
+        const double R  = CircVal<T>::GetR();
+        const double R2 = R / 2.;
+
+        vector<double> fSweepSum(B.size());
+        double         fMinSweepSum = numeric_limits<double>::max();
+
+        size_t lo = 0, mid = 0, hi = 0;
+        for (size_t j = 0; j < B.size(); ++j)
+        {
+            const double b = B[j];
+            while (lo  < n && X[lo ] <  b - R2) ++lo ;
+            while (mid < n && X[mid] <  b     ) ++mid;
+            while (hi  < n && X[hi ] <= b + R2) ++hi ;
+
+            fSweepSum[j] =  PX[lo]             + PW[lo]              * (R - b)
+                         + (PW[mid] - PW[lo])  * b - (PX[mid] - PX[lo])
+                         + (PX[hi]  - PX[mid]) - (PW[hi] - PW[mid])  * b
+                         + (PW[n]   - PW[hi])  * (b + R) - (PX[n] - PX[hi]);
+
+            fMinSweepSum = __min(fMinSweepSum, fSweepSum[j]);
+        }
+
+        // bound of the rounding errors - see CircMedian
+        const double fEps = numeric_limits<double>::epsilon();
+        const double M    = __max(abs(CircVal<T>::GetL()), abs(CircVal<T>::GetH())) + R;
+        const double fTol = (n + 2) * fEps * fMinSweepSum + 16. * PW[n] * fEps * M;
+
+        double fMinSum = numeric_limits<double>::max();
+        for (size_t j = 0; j < B.size(); ++j)
+        {
+            if (fSweepSum[j] > fMinSweepSum + fTol)
+                continue;
+
+            double fSum = 0.;
+            for (size_t i = 0; i < n; ++i)
+                fSum += Wt[i] * abs(CircVal<T>::Sdist(B[j], X[i]));
+
+                 if (fSum == fMinSum)                Res.emplace_back(B[j]);
+            else if (fSum <  fMinSum) { Res.clear(); Res.emplace_back(B[j]); fMinSum = fSum; }
+        }
+    }
+
+    // sorted residents of the marked bins. assert that all the values of the marked bins are present
+    vector<double> SortedResidents(span<const CircVal<T>> A, vector<bool> const& Bins) const
+    {
+        vector<double> S;
+        for (const auto& a : A)
+            if (Bins[GetBin(a)])
+                S.emplace_back(a);
+
+        [[maybe_unused]] uint64_t n = 0;
+        for (size_t b = 0; b < m_Bins.size(); ++b)
+            if (Bins[b])
+                n += m_Bins[b].nCount;
+        assert(S.size() == n); // all the residents of the marked bins - collected by CollectResidents
+
+        vector<double> Tmp;
+        SortValues(S, Tmp);
+        return S;
+    }
+
+    // minimal sum(|Sdist(b, Pi)|) candidates of B - for weighted points P <value,weight>, in any order
+    static vector<double> MinSumCandidates(vector<pair<double, double>>& P, vector<double> const& B)
+    {
+        CircStatWorkspace W;
+        SortWeighted(P, W);
+
+        vector<double> X(P.size()), Wt(P.size()), Res;
+        for (size_t i = 0; i < P.size(); ++i)
+        {
+            X [i] = P[i].first ;
+            Wt[i] = P[i].second;
+        }
+
+        MinSumCandidates(X, Wt, B, Res);
+        return Res;
+    }
+
+    // bins that may contain a local minimum of sum(|Sdist(m, Ai)|)
+    // at a local minimum m, at most half of the values are in (m, m+R/2), and at most half are in (m-R/2, m).
+    // for m in bin k, bins k+1..k+h-1 are in (m, m+R/2), and bins k-h+1..k-1 are in (m-R/2, m) - h= nBins/2
+    vector<bool> GetMedianCandidateBins() const
+    {
+        const size_t nBins = m_Bins.size();
+        const size_t h     = nBins / 2;
+
+        vector<bool> M(nBins);
+        uint64_t nPlus  = CountAfter(0      , h-1);           // bins    1..h-1
+        uint64_t nMinus = CountAfter(Prev(0, h), h-1);        // bins -h+1..-1
+        for (size_t k = 0; k < nBins; ++k)
+        {
+            M[k] = 2*nPlus <= m_nCount && 2*nMinus <= m_nCount;
+
+            // slide to k+1
+            if (h > 1)
+            {
+                nPlus  += m_Bins[Next(k, h)].nCount - m_Bins[Next(k)].nCount;
+                nMinus += m_Bins[k].nCount - m_Bins[Prev(k, h-1)].nCount;
+            }
+        }
+
+        return M;
+    }
+
+public:
+    explicit CircHistogram(size_t nBins = 360) : m_Bins(nBins), m_fWidth(CircVal<T>::GetR() / nBins), m_nCount(0)
+    {
+        assert(nBins >= 2);
+    }
+
+    void Clear()
+    {
+        m_Bins.assign(m_Bins.size(), Bin());
+        m_nCount = 0;
+    }
+
+    size_t   GetBins    (        ) const { return m_Bins.size();                      } // number of bins
+    uint64_t GetCount   (        ) const { return m_nCount;                           } // number of values
+    uint64_t GetCount   (size_t b) const { return m_Bins[b].nCount;                   } // number of values in bin b
+    double   GetBinWidth(        ) const { return m_fWidth;                           }
+    double   GetBinLow  (size_t b) const { return CircVal<T>::GetL() + b * m_fWidth;  } // lower bound of bin b
+
+    // mean of the values of (non-empty) bin b
+    double GetBinMean(size_t b) const
+    {
+        assert(m_Bins[b].nCount > 0);
+        const double fOffset = (m_Bins[b].fSum + m_Bins[b].fComp) / m_Bins[b].nCount;
+        return CircVal<T>::Wrap(GetBinLow(b) + std::clamp(fOffset, 0., m_fWidth));
+    }
+
+    // bin of circular value c
+    size_t GetBin(const CircVal<T>& c) const
+    {
+        const double v = c;
+        return min<size_t>((size_t)((v - CircVal<T>::GetL()) / m_fWidth), m_Bins.size() - 1);
+    }
+
+    // ----------------------------------------------
+    void Add(const CircVal<T>& c)
+    {
+        const size_t b = GetBin(c);
+        ++m_Bins[b].nCount;
+        AddCompensated(m_Bins[b].fSum, m_Bins[b].fComp, (double)c - GetBinLow(b));
+        ++m_nCount;
+    }
+
+    // C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+    template<CircValue C>
+    void Add(span<const C> A)
+    {
+        for (const auto& a : A)
+            Add(CircVal<T>(a));
+    }
+
+    // add the values of histogram H, of the same number of bins
+    // throws std::invalid_argument for a histogram of another number of bins
+    void Merge(const CircHistogram& H)
+    {
+        if (H.m_Bins.size() != m_Bins.size())
+            throw std::invalid_argument("CircHistogram of another number of bins");
+
+        for (size_t b = 0; b < m_Bins.size(); ++b)
+        {
+            m_Bins[b].nCount += H.m_Bins[b].nCount;
+            AddCompensated(m_Bins[b].fSum, m_Bins[b].fComp, H.m_Bins[b].fSum);
+            m_Bins[b].fComp  += H.m_Bins[b].fComp;
+        }
+
+        m_nCount += H.m_nCount;
+    }
+
+    // append the values of A that belong to the marked bins to Residents
+    // C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+    template<CircValue C>
+    void CollectResidents(span<const C> A, vector<bool> const& Bins, vector<CircVal<T>>& Residents) const
+    {
+        for (const auto& a : A)
+        {
+            const CircVal<T> c(a);
+            if (Bins[GetBin(c)])
+                Residents.emplace_back(c);
+        }
+    }
+
+    // ----------------------------------------------
+    // approximate average set - the weighted average of the bin means
+    set<CircVal<T>> GetAvrg() const
+    {
+        if (m_nCount == 0)
+            return {};
+
+        vector<pair<CircVal<T>, double>> A;
+        for (size_t b = 0; b < m_Bins.size(); ++b)
+            if (m_Bins[b].nCount)
+                A.emplace_back(GetBinMean(b), (double)m_Bins[b].nCount);
+
+        return WeightedCircAverage(A);
+    }
+
+    // estimate of the distance between the approximate and the exact average - concentrated values only, see above
+    // of the values near the antipode of the average, some are represented on the wrong side - each moves the
+    // average by up to R/n. estimate: R * (count of the bins within one bin of the antipodes) / n
+    double GetAvrgErrorEstimate() const
+    {
+        if (m_nCount == 0)
+            return 0.;
+
+        vector<bool> Bins(m_Bins.size());
+        for (const auto& a : GetAvrg())
+            MarkNear((double)a + CircVal<T>::GetR() / 2., m_fWidth, Bins);
+
+        uint64_t k = 0;
+        for (size_t b = 0; b < m_Bins.size(); ++b)
+            if (Bins[b])
+                k += m_Bins[b].nCount;
+
+        return CircVal<T>::GetR() * k / m_nCount;
+    }
+
+    // bins needed for the exact average: the bins within the error estimate (and one bin) of the antipodes of the
+    // approximate averages - which contain the antipodes of the exact averages
+    vector<bool> GetAvrgBins() const
+    {
+        vector<bool> Bins(m_Bins.size());
+        const double fDist = GetAvrgErrorEstimate() + m_fWidth;
+        for (const auto& a : GetAvrg())
+            MarkNear((double)a + CircVal<T>::GetR() / 2., fDist, Bins);
+
+        return Bins;
+    }
+
+    // exact average set, given the residents of GetAvrgBins() (values of other bins are ignored)
+    // the bins whose values are all on one side of the antipodes of the averages are represented by their means:
+    // sum(dist(x, Ai)^2) changes only by the constant sum of squares within these bins
+    set<CircVal<T>> GetAvrgExact(span<const CircVal<T>> Residents) const
+    {
+        const vector<bool>   Bins = GetAvrgBins();
+        const vector<double> S    = SortedResidents(Residents, Bins);
+
+        vector<pair<CircVal<T>, double>> A;
+        for (size_t b = 0; b < m_Bins.size(); ++b)
+            if (!Bins[b] && m_Bins[b].nCount)
+                A.emplace_back(GetBinMean(b), (double)m_Bins[b].nCount);
+
+        for (const auto& s : S)
+            A.emplace_back(s, 1.);
+
+        return WeightedCircAverage(A);
+    }
+
+    // ----------------------------------------------
+    // approximate median set - the weighted median of the bin means
+    set<CircVal<T>> GetMedian() const
+    {
+        vector<pair<double, double>> P;
+        for (size_t b = 0; b < m_Bins.size(); ++b)
+            if (m_Bins[b].nCount)
+                P.emplace_back(GetBinMean(b), (double)m_Bins[b].nCount);
+
+        vector<double> B(P.size());
+        for (size_t i = 0; i < P.size(); ++i)
+            B[i] = P[i].first;
+        sort(B.begin(), B.end());
+
+        const vector<double> Res = MinSumCandidates(P, B);
+        return set<CircVal<T>>(Res.begin(), Res.end());
+    }
+
+    // estimate of the distance between the approximate and the exact median - concentrated values only, see above
+    // the exact median is in a bin that passes the necessary condition of GetMedianBins - the distance to the far end of
+    // the run of such bins that contains the approximate median. another run may hold a nearly tied minimum
+    double GetMedianErrorEstimate() const
+    {
+        const vector<bool> M     = GetMedianCandidateBins();
+        const size_t       nBins = m_Bins.size();
+
+        double fBound = 0.;
+        for (const auto& m : GetMedian())
+        {
+            const size_t b = GetBin(m);
+            if (!M[b])
+            {
+                fBound = __max(fBound, m_fWidth);
+                continue;
+            }
+
+            size_t lo = 0, hi = 0; // number of candidate bins before / after b
+            while (lo < nBins && M[Prev(b, lo+1)]) ++lo;
+            while (hi < nBins && M[Next(b, hi+1)]) ++hi;
+            if (lo + hi + 1 >= nBins)
+                return CircVal<T>::GetR() / 2.;
+
+            const double fOffset = (double)m - GetBinLow(b);
+            fBound = __max(fBound, __max(fOffset + lo * m_fWidth, (hi + 1) * m_fWidth - fOffset));
+        }
+
+        return fBound;
+    }
+
+    // bins needed for the exact median: the bins that may contain a local minimum, their antipodal bins, and the
+    // nearest non-empty bins on both sides (the neighbors of the mid-point candidates)
+    vector<bool> GetMedianBins() const
+    {
+        const vector<bool> M     = GetMedianCandidateBins();
+        const size_t       nBins = m_Bins.size();
+        const size_t       h     = nBins / 2;
+
+        vector<bool> Bins(nBins);
+        for (size_t k = 0; k < nBins; ++k)
+        {
+            if (!M[k])
+                continue;
+
+            Bins[k] = Bins[Next(k, h)] = true;   // the antipode of bin k is in bins k+h (even nBins), k+h..k+h+1 (odd)
+            if (nBins % 2)
+                Bins[Next(k, h+1)] = true;
+
+            for (size_t i = 1; i < nBins; ++i)
+                if (m_Bins[Prev(k, i)].nCount) { Bins[Prev(k, i)] = true; break; }
+            for (size_t i = 1; i < nBins; ++i)
+                if (m_Bins[Next(k, i)].nCount) { Bins[Next(k, i)] = true; break; }
+        }
+
+        return Bins;
+    }
+
+    // exact median set, given the residents of GetMedianBins() (values of other bins are ignored)
+    // candidates as in CircMedian: the residents (odd count) or the mid-points of consecutive values (even count), in
+    // bins that may contain a local minimum. the bins that contain neither a candidate nor its antipode are represented
+    // by their means - their values are all on one side of the candidate
+    set<CircVal<T>> GetMedianExact(span<const CircVal<T>> Residents) const
+    {
+        const vector<bool>   M     = GetMedianCandidateBins();
+        const vector<bool>   Bins  = GetMedianBins();
+        const vector<double> S     = SortedResidents(Residents, Bins);
+        const size_t         nBins = m_Bins.size();
+        const size_t         n     = S.size();
+
+        // ----------------------------------------------
+        vector<double> B; // candidates
+        if (m_nCount % 2 == 0)
+        {
+            for (size_t m = 0; m < n; ++m)
+            {
+                const size_t k  = m+1 == n ? 0 : m+1;
+                const size_t bm = GetBin(S[m]);
+                const size_t bk = GetBin(S[k]);
+
+                // S[m], S[k] are consecutive values if the bins between them are empty
+                size_t nSteps = (bk + nBins - bm) % nBins;
+                if (k <= m && nSteps == 0)
+                    nSteps = nBins;
+                if (nSteps > 1 && CountAfter(bm, nSteps-1))
+                    continue;
+
+                const double d = CircVal<T>::Sdist(S[m], S[k]);
+                B.emplace_back(CircVal<T>::Wrap(S[m] + d / 2.));
+                if (d == -CircVal<T>::GetR() / 2.)
+                    B.emplace_back(CircVal<T>::Wrap(S[k] + d / 2.));
+            }
+        }
+        else
+            B = S;
+
+        erase_if(B, [&](double b) { return !M[GetBin(CircVal<T>(b))]; });
+        sort(B.begin(), B.end());
+        B.erase(unique(B.begin(), B.end()), B.end());
+
+        // ----------------------------------------------
+        // points: the residents, and the means of the other bins
+        vector<pair<double, double>> P;
+        for (const auto& s : S)
+            P.emplace_back(s, 1.);
+        for (size_t b = 0; b < nBins; ++b)
+            if (!Bins[b] && m_Bins[b].nCount)
+                P.emplace_back(GetBinMean(b), (double)m_Bins[b].nCount);
+
+        const vector<double> Res = MinSumCandidates(P, B);
+        return set<CircVal<T>>(Res.begin(), Res.end());
+    }
+
+    // ----------------------------------------------
+    // quantiles: the values are ordered counterclockwise, starting with the values of bin nOriginBin (e.g. the bin of the
+    // antipode of the median). the p-quantile (0 <= p <= 1) is the value of rank floor(p*(n-1)) in this order.
+    // an origin within a bin would need the residents of two bins
+
+    // bin of the p-quantile
+    size_t GetQuantileBin(double p, size_t nOriginBin) const
+    {
+        assert(m_nCount > 0 && p >= 0. && p <= 1.);
+        const uint64_t nRank = (uint64_t)(p * (m_nCount - 1));
+
+        uint64_t nCum = 0;
+        for (size_t i = 0; ; ++i)
+        {
+            const size_t b = Next(nOriginBin, i);
+            if (nCum + m_Bins[b].nCount > nRank)
+                return b;
+            nCum += m_Bins[b].nCount;
+        }
+    }
+
+    // bins needed for the exact p-quantile
+    vector<bool> GetQuantileBins(double p, size_t nOriginBin) const
+    {
+        vector<bool> Bins(m_Bins.size());
+        Bins[GetQuantileBin(p, nOriginBin)] = true;
+        return Bins;
+    }
+
+    // rank of the p-quantile within its bin
+    uint64_t GetQuantileRankInBin(double p, size_t nOriginBin) const
+    {
+        const size_t   nBin  = GetQuantileBin(p, nOriginBin);
+        const uint64_t nRank = (uint64_t)(p * (m_nCount - 1));
+
+        uint64_t nCum = 0;
+        for (size_t b = nOriginBin; b != nBin; b = Next(b))
+            nCum += m_Bins[b].nCount;
+
+        return nRank - nCum;
+    }
+
+    // approximate p-quantile - values are assumed to be uniformly distributed within the bin. error < bin width
+    CircVal<T> GetQuantile(double p, size_t nOriginBin) const
+    {
+        const size_t b = GetQuantileBin(p, nOriginBin);
+        return CircVal<T>::Wrap(GetBinLow(b) + m_fWidth * (GetQuantileRankInBin(p, nOriginBin) + 0.5) / m_Bins[b].nCount);
+    }
+
+    // exact p-quantile, given the residents of GetQuantileBins(p, nOriginBin) (values of other bins are ignored)
+    CircVal<T> GetQuantileExact(double p, size_t nOriginBin, span<const CircVal<T>> Residents) const
+    {
+        const vector<double> S = SortedResidents(Residents, GetQuantileBins(p, nOriginBin));
+        return CircVal<T>(S[GetQuantileRankInBin(p, nOriginBin)]);
+    }
+};
+
+// ==========================================================================
+// tester for CircStat functions
+template <typename Type>
+class CircStatTester
+{
+    // random set of circular values. if nLevels > 0, values are quantized to nLevels levels (duplicates and ties)
+    static vector<CircVal<Type>> RandomVals(std::default_random_engine& rand_engine, size_t nCount, unsigned nLevels)
+    {
+        std::uniform_real_distribution<double> c_uni_dist(Type::L, Type::H);
+        std::uniform_int_distribution <unsigned> q_uni_dist(0, nLevels ? nLevels-1 : 0);
+
+        vector<CircVal<Type>> A(nCount);
+        for (auto& a : A)
+            a = nLevels ? Type::L + q_uni_dist(rand_engine) * Type::R / nLevels : c_uni_dist(rand_engine);
+
+        return A;
+    }
+
+    // check if 2 sets of circular-values are almost equal
+    static bool IsCircSetAlmostEq(const set<CircVal<Type>>& S1, const set<CircVal<Type>>& S2)
+    {
+        if (S1.size() != S2.size())
+            return false;
+
+        for (const auto& c1 : S1)
+            if (none_of(S2.begin(), S2.end(), [&](const CircVal<Type>& c2) { return abs(CircVal<Type>::Sdist(c1, c2)) < 1e-9 * Type::R; }))
+                return false;
+
+        return true;
+    }
+
+    // check if all values are integers - all sums are exact (the algorithms run in the units of Type)
+    static bool IsExactVals(const vector<CircVal<Type>>& A)
+    {
+        return all_of(A.begin(), A.end(), [](const CircVal<Type>& c) { const double v = c; return floor(v) == v; });
+    }
+
+public:
+    CircStatTester()
+    {
+        Test();
+    }
+
+    static void Test()
+    {
+        std::default_random_engine rand_engine;
+        std::random_device         rnd_device ;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        CircStatWorkspace              W   ; // reused across iterations - results must not depend on previous calls
+        vector<CircVal<Type>>          Res ; // results written through an output iterator
+        vector<pair<CircVal<Type>, double>> AW; // weighted values
+
+        for (unsigned i = 2000; i--;)
+        {
+            const unsigned Divs[]  = {2, 3, 4, 5, 6, 8, 9, 10, 12, 15, 18, 20, 24, 30, 36}; // divisors of 360 - integer degrees for degree ranges
+
+            const size_t   nCount  = 1 + i % 41                                   ;
+            const unsigned nLevels = (i % 3 == 0) ? 0 : Divs[(i / 3) % size(Divs)]; // continuous / quantized values
+
+            const vector<CircVal<Type>> A = RandomVals(rand_engine, nCount, nLevels);
+
+            // --------------------------------------------------------
+            assert(CircMedian(A) == CircMedianBruteForce(A));
+
+            // weighted median: the brute-force reference. unit weights of an odd count, exact sums: CircMedian
+            vector<double> WtM(A.size());
+            for (auto& w : WtM)
+                w = (i % 2) ? 1. + rand_engine() % 3 : uniform_real_distribution<double>(0.1, 10.)(rand_engine);
+
+            assert(WeightedCircMedian(A, WtM) == WeightedCircMedianBruteForce(A, WtM));
+            if (A.size() % 2 && IsExactVals(A))
+                assert(WeightedCircMedian(A, vector<double>(A.size(), 1.)) == CircMedian(A));
+
+            // --------------------------------------------------------
+            // workspace overloads, with a reused workspace
+            AW.clear();
+            for (const auto& a : A)
+                AW.emplace_back(a, 0.5 + (i % 5));
+
+            auto AssertResEq = [&]([[maybe_unused]] const set<CircVal<Type>>& S) { assert(Res.size() == S.size() && equal(Res.begin(), Res.end(), S.begin())); };
+
+            Res.clear(); CircAverage        (span<const CircVal<Type>>(A), W, back_inserter(Res));                   AssertResEq(CircAverage        (A ));
+            Res.clear(); CircAverage2       (span<const CircVal<Type>>(A), W, back_inserter(Res));                   AssertResEq(CircAverage2       (A ));
+            Res.clear(); CircAverage2       (execution::par, span<const CircVal<Type>>(A), W, back_inserter(Res));   AssertResEq(CircAverage2       (A ));
+            Res.clear(); WeightedCircAverage(span<const pair<CircVal<Type>, double>>(AW), W, back_inserter(Res));    AssertResEq(WeightedCircAverage(AW));
+
+            // values and weights in separate spans: same as <value,weight>
+            vector<double> Wt(A.size());
+            for (auto& w : Wt)
+                w = (i % 2) ? 0.5 + (i % 5) : uniform_real_distribution<double>(0.1, 10.)(rand_engine);
+
+            AW.clear();
+            for (size_t k = 0; k < A.size(); ++k)
+                AW.emplace_back(A[k], Wt[k]);
+
+            Res.clear(); WeightedCircAverage(span<const CircVal<Type>>(A), span<const double>(Wt), W, back_inserter(Res)); AssertResEq(WeightedCircAverage(AW   ));
+                                                                                                                             AssertResEq(WeightedCircAverage(A, Wt));
+            Res.clear(); CircMedian         (span<const CircVal<Type>>(A), W, back_inserter(Res));                   AssertResEq(CircMedian         (A ));
+            Res.clear(); WeightedCircMedian (span<const CircVal<Type>>(A), span<const double>(Wt), W, back_inserter(Res)); AssertResEq(WeightedCircMedian(A, Wt));
+
+            // --------------------------------------------------------
+            // fixed-point circular values: same results as the CircVal values they represent
+            const vector<CircValFixed<Type>> AF(A .begin(), A .end());
+            const vector<CircVal     <Type>> AC(AF.begin(), AF.end());
+
+            assert(CircAverage (AF) == CircAverage (AC));
+            assert(CircAverage2(AF) == CircAverage2(AC));
+            assert(CircMedian  (AF) == CircMedian  (AC));
+            assert(WeightedCircMedian(AF, Wt) == WeightedCircMedian(AC, Wt));
+
+            // float storage: same results as the double values they represent, rounded to float
+            const vector<CircVal<Type, float>> AS(A .begin(), A .end());
+            const vector<CircVal<Type       >> AD(AS.begin(), AS.end());
+            [[maybe_unused]] auto ToFloat = [](const set<CircVal<Type>>& S) { return set<CircVal<Type, float>>(S.begin(), S.end()); };
+
+            assert(CircAverage (AS) == ToFloat(CircAverage (AD)));
+            assert(CircAverage2(AS) == ToFloat(CircAverage2(AD)));
+            assert(CircMedian  (AS) == ToFloat(CircMedian  (AD)));
+
+            // --------------------------------------------------------
+            // accumulator: add all values, then slide the window - remove first half, add new values
+            CircAverageAccumulator<Type> Acc;
+            for (const auto& a : A)
+                Acc.Add(a);
+
+            // the same exact sums and the same calculations of the sectors: identical result
+            auto AssertAccEq = [&]([[maybe_unused]] const vector<CircVal<Type>>& V)
+            {
+                assert(Acc.Size() == V.size() && Acc.GetAvrg() == CircAverage(V));
+            };
+
+            AssertAccEq(A);
+
+            vector<CircVal<Type>> W(A.begin() + A.size() / 2, A.end()); // window
+            for (size_t j = 0; j < A.size() / 2; ++j)
+                assert(Acc.Remove(A[j]));
+
+            for (const auto& a : RandomVals(rand_engine, A.size() / 3, nLevels))
+            {
+                Acc.Add(a);
+                W.emplace_back(a);
+            }
+
+            if (!W.empty())
+                AssertAccEq(W);
+
+            // --------------------------------------------------------
+            // sampled signal: Window mode vs. WeightedCircAverage of the window's intervals, Exact mode, Running mode
+            if (nLevels == 0) // continuous values - no ties
+            {
+                using Signal = CAvrgSampledCircSignal<Type>;
+
+                const double fWindow = 10.;
+                Signal SExact, SHuge(Signal::Mode::Window, 1e9), SWindow(Signal::Mode::Window, fWindow), SRunning(Signal::Mode::Running);
+
+                vector<CircVal<Type>> IAvrgs ; // avrg   of each interval
+                vector<double>        IWghts ; // weight of each interval
+                vector<double>        IEnds  ; // end time of each interval
+                double                fTime = 0.;
+                CircVal<Type>         Prev  ;
+
+                for (size_t k = 0; k < A.size(); ++k)
+                {
+                    if (k)
+                    {
+                        const double fStep = uniform_real_distribution<double>(0.5, 2.)(rand_engine);
+                        IAvrgs.emplace_back(CircVal<Type>::Wrap((double)Prev + CircVal<Type>::Sdist(Prev, A[k]) / 2.));
+                        IWghts.emplace_back(fStep);
+                        fTime += fStep;
+                        IEnds .emplace_back(fTime);
+                    }
+
+                    for (Signal* S : { &SExact, &SHuge, &SWindow, &SRunning })
+                        S->AddMeasurement(A[k], fTime);
+
+                    Prev = A[k];
+                    assert(SWindow.GetIntervals() <= fWindow / 0.5 + 1); // bounded by the window
+                }
+
+                CircVal<Type> a1, a2;
+                SExact.GetAvrg(a1);
+                SHuge .GetAvrg(a2);
+                assert(abs(CircVal<Type>::Sdist(a1, a2)) < 1e-9 * Type::R);
+
+                if (!IAvrgs.empty())
+                {
+                    const size_t nFirst = find_if(IEnds.begin(), IEnds.end(), [&](double e) { return e > fTime - fWindow; }) - IEnds.begin();
+                    const vector<CircVal<Type>> WA(IAvrgs.begin() + nFirst, IAvrgs.end());
+                    const vector<double       > WW(IWghts.begin() + nFirst, IWghts.end());
+
+                    SWindow.GetAvrg(a2);
+                    assert(abs(CircVal<Type>::Sdist(*WeightedCircAverage(WA, WW).begin(), a2)) < 1e-9 * Type::R);
+                }
+
+                // concentrated signal: the mean direction is close to the average
+                Signal SConcExact, SConcRunning(Signal::Mode::Running);
+                uniform_real_distribution<double> ud(-0.02 * Type::R, 0.02 * Type::R);
+                for (size_t k = 0; k < A.size(); ++k)
+                {
+                    const CircVal<Type> c = CircVal<Type>::Wrap((double)A[0] + ud(rand_engine));
+                    SConcExact  .AddMeasurement(c, (double)k);
+                    SConcRunning.AddMeasurement(c, (double)k);
+                }
+
+                SConcExact  .GetAvrg      (a1);
+                SConcRunning.GetVectorMean(a2);
+                assert(abs(CircVal<Type>::Sdist(a1, a2)) < 1e-3 * Type::R);
+            }
+
+            // --------------------------------------------------------
+            // sliding-window median vs. the weighted-median set of the window, after each sample and each eviction:
+            // the median is in the set (exact sums), and its sum is minimal - samples within a half circle (the
+            // tracked median) or not (a value of the set)
+            {
+                struct Sample { CircVal<Type> c; double w, t; };
+
+                const bool     bConc       = i % 2 == 0;  // concentrated samples: within a fifth of the circle
+                const double   fWindow     = 8.5;
+                const size_t   nMaxSamples = 6 + i % 7;
+                deque<Sample>  Win;                       // the expected window
+                double         fTime = 0.;
+
+                CMedianSampledCircSignal<Type> SM(fWindow, nMaxSamples);
+
+                [[maybe_unused]] auto Sum = [&](const CircVal<Type>& x)    // sum(Wi*|Sdist(x, Ai)|) of the window
+                {
+                    double f = 0.;
+                    for (const auto& s : Win)
+                        f += s.w * abs(CircVal<Type>::Sdist(x, s.c));
+                    return f;
+                };
+
+                auto AssertMedian = [&]()
+                {
+                    assert(SM.GetSamples() == Win.size());
+
+                    vector<CircVal<Type>> V;
+                    vector<double       > Wv;
+                    for (const auto& s : Win)
+                    {
+                        V .emplace_back(s.c);
+                        Wv.emplace_back(s.w);
+                    }
+
+                    Res.clear();
+                    SM.GetMedianSet(back_inserter(Res));
+                    const set<CircVal<Type>> MedSet = WeightedCircMedian(V, Wv);
+                    AssertResEq(MedSet);
+
+                    CircVal<Type> Med;
+                    if (!SM.GetMedian(Med))
+                    {
+                        assert(Win.empty());
+                        return;
+                    }
+
+                    [[maybe_unused]] const double fTol = 1e-12 * Type::R * (1. + accumulate(Wv.begin(), Wv.end(), 0.));
+
+                    if (IsExactVals(V))
+                        assert(MedSet.count(Med));
+
+                    // the sum is piecewise linear, with concave breaks at the antipodes: its minimum is at a sample
+                    assert(all_of(Win.begin(), Win.end(), [&](const Sample& s) { return Sum(Med) <= Sum(s.c) + fTol; }));
+                    assert(Sum(Med) <= Sum(*MedSet.begin()) + fTol);
+                };
+
+                uniform_real_distribution<double> ud(-0.1 * Type::R, 0.1 * Type::R);
+                for (size_t k = 0; k < A.size(); ++k)
+                {
+                    // concentrated: around A[0], in steps of R/360 for quantized values - integer degrees
+                    const double        fOffset = nLevels ? floor(ud(rand_engine) * 360. / Type::R) * Type::R / 360. : ud(rand_engine);
+                    const CircVal<Type> c       = bConc ? CircVal<Type>(CircVal<Type>::Wrap((double)A[0] + fOffset)) : A[k];
+                    const double        w       = (i % 3) ? 1. + rand_engine() % 3 : 1.;
+
+                    fTime += 1. + rand_engine() % 2;
+                    SM.AddMeasurement(c, fTime, w);
+                    Win.push_back({ c, w, fTime });
+                    while (Win.size() > nMaxSamples || Win.front().t <= fTime - fWindow)
+                        Win.pop_front();
+                    AssertMedian();
+
+                    if (k % 5 == 4) { SM.PopBack   (        ); Win.pop_back (); AssertMedian(); }
+                    if (k % 7 == 6) { SM.PopFront  (2       ); for (size_t j = 0; j < 2 && !Win.empty(); ++j) Win.pop_front(); AssertMedian(); }
+                    if (k % 11==10) { SM.EvictFront(fTime-4.); while (!Win.empty() && Win.front().t <= fTime-4.) Win.pop_front(); AssertMedian(); }
+                    if (k % 13==12) { SM.EvictBack (fTime-1.); while (!Win.empty() && Win.back ().t >= fTime-1.) Win.pop_back (); AssertMedian(); }
+                }
+            }
+        }
+
+        // --------------------------------------------------------
+        // large inputs - sorted by RadixSort: same order as std::sort. even/odd count, continuous/quantized values
+        for (unsigned i = 0; i < 4; ++i)
+        {
+            const vector<CircVal<Type>> A = RandomVals(rand_engine, RadixSortMinSize + 100 + i % 2, (i / 2) ? 36 : 0);
+
+            vector<double> K(A.begin(), A.end());
+            K[0] = -0.;
+            vector<double> S = K;
+            SortValues(K, W.RadixTmpK);
+            sort(S.begin(), S.end());
+            assert(K == S);
+
+            vector<pair<double, double>> P, Q;
+            for (const auto& a : A)
+                P.emplace_back(a, 1. + rand_engine() % 3); // equal values with different weights
+            Q = P;
+            SortWeighted(P, W);
+            sort(Q.begin(), Q.end());
+            assert(P == Q);
+
+            assert(CircMedian(A) == CircMedianBruteForce(A));
+        }
+
+        // --------------------------------------------------------
+        // large quantized inputs: 360 levels (integer degrees for degree ranges), equally often - a flat sum, whose
+        // hundreds of tied candidates are not re-evaluated directly (see CircMedianMaxRefined)
+        for (const size_t nCount : { 36000, 36001 })
+        {
+            vector<CircVal<Type>> A(nCount);
+            for (size_t k = 0; k < nCount; ++k)
+                A[k] = Type::L + (k % 360) * Type::R / 360.;
+            shuffle(A.begin(), A.end(), rand_engine);
+
+            [[maybe_unused]] const set<CircVal<Type>> Medn = CircMedian(A);
+            [[maybe_unused]] const set<CircVal<Type>> MedB = CircMedianBruteForce(A);
+
+            [[maybe_unused]] auto Sum = [&](const CircVal<Type>& x) // sum(|Sdist(x, Ai)|)
+            {
+                double f = 0.;
+                for (const auto& a : A)
+                    f += abs(CircVal<Type>::Sdist(x, a));
+                return f;
+            };
+
+            if (IsExactVals(A))
+                assert(Medn == MedB);
+            else
+                assert(!Medn.empty() && all_of(Medn.begin(), Medn.end(), [&](const CircVal<Type>& m) { return Sum(m) <= Sum(*MedB.begin()) * (1. + 1e-10); }));
+
+            // integer weights, balanced over the levels
+            vector<double> Wt(nCount);
+            for (size_t k = 0; k < nCount; ++k)
+                Wt[k] = 1. + k % 2;
+
+            [[maybe_unused]] const set<CircVal<Type>> MednW = WeightedCircMedian          (A, Wt);
+            [[maybe_unused]] const set<CircVal<Type>> MedBW = WeightedCircMedianBruteForce(A, Wt);
+
+            [[maybe_unused]] auto SumW = [&](const CircVal<Type>& x) // sum(Wi*|Sdist(x, Ai)|)
+            {
+                double f = 0.;
+                for (size_t k = 0; k < nCount; ++k)
+                    f += Wt[k] * abs(CircVal<Type>::Sdist(x, A[k]));
+                return f;
+            };
+
+            if (IsExactVals(A))
+                assert(MednW == MedBW);
+            else
+                assert(!MednW.empty() && all_of(MednW.begin(), MednW.end(), [&](const CircVal<Type>& m) { return SumW(m) <= SumW(*MedBW.begin()) * (1. + 1e-10); }));
+        }
+
+        // non-integer quantized values for all ranges - a third of a level off the levels above, and non-integer
+        // weights: near-ties beyond CircMedianMaxRefined, whose set may differ from the brute-force one; each median is
+        // within the rounding errors of the brute-force minimum
+        for (const size_t nCount : { 3600, 3601 })
+        {
+            vector<CircVal<Type>> A (nCount);
+            vector<double>        Wt(nCount);
+            for (size_t k = 0; k < nCount; ++k)
+            {
+                A [k] = Type::L + (k % 360 + 1./3.) * Type::R / 360.;
+                Wt[k] = 0.1 + 0.2 * (k % 2);
+            }
+            shuffle(A.begin(), A.end(), rand_engine);
+
+            [[maybe_unused]] auto SumW = [&](const CircVal<Type>& x, const vector<double>& V) // sum(Vi*|Sdist(x, Ai)|)
+            {
+                double f = 0.;
+                for (size_t k = 0; k < nCount; ++k)
+                    f += V[k] * abs(CircVal<Type>::Sdist(x, A[k]));
+                return f;
+            };
+
+            const vector<double> Ones(nCount, 1.);
+
+            [[maybe_unused]] const set<CircVal<Type>> Medn  = CircMedian                  (A    );
+            [[maybe_unused]] const set<CircVal<Type>> MedB  = CircMedianBruteForce        (A    );
+            [[maybe_unused]] const set<CircVal<Type>> MednW = WeightedCircMedian          (A, Wt);
+            [[maybe_unused]] const set<CircVal<Type>> MedBW = WeightedCircMedianBruteForce(A, Wt);
+
+            assert(!Medn .empty() && all_of(Medn .begin(), Medn .end(), [&](const CircVal<Type>& m) { return SumW(m, Ones) <= SumW(*MedB .begin(), Ones) * (1. + 1e-10); }));
+            assert(!MednW.empty() && all_of(MednW.begin(), MednW.end(), [&](const CircVal<Type>& m) { return SumW(m, Wt  ) <= SumW(*MedBW.begin(), Wt  ) * (1. + 1e-10); }));
+        }
+
+        // --------------------------------------------------------
+        // accumulator, large sliding windows: concentrated, uniform continuous and quantized (360 levels) values -
+        // identical to CircAverage of the window
+        for (unsigned i = 0; i < 3; ++i)
+        {
+            normal_distribution<double> r_nrm(Type::L + Type::R / 3., Type::R / 50.);
+
+            const size_t          nWindow = 2000;
+            vector<CircVal<Type>> A       = RandomVals(rand_engine, nWindow + 500, i == 2 ? 360 : 0);
+            if (i == 0)
+                for (auto& a : A)
+                    a = CircVal<Type>(r_nrm(rand_engine));
+
+            CircAverageAccumulator<Type> Acc;
+            for (size_t k = 0; k < A.size(); ++k)
+            {
+                Acc.Add(A[k]);
+                if (k >= nWindow)
+                {
+                    [[maybe_unused]] const bool bRemoved = Acc.Remove(A[k - nWindow]);
+                    assert(bRemoved);
+                }
+
+                if (k >= nWindow && k % 50 == 0)
+                    assert(Acc.GetAvrg() == CircAverage(vector<CircVal<Type>>(A.begin() + (k + 1 - nWindow), A.begin() + (k + 1))));
+            }
+
+            Acc.Clear();
+            assert(Acc.Size() == 0 && Acc.GetAvrg().empty());
+        }
+    }
+};
+
+// ==========================================================================
+// tester for CircHistogram
+template <typename Type>
+class CircHistogramTester
+{
+    // check if each value of S1 is within fTol of a value of S2
+    static bool IsCircSetNear(const set<CircVal<Type>>& S1, const set<CircVal<Type>>& S2, double fTol)
+    {
+        for (const auto& c1 : S1)
+            if (none_of(S2.begin(), S2.end(), [&](const CircVal<Type>& c2) { return abs(CircVal<Type>::Sdist(c1, c2)) <= fTol; }))
+                return false;
+
+        return true;
+    }
+
+public:
+    CircHistogramTester()
+    {
+        Test();
+    }
+
+    static void Test()
+    {
+        std::default_random_engine rand_engine;
+        std::random_device         rnd_device ;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        std::uniform_real_distribution<double> c_uni_dist(Type::L, Type::H);
+
+        for (unsigned i = 0; i < 64; ++i)
+        {
+            const size_t nBinsOpt[] = {360, 97, 4, 2};                       // even, odd, few bins
+
+            const size_t nCount = 2000 + i % 2;                              // even / odd count
+            const size_t nBins  = nBinsOpt[(i / 2) % size(nBinsOpt)];
+            const double fSigma = Type::R / (32. / ((i / 8) % 4 * 3 + 1));   // concentration: R/32..R/3
+            const bool   bQuant = (i / 32) % 2 == 1;                         // values quantized to R/360 - duplicates and ties
+
+            std::normal_distribution<double> nd(c_uni_dist(rand_engine), fSigma);
+
+            vector<CircVal<Type>> A(nCount);
+            for (auto& a : A)
+            {
+                double v = CircVal<Type>::Wrap(nd(rand_engine));
+                if (bQuant)
+                    v = CircVal<Type>::Wrap(Type::L + round((v - Type::L) / (Type::R / 360.)) * (Type::R / 360.));
+                a = v;
+            }
+
+            const span<const CircVal<Type>> SA(A);
+
+            CircHistogram<Type> H(nBins), H1(nBins), H2(nBins);
+            H .Add(SA);
+            H1.Add(SA.first(nCount / 2));
+            H2.Add(SA.last (nCount - nCount / 2));
+            H1.Merge(H2);
+
+            // ----------------------------------------------
+            // merge: same counts, (almost) same means
+            assert(H1.GetCount() == nCount && H.GetCount() == nCount);
+            for (size_t b = 0; b < nBins; ++b)
+            {
+                assert(H1.GetCount(b) == H.GetCount(b));
+                if (H.GetCount(b))
+                    assert(abs(CircVal<Type>::Sdist(H1.GetBinMean(b), H.GetBinMean(b))) < 1e-9 * Type::R);
+            }
+
+            // merge of another number of bins
+            [[maybe_unused]] bool bThrown = false;
+            try { H1.Merge(CircHistogram<Type>(nBins + 1)); } catch (const std::invalid_argument&) { bThrown = true; }
+            assert(bThrown && H1.GetCount() == nCount);
+
+            // ----------------------------------------------
+            // the averages / medians are the minima of sum(dist(m, Ai)^2) / sum(|Sdist(m, Ai)|). nearly tied minima (e.g. of
+            // quantized values) are selected by rounding of the sums, which differ - the exact results are compared by sums
+            [[maybe_unused]] auto SumSqr = [&](const CircVal<Type>& m) { double fSum = 0.; for (const auto& a : A) fSum += Sqr(CircVal<Type>::Sdist(m, a)); return fSum; };
+            [[maybe_unused]] auto SumAbs = [&](const CircVal<Type>& m) { double fSum = 0.; for (const auto& a : A) fSum +=  abs(CircVal<Type>::Sdist(m, a)); return fSum; };
+
+            // the error estimates hold if there is no distant, nearly tied local minimum - test concentrated values only
+            [[maybe_unused]] const bool bBounds = fSigma <= Type::R / 8.;
+
+            // ----------------------------------------------
+            // average: approximate within its error estimate; exact given the residents
+            const auto Avrg = CircAverage(A);
+            assert(!bBounds || IsCircSetNear(Avrg, H.GetAvrg(), H.GetAvrgErrorEstimate() + 1e-9 * Type::R));
+
+            vector<CircVal<Type>> Res;
+            H.CollectResidents(SA, H.GetAvrgBins(), Res);
+
+            const auto AvrgExact = H.GetAvrgExact(Res);
+            assert(!AvrgExact.empty());
+            for ([[maybe_unused]] const auto& a : AvrgExact)
+                assert(abs(SumSqr(a) - SumSqr(*Avrg.begin())) <= 1e-12 * SumSqr(*Avrg.begin()));
+
+            // ----------------------------------------------
+            // median: approximate within its error estimate; exact given the residents
+            const auto Medn = CircMedian(A);
+            assert(!bBounds || IsCircSetNear(Medn, H.GetMedian(), H.GetMedianErrorEstimate() + 1e-9 * Type::R));
+
+            Res.clear();
+            H.CollectResidents(SA, H.GetMedianBins(), Res);
+
+            const auto MednExact = H.GetMedianExact(Res);
+            assert(!MednExact.empty());
+            for ([[maybe_unused]] const auto& m : MednExact)
+                assert(abs(SumAbs(m) - SumAbs(*Medn.begin())) <= 1e-12 * SumAbs(*Medn.begin()));
+
+            // ----------------------------------------------
+            // quantiles, from the bin of the antipode of the median: approximate within a bin width; exact given the residents
+            const size_t nOrigin = H.GetBin(*Medn.begin() + CircVal<Type>(Type::Z + Type::R / 2.)); // median + R/2
+
+            vector<pair<size_t, double>> U(nCount); // <bins after nOrigin, value> - the order of the quantiles
+            for (size_t k = 0; k < nCount; ++k)
+                U[k] = { (H.GetBin(A[k]) + nBins - nOrigin) % nBins, A[k] };
+            sort(U.begin(), U.end());
+
+            for (const double p : {0., 0.1, 0.25, 0.5, 0.75, 0.9, 1.})
+            {
+                const CircVal<Type> q(U[(size_t)(p * (nCount - 1))].second);
+
+                assert(abs(CircVal<Type>::Sdist(H.GetQuantile(p, nOrigin), q)) < H.GetBinWidth());
+
+                Res.clear();
+                H.CollectResidents(SA, H.GetQuantileBins(p, nOrigin), Res);
+                assert(H.GetQuantileExact(p, nOrigin, Res) == q);
+            }
+        }
+
+        // empty histogram
+        CircHistogram<Type> H;
+        assert(H.GetAvrg().empty() && H.GetMedian().empty() && H.GetCount() == 0);
+    }
+};
+
+// ==========================================================================
+// tester for CircAverageSummary, WeightedCircAverageSummary
+template <typename Type>
+class CircAverageSummaryTester
+{
+    // check if 2 sets of circular-values are almost equal
+    static bool IsCircSetAlmostEq(const set<CircVal<Type>>& S1, const set<CircVal<Type>>& S2, double fTol = 1e-9 * Type::R)
+    {
+        if (S1.size() != S2.size())
+            return false;
+
+        for (const auto& c1 : S1)
+            if (none_of(S2.begin(), S2.end(), [&](const CircVal<Type>& c2) { return abs(CircVal<Type>::Sdist(c1, c2)) <= fTol; }))
+                return false;
+
+        return true;
+    }
+
+    // check if each value of S1 minimizes sum(Wt[i]*dist(x, A[i])^2) as the values of S2 - for nearly tied minima (e.g. of
+    // quantized values), which are selected by rounding of the sums
+    static bool IsCircSetMinEq(const set<CircVal<Type>>& S1, const set<CircVal<Type>>& S2, const vector<CircVal<Type>>& A, const vector<double>& Wt)
+    {
+        auto SumSqr = [&](const CircVal<Type>& x) { double fSum = 0.; for (size_t i = 0; i < A.size(); ++i) fSum += Wt[i] * Sqr(CircVal<Type>::Sdist(x, A[i])); return fSum; };
+
+        const double fMin = SumSqr(*S2.begin());
+        return !S1.empty() && all_of(S1.begin(), S1.end(), [&](const CircVal<Type>& c1) { return abs(SumSqr(c1) - fMin) <= 1e-12 * fMin + 1e-300; });
+    }
+
+    // summarize shards of A (and weights Wt), ship each one through the wire format, and reduce them as a tree
+    template<typename Summary, typename AddFn>
+    static Summary Reduce(size_t nCount, size_t nShards, size_t nBins, AddFn&& Add)
+    {
+        vector<Summary> S;
+        for (size_t s = 0; s < nShards; ++s)
+        {
+            Summary Shard(nBins);
+            Add(Shard, nCount * s / nShards, nCount * (s+1) / nShards);
+
+            vector<uint8_t> Buf;
+            Shard.Serialize(Buf);
+            S.emplace_back(Summary::Deserialize(span<const uint8_t>(Buf)));
+        }
+
+        for (size_t nStep = 1; nStep < nShards; nStep *= 2)
+            for (size_t s = 0; s + nStep < nShards; s += 2 * nStep)
+                S[s].Merge(S[s + nStep]);
+
+        return S[0];
+    }
+
+public:
+    CircAverageSummaryTester()
+    {
+        Test();
+    }
+
+    static void Test()
+    {
+        std::default_random_engine rand_engine;
+        std::random_device         rnd_device ;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        std::uniform_real_distribution<double> c_uni_dist(Type::L, Type::H);
+        std::uniform_real_distribution<double> w_uni_dist(0.1, 10.);
+
+        for (unsigned i = 0; i < 200; ++i)
+        {
+            const size_t nCount  = 1 + i % 97;
+            const size_t nShards = 1 + i % 7;
+            const size_t nBins   = (i % 2) ? 360 : 0; // approximate / exact
+            const bool   bQuant  = i % 8 >= 4;        // values quantized to R/36 - duplicates and ties
+
+            std::normal_distribution<double> nd(c_uni_dist(rand_engine), Type::R * (i % 4 ? 0.05 : 0.3));
+
+            vector<CircVal<Type>>               A (nCount);
+            vector<double>                      Wt(nCount);
+            vector<pair<CircVal<Type>, double>> AW(nCount);
+            for (size_t k = 0; k < nCount; ++k)
+            {
+                A [k] = bQuant ? Type::L + (rand_engine() % 36) * Type::R / 36. : nd(rand_engine);
+                Wt[k] = w_uni_dist(rand_engine);
+                AW[k] = { A[k], Wt[k] };
+            }
+
+            // ----------------------------------------------
+            // unweighted: shards of single values and of spans
+            auto S = Reduce<CircAverageSummary<Type>>(nCount, nShards, nBins, [&](auto& Shard, size_t b, size_t e)
+            {
+                if (b % 2)
+                    for (size_t k = b; k < e; ++k)
+                        Shard.Add(A[k]);
+                else
+                    Shard.Add(span<const CircVal<Type>>(A).subspan(b, e - b));
+            });
+
+            const auto Avrg = CircAverage(A);
+
+            if (nBins == 0)
+            {
+                assert(S.GetItems() == nCount);
+                assert(bQuant ? IsCircSetMinEq(S.GetAvrg(), Avrg, A, vector<double>(nCount, 1.)) : IsCircSetAlmostEq(S.GetAvrg(), Avrg));
+
+                // the result depends only on the values - not on the sharding
+                auto S1 = Reduce<CircAverageSummary<Type>>(nCount, 1, 0, [&](auto& Shard, size_t b, size_t e) { Shard.Add(span<const CircVal<Type>>(A).subspan(b, e - b)); });
+                assert(S1.GetAvrg() == S.GetAvrg());
+            }
+            else if (!bQuant && i % 4) // concentrated continuous values: a single minimum
+            {
+                assert(S.GetItems() <= nBins);
+                for ([[maybe_unused]] const auto& a : Avrg)
+                    assert(abs(CircVal<Type>::Sdist(a, *S.GetAvrg().begin())) <= S.GetAvrgErrorEstimate() + Type::R / nBins + 1e-9 * Type::R);
+            }
+
+            // ----------------------------------------------
+            // weighted
+            auto SW = Reduce<WeightedCircAverageSummary<Type>>(nCount, nShards, nBins, [&](auto& Shard, size_t b, size_t e)
+            {
+                if (b % 2)
+                    for (size_t k = b; k < e; ++k)
+                        Shard.Add(A[k], Wt[k]);
+                else
+                    Shard.Add(span<const CircVal<Type>>(A).subspan(b, e - b), span<const double>(Wt).subspan(b, e - b));
+            });
+
+            if (nBins == 0)
+                assert(bQuant ? IsCircSetMinEq(SW.GetAvrg(), WeightedCircAverage(AW), A, Wt) : IsCircSetAlmostEq(SW.GetAvrg(), WeightedCircAverage(AW)));
+
+            // ----------------------------------------------
+            // wire format: size, and malformed buffers
+            vector<uint8_t> Buf;
+            S.Serialize(Buf);
+            assert(nBins || Buf.size() == 17 + 8 * nCount);
+
+            [[maybe_unused]] auto IsRejected = [](span<const uint8_t> B) { try { CircAverageSummary<Type>::Deserialize(B); } catch (const std::invalid_argument&) { return true; } return false; };
+
+            assert(IsRejected(span<const uint8_t>(Buf).first(Buf.size() - 1))); // truncated
+            assert(IsRejected(span<const uint8_t>(Buf).first(3)));              // truncated header
+            vector<uint8_t> Buf2 = Buf; Buf2[0] = 'X';
+            assert(IsRejected(Buf2));                                           // magic
+            Buf2 = Buf; Buf2.push_back(0);
+            assert(IsRejected(Buf2));                                           // trailing bytes
+            Buf2 = Buf; Buf2[3] = 1;
+            assert(IsRejected(Buf2));                                           // version 1: values in [0,360)
+
+            vector<uint8_t> BufW;
+            SW.Serialize(BufW);
+            assert(IsRejected(BufW));                                           // another kind
+
+            [[maybe_unused]] auto IsRejectedW = [](span<const uint8_t> B) { try { WeightedCircAverageSummary<Type>::Deserialize(B); } catch (const std::invalid_argument&) { return true; } return false; };
+            auto SetDouble = [](vector<uint8_t>& B, size_t nPos, double f) { for (size_t k = 0; k < 8; ++k) B[nPos + k] = static_cast<uint8_t>(bit_cast<uint64_t>(f) >> (8 * k)); };
+
+            // the first item: at byte 17; exact mode: value, weight. approximate mode: bin, weight, sum
+            const size_t nWgtPos = nBins ? 17 + 4 : 17 + 8;
+            for (const double f : { numeric_limits<double>::quiet_NaN(), numeric_limits<double>::infinity(), -1. })
+            {
+                Buf2 = BufW; SetDouble(Buf2, nWgtPos, f);
+                assert(IsRejectedW(Buf2));                                      // NaN, infinite or negative weight
+                if (nBins)
+                {
+                    Buf2 = BufW; SetDouble(Buf2, nWgtPos + 8, f);
+                    assert(IsRejectedW(Buf2));                                  // NaN, infinite or negative sum
+                }
+            }
+
+            if (nBins && S.GetItems() >= 2)
+            {
+                Buf2 = Buf; copy_n(Buf.begin() + 17, 4, Buf2.begin() + 17 + 20);
+                assert(IsRejected(Buf2));                                       // duplicate bin
+            }
+
+            // header of an approximate summary of MaxBins+1 bins, and no items
+            vector<uint8_t> BufBins = { 'C', 'A', 'S', 2, 2 };
+            for (size_t k = 0; k < 4; ++k) BufBins.push_back(static_cast<uint8_t>((CircAverageSummary<Type>::MaxBins + 1) >> (8 * k)));
+            BufBins.resize(BufBins.size() + 8, 0);
+            assert(IsRejected(BufBins));                                        // too many bins
+
+            // Merge of another mode or number of bins
+            [[maybe_unused]] bool bThrown = false;
+            try { CircAverageSummary<Type>(nBins).Merge(CircAverageSummary<Type>(nBins ? 0 : 360)); } catch (const std::invalid_argument&) { bThrown = true; }
+            assert(bThrown);
+        }
+    }
+};
+
+// ==========================================================================
+// tester for the instrumentation of the CircStat functions
+// instrumentation enabled (CIRC_INSTRUMENT): the counters of each call, and drain. disabled: nothing is recorded
+template <typename Type>
+class CircInstrumentTester
+{
+public:
+    CircInstrumentTester()
+    {
+        CircInstrument::Drain();
+
+        // three evenly spaced values: a set of 3 averages
+        const vector<CircVal<Type>> A = { CircVal<Type>::Wrap(Type::Z), CircVal<Type>::Wrap(Type::Z + Type::R/3.), CircVal<Type>::Wrap(Type::Z + 2.*Type::R/3.) };
+        const vector<double       > Wt(A.size(), 1.);
+
+        [[maybe_unused]] const auto Avrg  = CircAverage        (A    );
+        [[maybe_unused]] const auto Avrg2 = CircAverage2       (A    );
+        [[maybe_unused]] const auto AvrgW = WeightedCircAverage(A, Wt);
+        [[maybe_unused]] const auto Medn  = CircMedian         (A    );
+        [[maybe_unused]] const auto MednW = WeightedCircMedian (A, Wt);
+
+        [[maybe_unused]] const CircInstrumentData D = CircInstrument::Drain();
+        assert(CircInstrument::Local().IsEmpty());
+
+        if constexpr (!CircInstrument::bEnabled)
+        {
+            assert(D.IsEmpty());
+            return;
+        }
+
+        [[maybe_unused]] auto AssertCall = [&]([[maybe_unused]] CircSite Site, [[maybe_unused]] size_t nResults)
+        {
+            assert(D.Count(Site, CircCounter::Calls   ) == 1       );
+            assert(D.Count(Site, CircCounter::Elements) == A.size());
+            assert(D.Count(Site, CircCounter::Ties    ) >= nResults - 1);
+        };
+
+        AssertCall(CircSite::CircAverage        , Avrg .size());
+        AssertCall(CircSite::CircAverage2       , Avrg2.size());
+        AssertCall(CircSite::WeightedCircAverage, AvrgW.size());
+        AssertCall(CircSite::CircMedian         , Medn .size());
+        AssertCall(CircSite::WeightedCircMedian , MednW.size());
+
+        assert(D.Count(CircSite::CircAverage2, CircCounter::Candidates) == A.size());
+        assert(D.Count(CircSite::CircMedian  , CircCounter::Candidates) >= Medn.size());
+        assert(D.Count(CircSite::CircMedian  , CircCounter::Refined   ) >= Medn.size());
+        assert(D.Count(CircSite::CircMedian  , CircCounter::Refined   ) <= D.Count(CircSite::CircMedian, CircCounter::Candidates));
+        assert(D.IsEmpty(CircSite::TruncNormal0));
+
+        // evenly spaced values: all the candidates tie - the direct re-evaluation is bounded
+        vector<CircVal<Type>> E(1000);
+        for (size_t k = 0; k < E.size(); ++k)
+            E[k] = CircVal<Type>::Wrap(Type::L + k * Type::R / E.size());
+
+        [[maybe_unused]] const auto               MednE  = CircMedian        (E                              );
+        [[maybe_unused]] const auto               MednWE = WeightedCircMedian(E, vector<double>(E.size(), 2.));
+        [[maybe_unused]] const CircInstrumentData DE     = CircInstrument::Drain();
+        assert(!MednE .empty() && DE.Count(CircSite::CircMedian        , CircCounter::Refined) <= CircMedianMaxRefined);
+        assert(!MednWE.empty() && DE.Count(CircSite::WeightedCircMedian, CircCounter::Refined) <= CircMedianMaxRefined);
+    }
+};
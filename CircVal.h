@@ -1,345 +1,656 @@
-// ==========================================================================
-// Copyright (C) 2011 Lior Kogan (koganlior1@gmail.com)
-// ==========================================================================
-// classes defined here:
-// CircVal            - circular-value
-// CircValTester      - tester for CircVal class
-// ==========================================================================
-
-// DRNadler 17-Jan-2026: Replace CircValTypeDef macro with CircValType template.
-
-// LK   2-Jan-2026: Replace FP comparison (==) with std::equal_to to avoid triggering -Wfloat-equal
-
-// DRNadler 31-Jan-2025: For better portability, replace M_PI with C++ 2020 std::numbers::pi
-
-// DRNadler 31-Jan-2025: To avoid multiple defines when this header is included from multiple C++ source files:
-// - static functions must be inline (compiler can decide whether or not to actually inline)
-// - CircValTypeDef macro must use static constexpr to force compile-time evaluation and no storage allocation
-
-#pragma once
-
-#include <random>
-#include <numbers>         // std::numbers::pi
-#include <assert.h>
-
-#include "FPCompare.h"
-#include "CircHelper.h"   // Mod
-
-// ==========================================================================
-// use this template to define a circular-value type
-template <double L_, double H_, double Z_>
-struct CircValType
-{
-    // Prevent instances (no default ctor, no ctors at all in practice)
-    CircValType() = delete;
-
-    static constexpr double L = L_;            // range: [L,H)
-    static constexpr double H = H_;
-    static constexpr double Z = Z_;            // zero-value
-    static constexpr double R = H_ - L_;       // range
-    static constexpr double R_2 = (H_ - L_) / 2.0; // half range
-
-    static_assert(H_ >  L_, "CircValType: invalid range (require H > L)");
-    static_assert(Z_ >= L_, "CircValType: invalid zero (require Z >= L)");
-    static_assert(Z_ <  H_, "CircValType: invalid zero (require Z < H)");
-};
-
-// define basic circular-value types
-using   SignedDegRange = CircValType<           -180.0,                180.0, 0.0>;
-using UnsignedDegRange = CircValType<              0.0,                360.0, 0.0>;
-using   SignedRadRange = CircValType<-std::numbers::pi,     std::numbers::pi, 0.0>;
-using UnsignedRadRange = CircValType<              0.0, 2 * std::numbers::pi, 0.0>;
-
-// for testing only, define some additional circular-value types
-using TestRange0 = CircValType<  3.0, 10.0,  5.3>;
-using TestRange1 = CircValType< -3.0, 10.0, -3.0>;
-using TestRange2 = CircValType< -3.0, 10.0,  9.9>;
-using TestRange3 = CircValType<-13.0, -3.0, -5.3>;
-
-// ==========================================================================
-// circular value
-// Type should be defined using the CircValType template
-template <typename Type>
-class CircVal
-{
-    double val; // actual value [Type::L, Type::H)
-
-    // ---------------------------------------------
-public:
-    inline static double GetL() { return Type::L; }
-    inline static double GetH() { return Type::H; }
-    inline static double GetZ() { return Type::Z; }
-    inline static double GetR() { return Type::R; }
-
-    // ---------------------------------------------
-    inline static bool IsInRange(double r)
-    {
-        return (r >= Type::L && r < Type::H);
-    }
-
-    // 'wraps' circular-value to [Type::L,Type::H)
-    inline static double Wrap(double r)
-    {
-        // the next lines are for optimization and improved accuracy only
-        if (r >= Type::L)
-        {
-                 if (r <  Type::H        ) return r        ;
-            else if (r <  Type::H+Type::R) return r-Type::R;
-        }
-        else
-                 if (r >= Type::L-Type::R) return r+Type::R;
-
-        // general case
-        return Mod(r - Type::L, Type::R) + Type::L;
-    }
-
-    // ---------------------------------------------
-    // the length of shortest directed walk from c1 to c2
-    // return value is in [-Type::R/2, Type::R/2)
-    inline static double Sdist(const CircVal& c1, const CircVal& c2)
-    {
-        double d = c2.val-c1.val;
-        if (d <  -Type::R_2) { return d + Type::R; };
-        if (d >=  Type::R_2) { return d - Type::R; };
-                             { return d          ; };
-    }
-
-    // the length of the shortest increasing walk from c1 to c2
-    // return value is in [0, Type::R)
-    inline static double Pdist(const CircVal& c1, const CircVal& c2)
-    {
-        return c2.val >= c1.val ? c2.val-c1.val : Type::R-c1.val+c2.val;
-    }
-
-    // ---------------------------------------------
-    CircVal() : val(Type::Z)
-    {
-    }
-
-    // construction based on a floating-point value
-    // floating-point is wrapped into the range
-    // to translate a floating-point such that 0 is mapped to Type::Z, call ToC()
-    CircVal(double r) : val(Wrap(r))
-    {
-    }
-
-    // construction based on a circular value of the same type
-    CircVal(const CircVal& c) : val(c.val)
-    {
-    }
-
-    // construction based on a circular value of another type
-    // sample use: CircVal<SignedRadRange> c= c2;   -or-   CircVal<SignedRadRange> c(c2);
-    template<typename Type2>
-    CircVal(const CircVal<Type2>& c) : val(Wrap(c.Pdist(c.GetZ(), c) * Type::R/Type2::R + Type::Z))
-    {
-    }
-
-    // ---------------------------------------------
-    operator double() const
-    {
-        return val;
-    }
-
-    // ---------------------------------------------
-    // assignment from a floating-point value
-    // floating-point is wrapped into the range
-    // to translate a floating-point such that 0 is mapped to Type::Z, call ToC()
-    CircVal& operator= (double r)
-    {
-        val = Wrap(r);
-        return *this;
-    }
-
-    // assignment from another type of circular value
-    template<typename Type2>
-    CircVal& operator= (const CircVal<Type2>& c)
-    {
-        val = Wrap(c.Pdist(c.GetZ(), c) * Type::R/Type2::R + Type::Z);
-        return *this;
-    }
-
-    // ---------------------------------------------
-    // convert circular-value c to real-value [L-Z,H-Z). Z is converted to 0
-    friend double ToR(const CircVal& c) { return c.val - Type::Z; }
-
-    // ---------------------------------------------
-    const CircVal  operator+ (                ) const { return val;                                               }
-    const CircVal  operator- (                ) const { return Wrap(Type::Z - Sdist(Type::Z, val));               } // return negative circular value
-    const CircVal  operator~ (                ) const { return Wrap(val + Type::R_2              );               } // return opposite circular-value
-
-    const CircVal  operator+ (const CircVal& c) const { return Wrap(val + c.val         - Type::Z);               }
-    const CircVal  operator- (const CircVal& c) const { return Wrap(val - c.val         + Type::Z);               }
-    const CircVal  operator* (const double&  r) const { return Wrap((val - Type::Z) * r + Type::Z);               }
-    const CircVal  operator/ (const double&  r) const { return Wrap((val - Type::Z) / r + Type::Z);               }
-
-          CircVal& operator+=(const CircVal& c)       { val = Wrap(val + c.val          - Type::Z); return *this; }
-          CircVal& operator-=(const CircVal& c)       { val = Wrap(val - c.val          + Type::Z); return *this; }
-          CircVal& operator*=(const double&  r)       { val = Wrap((val - Type::Z) * r  + Type::Z); return *this; }
-          CircVal& operator/=(const double&  r)       { val = Wrap((val - Type::Z) / r  + Type::Z); return *this; }
-
-          CircVal& operator =(const CircVal& c)       { val = c.val                               ; return *this; }
-          bool     operator==(const CircVal& c) const { return std::equal_to<decltype(val)>{}(val, c.val);        } // std::equal_to instead of == to avoid triggering -Wfloat-equal
-          bool     operator!=(const CircVal& c) const { return !(*this == c);                                     }
-    
-    // note that two circular values can be compared in several different ways.
-    // check carefully if this is really what you need!
-    bool           operator> (const CircVal& c) const { return val >  c.val;                                      }
-    bool           operator>=(const CircVal& c) const { return val >= c.val;                                      }
-    bool           operator< (const CircVal& c) const { return val <  c.val;                                      }
-    bool           operator<=(const CircVal& c) const { return val <= c.val;                                      }
-};
-
-// ==========================================================================
-template <typename Type> static double        sin  (const CircVal<Type>& c) { return std::sin(ToR(CircVal<SignedRadRange>(c)));  }
-template <typename Type> static double        cos  (const CircVal<Type>& c) { return std::cos(ToR(CircVal<SignedRadRange>(c)));  }
-template <typename Type> static double        tan  (const CircVal<Type>& c) { return std::tan(ToR(CircVal<SignedRadRange>(c)));  }
-template <typename Type> static CircVal<Type> asin (double r              ) { return CircVal<SignedRadRange>(std::asin (r    )); } // calls copy ctor CircVal(CircVal<SignedRadRange>)
-template <typename Type> static CircVal<Type> acos (double r              ) { return CircVal<SignedRadRange>(std::acos (r    )); } // calls copy ctor CircVal(CircVal<SignedRadRange>)
-template <typename Type> static CircVal<Type> atan (double r              ) { return CircVal<SignedRadRange>(std::atan (r    )); } // calls copy ctor CircVal(CircVal<SignedRadRange>)
-template <typename Type> static CircVal<Type> atan2(double r1, double r2  ) { return CircVal<SignedRadRange>(std::atan2(r1,r2)); } // calls copy ctor CircVal(CircVal<SignedRadRange>)
-template <typename Type> static CircVal<Type> ToC  (double r              ) { return CircVal<Type>::Wrap(r + Type::Z);           } // convert real-value r to circular-value in the range. 0 is converted to Type.Z
-
-// ==========================================================================
-// tester for CircVal class
-template <typename Type>
-class CircValTester
-{
-    // check if 2 circular-values are almost equal
-    inline static bool IsCircAlmostEq(const CircVal<Type>& c1, const CircVal<Type>& c2)
-    {
-        double r1 = c1;
-        double r2 = c2;
-
-        if (::IsAlmostEq(r1, r2))
-            return true;
-
-        if (r1 < r2)
-            return IsAlmostEq(r1, r2 - Type::R);
-        else
-            return IsAlmostEq(r1, r2 + Type::R);
-    }
-
-    // assert that 2 circular-values are almost equal
-    inline static void AssertCircAlmostEq([[maybe_unused]]const CircVal<Type>& c1, [[maybe_unused]]const CircVal<Type>& c2)
-    {
-        assert(IsCircAlmostEq(c1, c2));
-    }
-
-    inline static void Test()
-    {
-        CircVal<Type> ZeroVal = Type::Z;
-
-        // --------------------------------------------------------
-        AssertCircAlmostEq(ZeroVal       , -ZeroVal);
-
-        AssertAlmostEq    (sin(ZeroVal)  , 0.      );
-        AssertAlmostEq    (cos(ZeroVal)  , 1.      );
-        AssertAlmostEq    (tan(ZeroVal)  , 0.      );
-
-        AssertCircAlmostEq(asin<Type>(0.), ZeroVal );
-        AssertCircAlmostEq(acos<Type>(1.), ZeroVal );
-        AssertCircAlmostEq(atan<Type>(0.), ZeroVal );
-
-        AssertCircAlmostEq(ToC<Type>(0)  , ZeroVal );
-        AssertAlmostEq    (ToR(ZeroVal)  , 0.      );
-
-        // --------------------------------------------------------
-        std::default_random_engine             rand_engine                 ;
-        std::uniform_real_distribution<double> c_uni_dist(Type::L, Type::H);
-        std::uniform_real_distribution<double> r_uni_dist(0.     , 1000.  ); // for multiplication,division by real-value
-        std::uniform_real_distribution<double> t_uni_dist(-1.    , 1.     ); // for inverse-trigonometric functions
-
-        std::random_device rnd_device;
-        rand_engine.seed(rnd_device()); // reseed engine
-
-        for (unsigned i = 10000; i--;)
-        {
-            CircVal<Type> c1(c_uni_dist(rand_engine)); // random circular value
-            CircVal<Type> c2(c_uni_dist(rand_engine)); // random circular value
-            CircVal<Type> c3(c_uni_dist(rand_engine)); // random circular value
-            double        r (r_uni_dist(rand_engine)); // random real     value [    0, 1000) - for testing *,/ operators
-            double        a1(t_uni_dist(rand_engine)); // random real     value [   -1,    1) - for testing asin,acos
-            double        a2(t_uni_dist(rand_engine)); // random real     value [-1000, 1000) - for testing atan
-
-            assert            (c1                                 == CircVal<Type>((double)c1)         );
-
-            AssertCircAlmostEq(+c1                                  , c1                               ); // +c         = c
-            AssertCircAlmostEq(-(-c1)                               , c1                               ); // -(-c)      = c
-            AssertCircAlmostEq(c1 + c2                              , c2 + c1                          ); // c1+c2      = c2+c1
-            AssertCircAlmostEq(c1 + (c2 +c3)                        , (c1 + c2) + c3                   ); // c1+(c2+c3) = (c1+c2)+c3
-            AssertCircAlmostEq(c1 + -c1                             , ZeroVal                          ); // c+(-c)     = z
-            AssertCircAlmostEq(c1 + ZeroVal                         , c1                               ); // c+z        = c
-
-            AssertCircAlmostEq(c1      - c1                         , ZeroVal                          ); // c-c        = z
-            AssertCircAlmostEq(c1      - ZeroVal                    , c1                               ); // c-z        = c
-            AssertCircAlmostEq(ZeroVal - c1                         , -c1                              ); // z-c        = -c
-            AssertCircAlmostEq(c1      - c2                         , -(c2 - c1)                       ); // c1-c2      = -(c2-c1)
-
-            AssertCircAlmostEq(c1 * 0.                              , ZeroVal                          ); // c*0        = 0
-            AssertCircAlmostEq(c1 * 1.                              , c1                               ); // c*1        = c
-            AssertCircAlmostEq(c1 / 1.                              , c1                               ); // c/1        = c
-
-            AssertCircAlmostEq((c1 * (1./(r+1.))) / (1./(r+1.))     , c1                               ); // (c*r)/r    = c, 0<r<=1
-            AssertCircAlmostEq((c1 / (    r+1.) ) * (    r+1. )     , c1                               ); // (c/r)*r    = c,   r>=1
-
-            // --------------------------------------------------------
-            AssertCircAlmostEq(~(~c1)                               , c1                               ); // opposite(opposite(c) = c
-            AssertCircAlmostEq(c1 - (~c1)                           , ToC<Type>(Type::R/2.)            ); // c - ~c               = r/2+z
-
-            // --------------------------------------------------------
-            AssertAlmostEq    (sin(ToR(CircVal<SignedRadRange>(c1))),  sin(c1)                         ); // member func sin
-            AssertAlmostEq    (cos(ToR(CircVal<SignedRadRange>(c1))),  cos(c1)                         ); // member func cos
-            AssertAlmostEq    (tan(ToR(CircVal<SignedRadRange>(c1))),  tan(c1)                         ); // member func tan
-
-            AssertAlmostEq    (sin(-c1)                             , -sin(c1)                         ); // sin(-c)    = -sin(c)
-            AssertAlmostEq    (cos(-c1)                             ,  cos(c1)                         ); // cos(-c)    =  cos(c)
-            AssertAlmostEq    (tan(-c1)                             , -tan(c1)                         ); // tan(-c1)   = -tan(c) the error may be large
-
-            AssertAlmostEq    (sin(c1+ToC<Type>(Type::R/4.))        ,  cos(c1)                         ); // sin(c+r/4) =  cos(c)
-            AssertAlmostEq    (cos(c1+ToC<Type>(Type::R/4.))        , -sin(c1)                         ); // cos(c+r/4) = -sin(c)
-            AssertAlmostEq    (sin(c1+ToC<Type>(Type::R/2.))        , -sin(c1)                         ); // sin(c+r/2) = -sin(c)
-            AssertAlmostEq    (cos(c1+ToC<Type>(Type::R/2.))        , -cos(c1)                         ); // cos(c+r/2) = -cos(c)
-
-            AssertAlmostEq    (Sqr(sin(c1))+Sqr(cos(c1))            , 1.                               ); // sin(x)^2+cos(x)^2 = 1
-
-            AssertAlmostEq    (sin(c1)/cos(c1)                      , tan(c1)                          ); // sin(x)/cos(x) = tan(x)
-
-            // --------------------------------------------------------
-            AssertCircAlmostEq(asin<Type>(a1)                       , CircVal<SignedRadRange>(asin(a1))); // member func asin
-            AssertCircAlmostEq(acos<Type>(a1)                       , CircVal<SignedRadRange>(acos(a1))); // member func acos
-            AssertCircAlmostEq(atan<Type>(a2)                       , CircVal<SignedRadRange>(atan(a2))); // member func atan
-
-            AssertCircAlmostEq(asin<Type>(a1) + asin<Type>(-a1)     , ZeroVal                          ); // asin(r)+asin(-r) = z
-            AssertCircAlmostEq(acos<Type>(a1) + acos<Type>(-a1)     , ToC<Type>(Type::R / 2.)          ); // acos(r)+acos(-r) = r/2+z
-            AssertCircAlmostEq(asin<Type>(a1) + acos<Type>( a1)     , ToC<Type>(Type::R / 4.)          ); // asin(r)+acos( r) = r/4+z
-            AssertCircAlmostEq(atan<Type>(a2) + atan<Type>(-a2)     , ZeroVal                          ); // atan(r)+atan(-r) = z
-
-            // --------------------------------------------------------
-            assert            ((c1 >  c2)                         ==    (c2 <  c1)                     ); // c1> c2 <==>   c2< c1
-            assert            ((c1 >= c2)                         ==    (c2 <= c1)                     ); // c1>=c2 <==>   c2<=c1
-            assert            ((c1 >= c2)                         ==  ( (c1 >  c2) ||  (c1 == c2))     ); // c1>=c2 <==>  (c1> c2)|| (c1==c2)
-            assert            ((c1 <= c2)                         ==  ( (c1 <  c2) ||  (c1 == c2))     ); // c1<=c2 <==>  (c1< c2)|| (c1==c2)
-            assert            ((c1 >  c2)                         ==  (!(c1 == c2) && !(c1 <  c2))     ); // c1> c2 <==> !(c1==c2)&&!(c1< c2)
-            assert            ((c1 == c2)                         ==  (!(c1 >  c2) && !(c1 <  c2))     ); // c1= c2 <==> !(c1> c2)&&!(c1< c2)
-            assert            ((c1 <  c2)                         ==  (!(c1 == c2) && !(c1 >  c2))     ); // c1< c2 <==> !(c1==c2)&&!(c1> c2)
-            assert            (!(c1>c2) || !(c2>c3) || (c1>c3)                                         ); // (c1>c2)&&(c2>c3) ==> c1>c3
-
-            // --------------------------------------------------------
-            AssertCircAlmostEq(c1                                   , ToC<Type>(ToR( c1)       )       ); //  c1        = ToC(ToR( c1)
-            AssertCircAlmostEq(-c1                                  , ToC<Type>(ToR(-c1)       )       ); // -c1        = ToC(ToR(-c1)
-            AssertCircAlmostEq(c1 + c2                              , ToC<Type>(ToR(c1)+ToR(c2))       ); // c1+c2      = ToC(ToR(c1)+ToR(c2))
-            AssertCircAlmostEq(c1 - c2                              , ToC<Type>(ToR(c1)-ToR(c2))       ); // c1-c2      = ToC(ToR(c1)-ToR(c2))
-            AssertCircAlmostEq(c1 * r                               , ToC<Type>(ToR(c1) * r    )       ); // c1*r       = ToC(ToR(c1)*r      )
-            AssertCircAlmostEq(c1 / r                               , ToC<Type>(ToR(c1) / r    )       ); // c1/r       = ToC(ToR(c1)/r      )
-
-            // --------------------------------------------------------
-        }
-    }
-
-public:
-    CircValTester()
-    {
-        Test();
-    }
-};
+// ==========================================================================
+// Copyright (C) 2011 Lior Kogan (koganlior1@gmail.com)
+// ==========================================================================
+// classes defined here:
+// CircVal            - circular-value
+// CircConvert        - conversion between circular-value types: compile-time constants, vectorized bulk conversion
+// CircValTester      - tester for CircVal class
+// ==========================================================================
+
+// DRNadler 14-Oct-2026: Add CircConvert.
+
+// DRNadler 14-Oct-2026: Add sincos, sincos_fast and their batch variants.
+
+// DRNadler 14-Oct-2026: CircVal takes its storage type (float, double, long double) as a template parameter.
+
+// DRNadler 14-Oct-2026: Add CircType and the CircValue concept - circular values convertible to CircVal.
+
+// DRNadler 14-Oct-2026: Wrap and the conversions are specialized on the compile-time range.
+
+// DRNadler 14-Oct-2026: Wrap: a value just below L, for which r+R rounds up to H, wraps to L.
+
+// DRNadler 17-Jan-2026: Replace CircValTypeDef macro with CircValType template.
+
+// LK   2-Jan-2026: Replace FP comparison (==) with std::equal_to to avoid triggering -Wfloat-equal
+
+// DRNadler 31-Jan-2025: For better portability, replace M_PI with C++ 2020 std::numbers::pi
+
+// DRNadler 31-Jan-2025: To avoid multiple defines when this header is included from multiple C++ source files:
+// - static functions must be inline (compiler can decide whether or not to actually inline)
+// - CircValTypeDef macro must use static constexpr to force compile-time evaluation and no storage allocation
+
+#pragma once
+
+#include <cmath>
+#include <random>
+#include <numbers>         // std::numbers::pi
+#include <assert.h>
+#include <functional>    // std::equal_to
+#include <limits>
+#include <algorithm>     // std::copy
+#include <span>
+#include <vector>
+#include <type_traits>   // std::is_convertible_v, std::type_identity_t
+#include <utility>       // std::pair
+
+#include "FPCompare.h"
+#include "CircHelper.h"   // ModConst, SinCosKernel, SinCosTable
+
+// ==========================================================================
+// use this template to define a circular-value type
+template <double L_, double H_, double Z_>
+struct CircValType
+{
+    // Prevent instances (no default ctor, no ctors at all in practice)
+    CircValType() = delete;
+
+    static constexpr double L = L_;            // range: [L,H)
+    static constexpr double H = H_;
+    static constexpr double Z = Z_;            // zero-value
+    static constexpr double R = H_ - L_;       // range
+    static constexpr double R_2 = (H_ - L_) / 2.0; // half range
+
+    static_assert(H_ >  L_, "CircValType: invalid range (require H > L)");
+    static_assert(Z_ >= L_, "CircValType: invalid zero (require Z >= L)");
+    static_assert(Z_ <  H_, "CircValType: invalid zero (require Z < H)");
+};
+
+// define basic circular-value types
+using   SignedDegRange = CircValType<           -180.0,                180.0, 0.0>;
+using UnsignedDegRange = CircValType<              0.0,                360.0, 0.0>;
+using   SignedRadRange = CircValType<-std::numbers::pi,     std::numbers::pi, 0.0>;
+using UnsignedRadRange = CircValType<              0.0, 2 * std::numbers::pi, 0.0>;
+
+// for testing only, define some additional circular-value types
+using TestRange0 = CircValType<  3.0, 10.0,  5.3>;
+using TestRange1 = CircValType< -3.0, 10.0, -3.0>;
+using TestRange2 = CircValType< -3.0, 10.0,  9.9>;
+using TestRange3 = CircValType<-13.0, -3.0, -5.3>;
+
+// ==========================================================================
+// arithmetic type - multiplier/divisor of a circular value
+template <typename A>
+concept Arithmetic = std::is_arithmetic_v<A>;
+
+// conversion between circular-value types - defined below
+template <typename From, typename To>
+struct CircConvert;
+
+// ==========================================================================
+// circular value
+// Type should be defined using the CircValType template
+// F is the storage type: float, double or long double. the range constants are converted to F, and all operations are
+// done at the precision of F - so a value is always in [F(Type::L), F(Type::H))
+// note that the range constants are double, so a long double range is only as fine as its double constants
+template <typename Type, typename F = double>
+class CircVal
+{
+    static_assert(std::is_floating_point_v<F>, "CircVal: floating-point storage type expected");
+
+    static constexpr F L   = static_cast<F>(Type::L  );
+    static constexpr F H   = static_cast<F>(Type::H  );
+    static constexpr F Z   = static_cast<F>(Type::Z  );
+    static constexpr F R   = static_cast<F>(Type::R  );
+    static constexpr F R_2 = static_cast<F>(Type::R_2);
+
+    using Real = std::common_type_t<F, double>; // multipliers/divisors
+
+    F val; // actual value [L, H)
+
+    // ---------------------------------------------
+public:
+    using CircType  = Type;
+    using ValueType = F   ;
+
+    inline static F GetL() { return L; }
+    inline static F GetH() { return H; }
+    inline static F GetZ() { return Z; }
+    inline static F GetR() { return R; }
+
+    // ---------------------------------------------
+    inline static bool IsInRange(F r)
+    {
+        return (r >= L && r < H);
+    }
+
+    // 'wraps' circular-value to [L,H)
+    inline static F Wrap(F r)
+    {
+        // the next lines are for optimization and improved accuracy only
+        // values far from the range skip them with a single, well predicted, branch: [L-R,H+R) is within 1.5R of the middle
+        if (std::abs(r - (L+H)/2) < 2*R)
+        {
+            if (r >= L)
+            {
+                     if (r <  H  ) return r  ;
+                else if (r <  H+R) return r-R;
+            }
+            else
+                     if (r >= L-R) return r+R < H ? r+R : L; // r+R may round up to H, e.g. r= -1e-17
+        }
+
+        // general case - Type::R is a compile-time constant: no divisor checks, multiplication by reciprocal
+        // m+L may round up to H, e.g. for L > 0 and m just below R
+        const F w = ModConst<Type::R>(r - L) + L;
+        return w < H ? w : L;
+    }
+
+    // ---------------------------------------------
+    // the length of shortest directed walk from c1 to c2
+    // return value is in [-R/2, R/2)
+    inline static F Sdist(const CircVal& c1, const CircVal& c2)
+    {
+        F d = c2.val-c1.val;
+        if (d <  -R_2) { return d + R; };
+        if (d >=  R_2) { return d - R; };
+                       { return d    ; };
+    }
+
+    // the length of the shortest increasing walk from c1 to c2
+    // return value is in [0, R)
+    inline static F Pdist(const CircVal& c1, const CircVal& c2)
+    {
+        return c2.val >= c1.val ? c2.val-c1.val : R-c1.val+c2.val;
+    }
+
+    // ---------------------------------------------
+    CircVal() : val(Z)
+    {
+    }
+
+    // construction based on a floating-point value
+    // floating-point is wrapped into the range
+    // to translate a floating-point such that 0 is mapped to Type::Z, call ToC()
+    CircVal(F r) : val(Wrap(r))
+    {
+    }
+
+    // construction based on a circular value of the same type
+    CircVal(const CircVal& c) : val(c.val)
+    {
+    }
+
+    // construction based on a circular value of another type and/or storage type
+    // sample use: CircVal<SignedRadRange> c= c2;   -or-   CircVal<SignedRadRange> c(c2);
+    template<typename Type2, typename F2>
+    CircVal(const CircVal<Type2, F2>& c) : val(Convert(c))
+    {
+    }
+
+    // ---------------------------------------------
+    operator F() const
+    {
+        return val;
+    }
+
+    // ---------------------------------------------
+    // assignment from a floating-point value
+    // floating-point is wrapped into the range
+    // to translate a floating-point such that 0 is mapped to Type::Z, call ToC()
+    CircVal& operator= (F r)
+    {
+        val = Wrap(r);
+        return *this;
+    }
+
+    // assignment from another type and/or storage type of circular value
+    template<typename Type2, typename F2>
+    CircVal& operator= (const CircVal<Type2, F2>& c)
+    {
+        val = Convert(c);
+        return *this;
+    }
+
+    // ---------------------------------------------
+    // convert circular-value c to real-value [L-Z,H-Z). Z is converted to 0
+    friend F ToR(const CircVal& c) { return c.val - Z; }
+
+    // ---------------------------------------------
+    const CircVal  operator+ (                ) const { return val;                                                     }
+    const CircVal  operator- (                ) const { return Wrap(Z - Sdist(Z, val));                                 } // return negative circular value
+    const CircVal  operator~ (                ) const { return Wrap(val + R_2);                                         } // return opposite circular-value
+
+    const CircVal  operator+ (const CircVal& c) const { return Wrap(val + c.val - Z);                                   }
+    const CircVal  operator- (const CircVal& c) const { return Wrap(val - c.val + Z);                                   }
+
+          CircVal& operator+=(const CircVal& c)       { val = Wrap(val + c.val - Z); return *this;                      }
+          CircVal& operator-=(const CircVal& c)       { val = Wrap(val - c.val + Z); return *this;                      }
+
+    // multiplication/division by a real value of any arithmetic type - an exact match, so c*r is not ambiguous with
+    // the built-in F*r. calculated at the precision of F, or of double if wider
+    template<Arithmetic A> const CircVal  operator* (A r) const { return Wrap(static_cast<F>((val - Z) * static_cast<Real>(r) + Z));               }
+    template<Arithmetic A> const CircVal  operator/ (A r) const { return Wrap(static_cast<F>((val - Z) / static_cast<Real>(r) + Z));               }
+    template<Arithmetic A>       CircVal& operator*=(A r)       { val = Wrap(static_cast<F>((val - Z) * static_cast<Real>(r) + Z)); return *this; }
+    template<Arithmetic A>       CircVal& operator/=(A r)       { val = Wrap(static_cast<F>((val - Z) / static_cast<Real>(r) + Z)); return *this; }
+
+          CircVal& operator =(const CircVal& c)       { val = c.val; return *this;                                      }
+          bool     operator==(const CircVal& c) const { return std::equal_to<decltype(val)>{}(val, c.val);              } // std::equal_to instead of == to avoid triggering -Wfloat-equal
+          bool     operator!=(const CircVal& c) const { return !(*this == c);                                           }
+    
+    // note that two circular values can be compared in several different ways.
+    // check carefully if this is really what you need!
+    bool           operator> (const CircVal& c) const { return val >  c.val;                                            }
+    bool           operator>=(const CircVal& c) const { return val >= c.val;                                            }
+    bool           operator< (const CircVal& c) const { return val <  c.val;                                            }
+    bool           operator<=(const CircVal& c) const { return val <= c.val;                                            }
+
+private:
+    // value of a circular value of another type and/or storage type, in this range
+    // same type: a precision conversion only. otherwise, the scale factor Type::R/Type2::R is a compile-time constant,
+    // so the conversion is a single multiply-add - at the wider of the two precisions
+    template<typename Type2, typename F2>
+    static F Convert(const CircVal<Type2, F2>& c)
+    {
+        if constexpr (std::is_same_v<Type, Type2>)
+            return Wrap(static_cast<F>(static_cast<F2>(c)));
+        else if constexpr (std::is_same_v<F, double> && std::is_same_v<F2, double>)
+            return CircConvert<Type2, Type>::Apply(static_cast<double>(c));
+        else
+        {
+            using G = std::common_type_t<F, F2>;
+            return Wrap(static_cast<F>(static_cast<G>(c.Pdist(c.GetZ(), c)) * static_cast<G>(Type::R/Type2::R) + static_cast<G>(Type::Z)));
+        }
+    }
+};
+
+// ==========================================================================
+// circular-value types: CircVal<Type>, and types convertible to it - e.g. CircValFixed. accepted by the CircStat functions
+template <typename C>
+concept CircValue = requires { typename C::CircType; } && std::is_convertible_v<const C&, CircVal<typename C::CircType>>;
+
+// storage type of a circular-value type: F of CircVal<Type, F>; double for other types (e.g. CircValFixed)
+template <typename C>                                              struct CircValueStorage    { using type = double;                };
+template <typename C> requires requires { typename C::ValueType; } struct CircValueStorage<C> { using type = typename C::ValueType; };
+template <typename C> using CircValueStorage_t = typename CircValueStorage<C>::type;
+
+// ==========================================================================
+// conversion of circular values of type From to type To: CircVal<To>(CircVal<From>(c)), bit-identical
+// the scale To::R/From::R and the zero-values are compile-time constants. Pdist(From::Z, c) * scale + To::Z is in
+// [To::L, To::H + To::R), so it is wrapped by a single compare instead of the general Wrap. in addition:
+// - same type      : a copy
+// - same range size: no multiplication - Pdist(From::Z, c) + To::Z
+// the bulk overloads are vectorized (see CircSimd.h). r may be the same array as c
+// sample use: CircConvert<SignedRadRange, UnsignedDegRange>::Apply(angles_rad, angles_deg);
+// From, To should be defined using the CircValType template
+template <typename From, typename To>
+struct CircConvert
+{
+    static constexpr double Scale  = To::R / From::R;
+    static constexpr bool   bSame  = std::is_same_v<From, To>;
+    static constexpr bool   bShift = !bSame && std::equal_to<double>{}(Scale, 1.);
+
+    // false only if To::Z is within rounding of To::H: the converted value may then need the general Wrap
+    static constexpr bool   bNarrowWrap = From::R * Scale + To::Z < To::H + To::R;
+
+    // Ops is one of the operations classes of CircSimd.h; c is in [From::L, From::H)
+    template <typename Ops> requires bNarrowWrap
+    static typename Ops::V Kernel(typename Ops::V c)
+    {
+        using V = typename Ops::V;
+
+        if constexpr (bSame)
+            return c;
+        else
+        {
+            // CircVal::Pdist(From::Z, c)
+            const V z = Ops::Set(From::Z);
+            const V p = Ops::Select(Ops::Ge(c, z), Ops::Sub(c, z), Ops::Add(Ops::Sub(Ops::Set(From::R), z), c));
+
+            V r;
+            if constexpr (bShift)
+                r = Ops::Add(p, Ops::Set(To::Z));
+            else
+                r = Ops::Add(Ops::Mul(p, Ops::Set(Scale)), Ops::Set(To::Z));
+
+            return Ops::Select(Ops::Lt(r, Ops::Set(To::H)), r, Ops::Sub(r, Ops::Set(To::R))); // r in [To::L, To::H+To::R)
+        }
+    }
+
+    // ---------------------------------------------
+    static double Apply(double c)
+    {
+        if constexpr (bNarrowWrap)
+            return Kernel<CircSimdScalar>(c);
+        else
+            return CircVal<To>::Wrap(CircVal<From>::Pdist(From::Z, c) * Scale + To::Z);
+    }
+
+    // r[i] = Apply(c[i])
+    static void Apply(std::span<const double> c, std::span<double> r)
+    {
+        assert(c.size() == r.size());
+
+        if constexpr (bSame)
+        {
+            if (c.data() != r.data())
+                std::copy(c.begin(), c.end(), r.begin());
+        }
+        else if constexpr (bNarrowWrap)
+        {
+            const double* pc = c.data();
+            double*       pr = r.data();
+            CircSimdLoop(c.size(), [&](auto ops, size_t i)
+            {
+                using Ops = decltype(ops);
+                Ops::Store(&pr[i], Kernel<Ops>(Ops::Load(&pc[i])));
+            });
+        }
+        else
+            for (size_t i = 0; i < c.size(); ++i)
+                r[i] = Apply(c[i]);
+    }
+
+    // r[i] = CircVal<To>(c[i]) - for CircVal<From> and for types convertible to it, e.g. CircValFixed
+    template <CircValue C> requires std::is_same_v<typename C::CircType, From>
+    static void Apply(std::span<const C> c, std::span<double> r)
+    {
+        assert(c.size() == r.size());
+
+        if constexpr (std::is_same_v<C, CircVal<From>>)
+        {
+            static_assert(sizeof(C) == sizeof(double) && std::is_standard_layout_v<C>);
+            Apply(std::span<const double>(reinterpret_cast<const double*>(c.data()), c.size()), r);
+        }
+        else
+            for (size_t i = 0; i < c.size(); ++i)
+                r[i] = Apply(static_cast<double>(CircVal<From>(c[i])));
+    }
+};
+
+// trigonometric functions, at the precision of the storage type F
+// for the inverse functions, F is not deduced from the argument: asin<Type>(r) returns CircVal<Type>, asin<Type,float>(r) returns CircVal<Type,float>
+template <typename Type, typename F             > static F               sin  (const CircVal<Type, F>& c          ) { return std::sin(ToR(CircVal<SignedRadRange, F>(c)));  }
+template <typename Type, typename F             > static F               cos  (const CircVal<Type, F>& c          ) { return std::cos(ToR(CircVal<SignedRadRange, F>(c)));  }
+template <typename Type, typename F             > static F               tan  (const CircVal<Type, F>& c          ) { return std::tan(ToR(CircVal<SignedRadRange, F>(c)));  }
+
+template <typename Type, typename F = double    > static CircVal<Type, F> asin (std::type_identity_t<F> r          ) { return CircVal<SignedRadRange, F>(std::asin (r    )); } // calls copy ctor CircVal(CircVal<SignedRadRange>)
+template <typename Type, typename F = double    > static CircVal<Type, F> acos (std::type_identity_t<F> r          ) { return CircVal<SignedRadRange, F>(std::acos (r    )); } // calls copy ctor CircVal(CircVal<SignedRadRange>)
+template <typename Type, typename F = double    > static CircVal<Type, F> atan (std::type_identity_t<F> r          ) { return CircVal<SignedRadRange, F>(std::atan (r    )); } // calls copy ctor CircVal(CircVal<SignedRadRange>)
+template <typename Type, typename F = double    > static CircVal<Type, F> atan2(std::type_identity_t<F> r1,
+                                                                                std::type_identity_t<F> r2         ) { return CircVal<SignedRadRange, F>(std::atan2(r1,r2)); } // calls copy ctor CircVal(CircVal<SignedRadRange>)
+template <typename Type, typename F = double    > static CircVal<Type, F> ToC  (std::type_identity_t<F> r          ) { return CircVal<Type, F>::Wrap(r + static_cast<F>(Type::Z)); } // convert real-value r to circular-value in the range. 0 is converted to Type.Z
+
+// sine and cosine together: {sin(c), cos(c)}
+// for float and double storage, the argument - already reduced to [-pi, pi) by the conversion to SignedRadRange - is passed
+// to SinCosKernel (CircHelper.h), which skips libm's general range reduction. within 1 ulp of sin(c), cos(c)
+template <typename Type, typename F>
+static std::pair<F, F> sincos(const CircVal<Type, F>& c)
+{
+    const F r = ToR(CircVal<SignedRadRange, F>(c));
+    if constexpr (std::is_same_v<F, long double>)
+        return { std::sin(r), std::cos(r) };
+    else
+    {
+        double s, co;
+        SinCosKernel<CircSimdScalar>(r, s, co);
+        return { static_cast<F>(s), static_cast<F>(co) };
+    }
+}
+
+// fast sine and cosine together, by table and polynomial - see SinCosTable (CircHelper.h)
+// max abs error: SinCosTable::MaxError (1e-9). several times faster than sin(c), cos(c); there is no conversion to SignedRadRange
+template <typename Type, typename F>
+static std::pair<F, F> sincos_fast(const CircVal<Type, F>& c)
+{
+    double s, co;
+    SinCosTable::Get((static_cast<double>(static_cast<F>(c)) - Type::Z) * (1. / Type::R), s, co);
+    return { static_cast<F>(s), static_cast<F>(co) };
+}
+
+// ==========================================================================
+// tester for CircVal class
+template <typename Type, typename F = double>
+class CircValTester
+{
+    // check if 2 circular-values are almost equal
+    inline static bool IsCircAlmostEq(const CircVal<Type, F>& c1, const CircVal<Type, F>& c2)
+    {
+        F r1 = c1;
+        F r2 = c2;
+
+        if (::IsAlmostEq(r1, r2))
+            return true;
+
+        if (r1 < r2)
+            return IsAlmostEq(r1, r2 - CircVal<Type, F>::GetR());
+        else
+            return IsAlmostEq(r1, r2 + CircVal<Type, F>::GetR());
+    }
+
+    // assert that 2 circular-values are almost equal
+    inline static void AssertCircAlmostEq([[maybe_unused]]const CircVal<Type, F>& c1, [[maybe_unused]]const CircVal<Type, F>& c2)
+    {
+        assert(IsCircAlmostEq(c1, c2));
+    }
+
+    // CircConvert<Type, To> - scalar, bulk and CircVal conversion - vs. the general conversion
+    // Wrap(Pdist(Z, c) * To::R/Type::R + To::Z): the same value, boundary values included
+    template <typename To>
+    inline static void TestConvert()
+    {
+        using Conv = CircConvert<Type, To>;
+
+        std::vector<double> c;
+        for (const double x : { Type::L, Type::Z, std::nextafter(Type::H, Type::L) })
+            for (const double y : { std::nextafter(x, Type::L - Type::R), x, std::nextafter(x, Type::H + Type::R) })
+                if (CircVal<Type>::IsInRange(y))
+                    c.emplace_back(y);
+
+        for (unsigned i = 0; i < 1003; ++i) // not a multiple of the number of lanes
+            c.emplace_back(CircVal<Type>(Type::L + Type::R * i / 1003.));
+
+        std::vector<double> r(c.size()), rc(c.size());
+        Conv::Apply(c, r);
+        Conv::Apply(std::span<const CircVal<Type>>(reinterpret_cast<const CircVal<Type>*>(c.data()), c.size()), rc);
+
+        for (size_t i = 0; i < c.size(); ++i)
+        {
+            [[maybe_unused]] const double g = Conv::bSame ? c[i] : CircVal<To>::Wrap(CircVal<Type>::Pdist(Type::Z, c[i]) * (To::R/Type::R) + To::Z);
+            assert(CircVal<To>::IsInRange(r[i])                              );
+            assert(std::equal_to<double>{}(r [i], g                         ));
+            assert(std::equal_to<double>{}(rc[i], g                         ));
+            assert(std::equal_to<double>{}(Conv::Apply(c[i]), g             ));
+            assert(std::equal_to<double>{}(CircVal<To>(CircVal<Type>(c[i])), g));
+        }
+    }
+
+    inline static void Test()
+    {
+        CircVal<Type, F> ZeroVal = Type::Z;
+
+        // --------------------------------------------------------
+        AssertCircAlmostEq(ZeroVal          , -ZeroVal);
+
+        AssertAlmostEq    (sin(ZeroVal)     , 0.      );
+        AssertAlmostEq    (cos(ZeroVal)     , 1.      );
+        AssertAlmostEq    (tan(ZeroVal)     , 0.      );
+
+        AssertCircAlmostEq(asin<Type, F>(0.), ZeroVal );
+        AssertCircAlmostEq(acos<Type, F>(1.), ZeroVal );
+        AssertCircAlmostEq(atan<Type, F>(0.), ZeroVal );
+
+        AssertCircAlmostEq(ToC<Type, F>(0)  , ZeroVal );
+        AssertAlmostEq    (ToR(ZeroVal)     , 0.      );
+
+        // --------------------------------------------------------
+        // boundary cases at the precision of F: L, H, multiples of R, and their neighbors are wrapped into [L,H)
+        using CV = CircVal<Type, F>;
+        const F fInf = std::numeric_limits<F>::infinity();
+
+        for (int k = -1000; k <= 1000; ++k)
+        {
+            const F x = CV::GetL() + k * CV::GetR();
+            for (const F y : { x, std::nextafter(x, -fInf), std::nextafter(x, fInf) })
+            {
+                [[maybe_unused]] const F m = Mod<F>(y - CV::GetL(), CV::GetR());
+                assert(CV::IsInRange(CV::Wrap(y)));
+                assert(m >= 0 && m < CV::GetR());
+            }
+        }
+
+        assert(std::equal_to<F>{}(CV::Wrap(CV::GetH()), CV::GetL()));
+        assert(std::equal_to<F>{}(CV::Wrap(CV::GetL()), CV::GetL()));
+        assert(std::equal_to<F>{}(CV::Wrap(std::nextafter(CV::GetH(), -fInf)), std::nextafter(CV::GetH(), -fInf)));
+        assert(CV::IsInRange(CV::Wrap(CV::GetL() - std::numeric_limits<F>::denorm_min())));
+
+        // values just below L: r+R may round up to H, which is L - not a value of its own
+        for (const F r : { std::nextafter(CV::GetL(), -fInf), F(CV::GetL() - F(1e-17)), F(CV::GetL() - F(1e-10)) })
+        {
+            if (r >= CV::GetL())
+                continue;
+
+            [[maybe_unused]] const F w = CV::Wrap(r);
+            assert(CV::IsInRange(w));
+            assert(std::abs(CV::Sdist(CV(w), CV(CV::GetL()))) <= 4 * (CV::GetL() - r) + 4 * std::numeric_limits<F>::epsilon() * CV::GetR());
+            assert(std::equal_to<F>{}(r + CV::GetR(), CV::GetH()) == std::equal_to<F>{}(w, CV::GetL()));
+        }
+
+        // precision conversions: a double just below H may round to H
+        using CVD  [[maybe_unused]] = CircVal<Type, double     >;
+        using CVLD [[maybe_unused]] = CircVal<Type, long double>;
+        assert(CV::IsInRange(CV(CVD (std::nextafter(Type::H, Type::L)))));
+        assert(CV::IsInRange(CV(CVLD(std::nextafter((long double)Type::H, (long double)Type::L)))));
+
+        // conversions to the other types
+        if constexpr (std::is_same_v<F, double>)
+        {
+            TestConvert<SignedDegRange  >();
+            TestConvert<UnsignedDegRange>();
+            TestConvert<SignedRadRange  >();
+            TestConvert<UnsignedRadRange>();
+            TestConvert<TestRange0      >();
+            TestConvert<TestRange1      >();
+            TestConvert<TestRange2      >();
+            TestConvert<TestRange3      >();
+        }
+
+        // --------------------------------------------------------
+        // c*r loses the resolution of the range magnified by r: real values up to 1000 for double, up to 10 for float
+        const F fRMax = sizeof(F) < sizeof(double) ? F(10.) : F(1000.);
+
+        std::default_random_engine             rand_engine                 ;
+        std::uniform_real_distribution<F>      c_uni_dist(Type::L, Type::H);
+        std::uniform_real_distribution<F>      r_uni_dist(0.     , fRMax  ); // for multiplication,division by real-value
+        std::uniform_real_distribution<F>      t_uni_dist(-1.    , 1.     ); // for inverse-trigonometric functions
+
+        std::random_device rnd_device;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        for (unsigned i = 10000; i--;)
+        {
+            CircVal<Type, F> c1(c_uni_dist(rand_engine)); // random circular value
+            CircVal<Type, F> c2(c_uni_dist(rand_engine)); // random circular value
+            CircVal<Type, F> c3(c_uni_dist(rand_engine)); // random circular value
+            F                r (r_uni_dist(rand_engine)); // random real     value [    0, 1000) - for testing *,/ operators
+            F                a1(t_uni_dist(rand_engine)); // random real     value [   -1,    1) - for testing asin,acos
+            F                a2(t_uni_dist(rand_engine)); // random real     value [-1000, 1000) - for testing atan
+
+            assert            (c1                                 == CV((F)c1)                         );
+
+            const F          w (r_uni_dist(rand_engine) * (i % 2 ? 1. : -1.) * Type::R); // random real value, far outside the range
+            assert            (CV::IsInRange(CV::Wrap(w))                                              ); // Wrap is in range
+            AssertCircAlmostEq(CircVal<Type, F>::Wrap(w)            , Mod<F>(w - F(Type::L), F(Type::R)) + F(Type::L)); // Wrap = Mod (division based)
+
+            AssertCircAlmostEq(+c1                                  , c1                               ); // +c         = c
+            AssertCircAlmostEq(-(-c1)                               , c1                               ); // -(-c)      = c
+            AssertCircAlmostEq(c1 + c2                              , c2 + c1                          ); // c1+c2      = c2+c1
+            AssertCircAlmostEq(c1 + (c2 +c3)                        , (c1 + c2) + c3                   ); // c1+(c2+c3) = (c1+c2)+c3
+            AssertCircAlmostEq(c1 + -c1                             , ZeroVal                          ); // c+(-c)     = z
+            AssertCircAlmostEq(c1 + ZeroVal                         , c1                               ); // c+z        = c
+
+            AssertCircAlmostEq(c1      - c1                         , ZeroVal                          ); // c-c        = z
+            AssertCircAlmostEq(c1      - ZeroVal                    , c1                               ); // c-z        = c
+            AssertCircAlmostEq(ZeroVal - c1                         , -c1                              ); // z-c        = -c
+            AssertCircAlmostEq(c1      - c2                         , -(c2 - c1)                       ); // c1-c2      = -(c2-c1)
+
+            AssertCircAlmostEq(c1 * 0.                              , ZeroVal                          ); // c*0        = 0
+            AssertCircAlmostEq(c1 * 1.                              , c1                               ); // c*1        = c
+            AssertCircAlmostEq(c1 / 1.                              , c1                               ); // c/1        = c
+
+            AssertCircAlmostEq((c1 * (1./(r+1.))) / (1./(r+1.))     , c1                               ); // (c*r)/r    = c, 0<r<=1
+            AssertCircAlmostEq((c1 / (    r+1.) ) * (    r+1. )     , c1                               ); // (c/r)*r    = c,   r>=1
+
+            // --------------------------------------------------------
+            AssertCircAlmostEq(~(~c1)                               , c1                               ); // opposite(opposite(c) = c
+            AssertCircAlmostEq(c1 - (~c1)                           , ToC<Type, F>(Type::R/2.)         ); // c - ~c               = r/2+z
+
+            // --------------------------------------------------------
+            AssertAlmostEq    (std::sin(ToR(CircVal<SignedRadRange, F>(c1))), sin(c1)); // member func sin
+            AssertAlmostEq    (std::cos(ToR(CircVal<SignedRadRange, F>(c1))), cos(c1)); // member func cos
+            AssertAlmostEq    (std::tan(ToR(CircVal<SignedRadRange, F>(c1))), tan(c1)); // member func tan
+
+            AssertAlmostEq    (sincos(c1).first                     ,  sin(c1)                         ); // sincos
+            AssertAlmostEq    (sincos(c1).second                    ,  cos(c1)                         ); // sincos
+            assert            (std::abs(sincos_fast(c1).first  - sin(c1)) <= SinCosTable::MaxError + 16*std::numeric_limits<F>::epsilon()); // sincos_fast
+            assert            (std::abs(sincos_fast(c1).second - cos(c1)) <= SinCosTable::MaxError + 16*std::numeric_limits<F>::epsilon()); // sincos_fast
+
+            AssertAlmostEq    (sin(-c1)                             , -sin(c1)                         ); // sin(-c)    = -sin(c)
+            AssertAlmostEq    (cos(-c1)                             ,  cos(c1)                         ); // cos(-c)    =  cos(c)
+            // tan is ill-conditioned near its poles: its relative error is ~|tan| times the relative error of the argument -
+            // beyond the tolerance of float storage only
+            const bool bTan = !std::is_same_v<F, float> || std::abs(tan(c1)) < 100.;
+
+            if (bTan)
+            AssertAlmostEq    (tan(-c1)                             , -tan(c1)                         ); // tan(-c1)   = -tan(c) the error may be large
+
+            AssertAlmostEq    (sin(c1+ToC<Type, F>(Type::R/4.))     ,  cos(c1)                         ); // sin(c+r/4) =  cos(c)
+            AssertAlmostEq    (cos(c1+ToC<Type, F>(Type::R/4.))     , -sin(c1)                         ); // cos(c+r/4) = -sin(c)
+            AssertAlmostEq    (sin(c1+ToC<Type, F>(Type::R/2.))     , -sin(c1)                         ); // sin(c+r/2) = -sin(c)
+            AssertAlmostEq    (cos(c1+ToC<Type, F>(Type::R/2.))     , -cos(c1)                         ); // cos(c+r/2) = -cos(c)
+
+            AssertAlmostEq    (Sqr(sin(c1))+Sqr(cos(c1))            , 1.                               ); // sin(x)^2+cos(x)^2 = 1
+
+            if (bTan)
+            AssertAlmostEq    (sin(c1)/cos(c1)                      , tan(c1)                          ); // sin(x)/cos(x) = tan(x)
+
+            // --------------------------------------------------------
+            AssertCircAlmostEq(asin<Type, F>(a1)                    , CircVal<SignedRadRange, F>(std::asin(a1))); // member func asin
+            AssertCircAlmostEq(acos<Type, F>(a1)                    , CircVal<SignedRadRange, F>(std::acos(a1))); // member func acos
+            AssertCircAlmostEq(atan<Type, F>(a2)                    , CircVal<SignedRadRange, F>(std::atan(a2))); // member func atan
+
+            AssertCircAlmostEq(asin<Type, F>(a1) + asin<Type, F>(-a1), ZeroVal                          ); // asin(r)+asin(-r) = z
+            AssertCircAlmostEq(acos<Type, F>(a1) + acos<Type, F>(-a1), ToC<Type, F>(Type::R / 2.)       ); // acos(r)+acos(-r) = r/2+z
+            AssertCircAlmostEq(asin<Type, F>(a1) + acos<Type, F>( a1), ToC<Type, F>(Type::R / 4.)       ); // asin(r)+acos( r) = r/4+z
+            AssertCircAlmostEq(atan<Type, F>(a2) + atan<Type, F>(-a2), ZeroVal                          ); // atan(r)+atan(-r) = z
+
+            // --------------------------------------------------------
+            assert            ((c1 >  c2)                         ==    (c2 <  c1)                     ); // c1> c2 <==>   c2< c1
+            assert            ((c1 >= c2)                         ==    (c2 <= c1)                     ); // c1>=c2 <==>   c2<=c1
+            assert            ((c1 >= c2)                         ==  ( (c1 >  c2) ||  (c1 == c2))     ); // c1>=c2 <==>  (c1> c2)|| (c1==c2)
+            assert            ((c1 <= c2)                         ==  ( (c1 <  c2) ||  (c1 == c2))     ); // c1<=c2 <==>  (c1< c2)|| (c1==c2)
+            assert            ((c1 >  c2)                         ==  (!(c1 == c2) && !(c1 <  c2))     ); // c1> c2 <==> !(c1==c2)&&!(c1< c2)
+            assert            ((c1 == c2)                         ==  (!(c1 >  c2) && !(c1 <  c2))     ); // c1= c2 <==> !(c1> c2)&&!(c1< c2)
+            assert            ((c1 <  c2)                         ==  (!(c1 == c2) && !(c1 >  c2))     ); // c1< c2 <==> !(c1==c2)&&!(c1> c2)
+            assert            (!(c1>c2) || !(c2>c3) || (c1>c3)                                         ); // (c1>c2)&&(c2>c3) ==> c1>c3
+
+            // --------------------------------------------------------
+            AssertCircAlmostEq(c1                                   , ToC<Type, F>(ToR( c1)       )    ); //  c1        = ToC(ToR( c1)
+            AssertCircAlmostEq(-c1                                  , ToC<Type, F>(ToR(-c1)       )    ); // -c1        = ToC(ToR(-c1)
+            AssertCircAlmostEq(c1 + c2                              , ToC<Type, F>(ToR(c1)+ToR(c2))    ); // c1+c2      = ToC(ToR(c1)+ToR(c2))
+            AssertCircAlmostEq(c1 - c2                              , ToC<Type, F>(ToR(c1)-ToR(c2))    ); // c1-c2      = ToC(ToR(c1)-ToR(c2))
+            AssertCircAlmostEq(c1 * r                               , ToC<Type, F>(ToR(c1) * r    )    ); // c1*r       = ToC(ToR(c1)*r      )
+            // c1/r for small r is far outside the range, where the absolute error is ~|c1/r| times the storage epsilon -
+            // beyond the tolerance of float storage only
+            if (!std::is_same_v<F, float> || std::abs(ToR(c1) / r) * std::numeric_limits<F>::epsilon() < 1e-5)
+            AssertCircAlmostEq(c1 / r                               , ToC<Type, F>(ToR(c1) / r    )    ); // c1/r       = ToC(ToR(c1)/r      )
+
+            // --------------------------------------------------------
+        }
+    }
+
+public:
+    CircValTester()
+    {
+        Test();
+    }
+};
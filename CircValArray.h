@@ -0,0 +1,443 @@
+// ==========================================================================
+// Copyright (C) 2026 DRNadler
+// ==========================================================================
+// classes defined here:
+// CircValKernels     - branchless circular-value kernels, over the operations of CircSimd.h
+// CircValArray       - array of circular-values (contiguous doubles), with vectorized bulk operations
+// CircValArrayTester - tester for CircValArray class
+// ==========================================================================
+
+#pragma once
+
+#include <cmath>
+#include <assert.h>
+#include <bit>             // std::bit_cast
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
+#include <type_traits>     // std::is_same_v
+#include <vector>
+
+#include "CircVal.h"       // CircVal, CircValType
+#include "CircSimd.h"      // CircSimdLoop, CircSimdScalar, CircSimdNative
+
+// ==========================================================================
+// branchless circular-value kernels
+// each kernel computes the same operations, in the same order, as the equivalent CircVal function,
+// so results are bit-identical to CircVal - boundary cases included
+// Type should be defined using the CircValType template
+// Ops is one of the operations classes of CircSimd.h
+template <typename Type, typename Ops>
+struct CircValKernels
+{
+    using V = typename Ops::V;
+
+    // ModConst<Type::R>(x) + Type::L - see ModConst() in CircHelper.h
+    static V ModL(V x)
+    {
+        return Ops::Add(ModConstKernel<Type::R, Ops>(x), Ops::Set(Type::L));
+    }
+
+    // CircVal::Wrap
+    static V Wrap(V r)
+    {
+        const V L  = Ops::Set(Type::L        );
+        const V H  = Ops::Set(Type::H        );
+        const V R  = Ops::Set(Type::R        );
+        const V HR = Ops::Set(Type::H+Type::R);
+        const V LR = Ops::Set(Type::L-Type::R);
+
+        const auto geL  = Ops::Ge(r, L );
+        const auto ltH  = Ops::Lt(r, H );
+        const auto ltHR = Ops::Lt(r, HR);
+        const auto geLR = Ops::Ge(r, LR);
+
+        const V rpR = Ops::Add(r, R);
+
+        V res = ModL(Ops::Sub(r, L));                                                                 // general case
+        res   = Ops::Select(Ops::Lt(res, H)                   , res                                , L  ); // m+L may round up to H
+        res   = Ops::Select(Ops::AndNot(geL, geLR)            , Ops::Select(Ops::Lt(rpR, H), rpR, L), res); // [L-R, L)
+        res   = Ops::Select(Ops::AndNot(ltH, Ops::And(geL, ltHR)), Ops::Sub(r, R)                  , res); // [H  , H+R)
+        res   = Ops::Select(Ops::And(geL, ltH)                , r                                  , res); // [L  , H)
+        return res;
+    }
+
+    // CircVal::Sdist
+    static V Sdist(V c1, V c2)
+    {
+        const V R  = Ops::Set(Type::R  );
+        const V R2 = Ops::Set(Type::R_2);
+
+        const V d = Ops::Sub(c2, c1);
+
+        V res = Ops::Select(Ops::Ge(d, R2), Ops::Sub(d, R), d);
+        res   = Ops::Select(Ops::Lt(d, Ops::Sub(Ops::Set(0.), R2)), Ops::Add(d, R), res);
+        return res;
+    }
+
+    // CircVal::Pdist
+    static V Pdist(V c1, V c2)
+    {
+        return Ops::Select(Ops::Ge(c2, c1), Ops::Sub(c2, c1), Ops::Add(Ops::Sub(Ops::Set(Type::R), c1), c2));
+    }
+
+    // CircVal<Type>(CircVal<Type2>) - see CircConvert in CircVal.h
+    template <typename Type2>
+    static V From(V c)
+    {
+        if constexpr (CircConvert<Type2, Type>::bNarrowWrap)
+            return CircConvert<Type2, Type>::template Kernel<Ops>(c);
+        else
+        {
+            const V p = CircValKernels<Type2, Ops>::Pdist(Ops::Set(Type2::Z), c);
+            return Wrap(Ops::Add(Ops::Mul(p, Ops::Set(Type::R/Type2::R)), Ops::Set(Type::Z)));
+        }
+    }
+};
+
+// ==========================================================================
+// array of circular values
+// the values are stored as contiguous doubles; all bulk operations are vectorized (see CircSimd.h)
+// Type should be defined using the CircValType template
+template <typename Type>
+class CircValArray
+{
+    std::vector<double> vals; // actual values [Type::L, Type::H)
+
+    // ---------------------------------------------
+public:
+    // 'wraps' floating-point values to [Type::L,Type::H), in place
+    static void Wrap(std::span<double> r)
+    {
+        double* p = r.data();
+        CircSimdLoop(r.size(), [&](auto ops, size_t i)
+        {
+            using Ops = decltype(ops);
+            Ops::Store(&p[i], CircValKernels<Type, Ops>::Wrap(Ops::Load(&p[i])));
+        });
+    }
+
+    // the length of shortest directed walk from c1[i] to c2[i]. d[i] is in [-Type::R/2, Type::R/2)
+    static void Sdist(const CircValArray& c1, const CircValArray& c2, std::span<double> d)
+    {
+        Sdist(c1.Vals(), c2.Vals(), d);
+    }
+
+    // same, over values [Type::L, Type::H) held elsewhere - e.g. a memory-mapped file (see CircFileReader::Doubles)
+    static void Sdist(std::span<const double> c1, std::span<const double> c2, std::span<double> d)
+    {
+        assert(c1.size() == c2.size() && c1.size() == d.size());
+        const double* p1 = c1.data();
+        const double* p2 = c2.data();
+        double*       pd = d .data();
+        CircSimdLoop(d.size(), [&](auto ops, size_t i)
+        {
+            using Ops = decltype(ops);
+            Ops::Store(&pd[i], CircValKernels<Type, Ops>::Sdist(Ops::Load(&p1[i]), Ops::Load(&p2[i])));
+        });
+    }
+
+    // the length of the shortest increasing walk from c1[i] to c2[i]. d[i] is in [0, Type::R)
+    static void Pdist(const CircValArray& c1, const CircValArray& c2, std::span<double> d)
+    {
+        Pdist(c1.Vals(), c2.Vals(), d);
+    }
+
+    // same, over values [Type::L, Type::H) held elsewhere - e.g. a memory-mapped file (see CircFileReader::Doubles)
+    static void Pdist(std::span<const double> c1, std::span<const double> c2, std::span<double> d)
+    {
+        assert(c1.size() == c2.size() && c1.size() == d.size());
+        const double* p1 = c1.data();
+        const double* p2 = c2.data();
+        double*       pd = d .data();
+        CircSimdLoop(d.size(), [&](auto ops, size_t i)
+        {
+            using Ops = decltype(ops);
+            Ops::Store(&pd[i], CircValKernels<Type, Ops>::Pdist(Ops::Load(&p1[i]), Ops::Load(&p2[i])));
+        });
+    }
+
+    // ---------------------------------------------
+    CircValArray()
+    {
+    }
+
+    // n values of Type::Z
+    explicit CircValArray(size_t n) : vals(n, Type::Z)
+    {
+    }
+
+    // construction based on floating-point values
+    // floating-point values are wrapped into the range
+    explicit CircValArray(std::span<const double> r) : vals(r.begin(), r.end())
+    {
+        Wrap(vals);
+    }
+
+    // construction based on circular values of the same type
+    explicit CircValArray(std::span<const CircVal<Type>> c) : vals(c.begin(), c.end())
+    {
+    }
+
+    // construction based on an array of circular values of another type
+    // sample use: CircValArray<SignedRadRange> a= a2;   -or-   CircValArray<SignedRadRange> a(a2);
+    template<typename Type2>
+    CircValArray(const CircValArray<Type2>& a) : vals(a.Size())
+    {
+        CircConvert<Type2, Type>::Apply(a.Vals(), vals);
+    }
+
+    // ---------------------------------------------
+    size_t                  Size      (                             ) const { return vals.size(); }
+    const double*           Data      (                             ) const { return vals.data(); }
+    std::span<const double> Vals      (                             ) const { return vals;        } // the values [Type::L, Type::H)
+    CircVal<Type>           operator[](size_t i                     ) const { return vals[i];     }
+    void                    Set       (size_t i, const CircVal<Type>& c)    { vals[i] = c;        }
+
+    // copy to circular values
+    std::vector<CircVal<Type>> ToCircVals() const
+    {
+        return std::vector<CircVal<Type>>(vals.begin(), vals.end());
+    }
+
+    // ---------------------------------------------
+    // element-wise operations - same as the CircVal operators
+    CircValArray& operator+=(const CircValArray& a)
+    {
+        assert(Size() == a.Size());
+        return Apply(a, [](auto ops, auto v, auto c) { using Ops = decltype(ops); return Ops::Sub(Ops::Add(v, c), Ops::Set(Type::Z)); });
+    }
+
+    CircValArray& operator-=(const CircValArray& a)
+    {
+        assert(Size() == a.Size());
+        return Apply(a, [](auto ops, auto v, auto c) { using Ops = decltype(ops); return Ops::Add(Ops::Sub(v, c), Ops::Set(Type::Z)); });
+    }
+
+    CircValArray& operator+=(const CircVal<Type>& c)
+    {
+        const double fc = c;
+        return Apply([=](auto ops, auto v) { using Ops = decltype(ops); return Ops::Sub(Ops::Add(v, Ops::Set(fc)), Ops::Set(Type::Z)); });
+    }
+
+    CircValArray& operator-=(const CircVal<Type>& c)
+    {
+        const double fc = c;
+        return Apply([=](auto ops, auto v) { using Ops = decltype(ops); return Ops::Add(Ops::Sub(v, Ops::Set(fc)), Ops::Set(Type::Z)); });
+    }
+
+    CircValArray& operator*=(const double& r)
+    {
+        return Apply([=](auto ops, auto v) { using Ops = decltype(ops); return Ops::Add(Ops::Mul(Ops::Sub(v, Ops::Set(Type::Z)), Ops::Set(r)), Ops::Set(Type::Z)); });
+    }
+
+    CircValArray& operator/=(const double& r)
+    {
+        return Apply([=](auto ops, auto v) { using Ops = decltype(ops); return Ops::Add(Ops::Div(Ops::Sub(v, Ops::Set(Type::Z)), Ops::Set(r)), Ops::Set(Type::Z)); });
+    }
+
+    const CircValArray operator+(const CircValArray&  a) const { CircValArray t(*this); return t += a; }
+    const CircValArray operator-(const CircValArray&  a) const { CircValArray t(*this); return t -= a; }
+    const CircValArray operator+(const CircVal<Type>& c) const { CircValArray t(*this); return t += c; }
+    const CircValArray operator-(const CircVal<Type>& c) const { CircValArray t(*this); return t -= c; }
+    const CircValArray operator*(const double&        r) const { CircValArray t(*this); return t *= r; }
+    const CircValArray operator/(const double&        r) const { CircValArray t(*this); return t /= r; }
+
+    // ---------------------------------------------
+    // same as the sin, cos free functions of CircVal.h
+    void Sin(std::span<double> s) const { Trig(s, [](double r) { return std::sin(r); }); }
+    void Cos(std::span<double> s) const { Trig(s, [](double r) { return std::cos(r); }); }
+
+    // s[i], c[i] = sincos(vals[i]) - same as the sincos free function of CircVal.h: vectorized, within 1 ulp of Sin(), Cos()
+    void SinCos(std::span<double> s, std::span<double> c) const
+    {
+        assert(s.size() == Size() && c.size() == Size());
+        const double* p  = vals.data();
+        double*       ps = s.data();
+        double*       pc = c.data();
+        CircSimdLoop(vals.size(), [&](auto ops, size_t i)
+        {
+            using Ops = decltype(ops);
+            typename Ops::V vs, vc;
+            SinCosKernel<Ops>(ToSignedRad<Ops>(Ops::Load(&p[i])), vs, vc);
+            Ops::Store(&ps[i], vs);
+            Ops::Store(&pc[i], vc);
+        });
+    }
+
+    // s[i], c[i] = sincos_fast(vals[i]) - same as the sincos_fast free function of CircVal.h: max abs error SinCosTable::MaxError
+    void SinCosFast(std::span<double> s, std::span<double> c) const
+    {
+        assert(s.size() == Size() && c.size() == Size());
+        for (size_t i = 0; i < vals.size(); ++i)
+            SinCosTable::Get((vals[i] - Type::Z) * (1. / Type::R), s[i], c[i]);
+    }
+
+private:
+    // vals[i] = Wrap(F(vals[i]))
+    template<typename F>
+    CircValArray& Apply(F&& f)
+    {
+        double* p = vals.data();
+        CircSimdLoop(vals.size(), [&](auto ops, size_t i)
+        {
+            using Ops = decltype(ops);
+            Ops::Store(&p[i], CircValKernels<Type, Ops>::Wrap(f(ops, Ops::Load(&p[i]))));
+        });
+        return *this;
+    }
+
+    // vals[i] = Wrap(F(vals[i], a[i]))
+    template<typename F>
+    CircValArray& Apply(const CircValArray& a, F&& f)
+    {
+        double*       p  = vals.data();
+        const double* pa = a.Data();
+        CircSimdLoop(vals.size(), [&](auto ops, size_t i)
+        {
+            using Ops = decltype(ops);
+            Ops::Store(&p[i], CircValKernels<Type, Ops>::Wrap(f(ops, Ops::Load(&p[i]), Ops::Load(&pa[i]))));
+        });
+        return *this;
+    }
+
+    // ToR(CircVal<SignedRadRange>(v))
+    template<typename Ops>
+    static typename Ops::V ToSignedRad(typename Ops::V v)
+    {
+        if constexpr (std::is_same_v<Type, SignedRadRange>)
+            return Ops::Sub(v, Ops::Set(SignedRadRange::Z)); // no conversion
+        else
+            return Ops::Sub(CircValKernels<SignedRadRange, Ops>::template From<Type>(v), Ops::Set(SignedRadRange::Z));
+    }
+
+    // s[i] = F(ToR(CircVal<SignedRadRange>(vals[i])))
+    template<typename F>
+    void Trig(std::span<double> s, F&& f) const
+    {
+        assert(s.size() == Size());
+        const double* p  = vals.data();
+        double*       ps = s.data();
+        CircSimdLoop(vals.size(), [&](auto ops, size_t i)
+        {
+            using Ops = decltype(ops);
+            Ops::Store(&ps[i], ToSignedRad<Ops>(Ops::Load(&p[i])));
+        });
+
+        for (size_t i = 0; i < s.size(); ++i)
+            ps[i] = f(ps[i]);
+    }
+};
+
+// ==========================================================================
+// tester for CircValArray class
+// all bulk operations must be bit-identical to the CircVal operations
+template <typename Type>
+class CircValArrayTester
+{
+    static bool IsBitEq(double r1, double r2)
+    {
+        return std::bit_cast<uint64_t>(r1) == std::bit_cast<uint64_t>(r2);
+    }
+
+    // floating-point values at and around the boundaries of Wrap and Mod
+    static std::vector<double> BoundaryVals()
+    {
+        std::vector<double> r;
+        const double Inf = std::numeric_limits<double>::infinity();
+
+        for (const double b : { Type::L, Type::H, Type::Z, Type::L-Type::R, Type::H+Type::R, Type::L-2*Type::R, Type::H+2*Type::R, 0. })
+        {
+            r.emplace_back(b);
+            r.emplace_back(std::nextafter(b,  Inf));
+            r.emplace_back(std::nextafter(b, -Inf));
+            r.emplace_back(b + 1e-17);
+            r.emplace_back(b - 1e-17);
+        }
+
+        for (const double b : { 1e-300, -1e-300, 1e-17, -1e-17, 1e6, -1e6, 1e15, -1e15, 106.81415022205296, -106.81415022205296 })
+            r.emplace_back(b);
+
+        return r;
+    }
+
+public:
+    CircValArrayTester()
+    {
+        Test();
+    }
+
+    static void Test()
+    {
+        std::default_random_engine             rand_engine                   ;
+        std::uniform_real_distribution<double> c_uni_dist(Type::L, Type::H  );
+        std::uniform_real_distribution<double> w_uni_dist(-3*Type::R, 3*Type::R); // values to be wrapped
+        std::uniform_real_distribution<double> r_uni_dist(0.     , 1000.    ); // for multiplication,division by real-value
+
+        std::random_device rnd_device;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        // --------------------------------------------------------
+        // Wrap
+        std::vector<double> w = BoundaryVals();
+        for (unsigned i = 1000; i--;)
+            w.emplace_back(w_uni_dist(rand_engine));
+
+        std::vector<double> ww = w;
+        CircValArray<Type>::Wrap(ww);
+        for (size_t i = 0; i < w.size(); ++i)
+            assert(IsBitEq(ww[i], CircVal<Type>::Wrap(w[i])));
+
+        // --------------------------------------------------------
+        const size_t n = 1003; // not a multiple of the number of lanes
+        std::vector<CircVal<Type>> c1(n), c2(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            c1[i] = c_uni_dist(rand_engine);
+            c2[i] = i < ww.size() ? CircVal<Type>(ww[i]) : CircVal<Type>(c_uni_dist(rand_engine)); // include the wrapped boundary values
+        }
+
+        const CircValArray<Type> a1{std::span<const CircVal<Type>>(c1)};
+        const CircValArray<Type> a2{std::span<const CircVal<Type>>(c2)};
+        const double             r  = r_uni_dist(rand_engine);
+
+        const CircValArray<Type> Add  = a1 + a2   ;
+        const CircValArray<Type> Sub  = a1 - a2   ;
+        const CircValArray<Type> AddC = a1 + c2[0];
+        const CircValArray<Type> SubC = a1 - c2[0];
+        const CircValArray<Type> Mul  = a1 * r    ;
+        const CircValArray<Type> Div  = a1 / r    ;
+
+        const CircValArray<SignedDegRange  > ConvA(a1);
+        const CircValArray<UnsignedRadRange> ConvB(a1);
+
+        std::vector<double> Sd(n), Pd(n), Sn(n), Cs(n), Sn2(n), Cs2(n), Sn3(n), Cs3(n);
+        CircValArray<Type>::Sdist(a1, a2, Sd);
+        CircValArray<Type>::Pdist(a1, a2, Pd);
+        a1.Sin(Sn);
+        a1.Cos(Cs);
+        a1.SinCos    (Sn2, Cs2);
+        a1.SinCosFast(Sn3, Cs3);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            assert(IsBitEq(Add [i], c1[i] + c2[i]                            ));
+            assert(IsBitEq(Sub [i], c1[i] - c2[i]                            ));
+            assert(IsBitEq(AddC[i], c1[i] + c2[0]                            ));
+            assert(IsBitEq(SubC[i], c1[i] - c2[0]                            ));
+            assert(IsBitEq(Mul [i], c1[i] * r                                ));
+            assert(IsBitEq(Div [i], c1[i] / r                                ));
+            assert(IsBitEq(ConvA[i], CircVal<SignedDegRange  >(c1[i])        ));
+            assert(IsBitEq(ConvB[i], CircVal<UnsignedRadRange>(c1[i])        ));
+            assert(IsBitEq(Sd  [i], CircVal<Type>::Sdist(c1[i], c2[i])       ));
+            assert(IsBitEq(Pd  [i], CircVal<Type>::Pdist(c1[i], c2[i])       ));
+            assert(IsBitEq(Sn  [i], sin(c1[i])                               ));
+            assert(IsBitEq(Cs  [i], cos(c1[i])                               ));
+            assert(IsBitEq(Sn2 [i], sincos     (c1[i]).first                 ));
+            assert(IsBitEq(Cs2 [i], sincos     (c1[i]).second                ));
+            assert(IsBitEq(Sn3 [i], sincos_fast(c1[i]).first                 ));
+            assert(IsBitEq(Cs3 [i], sincos_fast(c1[i]).second                ));
+        }
+    }
+};
@@ -0,0 +1,260 @@
+// ==========================================================================
+// Copyright (C) 2026 DRNadler
+// ==========================================================================
+// classes defined here:
+// CircValFixed       - fixed-point (integer-backed) circular-value
+// CircValFixedTester - tester for CircValFixed class
+// ==========================================================================
+
+#pragma once
+
+#include <cmath>
+#include <assert.h>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+
+#include "CircVal.h"      // CircVal, CircValType
+
+// ==========================================================================
+// fixed-point circular value
+// the range [Type::L, Type::H) is divided into 2^Bits equal steps of Q= Type::R / 2^Bits.
+// n in [0, 2^Bits) represents the circular value Type::L + n*Q, so wrapping is a mask - or the unsigned overflow of IntT,
+// when Bits is the number of bits of IntT - and +, -, unary -, ~, Sdist, Pdist and the comparisons are exact.
+// sample use: 16-bit encoder counts - CircValFixed<UnsignedDegRange, uint16_t>; milliseconds of a day - CircValFixed<DayRange, uint32_t>
+//
+// Type::Z is represented by the nearest step, NZ. * and / round the result to the nearest step.
+// conversion to CircVal is exact for Bits <= 53 when Q is a power of two (e.g. Type::R= 360 or 256); else it is rounded,
+// and conversion back to CircValFixed returns the same n (the round trip is lossless)
+// Type should be defined using the CircValType template; IntT is an unsigned integer type
+template <typename Type, typename IntT = uint16_t, int Bits = std::numeric_limits<IntT>::digits>
+class CircValFixed
+{
+    static_assert(std::is_unsigned_v<IntT>                                           , "CircValFixed: unsigned integer type expected"              );
+    static_assert(Bits > 0 && Bits <= std::numeric_limits<IntT>::digits && Bits <= 53, "CircValFixed: Bits should be in [1, min(digits of IntT, 53)]");
+
+public:
+    using CircType = Type;
+
+    static constexpr uint64_t N    = uint64_t(1) << Bits;                                      // number of steps
+    static constexpr uint64_t Mask = N - 1;
+    static constexpr double   Q    = Type::R / N;                                              // step
+    static constexpr IntT     NZ   = static_cast<IntT>(static_cast<uint64_t>((Type::Z - Type::L) / Q + 0.5) & Mask); // zero-value
+
+private:
+    IntT n; // actual value [0, 2^Bits)
+
+    // 'wraps' to [0, 2^Bits)
+    inline static IntT WrapN(uint64_t x)
+    {
+        return static_cast<IntT>(x & Mask);
+    }
+
+    // nearest step of circular-value v, in [Type::L, Type::H)
+    inline static IntT Quantize(double v)
+    {
+        return WrapN(static_cast<uint64_t>(std::llround((v - Type::L) * (N / Type::R))));
+    }
+
+    // round (n - NZ) * r to the nearest step, and add to NZ - see CircVal::operator*
+    inline static IntT Scale(IntT n, double r, bool bDiv)
+    {
+        const double d = static_cast<double>(static_cast<int64_t>(n) - static_cast<int64_t>(NZ));
+        const double x = std::fmod(bDiv ? d / r : d * r, static_cast<double>(N));          // exact: |x| < N
+        return WrapN(NZ + static_cast<uint64_t>(std::llround(x)));
+    }
+
+    // ---------------------------------------------
+public:
+    inline static double GetL() { return Type::L; }
+    inline static double GetH() { return Type::H; }
+    inline static double GetZ() { return Type::Z; }
+    inline static double GetR() { return Type::R; }
+    inline static double GetQ() { return Q      ; }
+
+    // ---------------------------------------------
+    // the length of shortest directed walk from c1 to c2
+    // return value is in [-Type::R/2, Type::R/2)
+    inline static double Sdist(const CircValFixed& c1, const CircValFixed& c2)
+    {
+        const uint64_t d = WrapN(uint64_t(c2.n) - c1.n);
+        return (d < N/2 ? static_cast<double>(d) : static_cast<double>(d) - static_cast<double>(N)) * Q;
+    }
+
+    // the length of the shortest increasing walk from c1 to c2
+    // return value is in [0, Type::R)
+    inline static double Pdist(const CircValFixed& c1, const CircValFixed& c2)
+    {
+        return static_cast<double>(WrapN(uint64_t(c2.n) - c1.n)) * Q;
+    }
+
+    // ---------------------------------------------
+    // construction based on the integer representation: Type::L + n*Q
+    inline static CircValFixed FromRaw(IntT n)
+    {
+        CircValFixed c;
+        c.n = WrapN(n);
+        return c;
+    }
+
+    // integer representation: Type::L + n*Q
+    IntT Raw() const
+    {
+        return n;
+    }
+
+    // ---------------------------------------------
+    CircValFixed() : n(NZ)
+    {
+    }
+
+    // construction based on a floating-point value
+    // floating-point is wrapped into the range, and rounded to the nearest step
+    CircValFixed(double r) : n(Quantize(CircVal<Type>::Wrap(r)))
+    {
+    }
+
+    // construction based on a circular value of the same type - rounded to the nearest step
+    CircValFixed(const CircVal<Type>& c) : n(Quantize(c))
+    {
+    }
+
+    // construction based on a circular value of another type and/or storage type - rounded to the nearest step
+    template<typename Type2, typename F2>
+    CircValFixed(const CircVal<Type2, F2>& c) : n(Quantize(CircVal<Type>(c)))
+    {
+    }
+
+    // construction based on a fixed-point circular value of another type, resolution or integer type
+    template<typename Type2, typename IntT2, int Bits2>
+    CircValFixed(const CircValFixed<Type2, IntT2, Bits2>& c) : n(Quantize(CircVal<Type>(CircVal<Type2>(c))))
+    {
+    }
+
+    // ---------------------------------------------
+    // no conversion to double - it would make CircVal<Type>(CircValFixed) ambiguous. use double(CircVal<Type>(c))
+    operator CircVal<Type>() const
+    {
+        return CircVal<Type>(Type::L + n * Q);
+    }
+
+    // ---------------------------------------------
+    // convert circular-value c to real-value [L-Z,H-Z). Z is converted to 0
+    friend double ToR(const CircValFixed& c) { return ToR(CircVal<Type>(c)); }
+
+    // ---------------------------------------------
+    const CircValFixed  operator+ (                     ) const { return *this;                                          }
+    const CircValFixed  operator- (                     ) const { return FromRaw(WrapN(2*uint64_t(NZ) - n   ));          } // return negative circular value
+    const CircValFixed  operator~ (                     ) const { return FromRaw(WrapN(uint64_t(n) + N/2    ));          } // return opposite circular-value
+
+    const CircValFixed  operator+ (const CircValFixed& c) const { return FromRaw(WrapN(uint64_t(n) + c.n - NZ));          }
+    const CircValFixed  operator- (const CircValFixed& c) const { return FromRaw(WrapN(uint64_t(n) - c.n + NZ));          }
+    const CircValFixed  operator* (const double&       r) const { return FromRaw(Scale(n, r, false          ));          }
+    const CircValFixed  operator/ (const double&       r) const { return FromRaw(Scale(n, r, true           ));          }
+
+          CircValFixed& operator+=(const CircValFixed& c)       { n = WrapN(uint64_t(n) + c.n - NZ);        return *this; }
+          CircValFixed& operator-=(const CircValFixed& c)       { n = WrapN(uint64_t(n) - c.n + NZ);        return *this; }
+          CircValFixed& operator*=(const double&       r)       { n = Scale(n, r, false          );         return *this; }
+          CircValFixed& operator/=(const double&       r)       { n = Scale(n, r, true           );         return *this; }
+
+          bool          operator==(const CircValFixed& c) const { return n == c.n;                                       }
+          bool          operator!=(const CircValFixed& c) const { return n != c.n;                                       }
+
+    // note that two circular values can be compared in several different ways.
+    // check carefully if this is really what you need!
+    bool                operator> (const CircValFixed& c) const { return n >  c.n;                                       }
+    bool                operator>=(const CircValFixed& c) const { return n >= c.n;                                       }
+    bool                operator< (const CircValFixed& c) const { return n <  c.n;                                       }
+    bool                operator<=(const CircValFixed& c) const { return n <= c.n;                                       }
+};
+
+// ==========================================================================
+template <typename Type, typename IntT, int Bits> static double sin(const CircValFixed<Type, IntT, Bits>& c) { return sin(CircVal<Type>(c)); }
+template <typename Type, typename IntT, int Bits> static double cos(const CircValFixed<Type, IntT, Bits>& c) { return cos(CircVal<Type>(c)); }
+template <typename Type, typename IntT, int Bits> static double tan(const CircValFixed<Type, IntT, Bits>& c) { return tan(CircVal<Type>(c)); }
+
+// ==========================================================================
+// tester for CircValFixed class
+template <typename Type, typename IntT = uint16_t, int Bits = std::numeric_limits<IntT>::digits>
+class CircValFixedTester
+{
+    using F = CircValFixed<Type, IntT, Bits>;
+    using C = CircVal     <Type            >;
+
+    // check if 2 circular-values are equal up to tolerance fTol
+    inline static bool IsCircNear(const C& c1, const C& c2, double fTol)
+    {
+        return std::abs(C::Sdist(c1, c2)) <= fTol;
+    }
+
+    inline static void Test()
+    {
+        static_assert(sizeof(F) == sizeof(IntT), "CircValFixed: no storage overhead expected");
+
+        const double fZErr = std::abs(C::Sdist(C(Type::Z), C(F())));                                 // quantization error of Z
+        assert(fZErr <= F::Q / 2.);
+
+        // --------------------------------------------------------
+        // wraparound is exact
+        assert(F::FromRaw(IntT(F::N-1)) + F::FromRaw(IntT((F::NZ + 1) & F::Mask)) == F::FromRaw(0)); // last step + one step = first step
+        assert(F::FromRaw(0) - F::FromRaw(IntT((F::NZ + 1) & F::Mask)) == F::FromRaw(IntT(F::N-1))); // first step - one step = last step
+        assert(-(-F::FromRaw(12345 & F::Mask)) == F::FromRaw(12345 & F::Mask));
+        assert(~(~F::FromRaw(12345 & F::Mask)) == F::FromRaw(12345 & F::Mask));
+
+        // --------------------------------------------------------
+        std::default_random_engine              rand_engine;
+        std::uniform_int_distribution<uint64_t> n_uni_dist(0, F::Mask);
+        std::uniform_real_distribution<double>  r_uni_dist(0., 10.);
+
+        std::random_device rnd_device;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        for (unsigned i = 10000; i--;)
+        {
+            const F      f1 = F::FromRaw(static_cast<IntT>(n_uni_dist(rand_engine)));
+            const F      f2 = F::FromRaw(static_cast<IntT>(n_uni_dist(rand_engine)));
+            const double r  = r_uni_dist(rand_engine);
+            [[maybe_unused]] const C c1 = f1;
+            [[maybe_unused]] const C c2 = f2;
+
+            // lossless round trip
+            assert(F(c1)                       == f1                       );
+            assert(F(static_cast<double>(c1))  == f1                       );
+
+            // same order as CircVal
+            assert((f1 <  f2)                  == (c1 <  c2)               );
+            assert((f1 == f2)                  == (c1 == c2)               );
+
+            // exact operations: same as CircVal - up to the quantization error of Z and the rounding of CircVal
+            [[maybe_unused]] const double fTol = 2. * fZErr + 1e-9 * Type::R;
+            assert(IsCircNear(f1 + f2           , c1 + c2                   , fTol                          ));
+            assert(IsCircNear(f1 - f2           , c1 - c2                   , fTol                          ));
+            assert(IsCircNear(-f1               , -c1                       , fTol                          ));
+            assert(IsCircNear(~f1               , ~c1                       , 1e-9 * Type::R                ));
+            assert(std::abs(F::Pdist(f1, f2)    - C::Pdist(c1, c2))           <= 1e-9 * Type::R              );
+            assert(std::abs(F::Sdist(f1, f2)    - C::Sdist(c1, c2))           <= 1e-9 * Type::R ||
+                   std::abs(std::abs(F::Sdist(f1, f2)) - Type::R_2)           <= 1e-9 * Type::R              ); // Sdist of opposite values may be -R/2 or R/2, due to rounding of CircVal
+
+            // rounded operations: rounded to the nearest step
+            assert(IsCircNear(f1 * r            , c1 * r                    , (r + 1.) * fZErr + F::Q / 2. + 1e-9 * Type::R));
+            assert(IsCircNear(f1 / (r + 1.)     , c1 / (r + 1.)             , 2. * fZErr + F::Q / 2. + 1e-9 * Type::R      ));
+
+            // compound assignment
+            F f3 = f1; f3 += f2; assert(f3 == f1 + f2       );
+            F f4 = f1; f4 -= f2; assert(f4 == f1 - f2       );
+            F f5 = f1; f5 *= r ; assert(f5 == f1 * r        );
+            F f6 = f1; f6 /= r ; assert(f6 == f1 / r        );
+
+            // trigonometric functions
+            assert(sin(f1) == sin(c1));
+            assert(cos(f1) == cos(c1));
+        }
+    }
+
+public:
+    CircValFixedTester()
+    {
+        Test();
+    }
+};
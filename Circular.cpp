@@ -1,326 +1,702 @@
-// ==========================================================================
-// Copyright (C) 2011 Lior Kogan (koganlior1@gmail.com)
-// ==========================================================================
-
-#include "stdafx.h"
-
-#include <chrono>
-#include <iostream>                 // cout
-#include <fstream>                  // ofstream
-#include <numbers>                  // std::numbers::pi
-#include <random>                   // random number generators 
-
-#include <ranges>                   // std::views::iota
-#include <execution>                // std::execution::par
-#include <syncstream>               // std::osyncstream
-
-#include "CircVal.h"                // CircVal, CircValTester
-#include "CircArc.h"                // CircArcLen, CircArc, CircArcTester
-#include "CircStat.h"               // CircAverage, WeightedCircAverage, CAvrgSampledCircSignal, CircMedian
-#include "CircHelper.h"             // Sqr, Mod
-#include "TruncNormalDist.h"        // truncated_normal_distribution
-#include "WrappedNormalDist.h"      // wrapped_normal_distribution
-#include "WrappedTruncNormalDist.h" // wrapped_truncated_normal_distribution
-
-// ==========================================================================
-int _tmain(int argc, _TCHAR* argv[])
-{
-    auto Time0 = chrono::system_clock::now();
-
-    // ------------------------------------------------------
-    {
-        CircVal   <UnsignedDegRange> Start0 ( 10.                );
-        CircArcLen<UnsignedRadRange> Length0(std::numbers::pi    );
-        CircArc   <SignedDegRange  > a0     (Start0, Length0     ); // construct by CircVal, CircArcLen
-
-        CircVal   <UnsignedRadRange> Start1 (std::numbers::pi/2  );
-        CircVal   <UnsignedRadRange> End1   (std::numbers::pi/2*3);
-        CircArc   <UnsignedDegRange> a1     (Start1, End1        ); // construct by CircVal, CircVal
-
-        CircVal   <UnsignedDegRange> Start2 ( 10.                );
-        CircVal   <UnsignedRadRange> End2   (std::numbers::pi    );
-        CircArc   <SignedDegRange  > a2     (Start2, End2        ); // construct by CircVal, CircVal (of different types)
-
-        CircArc   <UnsignedDegRange> a3     (100, 200            ); // construct by double, double
-        CircArc   <UnsignedRadRange> a4     (a3                  ); // construct by CircArc (of different type)
-        a4 = a3;                                                    // assignment operator
-
-        bool b1 = a3.Contains( 50 );
-        bool b2 = a3.Contains(100 );
-        bool b3 = a3.Contains(150 );
-        bool b4 = a3.Contains(200 );
-        bool b5 = a3.Contains(250 );
-        bool b6 = a3.Contains(300 );
-        bool b7 = a3.Contains(Start1);
-
-        CircArc<UnsignedDegRange> Arc3(a3);
-        CircArc<UnsignedRadRange> Arc4(a3);
-        CircArc<UnsignedRadRange> Arc5 = a3;
-        Arc5 = a4;
-
-        bool b = (Arc4 == Arc3);
-        double d = Arc4.GetL();
-
-        bool c1 = a4.Contains(Arc3);
-        bool c2 = CircArc<SignedDegRange  >(-170., 360.).Contains (CircArc<SignedDegRange  >(-180., 360.)); // both are full circles
-        bool c3 = CircArc<UnsignedDegRange>(   0., 100.).Intersect(CircArc<UnsignedDegRange>( 100., 100.));
-    }
-
-    // todo: assure ArcLength is equal
-
-    // ------------------------------------------------------
-    // testing correctness of CircVal class implementation
-    {
-        CircValTester<SignedDegRange  > testA;
-        CircValTester<UnsignedDegRange> testB;
-        CircValTester<SignedRadRange  > testC;
-        CircValTester<UnsignedRadRange> testD;
-
-        CircValTester<TestRange0      > test0;
-        CircValTester<TestRange1      > test1;
-        CircValTester<TestRange2      > test2;
-        CircValTester<TestRange3      > test3;
-    }
-
-    // ------------------------------------------------------
-    // testing correctness of CircArc class implementation
-    {
-        CircArcTester<SignedDegRange  > testA;
-        CircArcTester<UnsignedDegRange> testB;
-        CircArcTester<SignedRadRange  > testC;
-        CircArcTester<UnsignedRadRange> testD;
-
-        CircArcTester<TestRange0      > test0;
-        CircArcTester<TestRange1      > test1;
-        CircArcTester<TestRange2      > test2;
-        CircArcTester<TestRange3      > test3;
-    }
-
-    // ------------------------------------------------------
-    // sample code: basic circular math operations
-    {
-        CircVal<SignedDegRange  > c1 =  10. ;
-        CircVal<UnsignedRadRange> c2 =   0.2;
-        CircVal<SignedDegRange  > c3 = c1+c2;
-
-        c1 = c2;
-
-        c1 += 355.;
-        double d = c1;
-
-        d  = sin(c1) / cos(c2) + tan(c3);
-        c1 = asin<SignedDegRange>(0.5); // don't do d1= asin(0.5) !!!
-    }
-
-    // ------------------------------------------------------
-    // sample code: generating wrapped normal distributed random value
-    {
-        std::default_random_engine rand_engine;
-        std::random_device         rnd_device ;
-        rand_engine.seed(rnd_device()); // reseed engine
-
-        double fAvrg  =    0.;
-        double fSigma =   45.;
-        double fL     = -180.; // wrapping-range lower-bound
-        double fH     =  180.; // wrapping-range upper-bound
-
-        wrapped_normal_distribution<double> r_wrp(fAvrg, fSigma, fL, fH);
-        double r1 = r_wrp(rand_engine); // random value
-    }
-
-    // ------------------------------------------------------
-    // sample code: generating truncated normal distributed random value
-    {
-        std::default_random_engine rand_engine;
-        std::random_device         rnd_device ;
-        rand_engine.seed(rnd_device()); // reseed engine
-
-        double fAvrg  =    0.;
-        double fSigma =   45.;
-        double fA     =  -40.; // truncation-range lower-bound
-        double fB     =   40.; // truncation-range upper-bound
-
-        truncated_normal_distribution<double> r_trn(fAvrg, fSigma, fA, fB);
-        double r2 = r_trn(rand_engine); // random value
-    }
-
-    // ------------------------------------------------------
-    // sample code: generating wrapped truncated normal distributed random value
-    {
-        std::default_random_engine rand_engine;
-        std::random_device         rnd_device ;
-        rand_engine.seed(rnd_device()); // reseed engine
-
-        // normal distribution is first truncated, and then wrapped
-
-        const double fAvrg  =    0.;
-        const double fSigma =  100.;
-        const double fA     = -500.; // truncation-range lower-bound
-        const double fB     =  500.; // truncation-range upper-bound
-        const double fL     =    0.; // wrapping  -range lower-bound
-        const double fH     =  360.; // wrapping  -range upper-bound
-
-        wrapped_truncated_normal_distribution<double> r_wrp_trn(fAvrg, fSigma, fA, fB, fL, fH);
-        double d = r_wrp_trn(rand_engine); // random value
-    }
-
-    // ------------------------------------------------------
-    {
-        std::default_random_engine rand_engine;
-        std::random_device         rnd_device ;
-        rand_engine.seed(rnd_device()); // reseed engine
-        uniform_real_distribution<double> ud(0., 360.);
-
-        const size_t count = 100;
-        vector<CircVal<UnsignedDegRange>> Angles2(count);
-
-        auto Time0 = chrono::system_clock::now();
-        for (size_t i = 0; i < 100000; i++)
-        {
-            for (size_t j = 0; j < count; ++j)
-                Angles2[j] = ud(rand_engine);
-
-            auto y = CircAverage (Angles2);
-        }
-
-        auto Duration = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now() - Time0).count();
-        cout << Duration << endl;
-
-        Time0 = chrono::system_clock::now();
-        for (int i = 0; i < 100000; i++)
-        {
-            for (size_t j = 0; j < count; ++j)
-                Angles2[j] = ud(rand_engine);
-
-            auto z = CircAverage2(Angles2);
-        }
-
-        Duration = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now() - Time0).count();
-        cout << Duration << endl;
-
-        cout << "=================" << endl;
-    }
-
-    // ------------------------------------------------------
-    // code used to collect data for graphs that demonstrate average of circular values
-    {
-        vector<CircVal<UnsignedDegRange>> Angles2 = {30., 130., 230., 330.};
-        auto y = CircAverage (Angles2);
-        auto z = CircAverage2(Angles2);
-
-        ofstream f0("log0.txt");
-
-        for (double x = 0.; x <= 360.; x += 0.1)
-        {
-            double fSum = 0;
-            for (const auto& a : Angles2)
-                fSum += Sqr(__min(abs(x-a), 360.-abs(x-a)));
-
-            f0 << x << "\t" << fSum << endl;
-        }
-    }
-
-    // ------------------------------------------------------
-    // sample code: calculate median, average and weighted-average set of circular values
-    {
-        std::default_random_engine rand_engine;
-        std::random_device         rnd_device ;
-        rand_engine.seed(rnd_device()); // reseed engine
-
-        uniform_real_distribution<double> ud(UnsignedDegRange::L, UnsignedDegRange::H);
-
-        vector<     CircVal<UnsignedDegRange>        > angles1;
-        vector<pair<CircVal<UnsignedDegRange>,double>> angles2;
-
-        for (size_t i = 0; i < 3; ++i)
-        {
-            double m = ud(rand_engine);
-            angles1.emplace_back(m     );
-            angles2.emplace_back(m, 0.3);
-        }
-
-        auto Medn  = CircMedian         (angles1);
-        auto Avrg1 = CircAverage        (angles1);
-        auto Avrg2 = WeightedCircAverage(angles2);
-    }
-
-    // ------------------------------------------------------
-    // sample code: estimate average of a sampled continuous-time circular signal, using circular linear interpolation
-    {
-        CAvrgSampledCircSignal<UnsignedDegRange> A1;
-        A1.AddMeasurement(CircVal<UnsignedDegRange>(200.), 1);
-        A1.AddMeasurement(CircVal<UnsignedDegRange>(300.), 2);
-        A1.AddMeasurement(CircVal<UnsignedDegRange>( 20.), 6);
-
-        CircVal<UnsignedDegRange> ad1;
-        A1.GetAvrg(ad1);
-    }
-
-    // ------------------------------------------------------
-    // code used to collect data for RMS error of average estimation based on noisy measurements
-    {
-        std::default_random_engine rand_engine;
-        std::random_device         rnd_device ;
-        rand_engine.seed(rnd_device()); // reseed engine
-
-        ofstream f1("log1.txt");
-
-        auto numbers = std::views::iota(1, 101); // for each value of standard-deviation: 1..100
-        std::for_each(std::execution::par, numbers.begin(), numbers.end(), [&rand_engine, &f1](int nStdDev) 
-        {
-            std::osyncstream(std::cout) << "StdDev: " << nStdDev << endl;
-
-            uniform_real_distribution<double> ud(0., 360.);
-
-            double fSumSqrErr1 = 0.;
-            double fSumSqrErr2 = 0.;
-
-            const size_t nTrails  = 50000;                  // number of trails
-            const size_t nSamples =  1000;                  // number of observations per trail
-
-            vector<CircVal<UnsignedDegRange>> vInput(nSamples);
-
-            const double fAvrg = ud(rand_engine);           // our const parameter for this trail
-            wrapped_normal_distribution          <double> r_wnd1(fAvrg, nStdDev,                       0., 360.);
-         // wrapped_truncated_normal_distribution<double> r_wnd1(fAvrg, nStdDev, fAvrg-45., fAvrg+45., 0., 360.);
-
-            for (size_t t = 0; t < nTrails; ++t)
-            {
-                for (auto& Sample : vInput)
-                    Sample = r_wnd1(rand_engine);           // generate "noisy" observation
-
-                set<CircVal<UnsignedDegRange>> sAvrg1 = CircAverage(vInput);                   // avrg - method 1 (new method)
-
-                double fSigSin = 0.;
-                double fSigCos = 0.;
-
-                for (const auto& Sample : vInput)
-                {
-                    fSigSin += sin(Sample);
-                    fSigCos += cos(Sample);
-                }
-
-                CircVal<UnsignedDegRange> Avrg2 = atan2<UnsignedDegRange>(fSigSin, fSigCos);   // avrg - method 2 (conventional method)
-
-                const double fErr1 = CircVal<UnsignedDegRange>::Sdist(*sAvrg1.begin(), fAvrg); // error of estimate - method 1
-                const double fErr2 = CircVal<UnsignedDegRange>::Sdist(Avrg2          , fAvrg); // error of estimate - method 2
-
-                fSumSqrErr1 += Sqr(fErr1);
-                fSumSqrErr2 += Sqr(fErr2);
-            }
-
-            const double fRMS1 = sqrt(fSumSqrErr1 / (nTrails-1));  // root mean square error - method 1
-            const double fRMS2 = sqrt(fSumSqrErr2 / (nTrails-1));  // root mean square error - method 2
-
-            std::osyncstream(f1) << nStdDev << "\t" << fRMS1 << "\t" << fRMS2 << endl; // save RMS results to file
-        } );
-    }
-
-    // -----------------------------------
-    auto Duration = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now() - Time0).count();
-    cout << Duration << endl;
-
-    // system ("pause");
-
-    return 0;
-}
+// ==========================================================================
+// Copyright (C) 2011 Lior Kogan (koganlior1@gmail.com)
+// ==========================================================================
+
+// DRNadler 14-Oct-2026: Run CircConcurrentAggregatorTester.
+
+// DRNadler 14-Oct-2026: Run CircResamplerTester.
+
+// DRNadler 14-Oct-2026: Run WrappedNormalFitTester.
+
+// DRNadler 14-Oct-2026: Run WrappedDensityTester.
+
+// DRNadler 14-Oct-2026: Run TruncNormalDistTester.
+
+// DRNadler 14-Oct-2026: Run CircInstrumentTester.
+
+// DRNadler 14-Oct-2026: The timings moved to CircularBench.
+
+// DRNadler 14-Oct-2026: Timing of sincos.
+
+// DRNadler 14-Oct-2026: Run CircFileTester.
+
+// DRNadler 14-Oct-2026: Run CircAverageSummaryTester; sample code: a sharded average.
+
+// DRNadler 14-Oct-2026: Run CircHistogramTester; sample code: CircHistogram.
+
+// DRNadler 14-Oct-2026: Run the testers of float and long double values.
+
+// DRNadler 14-Oct-2026: Timing of the sorts.
+
+// DRNadler 14-Oct-2026: Sample code and timing of the modes of CAvrgSampledCircSignal.
+
+// DRNadler 14-Oct-2026: Timing of WeightedCircAverage over spans.
+
+// DRNadler 14-Oct-2026: Run CircArcIndexTester.
+
+// DRNadler 14-Oct-2026: Run CircArcsTester.
+
+// DRNadler 14-Oct-2026: Run CircValFixedTester.
+
+// DRNadler 14-Oct-2026: Timing of Wrap per range.
+
+// DRNadler 14-Oct-2026: The Monte Carlo simulations run on ParallelSimulate; run ParallelSimulationTester.
+
+// DRNadler 14-Oct-2026: Run WrappedNormalDistTester.
+
+// DRNadler 14-Oct-2026: Sample code: bulk sampling.
+
+// DRNadler 14-Oct-2026: Run CircValArrayTester.
+
+// DRNadler 14-Oct-2026: Timing of CircAverage2 with execution policies.
+
+// DRNadler 14-Oct-2026: Sample code: the workspace overloads.
+
+// DRNadler 14-Oct-2026: Sample code: sliding-window average by CircAverageAccumulator.
+
+// DRNadler 14-Oct-2026: Run CircStatTester for all ranges.
+
+#include "stdafx.h"
+
+#include <chrono>                   // total run time
+#include <iostream>                 // cout
+#include <fstream>                  // ofstream
+#include <filesystem>               // std::filesystem::temp_directory_path
+#include <numbers>                  // std::numbers::pi
+#include <random>                   // random number generators 
+#include <deque>                    // std::deque
+#include <thread>                   // std::thread
+
+#include "CircVal.h"                // CircVal, CircValTester
+#include "CircArc.h"                // CircArcLen, CircArc, CircArcs, CircArcIndex, CircArcTester, CircArcsTester, CircArcIndexTester
+#include "CircStat.h"               // CircAverage, CircAverageAccumulator, WeightedCircAverage, CircAverageSummary, CAvrgSampledCircSignal, CircMedian, CircHistogram
+#include "CircValArray.h"           // CircValArray, CircValArrayTester
+#include "CircValFixed.h"           // CircValFixed, CircValFixedTester
+#include "CircHelper.h"             // Sqr, Mod
+#include "TruncNormalDist.h"        // truncated_normal_distribution, TruncNormalDistTester
+#include "WrappedNormalDist.h"      // wrapped_normal_distribution, ziggurat_normal, WrappedNormalDistTester
+#include "WrappedTruncNormalDist.h" // wrapped_truncated_normal_distribution, wrapped_density_table, WrappedDensityTester
+#include "WrappedNormalFit.h"       // WrappedNormalFit, WrappedNormalEMStep, FitWrappedNormal, WrappedNormalFitTester
+#include "ParallelSimulation.h"     // ParallelSimulate, ParallelSimulationTester
+#include "CircFile.h"               // CircFileWriter, CircFileReader, CircBufferedWriter, CircFileTester
+#include "CircInstrument.h"         // CircInstrument, CircInstrumentData
+#include "CircResample.h"           // CircResampler, CircResamplerTester
+#include "CircAggregator.h"         // CircConcurrentAggregator, CircConcurrentAggregatorTester
+
+// ==========================================================================
+int _tmain(int argc, _TCHAR* argv[])
+{
+    auto Time0 = chrono::system_clock::now();
+
+    // ------------------------------------------------------
+    {
+        CircVal   <UnsignedDegRange> Start0 ( 10.                );
+        CircArcLen<UnsignedRadRange> Length0(std::numbers::pi    );
+        CircArc   <SignedDegRange  > a0     (Start0, Length0     ); // construct by CircVal, CircArcLen
+
+        CircVal   <UnsignedRadRange> Start1 (std::numbers::pi/2  );
+        CircVal   <UnsignedRadRange> End1   (std::numbers::pi/2*3);
+        CircArc   <UnsignedDegRange> a1     (Start1, End1        ); // construct by CircVal, CircVal
+
+        CircVal   <UnsignedDegRange> Start2 ( 10.                );
+        CircVal   <UnsignedRadRange> End2   (std::numbers::pi    );
+        CircArc   <SignedDegRange  > a2     (Start2, End2        ); // construct by CircVal, CircVal (of different types)
+
+        CircArc   <UnsignedDegRange> a3     (100, 200            ); // construct by double, double
+        CircArc   <UnsignedRadRange> a4     (a3                  ); // construct by CircArc (of different type)
+        a4 = a3;                                                    // assignment operator
+
+        bool b1 = a3.Contains( 50 );
+        bool b2 = a3.Contains(100 );
+        bool b3 = a3.Contains(150 );
+        bool b4 = a3.Contains(200 );
+        bool b5 = a3.Contains(250 );
+        bool b6 = a3.Contains(300 );
+        bool b7 = a3.Contains(Start1);
+
+        CircArc<UnsignedDegRange> Arc3(a3);
+        CircArc<UnsignedRadRange> Arc4(a3);
+        CircArc<UnsignedRadRange> Arc5 = a3;
+        Arc5 = a4;
+
+        bool b = (Arc4 == Arc3);
+        double d = Arc4.GetL();
+
+        bool c1 = a4.Contains(Arc3);
+        bool c2 = CircArc<SignedDegRange  >(-170., 360.).Contains (CircArc<SignedDegRange  >(-180., 360.)); // both are full circles
+        bool c3 = CircArc<UnsignedDegRange>(   0., 100.).Intersect(CircArc<UnsignedDegRange>( 100., 100.));
+    }
+
+    // todo: assure ArcLength is equal
+
+    // ------------------------------------------------------
+    // testing correctness of CircVal class implementation
+    {
+        CircValTester<SignedDegRange  > testA;
+        CircValTester<UnsignedDegRange> testB;
+        CircValTester<SignedRadRange  > testC;
+        CircValTester<UnsignedRadRange> testD;
+
+        CircValTester<TestRange0      > test0;
+        CircValTester<TestRange1      > test1;
+        CircValTester<TestRange2      > test2;
+        CircValTester<TestRange3      > test3;
+
+        // float and long double storage
+        CircValTester<SignedDegRange  , float      > testAf;
+        CircValTester<UnsignedRadRange, float      > testDf;
+        CircValTester<TestRange2      , float      > test2f;
+        CircValTester<SignedDegRange  , long double> testAl;
+        CircValTester<UnsignedRadRange, long double> testDl;
+        CircValTester<TestRange2      , long double> test2l;
+    }
+
+    // ------------------------------------------------------
+    // testing correctness of CircArc class implementation
+    {
+        CircArcTester<SignedDegRange  > testA;
+        CircArcTester<UnsignedDegRange> testB;
+        CircArcTester<SignedRadRange  > testC;
+        CircArcTester<UnsignedRadRange> testD;
+
+        CircArcTester<TestRange0      > test0;
+        CircArcTester<TestRange1      > test1;
+        CircArcTester<TestRange2      > test2;
+        CircArcTester<TestRange3      > test3;
+
+        // float and long double storage
+        CircArcTester<SignedDegRange  , float      > testAf;
+        CircArcTester<UnsignedRadRange, float      > testDf;
+        CircArcTester<TestRange2      , float      > test2f;
+        CircArcTester<SignedDegRange  , long double> testAl;
+        CircArcTester<UnsignedRadRange, long double> testDl;
+        CircArcTester<TestRange2      , long double> test2l;
+    }
+
+    // ------------------------------------------------------
+    // testing correctness of CircArcs class implementation
+    {
+        CircArcsTester<SignedDegRange  > testA;
+        CircArcsTester<UnsignedDegRange> testB;
+        CircArcsTester<SignedRadRange  > testC;
+        CircArcsTester<UnsignedRadRange> testD;
+
+        CircArcsTester<TestRange0      > test0;
+        CircArcsTester<TestRange1      > test1;
+        CircArcsTester<TestRange2      > test2;
+        CircArcsTester<TestRange3      > test3;
+    }
+
+    // ------------------------------------------------------
+    // testing correctness of CircArcIndex class implementation
+    {
+        CircArcIndexTester<SignedDegRange  > testA;
+        CircArcIndexTester<UnsignedDegRange> testB;
+        CircArcIndexTester<SignedRadRange  > testC;
+        CircArcIndexTester<UnsignedRadRange> testD;
+
+        CircArcIndexTester<TestRange0      > test0;
+        CircArcIndexTester<TestRange1      > test1;
+        CircArcIndexTester<TestRange2      > test2;
+        CircArcIndexTester<TestRange3      > test3;
+    }
+
+    // ------------------------------------------------------
+    // testing correctness of CircStat functions
+    {
+        CircStatTester<SignedDegRange  > testA;
+        CircStatTester<UnsignedDegRange> testB;
+        CircStatTester<SignedRadRange  > testC;
+        CircStatTester<UnsignedRadRange> testD;
+
+        CircStatTester<TestRange0      > test0;
+        CircStatTester<TestRange1      > test1;
+        CircStatTester<TestRange2      > test2;
+        CircStatTester<TestRange3      > test3;
+    }
+
+    // ------------------------------------------------------
+    // testing correctness of CircHistogram class implementation
+    {
+        CircHistogramTester<SignedDegRange  > testA;
+        CircHistogramTester<UnsignedDegRange> testB;
+        CircHistogramTester<SignedRadRange  > testC;
+        CircHistogramTester<UnsignedRadRange> testD;
+
+        CircHistogramTester<TestRange0      > test0;
+        CircHistogramTester<TestRange1      > test1;
+        CircHistogramTester<TestRange2      > test2;
+        CircHistogramTester<TestRange3      > test3;
+    }
+
+    // ------------------------------------------------------
+    // testing correctness of CircAverageSummary, WeightedCircAverageSummary class implementation
+    {
+        CircAverageSummaryTester<SignedDegRange  > testA;
+        CircAverageSummaryTester<UnsignedDegRange> testB;
+        CircAverageSummaryTester<SignedRadRange  > testC;
+        CircAverageSummaryTester<UnsignedRadRange> testD;
+
+        CircAverageSummaryTester<TestRange0      > test0;
+        CircAverageSummaryTester<TestRange1      > test1;
+        CircAverageSummaryTester<TestRange2      > test2;
+        CircAverageSummaryTester<TestRange3      > test3;
+    }
+
+    // ------------------------------------------------------
+    // testing correctness of CircResampler class implementation
+    {
+        CircResamplerTester<SignedDegRange  > testA;
+        CircResamplerTester<UnsignedDegRange> testB;
+        CircResamplerTester<SignedRadRange  > testC;
+        CircResamplerTester<UnsignedRadRange> testD;
+
+        CircResamplerTester<TestRange0      > test0;
+        CircResamplerTester<TestRange1      > test1;
+        CircResamplerTester<TestRange2      > test2;
+        CircResamplerTester<TestRange3      > test3;
+    }
+
+    // ------------------------------------------------------
+    // testing the instrumentation of the CircStat functions (CircInstrument.h; recording only if CIRC_INSTRUMENT is defined)
+    {
+        CircInstrumentTester<SignedDegRange  > testA;
+        CircInstrumentTester<UnsignedRadRange> testD;
+        CircInstrumentTester<TestRange2      > test2;
+    }
+
+    // ------------------------------------------------------
+    // testing truncated_normal_distribution: generated values vs. truncated normal CDF, for each sampling algorithm
+    {
+        TruncNormalDistTester<double> testA;
+        TruncNormalDistTester<float > testB;
+    }
+
+    // ------------------------------------------------------
+    // testing wrapped_normal_distribution: generated values vs. wrapped normal CDF
+    {
+        WrappedNormalDistTester<double> testA;
+        WrappedNormalDistTester<float > testB;
+    }
+
+    // ------------------------------------------------------
+    // testing pdf, log_pdf, cdf, quantile of the wrapped distributions, and wrapped_density_table: vs. direct summation
+    {
+        WrappedDensityTester<double> testA;
+        WrappedDensityTester<float > testB;
+    }
+
+    // ------------------------------------------------------
+    // testing WrappedNormalFit, WrappedNormalEMStep, FitWrappedNormal: estimates of generated values, merge, execution policy
+    {
+        WrappedNormalFitTester<SignedDegRange  > testA;
+        WrappedNormalFitTester<UnsignedRadRange> testD;
+        WrappedNormalFitTester<TestRange2      > test2;
+    }
+
+    // ------------------------------------------------------
+    // testing ParallelSimulate: reproducibility
+    {
+        ParallelSimulationTester test;
+    }
+
+    // ------------------------------------------------------
+    // testing CircConcurrentAggregator: concurrent producers and snapshots vs. the summaries of the snapshots' prefixes
+    {
+        CircConcurrentAggregatorTester<SignedDegRange  > testA;
+        CircConcurrentAggregatorTester<UnsignedRadRange> testD;
+        CircConcurrentAggregatorTester<TestRange2      > test2;
+    }
+
+    // ------------------------------------------------------
+    // testing correctness of CircValArray class implementation
+    {
+        CircValArrayTester<SignedDegRange  > testA;
+        CircValArrayTester<UnsignedDegRange> testB;
+        CircValArrayTester<SignedRadRange  > testC;
+        CircValArrayTester<UnsignedRadRange> testD;
+
+        CircValArrayTester<TestRange0      > test0;
+        CircValArrayTester<TestRange1      > test1;
+        CircValArrayTester<TestRange2      > test2;
+        CircValArrayTester<TestRange3      > test3;
+    }
+
+    // ------------------------------------------------------
+    // testing correctness of CircFileWriter and CircFileReader classes implementation
+    {
+        CircFileTester<SignedDegRange  > testA;
+        CircFileTester<UnsignedDegRange> testB;
+        CircFileTester<SignedRadRange  > testC;
+        CircFileTester<UnsignedRadRange> testD;
+
+        CircFileTester<TestRange2      > test2;
+    }
+
+    // ------------------------------------------------------
+    // testing correctness of CircValFixed class implementation
+    {
+        CircValFixedTester<SignedDegRange  > testA;
+        CircValFixedTester<UnsignedDegRange> testB;
+        CircValFixedTester<SignedRadRange  > testC;
+        CircValFixedTester<UnsignedRadRange> testD;
+
+        CircValFixedTester<TestRange0      > test0;
+        CircValFixedTester<TestRange1      > test1;
+        CircValFixedTester<TestRange2      > test2;
+        CircValFixedTester<TestRange3      > test3;
+
+        CircValFixedTester<UnsignedDegRange, uint32_t    > testE; // 32-bit
+        CircValFixedTester<UnsignedDegRange, uint16_t, 12> testF; // 12-bit, e.g. an encoder
+    }
+
+    // ------------------------------------------------------
+    // sample code: basic circular math operations
+    {
+        CircVal<SignedDegRange  > c1 =  10. ;
+        CircVal<UnsignedRadRange> c2 =   0.2;
+        CircVal<SignedDegRange  > c3 = c1+c2;
+
+        c1 = c2;
+
+        c1 += 355.;
+        double d = c1;
+
+        d  = sin(c1) / cos(c2) + tan(c3);
+        c1 = asin<SignedDegRange>(0.5); // don't do d1= asin(0.5) !!!
+    }
+
+    // ------------------------------------------------------
+    // sample code: generating wrapped normal distributed random value
+    {
+        std::default_random_engine rand_engine;
+        std::random_device         rnd_device ;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        double fAvrg  =    0.;
+        double fSigma =   45.;
+        double fL     = -180.; // wrapping-range lower-bound
+        double fH     =  180.; // wrapping-range upper-bound
+
+        wrapped_normal_distribution<double> r_wrp(fAvrg, fSigma, fL, fH);
+        double r1 = r_wrp(rand_engine); // random value
+
+        vector<double> v1(1000);
+        r_wrp.fill(rand_engine, v1);    // random values - bulk generation
+    }
+
+    // ------------------------------------------------------
+    // sample code: generating truncated normal distributed random value
+    {
+        std::default_random_engine rand_engine;
+        std::random_device         rnd_device ;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        double fAvrg  =    0.;
+        double fSigma =   45.;
+        double fA     =  -40.; // truncation-range lower-bound
+        double fB     =   40.; // truncation-range upper-bound
+
+        truncated_normal_distribution<double> r_trn(fAvrg, fSigma, fA, fB);
+        double r2 = r_trn(rand_engine); // random value
+    }
+
+    // ------------------------------------------------------
+    // sample code: generating wrapped truncated normal distributed random value
+    {
+        std::default_random_engine rand_engine;
+        std::random_device         rnd_device ;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        // normal distribution is first truncated, and then wrapped
+
+        const double fAvrg  =    0.;
+        const double fSigma =  100.;
+        const double fA     = -500.; // truncation-range lower-bound
+        const double fB     =  500.; // truncation-range upper-bound
+        const double fL     =    0.; // wrapping  -range lower-bound
+        const double fH     =  360.; // wrapping  -range upper-bound
+
+        wrapped_truncated_normal_distribution<double> r_wrp_trn(fAvrg, fSigma, fA, fB, fL, fH);
+        double d = r_wrp_trn(rand_engine); // random value
+    }
+
+    // ------------------------------------------------------
+    // code used to collect data for graphs that demonstrate average of circular values
+    {
+        vector<CircVal<UnsignedDegRange>> Angles2 = {30., 130., 230., 330.};
+        auto y = CircAverage (Angles2);
+        auto z = CircAverage2(Angles2);
+
+        ofstream f0("log0.txt");
+
+        for (double x = 0.; x <= 360.; x += 0.1)
+        {
+            double fSum = 0;
+            for (const auto& a : Angles2)
+                fSum += Sqr(__min(abs(x-a), 360.-abs(x-a)));
+
+            f0 << x << "\t" << fSum << "\n";
+        }
+    }
+
+    // ------------------------------------------------------
+    // sample code: calculate median, average and weighted-average set of circular values
+    {
+        std::default_random_engine rand_engine;
+        std::random_device         rnd_device ;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        uniform_real_distribution<double> ud(UnsignedDegRange::L, UnsignedDegRange::H);
+
+        vector<     CircVal<UnsignedDegRange>        > angles1;
+        vector<pair<CircVal<UnsignedDegRange>,double>> angles2;
+
+        for (size_t i = 0; i < 3; ++i)
+        {
+            double m = ud(rand_engine);
+            angles1.emplace_back(m     );
+            angles2.emplace_back(m, 0.3);
+        }
+
+        auto Medn  = CircMedian         (angles1);
+        auto Avrg1 = CircAverage        (angles1);
+        auto Avrg2 = WeightedCircAverage(angles2);
+    }
+
+    // ------------------------------------------------------
+    // sample code: average of circular values sharded across nodes - each node ships a summary instead of its values
+    {
+        vector<CircVal<UnsignedDegRange>> Shard1 = { 350., 10., 20. };
+        vector<CircVal<UnsignedDegRange>> Shard2 = { 340., 5. };
+
+        // on each node: summarize, and serialize
+        vector<uint8_t> Buf1, Buf2;
+        {
+            CircAverageSummary<UnsignedDegRange> S1; S1.Add(span<const CircVal<UnsignedDegRange>>(Shard1)); S1.Serialize(Buf1);
+            CircAverageSummary<UnsignedDegRange> S2; S2.Add(span<const CircVal<UnsignedDegRange>>(Shard2)); S2.Serialize(Buf2);
+        }
+
+        // on the reducing node: deserialize, and merge
+        auto S = CircAverageSummary<UnsignedDegRange>::Deserialize(span<const uint8_t>(Buf1));
+        S.Merge(CircAverageSummary<UnsignedDegRange>::Deserialize(span<const uint8_t>(Buf2)));
+        auto Avrg = S.GetAvrg(); // same as CircAverage of all the values
+
+        // approximate mode: 360 bins - O(bins) summaries
+        CircAverageSummary<UnsignedDegRange> A(360);
+        A.Add(span<const CircVal<UnsignedDegRange>>(Shard1));
+        A.Add(span<const CircVal<UnsignedDegRange>>(Shard2));
+        auto AvrgA  = A.GetAvrg          ();
+        [[maybe_unused]] auto fBound = A.GetAvrgErrorEstimate(); // concentrated values. plus one bin: a bin may straddle a sector boundary
+
+        assert(abs(CircVal<UnsignedDegRange>::Sdist(*AvrgA.begin(), *Avrg.begin())) <= fBound + UnsignedDegRange::R / 360. + 1e-9);
+    }
+
+    // ------------------------------------------------------
+    // sample code: average of circular values stored in a binary file - the values are memory-mapped, not copied
+    {
+        const auto Path = filesystem::temp_directory_path() / "CircularSample.bin";
+
+        vector<CircVal<UnsignedDegRange>> Angles = { 350., 10., 20., 340., 5. };
+        {
+            CircFileWriter<CircVal<UnsignedDegRange>> w(Path);
+            w.Write(span<const CircVal<UnsignedDegRange>>(Angles));
+            w.Close();
+        }
+
+        {
+            CircFileReader f(Path);                                       // validates the header: L, H, Z and element type
+            auto V = f.Values<CircVal<UnsignedDegRange>>();               // span over the mapped file
+
+            CircStatWorkspace                 W;
+            vector<CircVal<UnsignedDegRange>> Avrg;
+            CircAverage(V, W, back_inserter(Avrg));                       // same as CircAverage(Angles)
+
+            CircValArray<UnsignedDegRange> a(V);                          // copy, for in-place bulk operations
+            vector<double> d(f.Size());
+            CircValArray<UnsignedDegRange>::Sdist(f.Doubles<UnsignedDegRange>(), a.Vals(), d);
+        }
+
+        filesystem::remove(Path);
+    }
+
+    // ------------------------------------------------------
+    // sample code: sliding-window average of circular values
+    {
+        std::default_random_engine rand_engine;
+        std::random_device         rnd_device ;
+        rand_engine.seed(rnd_device()); // reseed engine
+
+        wrapped_normal_distribution<double> r_wrp(350., 20., 0., 360.);
+
+        const size_t                             nWindow = 50; // window length
+        deque<CircVal<UnsignedDegRange>>         Window      ; // values in window
+        CircAverageAccumulator<UnsignedDegRange> Acc         ; // average of values in window
+
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            Window.emplace_back(r_wrp(rand_engine));
+            Acc.Add(Window.back());
+
+            if (Window.size() > nWindow)
+            {
+                Acc.Remove(Window.front());
+                Window.pop_front();
+            }
+
+            auto Avrg = Acc.GetAvrg(); // average of the last nWindow values
+        }
+    }
+
+    // ------------------------------------------------------
+    // sample code: estimate average of a sampled continuous-time circular signal, using circular linear interpolation
+    {
+        CAvrgSampledCircSignal<UnsignedDegRange> A1;
+        A1.AddMeasurement(CircVal<UnsignedDegRange>(200.), 1);
+        A1.AddMeasurement(CircVal<UnsignedDegRange>(300.), 2);
+        A1.AddMeasurement(CircVal<UnsignedDegRange>( 20.), 6);
+
+        CircVal<UnsignedDegRange> ad1;
+        A1.GetAvrg(ad1);
+
+        // bounded memory: average of the intervals of the last 4 time units
+        CAvrgSampledCircSignal<UnsignedDegRange> A2(CAvrgSampledCircSignal<UnsignedDegRange>::Mode::Window, 4.);
+        A2.AddMeasurement(CircVal<UnsignedDegRange>(200.), 1);
+        A2.AddMeasurement(CircVal<UnsignedDegRange>(300.), 2);
+        A2.AddMeasurement(CircVal<UnsignedDegRange>( 20.), 6);
+
+        CircVal<UnsignedDegRange> ad2;
+        A2.GetAvrg(ad2);
+
+        // O(1) memory and time: mean direction of the intervals
+        CAvrgSampledCircSignal<UnsignedDegRange> A3(CAvrgSampledCircSignal<UnsignedDegRange>::Mode::Running);
+        A3.AddMeasurement(CircVal<UnsignedDegRange>(200.), 1);
+        A3.AddMeasurement(CircVal<UnsignedDegRange>(300.), 2);
+        A3.AddMeasurement(CircVal<UnsignedDegRange>( 20.), 6);
+
+        CircVal<UnsignedDegRange> ad3;
+        A3.GetVectorMean(ad3);
+    }
+
+    // ------------------------------------------------------
+    // sample code: average and median of circular values added by several threads, read while they are added
+    {
+        CircConcurrentAggregator<UnsignedDegRange> Agg(CircHistogram<UnsignedDegRange>(3600));
+
+        vector<std::thread> Producers;
+        for (size_t t = 0; t < 4; ++t)
+            Producers.emplace_back([&, P = Agg.GetProducer()]() mutable // a producer per thread
+            {
+                for (size_t i = 0; i < 10000; ++i)
+                    P.Add(CircVal<UnsignedDegRange>(350. + (i % 20)));
+            });
+
+        auto Snap = Agg.GetSnapshot(); // the values added so far - does not wait for the producers
+        for (auto& t : Producers)
+            t.join();
+
+        Snap = Agg.GetSnapshot();      // all values
+        auto Avrg = Snap.Sum.GetAvrg();
+        auto Medn = Snap.Sum.GetMedian();
+    }
+
+    // ------------------------------------------------------
+    // sample code: resample a sampled circular signal onto a 100 Hz grid - values, and averages of 1 second buckets
+    {
+        const vector<double> Times = {   0.  ,   0.37,   1.02,   1.5 ,   2.25 }; // ascending
+        const vector<double> Vals  = { 350.  ,  10.  ,  40.  ,  20.  , 300.   }; // [0,360)
+
+        CircResampler<UnsignedDegRange> Res(CircResampler<UnsignedDegRange>::Mode::Spline);
+        vector<double> Out(226), Avrgs(3);
+        Res.Resample    (Times, Vals, 0., 0.01, Out  ); // Out  [j]: the signal at 0.01*j
+        Res.ResampleAvrg(Times, Vals, 0., 1.  , Avrgs); // Avrgs[j]: the average of the signal over [j, j+1)
+    }
+
+    // ------------------------------------------------------
+    // code used to collect data for RMS error of average estimation based on noisy measurements
+    // each item is a block of trails for one value of standard-deviation, simulated with its own random stream;
+    // the fixed seed makes the results reproducible
+    {
+        const uint64_t nSeed    = 2012;
+        const size_t   nStdDevs =   100;                  // values of standard-deviation: 1..100
+        const size_t   nTrails  = 50000;                  // number of trails
+        const size_t   nSamples =  1000;                  // number of observations per trail
+        const size_t   nBlock   =   500;                  // number of trails per item
+        const size_t   nBlocks  = nTrails / nBlock;       // number of items per standard-deviation
+
+        struct SqrErr
+        {
+            double f1 = 0.;                               // sum of squared errors - method 1
+            double f2 = 0.;                               // sum of squared errors - method 2
+        };
+
+        auto Res = ParallelSimulate(nStdDevs * nBlocks, nSeed, vector<SqrErr>(nStdDevs),
+            [&](size_t nItem, auto& rand_engine, vector<SqrErr>& Acc)
+            {
+                const size_t nStdDev = nItem / nBlocks + 1;
+
+                uniform_real_distribution<double> ud(0., 360.);
+
+                vector<CircVal<UnsignedDegRange>> vInput(nSamples);
+
+                const double fAvrg = ud(rand_engine);     // our const parameter for this block of trails
+                wrapped_normal_distribution          <double> r_wnd1(fAvrg, nStdDev,                       0., 360.);
+             // wrapped_truncated_normal_distribution<double> r_wnd1(fAvrg, nStdDev, fAvrg-45., fAvrg+45., 0., 360.);
+
+                for (size_t t = 0; t < nBlock; ++t)
+                {
+                    r_wnd1.generate(rand_engine, vInput.begin(), vInput.end()); // generate "noisy" observations
+
+                    set<CircVal<UnsignedDegRange>> sAvrg1 = CircAverage(vInput);                   // avrg - method 1 (new method)
+
+                    double fSigSin = 0.;
+                    double fSigCos = 0.;
+
+                    for (const auto& Sample : vInput)
+                    {
+                        const auto [fSin, fCos] = sincos(Sample);
+                        fSigSin += fSin;
+                        fSigCos += fCos;
+                    }
+
+                    CircVal<UnsignedDegRange> Avrg2 = atan2<UnsignedDegRange>(fSigSin, fSigCos);   // avrg - method 2 (conventional method)
+
+                    const double fErr1 = CircVal<UnsignedDegRange>::Sdist(*sAvrg1.begin(), fAvrg); // error of estimate - method 1
+                    const double fErr2 = CircVal<UnsignedDegRange>::Sdist(Avrg2          , fAvrg); // error of estimate - method 2
+
+                    Acc[nStdDev-1].f1 += Sqr(fErr1);
+                    Acc[nStdDev-1].f2 += Sqr(fErr2);
+                }
+            },
+            [](vector<SqrErr>& Acc, const vector<SqrErr>& Other)
+            {
+                for (size_t i = 0; i < Acc.size(); ++i)
+                {
+                    Acc[i].f1 += Other[i].f1;
+                    Acc[i].f2 += Other[i].f2;
+                }
+            });
+
+        ofstream           f1("log1.txt");
+        CircBufferedWriter b1("log1.bin");                       // same results, binary: {standard-deviation, RMS1, RMS2} doubles
+
+        for (size_t i = 0; i < nStdDevs; ++i)
+        {
+            const double fRMS1 = sqrt(Res[i].f1 / (nTrails-1)); // root mean square error - method 1
+            const double fRMS2 = sqrt(Res[i].f2 / (nTrails-1)); // root mean square error - method 2
+
+            f1 << i+1 << "\t" << fRMS1 << "\t" << fRMS2 << "\n";  // save RMS results to file - buffered, no flush per line
+            b1.Write(double(i+1)); b1.Write(fRMS1); b1.Write(fRMS2);
+        }
+
+        b1.Close();
+    }
+
+    // -----------------------------------
+    auto Duration = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now() - Time0).count();
+    cout << Duration << endl;
+
+    // system ("pause");
+
+    return 0;
+}
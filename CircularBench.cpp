@@ -0,0 +1,1008 @@
+// ==========================================================================
+// Copyright (C) 2026 DRNadler
+// ==========================================================================
+// benchmark suite - separate from the testers and the sample code of Circular.cpp
+// each benchmark is warmed up, then timed by a steady clock for several repetitions; fast bodies are run several times
+// per repetition. the min, median, mean and standard-deviation of the duration of one run are reported - over several
+// input sizes - to stdout, and optionally as JSON and/or CSV, to track regressions between releases.
+// the inputs are generated from fixed seeds, so runs are comparable.
+//
+// usage: CircularBench [--quick] [--reps n] [--filter text] [--json file] [--csv file]
+//   --quick      small sizes and few repetitions - a smoke test
+//   --reps n     timed repetitions per benchmark (default: 15; --quick: 3)
+//   --filter t   run only the benchmarks whose name contains t
+//   --json f     write the results to file f as JSON
+//   --csv f      write the results to file f as CSV
+// ==========================================================================
+
+#include <algorithm>                // std::sort, std::any_of
+#include <atomic>                   // std::atomic - BenchAggregator
+#include <chrono>                   // std::chrono::steady_clock
+#include <cmath>
+#include <cstdlib>                  // std::strtoul
+#include <execution>                // std::execution::par
+#include <fstream>
+#include <iomanip>                  // std::setw
+#include <iostream>
+#include <limits>                   // std::numeric_limits
+#include <mutex>                    // std::mutex - BenchAggregator
+#include <numeric>                  // std::accumulate
+#include <random>
+#include <span>
+#include <stdexcept>                // std::domain_error
+#include <string>
+#include <thread>                   // std::thread, std::thread::hardware_concurrency
+#include <type_traits>              // std::type_identity
+#include <vector>
+
+#include "CircVal.h"                // CircVal, sincos, sincos_fast
+#include "CircArc.h"                // CircArc, CircArcs, CircArcIndex
+#include "CircStat.h"               // CircAverage, CircMedian, CircHistogram, CircAverageSummary, CAvrgSampledCircSignal, ...
+#include "CircValArray.h"           // CircValArray
+#include "CircValFixed.h"           // CircValFixed
+#include "CircResample.h"           // CircResampler
+#include "CircAggregator.h"         // CircConcurrentAggregator
+#include "CircHelper.h"             // Mod, RadixSort, SortValues
+#include "TruncNormalDist.h"        // truncated_normal_distribution
+#include "WrappedNormalDist.h"      // wrapped_normal_distribution, wrapped_density_table
+#include "WrappedTruncNormalDist.h" // wrapped_truncated_normal_distribution
+#include "WrappedNormalFit.h"       // WrappedNormalFit, FitWrappedNormal
+#include "CircInstrument.h"         // CircInstrument
+
+#if __has_include(<tbb/global_control.h>)
+#include <tbb/global_control.h>     // tbb::global_control - the thread count of std::execution::par, on a TBB back-end
+#define CIRC_BENCH_TBB
+#endif
+
+// ==========================================================================
+// benchmark options - see usage above
+struct BenchOptions
+{
+    bool   bQuick  = false;
+    size_t nReps   = 15   ;
+    double fMinRep = 2e-3 ; // min duration of a repetition [s]
+    string Filter         ;
+    string JsonFile       ;
+    string CsvFile        ;
+};
+
+// result of a benchmark: durations of one run [us]
+struct BenchResult
+{
+    string Name   ; // group/variant
+    size_t n      ; // input size: items processed by one run
+    size_t nReps  ; // timed repetitions
+    size_t nIters ; // runs per repetition
+    double fMin   ;
+    double fMedian;
+    double fMean  ;
+    double fStdDev;
+};
+
+// results are accumulated here, so the optimizer cannot drop the benchmarked code
+static volatile double g_fSink = 0.;
+
+template<typename T>
+void Sink(const T& x)
+{
+    if constexpr (std::is_arithmetic_v<T>)
+        g_fSink = g_fSink + static_cast<double>(x);
+    else if constexpr (requires { x.size(); })
+        g_fSink = g_fSink + static_cast<double>(x.size());
+    else
+        g_fSink = g_fSink + static_cast<double>(x);
+}
+
+// ==========================================================================
+// runs the benchmarks, and collects their results
+class BenchSuite
+{
+    using Clock = chrono::steady_clock;
+
+    BenchOptions        m_Opt    ;
+    vector<BenchResult> m_Results;
+
+    template<typename F>
+    static double TimeRuns(F& Body, size_t nIters) // [s]
+    {
+        const auto Time0 = Clock::now();
+        for (size_t i = 0; i < nIters; ++i)
+            Body();
+        return chrono::duration<double>(Clock::now() - Time0).count();
+    }
+
+public:
+    explicit BenchSuite(const BenchOptions& Opt) : m_Opt(Opt)
+    {
+    }
+
+    bool                       IsQuick() const { return m_Opt.bQuick; }
+    const vector<BenchResult>& Results() const { return m_Results;    }
+
+    // input sizes 10^k in [nMin, nMax]; --quick: at most the first two, and at most 10^4
+    vector<size_t> Sizes(size_t nMin, size_t nMax) const
+    {
+        vector<size_t> v;
+        for (size_t n = nMin; n <= nMax; n *= 10)
+            if (!m_Opt.bQuick || (v.size() < 2 && n <= 10000))
+                v.push_back(n);
+        if (v.empty())
+            v.push_back(nMin);
+        return v;
+    }
+
+    bool IsEnabled(const string& Name) const
+    {
+        return m_Opt.Filter.empty() || Name.find(m_Opt.Filter) != string::npos;
+    }
+
+    // time Body(): one run processes n items
+    template<typename F>
+    void Run(const string& Name, size_t n, F&& Body)
+    {
+        if (!IsEnabled(Name))
+            return;
+
+        // warm-up: at least one run, and at least fMinRep; determines the runs per repetition
+        size_t nWarm = 0;
+        double fWarm = 0.;
+        do
+        {
+            fWarm += TimeRuns(Body, 1);
+            ++nWarm;
+        } while (!m_Opt.bQuick && fWarm < m_Opt.fMinRep);
+
+        const double fRun   = max(fWarm / nWarm, 1e-9);
+        const size_t nIters = static_cast<size_t>(clamp(ceil(m_Opt.fMinRep / fRun), 1., 1e7));
+
+        vector<double> T(m_Opt.nReps);
+        for (auto& t : T)
+            t = TimeRuns(Body, nIters) / nIters * 1e6;
+
+        sort(T.begin(), T.end());
+        const size_t k     = T.size();
+        const double fMean = accumulate(T.begin(), T.end(), 0.) / k;
+        double       fVar  = 0.;
+        for (const double t : T)
+            fVar += Sqr(t - fMean);
+
+        BenchResult R{ Name, n, k, nIters, T.front(), k % 2 ? T[k/2] : (T[k/2-1] + T[k/2]) / 2., fMean, k > 1 ? sqrt(fVar / (k-1)) : 0. };
+        m_Results.push_back(R);
+
+        cout << left  << setw(56) << Name << right << " n=" << setw(8) << n
+             << fixed << setprecision(3)
+             << "  median " << setw(12) << R.fMedian << " us"
+             << "  (" << setw(9) << R.fMedian / n * 1e3 << " ns/item)"
+             << "  min "    << setw(12) << R.fMin
+             << "  mean "   << setw(12) << R.fMean
+             << "  sd "     << setw(10) << R.fStdDev << endl;
+        cout.unsetf(ios::floatfield);
+    }
+
+    // ---------------------------------------------
+    static string Escape(const string& s)
+    {
+        string r;
+        for (const char c : s)
+        {
+            if (c == '"' || c == '\\')
+                r += '\\';
+            r += c;
+        }
+        return r;
+    }
+
+    static string Compiler()
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return "MSVC " + to_string(_MSC_FULL_VER);
+#elif defined(__VERSION__)
+        return __VERSION__;
+#else
+        return "unknown";
+#endif
+    }
+
+    void WriteJson(ostream& os) const
+    {
+        os << setprecision(17);
+        os << "{\n"
+           << "  \"suite\": \"CircularBench\",\n"
+           << "  \"version\": 1,\n"
+           << "  \"compiler\": \"" << Escape(Compiler()) << "\",\n"
+           << "  \"simd_lanes\": " << CircSimdNative::N << ",\n"
+           << "  \"hardware_threads\": " << thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+           << "  \"asserts\": false,\n"
+#else
+           << "  \"asserts\": true,\n"
+#endif
+           << "  \"quick\": " << (m_Opt.bQuick ? "true" : "false") << ",\n"
+           << "  \"unit\": \"us\",\n"
+           << "  \"results\": [";
+
+        for (size_t i = 0; i < m_Results.size(); ++i)
+        {
+            const BenchResult& R = m_Results[i];
+            os << (i ? ",\n" : "\n")
+               << "    { \"name\": \"" << Escape(R.Name) << "\", \"n\": " << R.n << ", \"reps\": " << R.nReps << ", \"iters\": " << R.nIters
+               << ", \"min\": " << R.fMin << ", \"median\": " << R.fMedian << ", \"mean\": " << R.fMean << ", \"stddev\": " << R.fStdDev << " }";
+        }
+
+        os << "\n  ]\n}\n";
+    }
+
+    void WriteCsv(ostream& os) const
+    {
+        os << setprecision(17);
+        os << "name,n,reps,iters,min_us,median_us,mean_us,stddev_us\n";
+        for (const BenchResult& R : m_Results)
+            os << '"' << R.Name << "\"," << R.n << ',' << R.nReps << ',' << R.nIters << ','
+               << R.fMin << ',' << R.fMedian << ',' << R.fMean << ',' << R.fStdDev << '\n';
+    }
+};
+
+// ==========================================================================
+// random inputs, from fixed seeds
+static vector<double> UniformVals(size_t n, double a, double b, uint64_t nSeed = 1)
+{
+    std::mt19937_64                   Eng(nSeed);
+    uniform_real_distribution<double> ud(a, b);
+
+    vector<double> v(n);
+    for (auto& x : v)
+        x = ud(Eng);
+    return v;
+}
+
+template<typename Type>
+static vector<CircVal<Type>> UniformCircVals(size_t n, uint64_t nSeed = 1)
+{
+    const vector<double> v = UniformVals(n, Type::L, Type::H, nSeed);
+    return vector<CircVal<Type>>(v.begin(), v.end());
+}
+
+static vector<CircVal<UnsignedDegRange>> NormalCircVals(size_t n, double fAvrg = 90., double fSigma = 20., uint64_t nSeed = 1)
+{
+    std::mt19937_64             Eng(nSeed);
+    normal_distribution<double> nd(fAvrg, fSigma);
+
+    vector<CircVal<UnsignedDegRange>> v(n);
+    for (auto& c : v)
+        c = nd(Eng);
+    return v;
+}
+
+// ==========================================================================
+// CircVal::Wrap vs. Mod - general case (values outside [L-R,H+R)), and wrapping of values near the range
+static void BenchWrap(BenchSuite& S)
+{
+    using Pow2Range = CircValType<0.0, 256.0, 0.0>; // power-of-two range: ModConst is exact
+
+    auto Bench = [&](auto Tag, const string& Range)
+    {
+        using Type = typename decltype(Tag)::type;
+
+        for (const size_t n : S.Sizes(1000, 1000000))
+        {
+            const vector<double> Far  = UniformVals(n, -100. * Type::R, 100. * Type::R);
+            const vector<double> Near = UniformVals(n, Type::L - Type::R, Type::H + Type::R);
+
+            S.Run("Wrap/" + Range + "/far" , n, [&] { double f = 0.; for (const double x : Far ) f += CircVal<Type>::Wrap(x);               Sink(f); });
+            S.Run("Wrap/" + Range + "/near", n, [&] { double f = 0.; for (const double x : Near) f += CircVal<Type>::Wrap(x);               Sink(f); });
+            S.Run("Mod/"  + Range + "/far" , n, [&] { double f = 0.; for (const double x : Far ) f += Mod(x - Type::L, Type::R) + Type::L;  Sink(f); });
+
+            vector<double> A(Far);
+            S.Run("Wrap/" + Range + "/CircValArray", n, [&] { A = Far; CircValArray<Type>::Wrap(A); Sink(A[0]); });
+        }
+    };
+
+    Bench(std::type_identity<  SignedDegRange>(), "SignedDegRange"  );
+    Bench(std::type_identity<UnsignedDegRange>(), "UnsignedDegRange");
+    Bench(std::type_identity<  SignedRadRange>(), "SignedRadRange"  );
+    Bench(std::type_identity<UnsignedRadRange>(), "UnsignedRadRange");
+    Bench(std::type_identity<       Pow2Range>(), "Pow2Range"       );
+}
+
+// ==========================================================================
+// conversion between circular-value types and storage types
+static void BenchConvert(BenchSuite& S)
+{
+    for (const size_t n : S.Sizes(1000, 1000000))
+    {
+        const auto                                   A = UniformCircVals<UnsignedDegRange>(n);
+        const CircValArray<UnsignedDegRange>         a{span<const CircVal<UnsignedDegRange>>(A)};
+        vector<CircVal<UnsignedDegRange, float>>     Af(A.begin(), A.end());
+        vector<CircValFixed<UnsignedDegRange>>       Ax(A.begin(), A.end());
+        vector<double>                               R (n);
+
+        S.Run("Convert/UnsignedDeg->SignedRad"             , n, [&] { double f = 0.; for (const auto& c : A ) f += CircVal<SignedRadRange>(c);           Sink(f); });
+        S.Run("Convert/UnsignedDeg->SignedDeg"             , n, [&] { double f = 0.; for (const auto& c : A ) f += CircVal<SignedDegRange>(c);           Sink(f); });
+        S.Run("Convert/UnsignedDeg->SignedRad/CircValArray", n, [&] { const CircValArray<SignedRadRange> b(a); Sink(b[0]); });
+        S.Run("Convert/UnsignedDeg->SignedRad/CircConvert" , n, [&] { CircConvert<UnsignedDegRange, SignedRadRange>::Apply(span<const CircVal<UnsignedDegRange>>(A), R); Sink(R[0]); });
+        S.Run("Convert/UnsignedDeg->SignedDeg/CircConvert" , n, [&] { CircConvert<UnsignedDegRange, SignedDegRange>::Apply(span<const CircVal<UnsignedDegRange>>(A), R); Sink(R[0]); });
+        S.Run("Convert/float->double"                      , n, [&] { double f = 0.; for (const auto& c : Af) f += CircVal<UnsignedDegRange>(c);         Sink(f); });
+        S.Run("Convert/CircValFixed->CircVal"              , n, [&] { double f = 0.; for (const auto& c : Ax) f += CircVal<UnsignedDegRange>(c);         Sink(f); });
+        S.Run("Convert/CircVal->CircValFixed"              , n, [&] { uint64_t s = 0; for (const auto& c : A) s += CircValFixed<UnsignedDegRange>(c).Raw(); Sink(s); });
+    }
+}
+
+// ==========================================================================
+// sin, cos vs. sincos vs. sincos_fast
+static void BenchTrig(BenchSuite& S)
+{
+    for (const size_t n : S.Sizes(1000, 1000000))
+    {
+        const auto                           A = UniformCircVals<UnsignedDegRange>(n);
+        const CircValArray<UnsignedDegRange> a{span<const CircVal<UnsignedDegRange>>(A)};
+        vector<double>                       s(n), c(n);
+
+        S.Run("Trig/sin+cos"                 , n, [&] { double f = 0.; for (const auto& x : A) f += sin(x) + cos(x);                                     Sink(f); });
+        S.Run("Trig/sincos"                  , n, [&] { double f = 0.; for (const auto& x : A) { const auto [p, q] = sincos     (x); f += p + q; }     Sink(f); });
+        S.Run("Trig/sincos_fast"             , n, [&] { double f = 0.; for (const auto& x : A) { const auto [p, q] = sincos_fast(x); f += p + q; }     Sink(f); });
+        S.Run("Trig/CircValArray Sin+Cos"    , n, [&] { a.Sin(s); a.Cos(c);   Sink(s[0] + c[0]); });
+        S.Run("Trig/CircValArray SinCos"     , n, [&] { a.SinCos    (s, c);   Sink(s[0] + c[0]); });
+        S.Run("Trig/CircValArray SinCosFast" , n, [&] { a.SinCosFast(s, c);   Sink(s[0] + c[0]); });
+    }
+}
+
+// ==========================================================================
+// the sort steps of CircStat. each run copies the input first - see the "copy" baseline
+static void BenchSort(BenchSuite& S)
+{
+    vector<double> Tmp;
+    for (const size_t n : S.Sizes(100, 1000000))
+    {
+        const vector<double> Vals = UniformVals(n, 0., 360.);
+        vector<double>       x;
+
+        S.Run("Sort/copy (baseline)", n, [&] { x = Vals;                                   Sink(x[0]); });
+        S.Run("Sort/std::sort"      , n, [&] { x = Vals; sort(x.begin(), x.end());         Sink(x[0]); });
+        S.Run("Sort/RadixSort"      , n, [&] { x = Vals; RadixSort (span<double>(x), Tmp); Sink(x[0]); });
+        S.Run("Sort/SortValues"     , n, [&] { x = Vals; SortValues(span<double>(x), Tmp); Sink(x[0]); });
+    }
+}
+
+// ==========================================================================
+// CircAverage, CircAverage2, WeightedCircAverage, CircAverageAccumulator
+static void BenchAverage(BenchSuite& S)
+{
+    CircStatWorkspace W;
+
+    for (const size_t n : S.Sizes(100, 1000000))
+    {
+        const auto                        A  = UniformCircVals<UnsignedDegRange>(n);
+        const span<const CircVal<UnsignedDegRange>> SA(A);
+        const vector<double>              Wt = UniformVals(n, 0., 1., 2);
+        vector<pair<CircVal<UnsignedDegRange>, double>> Pairs(n);
+        for (size_t i = 0; i < n; ++i)
+            Pairs[i] = { A[i], Wt[i] };
+
+        vector<CircVal<UnsignedDegRange>> Res;
+
+        S.Run("CircAverage/vector"                  , n, [&] { Sink(CircAverage(A)); });
+        S.Run("CircAverage/span+workspace"          , n, [&] { Res.clear(); CircAverage (SA, W, back_inserter(Res)); Sink(Res); });
+        S.Run("CircAverage2/vector"                 , n, [&] { Sink(CircAverage2(A)); });
+        S.Run("CircAverage2/span+workspace"         , n, [&] { Res.clear(); CircAverage2(SA, W, back_inserter(Res)); Sink(Res); });
+        S.Run("CircAverage2/par"                    , n, [&] { Sink(CircAverage2(std::execution::par, A)); });
+
+#ifdef CIRC_BENCH_TBB
+        // the scaling of the parallel version: the std::execution::par back-end limited to 1, 2, 4, ... threads
+        for (size_t k = 1; k < 2*thread::hardware_concurrency(); k *= 2)
+        {
+            const size_t nThreads = min(k, size_t(thread::hardware_concurrency()));
+            tbb::global_control C(tbb::global_control::max_allowed_parallelism, nThreads);
+            S.Run("CircAverage2/par threads=" + to_string(nThreads), n, [&] { Sink(CircAverage2(std::execution::par, A)); });
+        }
+#endif
+        S.Run("WeightedCircAverage/pairs"           , n, [&] { Res.clear(); WeightedCircAverage(span<const pair<CircVal<UnsignedDegRange>, double>>(Pairs), W, back_inserter(Res)); Sink(Res); });
+        S.Run("WeightedCircAverage/spans"           , n, [&] { Res.clear(); WeightedCircAverage(SA, span<const double>(Wt), W, back_inserter(Res));                         Sink(Res); });
+
+        if (n <= 100000) // the accumulator inserts each value into a tree: O(n log n), cache misses
+        S.Run("CircAverageAccumulator/Add+GetAvrg"  , n, [&] { CircAverageAccumulator<UnsignedDegRange> Acc; for (const auto& c : A) Acc.Add(c); Sink(Acc.GetAvrg()); });
+    }
+
+    // sliding window: one Add, one Remove and one GetAvrg per value
+    for (const size_t nWindow : S.Sizes(10, 100000))
+    {
+        const auto A = NormalCircVals(1000 + nWindow);
+
+        CircAverageAccumulator<UnsignedDegRange> Acc;
+        for (size_t i = 0; i < nWindow; ++i)
+            Acc.Add(A[i]);
+
+        S.Run("CircAverageAccumulator/slide 1000 (window n)", 1000, [&]
+        {
+            for (size_t i = nWindow; i < A.size(); ++i)
+            {
+                Acc.Add   (A[i]          );
+                Acc.Remove(A[i - nWindow]);
+                Sink(Acc.GetAvrg());
+            }
+            for (size_t i = A.size(); i-- > nWindow; ) // restore the window
+            {
+                Acc.Add   (A[i - nWindow]);
+                Acc.Remove(A[i]          );
+            }
+        });
+    }
+}
+
+// ==========================================================================
+// CircAverage, CircAverage2, WeightedCircAverage of a predefined range: in the units of the range, vs. the path through
+// UnsignedDegRange - the values converted to degrees, the algorithm in degrees, and the results converted back
+template<typename T>
+static void BenchRange(BenchSuite& S, const string& sRange)
+{
+    CircStatWorkspace W;
+
+    for (const size_t n : S.Sizes(1000, 1000000))
+    {
+        const auto                        A  = UniformCircVals<T>(n);
+        const vector<double>              Wt = UniformVals(n, 0., 1., 2);
+        vector<CircVal<UnsignedDegRange>> D (n);
+        vector<CircVal<UnsignedDegRange>> ResD;
+        vector<CircVal<T>>                Res;
+
+        auto Native = [&](auto Avrg)
+        {
+            Res.clear();
+            Avrg(span<const CircVal<T>>(A), back_inserter(Res));
+            Sink(Res);
+        };
+
+        auto ViaDeg = [&](auto Avrg)
+        {
+            for (size_t i = 0; i < n; ++i)
+                D[i] = A[i];                      // convert to [0,360)
+            ResD.clear();
+            Avrg(span<const CircVal<UnsignedDegRange>>(D), back_inserter(ResD));
+            Res.assign(ResD.begin(), ResD.end()); // convert from [0,360)
+            Sink(Res);
+        };
+
+        auto Avrg  = [&](auto A, auto Out) { CircAverage        (A, W, Out);                         };
+        auto Avrg2 = [&](auto A, auto Out) { CircAverage2       (A, W, Out);                         };
+        auto WAvrg = [&](auto A, auto Out) { WeightedCircAverage(A, span<const double>(Wt), W, Out); };
+
+        S.Run(sRange + "/CircAverage/native"                , n, [&] { Native(Avrg ); });
+        S.Run(sRange + "/CircAverage/via UnsignedDeg"       , n, [&] { ViaDeg(Avrg ); });
+        S.Run(sRange + "/CircAverage2/native"               , n, [&] { Native(Avrg2); });
+        S.Run(sRange + "/CircAverage2/via UnsignedDeg"      , n, [&] { ViaDeg(Avrg2); });
+        S.Run(sRange + "/WeightedCircAverage/native"        , n, [&] { Native(WAvrg); });
+        S.Run(sRange + "/WeightedCircAverage/via UnsignedDeg", n, [&] { ViaDeg(WAvrg); });
+    }
+}
+
+static void BenchRanges(BenchSuite& S)
+{
+    BenchRange<SignedDegRange  >(S, "SignedDegRange"  );
+    BenchRange<UnsignedDegRange>(S, "UnsignedDegRange");
+    BenchRange<SignedRadRange  >(S, "SignedRadRange"  );
+    BenchRange<UnsignedRadRange>(S, "UnsignedRadRange");
+}
+
+// ==========================================================================
+// CircMedian vs. CircMedianBruteForce
+static void BenchMedian(BenchSuite& S)
+{
+    CircStatWorkspace W;
+
+    for (const size_t n : S.Sizes(100, 1000000))
+    {
+        const auto A = NormalCircVals(n);
+        vector<CircVal<UnsignedDegRange>> Res;
+
+        S.Run("CircMedian/vector"        , n, [&] { Sink(CircMedian(A)); });
+        S.Run("CircMedian/span+workspace", n, [&] { Res.clear(); CircMedian(span<const CircVal<UnsignedDegRange>>(A), W, back_inserter(Res)); Sink(Res); });
+
+        if (n <= 1000) // O(n^2)
+        S.Run("CircMedianBruteForce"     , n, [&] { Sink(CircMedianBruteForce(A)); });
+
+        // integer degrees and evenly spaced values: a flat sum, with up to n tied candidates
+        vector<CircVal<UnsignedDegRange>> Q(n), E(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            Q[i] = (double)(i * 7 % 360);
+            E[i] = 360. * i / n;
+        }
+
+        S.Run("CircMedian/integer degrees", n, [&] { Res.clear(); CircMedian(span<const CircVal<UnsignedDegRange>>(Q), W, back_inserter(Res)); Sink(Res); });
+        S.Run("CircMedian/evenly spaced"  , n, [&] { Res.clear(); CircMedian(span<const CircVal<UnsignedDegRange>>(E), W, back_inserter(Res)); Sink(Res); });
+
+        const vector<double> Wt = UniformVals(n, 0.5, 2., 2);
+        S.Run("WeightedCircMedian/span+workspace", n, [&] { Res.clear(); WeightedCircMedian(span<const CircVal<UnsignedDegRange>>(A), span<const double>(Wt), W, back_inserter(Res)); Sink(Res); });
+        S.Run("WeightedCircMedian/evenly spaced" , n, [&] { Res.clear(); WeightedCircMedian(span<const CircVal<UnsignedDegRange>>(E), span<const double>(Wt), W, back_inserter(Res)); Sink(Res); });
+
+        if (n <= 1000) // O(n^2)
+        S.Run("WeightedCircMedianBruteForce"     , n, [&] { Sink(WeightedCircMedianBruteForce(A, Wt)); });
+    }
+}
+
+// ==========================================================================
+// CMedianSampledCircSignal: AddMeasurement and GetMedian of every sample, vs. WeightedCircMedian of the window of
+// every sample
+static void BenchSlidingMedian(BenchSuite& S)
+{
+    using Signal = CMedianSampledCircSignal<UnsignedDegRange>;
+
+    CircStatWorkspace W;
+
+    for (const size_t n : S.Sizes(10000, 100000))
+    {
+        std::mt19937_64             Eng(3);
+        normal_distribution<double> nd(0., 5.);
+
+        vector<CircVal<UnsignedDegRange>> Vals(n);
+        double fVal = 0.;
+        for (auto& v : Vals)
+            v = CircVal<UnsignedDegRange>::Wrap(fVal += nd(Eng)); // random walk
+
+        for (const size_t m : { 16, 256 })
+        {
+            const string sWindow = "/window=" + to_string(m);
+
+            S.Run("CMedianSampledCircSignal" + sWindow, n, [&]
+            {
+                Signal Sig(numeric_limits<double>::infinity(), m);
+                CircVal<UnsignedDegRange> Med;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    Sig.AddMeasurement(Vals[i], (double)i);
+                    Sig.GetMedian(Med);
+                }
+                Sink(static_cast<double>(Med));
+            });
+
+            S.Run("WeightedCircMedian of the window" + sWindow, n, [&]
+            {
+                const vector<double>              Wt(m, 1.);
+                vector<CircVal<UnsignedDegRange>> Res;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    const size_t b = i + 1 < m ? 0 : i + 1 - m;
+                    Res.clear();
+                    WeightedCircMedian(span<const CircVal<UnsignedDegRange>>(Vals.data() + b, i + 1 - b), span<const double>(Wt.data(), i + 1 - b), W, back_inserter(Res));
+                }
+                Sink(Res);
+            });
+        }
+    }
+}
+
+// ==========================================================================
+// CircHistogram: single pass (approximate) and exact refinement
+static void BenchHistogram(BenchSuite& S)
+{
+    for (const size_t n : S.Sizes(10000, 1000000))
+    {
+        const auto                                   A = NormalCircVals(n);
+        const span<const CircVal<UnsignedDegRange>>  SA(A);
+
+        CircHistogram<UnsignedDegRange> H(3600);
+        H.Add(SA);
+
+        vector<CircVal<UnsignedDegRange>> ResA, ResM;
+
+        S.Run("CircHistogram/Add"              , n, [&] { CircHistogram<UnsignedDegRange> G(3600); G.Add(SA); Sink(G.GetCount()); });
+        S.Run("CircHistogram/GetAvrg"          , n, [&] { Sink(H.GetAvrg  ()); });
+        S.Run("CircHistogram/GetMedian"        , n, [&] { Sink(H.GetMedian()); });
+        S.Run("CircHistogram/GetQuantile"      , n, [&] { Sink(static_cast<double>(H.GetQuantile(0.9, 2700))); }); // origin bin: 270 degrees, opposite to the mode
+        S.Run("CircHistogram/GetAvrgErrorEstimate", n, [&] { Sink(H.GetAvrgErrorEstimate()); });
+        S.Run("CircHistogram/GetAvrgExact"     , n, [&] { ResA.clear(); H.CollectResidents(SA, H.GetAvrgBins  (), ResA); Sink(H.GetAvrgExact  (ResA)); });
+        S.Run("CircHistogram/GetMedianExact"   , n, [&] { ResM.clear(); H.CollectResidents(SA, H.GetMedianBins(), ResM); Sink(H.GetMedianExact(ResM)); });
+    }
+}
+
+// ==========================================================================
+// CircAverageSummary: build, wire format, merge
+static void BenchSummary(BenchSuite& S)
+{
+    for (const size_t n : S.Sizes(1000, 1000000))
+    {
+        const auto                                  A = UniformCircVals<UnsignedDegRange>(n);
+        const span<const CircVal<UnsignedDegRange>> SA(A);
+
+        CircAverageSummary<UnsignedDegRange> E;      E.Add(SA);
+        CircAverageSummary<UnsignedDegRange> B(360); B.Add(SA);
+
+        vector<uint8_t> Buf;
+        E.Serialize(Buf);
+
+        S.Run("CircAverageSummary/exact Add"          , n, [&] { CircAverageSummary<UnsignedDegRange> T;      T.Add(SA); Sink(T.GetItems()); });
+        S.Run("CircAverageSummary/exact GetAvrg"      , n, [&] { Sink(E.GetAvrg()); });
+        S.Run("CircAverageSummary/exact Serialize"    , n, [&] { vector<uint8_t> V; E.Serialize(V); Sink(V); });
+        S.Run("CircAverageSummary/exact Deserialize"  , n, [&] { Sink(CircAverageSummary<UnsignedDegRange>::Deserialize(span<const uint8_t>(Buf)).GetItems()); });
+        S.Run("CircAverageSummary/exact Merge"        , n, [&] { CircAverageSummary<UnsignedDegRange> T = E; T.Merge(E); Sink(T.GetItems()); });
+        S.Run("CircAverageSummary/approximate Add"    , n, [&] { CircAverageSummary<UnsignedDegRange> T(360); T.Add(SA); Sink(T.GetBins()); });
+        S.Run("CircAverageSummary/approximate GetAvrg", n, [&] { Sink(B.GetAvrg()); });
+    }
+}
+
+// ==========================================================================
+// CAvrgSampledCircSignal: GetAvrg after every 100 samples, per mode
+static void BenchSampledSignal(BenchSuite& S)
+{
+    using Signal = CAvrgSampledCircSignal<UnsignedDegRange>;
+
+    for (const size_t n : S.Sizes(1000, 100000))
+    {
+        std::mt19937_64             Eng(3);
+        normal_distribution<double> nd(0., 5.);
+
+        vector<CircVal<UnsignedDegRange>> Vals(n);
+        double fVal = 0.;
+        for (auto& v : Vals)
+            v = CircVal<UnsignedDegRange>::Wrap(fVal += nd(Eng)); // random walk
+
+        const pair<Signal::Mode, const char*> Modes[] = { { Signal::Mode::Exact, "Exact" }, { Signal::Mode::Window, "Window" }, { Signal::Mode::Running, "Running" } };
+        for (const auto& m : Modes)
+            S.Run(string("CAvrgSampledCircSignal/") + m.second, n, [&]
+            {
+                Signal Sig(m.first, 1000.); // window: last 1000 intervals
+                CircVal<UnsignedDegRange> Avrg;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    Sig.AddMeasurement(Vals[i], (double)i);
+                    if (i % 100 == 99)
+                        m.first == Signal::Mode::Running ? Sig.GetVectorMean(Avrg) : Sig.GetAvrg(Avrg);
+                }
+                Sink(static_cast<double>(Avrg));
+            });
+    }
+}
+
+// ==========================================================================
+// CircResampler: irregular samples of a random walk (~100 Hz) onto a 100 Hz grid, and 1 second bucket averages
+// vs. a scalar loop over the grid - binary search of the interval, CircVal expressions
+static void BenchResample(BenchSuite& S)
+{
+    using Resampler = CircResampler<UnsignedDegRange>;
+
+    for (const size_t n : S.Sizes(10000, 1000000))
+    {
+        std::mt19937_64                   Eng(3);
+        normal_distribution<double>       nd(0., 5.);
+        uniform_real_distribution<double> ud(0.005, 0.015);
+
+        vector<double> Times(n), Vals(n);
+        double fTime = 0., fVal = 0.;
+        for (size_t i = 0; i < n; ++i)
+        {
+            Times[i] = fTime += ud(Eng);
+            Vals [i] = CircVal<UnsignedDegRange>::Wrap(fVal += nd(Eng)); // random walk
+        }
+
+        const size_t   m = (size_t)(fTime / 0.01); // 100 Hz grid
+        vector<double> Out(m), Avrgs((size_t)fTime);
+
+        S.Run("Resample scalar loop/Linear", n, [&]
+        {
+            for (size_t j = 0; j < m; ++j)
+            {
+                const double t = j * 0.01;
+                if      (t <= Times.front()) Out[j] = Vals.front();
+                else if (t >= Times.back ()) Out[j] = Vals.back ();
+                else
+                {
+                    const size_t i = upper_bound(Times.begin(), Times.end(), t) - Times.begin() - 1;
+                    const double d = CircVal<UnsignedDegRange>::Sdist(Vals[i], Vals[i+1]);
+                    Out[j] = CircVal<UnsignedDegRange>::Wrap(Vals[i] + d * ((t - Times[i]) / (Times[i+1] - Times[i])));
+                }
+            }
+            Sink(Out.back());
+        });
+
+        const pair<Resampler::Mode, const char*> Modes[] = { { Resampler::Mode::Linear, "Linear" }, { Resampler::Mode::Spline, "Spline" } };
+        for (const auto& md : Modes)
+        {
+            Resampler R(md.first);
+            S.Run(string("CircResampler/") + md.second, n, [&]
+            {
+                R.Resample(Times, Vals, 0., 0.01, Out);
+                Sink(Out.back());
+            });
+        }
+
+        Resampler R;
+        S.Run("CircResampler/ResampleAvrg 1s buckets", n, [&]
+        {
+            R.ResampleAvrg(Times, Vals, 0., 1., Avrgs);
+            Sink(Avrgs.back());
+        });
+    }
+}
+
+// ==========================================================================
+// CircConcurrentAggregator: contention of 1 to 64 producer threads, appending single values while a reader takes
+// snapshots, vs. a CircHistogram shared under a mutex - n values in all, per run
+static void BenchAggregator(BenchSuite& S)
+{
+    using Aggregator = CircConcurrentAggregator<UnsignedDegRange>;
+
+    for (const size_t n : S.Sizes(100000, 1000000))
+    {
+        const auto A = UniformCircVals<UnsignedDegRange>(n);
+
+        for (const size_t k : { 1, 2, 4, 8, 16, 32, 64 })
+        {
+            const string sProducers = "/producers=" + to_string(k);
+
+            // each of k threads adds its part of A; Reader runs concurrently, until the producers are done
+            auto RunThreads = [&](auto&& Producer, auto&& Reader)
+            {
+                atomic<size_t> nDone{ 0 };
+                thread         R([&] { while (nDone.load() < k) Reader(); });
+
+                vector<thread> P;
+                for (size_t t = 0; t < k; ++t)
+                    P.emplace_back([&, t] { Producer(t, span<const CircVal<UnsignedDegRange>>(A.data() + n*t/k, n*(t+1)/k - n*t/k)); ++nDone; });
+
+                for (auto& p : P)
+                    p.join();
+                R.join();
+            };
+
+            S.Run("CircConcurrentAggregator" + sProducers, n, [&]
+            {
+                Aggregator Agg(CircHistogram<UnsignedDegRange>(360), k);
+                vector<Aggregator::Producer> P;
+                for (size_t t = 0; t < k; ++t)
+                    P.emplace_back(Agg.GetProducer());
+
+                RunThreads([&](size_t t, span<const CircVal<UnsignedDegRange>> V) { for (const auto& v : V) P[t].Add(v); },
+                           [&] { Sink(Agg.GetSnapshot().nCount); });
+                Sink(Agg.GetSnapshot().Sum.GetMedian());
+            });
+
+            S.Run("CircHistogram under a mutex" + sProducers, n, [&]
+            {
+                CircHistogram<UnsignedDegRange> H(360);
+                mutex                           Lock;
+
+                RunThreads([&](size_t, span<const CircVal<UnsignedDegRange>> V) { for (const auto& v : V) { lock_guard<mutex> L(Lock); H.Add(v); } },
+                           [&] { lock_guard<mutex> L(Lock); Sink(CircHistogram<UnsignedDegRange>(H).GetCount()); });
+                Sink(H.GetMedian());
+            });
+        }
+    }
+}
+
+// ==========================================================================
+// wrapped_normal_distribution (polar, ziggurat), truncated_normal_distribution, wrapped_truncated_normal_distribution
+static void BenchDistributions(BenchSuite& S)
+{
+    for (const size_t n : S.Sizes(1000, 100000))
+    {
+        std::mt19937_64 Eng(4);
+        vector<double>  v(n);
+
+        wrapped_normal_distribution<double                        > r_polar(10., 30., 0., 360.);
+        wrapped_normal_distribution<double, normal_ziggurat_method> r_zig  (10., 30., 0., 360.);
+        truncated_normal_distribution<double>                       r_trn  ( 0., 45., -40., 40.);
+        wrapped_truncated_normal_distribution<double>               r_wtrn (10., 60., -200., 500., 0., 360.);
+
+        S.Run("wrapped_normal_distribution/polar operator()"   , n, [&] { for (auto& x : v) x = r_polar(Eng); Sink(v[0]); });
+        S.Run("wrapped_normal_distribution/ziggurat operator()", n, [&] { for (auto& x : v) x = r_zig  (Eng); Sink(v[0]); });
+        S.Run("wrapped_normal_distribution/polar fill()"       , n, [&] { r_polar.fill(Eng, v);               Sink(v[0]); });
+        S.Run("wrapped_normal_distribution/ziggurat fill()"    , n, [&] { r_zig  .fill(Eng, v);               Sink(v[0]); });
+        S.Run("truncated_normal_distribution/operator()"       , n, [&] { for (auto& x : v) x = r_trn  (Eng); Sink(v[0]); });
+        S.Run("wrapped_truncated_normal_distribution/operator()", n, [&] { for (auto& x : v) x = r_wtrn (Eng); Sink(v[0]); });
+    }
+}
+
+// ==========================================================================
+// truncated_normal_distribution: each sampling algorithm, and the automatic selections, over truncation-ranges of
+// different regimes - the source of _Truncated_std_normal::_Cost (time per value * acceptance: time per attempt)
+static void BenchTruncatedNormal(BenchSuite& S)
+{
+    typedef truncated_normal_distribution<double>::param_type param_type;
+
+    constexpr double Inf = numeric_limits<double>::infinity();
+    const struct { const char* sName; double fA, fB; } Ranges[] =
+        { { "[-3,3]"    , -3. ,  3.  }, { "[-0.1,inf)", -0.1, Inf }, { "[0,1.5]", 0., 1.5 }, { "[0.5,2.5]", 0.5, 2.5 },
+          { "[2,inf)"   ,  2. ,  Inf }, { "[5,5.2]"   ,  5. , 5.2 }, { "[3,6]"  , 3., 6.  } };
+
+    for (const size_t n : S.Sizes(1000, 100000))
+    {
+        std::mt19937_64 Eng(6);
+        vector<double>  v(n);
+
+        for (const auto& R : Ranges)
+        {
+            const string sName = string("truncated_normal_distribution/") + R.sName + '/';
+
+            auto Bench = [&](const string& sAlg, const param_type& P)
+            {
+                const truncated_normal_distribution<double> d(P);
+                S.Run(sName + sAlg, n, [&] { for (auto& x : v) x = d(Eng); Sink(v[0]); });
+            };
+
+            const param_type Auto     (0., 1., R.fA, R.fB, param_type::alg_auto      );
+            const param_type AutoTable(0., 1., R.fA, R.fB, param_type::alg_auto_table);
+            Bench("auto (alg "       + to_string(Auto     .alg()) + ")", Auto     );
+            Bench("auto table (alg " + to_string(AutoTable.alg()) + ")", AutoTable);
+
+            for (int nAlg = 0; nAlg <= 5; ++nAlg)
+            {
+                try
+                {
+                    const param_type P(0., 1., R.fA, R.fB, nAlg);
+                    if (P.acceptance() >= 0.05)                     // applicable, and not hopelessly slow
+                        Bench("alg " + to_string(nAlg) + ", acceptance " + to_string(P.acceptance()).substr(0, 5), P);
+                }
+                catch (const std::domain_error&) {}
+            }
+        }
+    }
+}
+
+// ==========================================================================
+// pdf, log_pdf, cdf of the wrapped distributions: series (images or Fourier form, by sigma) vs. wrapped_density_table
+static void BenchDensity(BenchSuite& S)
+{
+    for (const size_t n : S.Sizes(1000, 100000))
+    {
+        const vector<double> x = UniformVals(n, 0., 360., 7);
+        vector<double>       o(n);
+
+        for (const double fSigma : { 20., 200. })
+        {
+            const wrapped_normal_distribution<double>           d_wn  (10., fSigma, 0., 360.);
+            const wrapped_truncated_normal_distribution<double> d_wtrn(10., fSigma, -200., 500., 0., 360.);
+            const wrapped_density_table<decltype(d_wn  )>       t_wn  (d_wn  );
+            const wrapped_density_table<decltype(d_wtrn)>       t_wtrn(d_wtrn);
+
+            const string sWN   = "wrapped_normal_distribution/sigma "           + to_string(int(fSigma)) + ' ';
+            const string sWTrn = "wrapped_truncated_normal_distribution/sigma " + to_string(int(fSigma)) + ' ';
+            S.Run(sWN   + "pdf"        , n, [&] { d_wn  .pdf    (x, o); Sink(o[0]); });
+            S.Run(sWN   + "log_pdf"    , n, [&] { d_wn  .log_pdf(x, o); Sink(o[0]); });
+            S.Run(sWN   + "cdf"        , n, [&] { d_wn  .cdf    (x, o); Sink(o[0]); });
+            S.Run(sWN   + "table pdf", n, [&] { t_wn  .pdf    (x, o); Sink(o[0]); });
+            S.Run(sWN   + "table cdf", n, [&] { t_wn  .cdf    (x, o); Sink(o[0]); });
+            S.Run(sWTrn + "pdf"        , n, [&] { d_wtrn.pdf    (x, o); Sink(o[0]); });
+            S.Run(sWTrn + "cdf"        , n, [&] { d_wtrn.cdf    (x, o); Sink(o[0]); });
+            S.Run(sWTrn + "table pdf", n, [&] { t_wtrn.pdf    (x, o); Sink(o[0]); });
+        }
+    }
+}
+
+// ==========================================================================
+// fit of a wrapped normal distribution: moments (serial, parallel), EM iterations
+static void BenchFit(BenchSuite& S)
+{
+    for (const size_t n : S.Sizes(1000, 1000000))
+    {
+        const auto A = NormalCircVals(n, 90., 30., 8);
+        const span<const CircVal<UnsignedDegRange>> sA(A);
+
+        S.Run("WrappedNormalFit/Add"                , n, [&] { WrappedNormalFit<UnsignedDegRange> F; F.Add(sA); Sink(F.GetSigma()); });
+        S.Run("FitWrappedNormal/moments"            , n, [&] { Sink(FitWrappedNormal(                     sA    ).sigma()); });
+        S.Run("FitWrappedNormal/moments par"        , n, [&] { Sink(FitWrappedNormal(std::execution::par, sA    ).sigma()); });
+        S.Run("FitWrappedNormal/moments + 1 EM step", n, [&] { Sink(FitWrappedNormal(                     sA, 1 ).sigma()); });
+        S.Run("FitWrappedNormal/EM par"             , n, [&] { Sink(FitWrappedNormal(std::execution::par, sA, 20).sigma()); });
+    }
+}
+
+// ==========================================================================
+// CircArc queries: pairwise CircArc vs. CircArcs vs. CircArcIndex
+static void BenchArc(BenchSuite& S)
+{
+    std::mt19937_64                   Eng(5);
+    uniform_real_distribution<double> sd(0., 360.);
+
+    const size_t nQueries = S.IsQuick() ? 1000 : 10000;
+    vector<CircVal<UnsignedDegRange>> Queries(nQueries);
+    for (auto& q : Queries)
+        q = sd(Eng);
+    vector<CircVal<UnsignedDegRange>> SortedQueries(Queries);
+    sort(SortedQueries.begin(), SortedQueries.end());
+
+    for (const size_t n : S.Sizes(100, 10000))
+    {
+        uniform_real_distribution<double> ld(0., 36. / n); // ~10% coverage
+
+        vector<CircArc<UnsignedDegRange>> Arcs(n);
+        for (auto& a : Arcs)
+            a = CircArc<UnsignedDegRange>(sd(Eng), ld(Eng));
+
+        const CircArcs    <UnsignedDegRange> A(Arcs.begin(), Arcs.end());
+        const CircArcIndex<UnsignedDegRange> Index(Arcs);
+        vector<size_t>                       Res;
+
+        const string sQ = " (" + to_string(nQueries) + " queries)";
+        S.Run("CircArc/Contains pairwise" + sQ  , n, [&] { size_t k = 0; for (const auto& q : Queries) k += any_of(Arcs.begin(), Arcs.end(), [&](const CircArc<UnsignedDegRange>& a) { return a.Contains(q); }); Sink(k); });
+        S.Run("CircArc/Intersect pairwise"      , n, [&] { size_t k = 0; for (const auto& a : Arcs) k += a.Intersect(Arcs[0]); Sink(k); });
+        S.Run("CircArcs/build"                  , n, [&] { const CircArcs<UnsignedDegRange> B(Arcs.begin(), Arcs.end()); Sink(B.Size()); });
+        S.Run("CircArcs/Contains" + sQ          , n, [&] { size_t k = 0; for (const auto& q : Queries) k += A.Contains(q); Sink(k); });
+        S.Run("CircArcs/set-ops"                , n, [&] { Sink(A.Union(A.Complement().Intersection(A)).Size()); });
+        S.Run("CircArcIndex/build"              , n, [&] { const CircArcIndex<UnsignedDegRange> B(Arcs); Sink(B.Size()); });
+        S.Run("CircArcIndex/Query" + sQ         , n, [&] { size_t k = 0; for (const auto& q : Queries) { Res.clear(); Index.Query(q, back_inserter(Res)); k += Res.size(); } Sink(k); });
+        S.Run("CircArcIndex/QuerySorted" + sQ   , n, [&] { size_t k = 0; Index.QuerySorted(span<const CircVal<UnsignedDegRange>>(SortedQueries), [&](size_t, size_t) { ++k; }); Sink(k); });
+    }
+}
+
+// ==========================================================================
+int main(int argc, char* argv[])
+{
+    BenchOptions Opt;
+    bool         bReps = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const string Arg   = argv[i];
+        const bool   bNext = i + 1 < argc;
+
+        if      (Arg == "--quick"            ) Opt.bQuick   = true;
+        else if (Arg == "--reps"   && bNext  ) Opt.nReps    = max<size_t>(1, strtoul(argv[++i], nullptr, 10)), bReps = true;
+        else if (Arg == "--filter" && bNext  ) Opt.Filter   = argv[++i];
+        else if (Arg == "--json"   && bNext  ) Opt.JsonFile = argv[++i];
+        else if (Arg == "--csv"    && bNext  ) Opt.CsvFile  = argv[++i];
+        else
+        {
+            cerr << "usage: CircularBench [--quick] [--reps n] [--filter text] [--json file] [--csv file]" << endl;
+            return 2;
+        }
+    }
+
+    if (Opt.bQuick)
+    {
+        Opt.fMinRep = 1e-4;
+        if (!bReps)
+            Opt.nReps = 3;
+    }
+
+#ifndef NDEBUG
+    cout << "warning: asserts are enabled - build with NDEBUG (Release) for meaningful results" << endl;
+#endif
+    if constexpr (CircInstrument::bEnabled)
+        cout << "warning: CIRC_INSTRUMENT is defined - the timings include the instrumentation overhead" << endl;
+
+    BenchSuite S(Opt);
+
+    BenchWrap           (S);
+    BenchConvert        (S);
+    BenchTrig           (S);
+    BenchSort           (S);
+    BenchAverage        (S);
+    BenchRanges         (S);
+    BenchMedian         (S);
+    BenchSlidingMedian  (S);
+    BenchHistogram      (S);
+    BenchSummary        (S);
+    BenchSampledSignal  (S);
+    BenchResample       (S);
+    BenchAggregator     (S);
+    BenchDistributions  (S);
+    BenchTruncatedNormal(S);
+    BenchDensity        (S);
+    BenchFit            (S);
+    BenchArc            (S);
+
+    if constexpr (CircInstrument::bEnabled) // phases and counters of all benchmarks
+        cout << "\ninstrumentation:\n" << CircInstrument::Drain();
+
+    if (!Opt.JsonFile.empty())
+    {
+        ofstream f(Opt.JsonFile);
+        S.WriteJson(f);
+        if (!f)
+        {
+            cerr << "cannot write " << Opt.JsonFile << endl;
+            return 1;
+        }
+    }
+
+    if (!Opt.CsvFile.empty())
+    {
+        ofstream f(Opt.CsvFile);
+        S.WriteCsv(f);
+        if (!f)
+        {
+            cerr << "cannot write " << Opt.CsvFile << endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
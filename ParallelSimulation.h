@@ -0,0 +1,140 @@
+// ==========================================================================
+// Copyright (C) 2026 DRNadler
+// ==========================================================================
+// classes defined here:
+// SimulationEngine           - random engine for a given (seed, stream) pair
+// ParallelSimulate           - parallel, reproducible Monte Carlo driver
+// ParallelSimulationTester   - tester for ParallelSimulate
+// ==========================================================================
+
+#pragma once
+
+#include <assert.h>
+#include <algorithm>     // std::clamp, std::for_each
+#include <cstdint>
+#include <execution>     // std::execution::par
+#include <random>
+#include <ranges>        // std::views::iota
+#include <vector>
+
+// ==========================================================================
+// random engine for stream nStream of seed nSeed
+// each (seed, stream) pair seeds the engine's full state through std::seed_seq, so the streams of a seed are
+// statistically independent, and every stream is reproducible - regardless of the thread that uses it
+// cost: std::seed_seq generates the whole state (312 words of std::mt19937_64), and the engine twists it before
+// the first draw - together about the cost of ~2000 draws
+template<typename Engine = std::mt19937_64>
+Engine SimulationEngine(uint64_t nSeed, uint64_t nStream)
+{
+    std::seed_seq Seq{ static_cast<uint32_t>(nSeed  ), static_cast<uint32_t>(nSeed   >> 32),
+                       static_cast<uint32_t>(nStream), static_cast<uint32_t>(nStream >> 32) };
+    return Engine(Seq);
+}
+
+// ==========================================================================
+// run nItems simulation items in parallel, and return the reduction of their results
+// Item  (size_t i, Engine& Eng, T& Acc)  - simulate item i using its own random stream Eng, and accumulate its result into Acc
+// Reduce(T& Acc, const T& Other)        - accumulate Other into Acc
+// Init                                  - identity value of Reduce (e.g. zeros)
+//
+// the items are split to nChunks consecutive chunks, processed in parallel; each chunk accumulates into a local T,
+// and the chunk results are reduced in chunk order. since the partition does not depend on the number of threads,
+// the result is deterministic for a given seed - bit-identical on any machine
+// nChunks should be several times the number of hardware threads, to balance the load
+// every item constructs its engine by SimulationEngine - about the cost of ~2000 draws. an item should therefore
+// draw at least ~10^5 values (e.g. a block of trails, not a single trail), to keep the seeding overhead to a few percent
+template<typename Engine = std::mt19937_64, typename T, typename ItemFn, typename ReduceFn>
+T ParallelSimulate(size_t nItems, uint64_t nSeed, const T& Init, ItemFn&& Item, ReduceFn&& Reduce, size_t nChunks = 1024)
+{
+    nChunks = std::clamp<size_t>(nChunks, 1, std::max<size_t>(nItems, 1));
+
+    std::vector<T> ChunkRes(nChunks, Init);
+
+    auto Chunks = std::views::iota(size_t(0), nChunks);
+    std::for_each(std::execution::par, Chunks.begin(), Chunks.end(), [&](size_t c)
+    {
+        T Acc = Init; // local - avoid false sharing between chunks
+
+        for (size_t i = nItems * c / nChunks; i < nItems * (c+1) / nChunks; ++i)
+        {
+            Engine Eng = SimulationEngine<Engine>(nSeed, i);
+            Item(i, Eng, Acc);
+        }
+
+        ChunkRes[c] = std::move(Acc);
+    });
+
+    T Res = std::move(ChunkRes[0]);
+    for (size_t c = 1; c < nChunks; ++c)
+        Reduce(Res, ChunkRes[c]);
+
+    return Res;
+}
+
+// ==========================================================================
+// tester for ParallelSimulate
+class ParallelSimulationTester
+{
+public:
+    ParallelSimulationTester()
+    {
+        const size_t nItems = 10000;
+        const size_t nCells =    10;
+
+        struct Cell
+        {
+            size_t nCount = 0 ;
+            double fSum   = 0.;
+
+            bool operator==(const Cell&) const = default;
+        };
+
+        auto Item = [](size_t i, auto& Eng, std::vector<Cell>& Acc)
+        {
+            std::uniform_real_distribution<double> ud;
+            Cell& c = Acc[i % nCells];
+            ++c.nCount;
+            for (size_t j = 0; j < 10; ++j)
+                c.fSum += ud(Eng);
+        };
+
+        auto Reduce = [](std::vector<Cell>& Acc, const std::vector<Cell>& Other)
+        {
+            for (size_t k = 0; k < nCells; ++k)
+            {
+                Acc[k].nCount += Other[k].nCount;
+                Acc[k].fSum   += Other[k].fSum  ;
+            }
+        };
+
+        const std::vector<Cell> Init(nCells);
+
+        // every item is simulated exactly once
+        [[maybe_unused]] auto r1 = ParallelSimulate(nItems, 1, Init, Item, Reduce);
+        for ([[maybe_unused]] const auto& c : r1)
+            assert(c.nCount == nItems / nCells);
+
+        // reproducible
+        [[maybe_unused]] auto r2 = ParallelSimulate(nItems, 1, Init, Item, Reduce);
+        assert(r1 == r2);
+
+        // different seed - different result
+        [[maybe_unused]] auto r3 = ParallelSimulate(nItems, 2, Init, Item, Reduce);
+        assert(r1 != r3);
+
+        // single chunk - same as serial simulation
+        std::vector<Cell> Serial = Init;
+        for (size_t i = 0; i < nItems; ++i)
+        {
+            auto Eng = SimulationEngine(1, i);
+            Item(i, Eng, Serial);
+        }
+
+        [[maybe_unused]] auto r4 = ParallelSimulate(nItems, 1, Init, Item, Reduce, 1);
+        assert(r4 == Serial);
+
+        // streams differ
+        assert(SimulationEngine(1, 0)() != SimulationEngine(1, 1)());
+        assert(SimulationEngine(1, 0)() != SimulationEngine(2, 0)());
+    }
+};
@@ -1,300 +1,770 @@
-// ==========================================================================
-// truncated normal distribution
-// Lior Kogan (koganlior1@gmail.com), 2012
-// based on VC 2012 std::normal_distribution (random) as a skeleton
-// and on C. H. Jackson's R's implementation of the following paper:
-// Robert, C. P. Simulation of truncated normal variables. Statistics and Computing (1995) 5, 121-125
-// ==========================================================================
-
-#pragma once
-
-#include <random>
-#include "CircHelper.h" // Sqr
-
-#define _NRAND(eng, resty) \
-    (std::generate_canonical<resty, static_cast<size_t>(-1)>(eng))
-
-// ==========================================================================
-// TEMPLATE CLASS truncated_normal_distribution
-template<class _Ty= double>
-class truncated_normal_distribution
-{   // template class for truncated normal distribution
-public:
-    static_assert(std::is_floating_point<_Ty>::value,
-        "invalid template argument for truncated_normal_distribution");
-
-    typedef truncated_normal_distribution<_Ty> _Myt;
-    typedef _Ty result_type;
-
-    struct param_type
-    {   // parameter package
-        typedef _Myt distribution_type;
-
-        explicit param_type(_Ty _Mean0 = 0., _Ty _Sigma0 = 1., _Ty _A0 = 0., _Ty _B0 = 0.)
-        {   // construct from parameters
-            _Init(_Mean0, _Sigma0, _A0, _B0);
-        }
-
-        bool operator==(const param_type& _Right) const
-        {   // test for equality
-            return _Mean  == _Right._Mean  &&
-                   _Sigma == _Right._Sigma &&
-                   _A     == _Right._A     &&
-                   _B     == _Right._B        ;
-        }
-
-        bool operator!=(const param_type& _Right) const
-        {   // test for inequality
-            return !(*this == _Right);
-        }
-
-        _Ty mean() const
-        {   // return mean value
-            return _Mean;
-        }
-
-        _Ty sigma() const
-        {   // return sigma value
-            return _Sigma;
-        }
-
-        _Ty a() const
-        {   // return truncation-range lower-bound
-            return _A;
-        }
-
-        _Ty b() const
-        {   // return truncation-range upper-bound
-            return _B;
-        }
-
-        _Ty stddev() const
-        {   // return sigma value
-            return _Sigma;
-        }
-
-        int alg() const
-        {  // return fastest algorithm for the given parameters
-            return _Alg;
-        }
-
-        void _Init(_Ty _Mean0, _Ty _Sigma0, _Ty _A0, _Ty _B0)
-        {   // set internal state
-            if (_Sigma0 <  0.) throw std::domain_error("invalid sigma argument for truncated_normal_distribution"  );
-            if (_B0     < _A0) throw std::logic_error ("invalid truncation-range for truncated_normal_distribution");
-            _Mean  = _Mean0 ;
-            _Sigma = _Sigma0;
-            _A     = _A0    ;
-            _B     = _B0    ;
-
-            _NA = (_A - _Mean) / _Sigma;
-            _NB = (_B - _Mean) / _Sigma;
-
-            // decide on the fastest algorithm for our case
-            _Alg = 3;
-                 if ((_NA < 0 ) && ( _NB > 0) && (_NB - _NA > sqrt(2. * std::numbers::pi)))                                                         _Alg = 0;
-            else if ((_NA >= 0) && ( _NB >  _NA + 2.*sqrt(exp(1.)) / ( _NA + sqrt(Sqr(_NA) + 4.)) * exp((_NA*2. -  _NA*sqrt(Sqr(_NA) + 4.)) / 4.))) _Alg = 1;
-            else if ((_NB <= 0) && (-_NA > -_NB + 2.*sqrt(exp(1.)) / (-_NB + sqrt(Sqr(_NB) + 4.)) * exp((_NB*2. - -_NB*sqrt(Sqr(_NB) + 4.)) / 4.))) _Alg = 2;
-        }
-
-        _Ty _Mean ;
-        _Ty _Sigma;
-        _Ty _A    ;
-        _Ty _B    ;
-
-        _Ty _NA   ; // _A normalized
-        _Ty _NB   ; // _B normalized
-        int _Alg  ; // algorithm to use
-    };
-
-    explicit truncated_normal_distribution(_Ty _Mean0  = 0.                              ,
-                                           _Ty _Sigma0 = 1.                              ,
-                                           _Ty _A0     = std::numeric_limits< _Ty>::min(),  // truncation-range lower-bound
-                                           _Ty _B0     = std::numeric_limits< _Ty>::max() ) // truncation-range upper-bound
-
-        : _Par(_Mean0, _Sigma0, _A0, _B0)
-    {   // construct
-    }
-
-    explicit truncated_normal_distribution(param_type _Par0)
-        : _Par(_Par0)
-    {   // construct from parameter package
-    }
-
-    _Ty mean() const
-    {   // return mean value
-        return _Par.mean();
-    }
-
-    _Ty sigma() const
-    {   // return sigma value
-        return _Par.sigma();
-    }
-
-    _Ty a() const
-    {   // return truncation-range lower-bound
-        return _Par.a();
-    }
-
-    _Ty b() const
-    {   // return truncation-range upper-bound
-        return _Par.b();
-    }
-
-    _Ty stddev() const
-    {   // return sigma value
-        return _Par.sigma();
-    }
-
-    param_type param() const
-    {   // return parameter package
-        return _Par;
-    }
-
-    void param(const param_type& _Par0)
-    {   // set parameter package
-        _Par = _Par0;
-        reset();
-    }
-
-    result_type (min)() const
-    {   // get smallest possible result
-        return _Par._A;
-    }
-
-    result_type (max)() const
-    {   // get largest possible result
-        return _Par._B;
-    }
-
-    void reset()
-    {   // clear internal state
-    }
-
-    template<class _Engine>
-    result_type operator()(_Engine& _Eng) const
-    {   // return next value
-        return _Eval(_Eng, _Par);
-    }
-
-    template<class _Engine>
-    result_type operator()(_Engine& _Eng, const param_type& _Par0) const
-    {   // return next value, given parameter package
-        reset();
-        return _Eval(_Eng, _Par0);
-    }
-
-    template<class _Elem, class _Traits>
-    basic_istream<_Elem, _Traits>& _Read(basic_istream<_Elem, _Traits>& _Istr)
-    {   // read state from _Istr
-        _Ty _Mean0 ;
-        _Ty _Sigma0;
-        _Ty _A0    ;
-        _Ty _B0    ;
-        _In(_Istr, _Mean0 );
-        _In(_Istr, _Sigma0);
-        _In(_Istr, _A0    );
-        _In(_Istr, _B0    );
-        _Par._Init(_Mean0, _Sigma0, _A0, _B0);
-
-        return _Istr;
-    }
-
-    template<class _Elem, class _Traits>
-    basic_ostream<_Elem, _Traits>& _Write(basic_ostream<_Elem, _Traits>& _Ostr) const
-    {   // write state to _Ostr
-        _Out(_Ostr, _Par._Mean );
-        _Out(_Ostr, _Par._Sigma);
-        _Out(_Ostr, _Par._A    );
-        _Out(_Ostr, _Par._B    );
-
-        return _Ostr;
-    }
-
-private:
-    template<class _Engine> result_type _Eval(_Engine& _Eng, const param_type& _Par0) const
-    {
-        _Ty _Res;
-
-        switch (_Par0._Alg)
-        {
-        case 0 :
-            {
-                normal_distribution<_Ty> nd;
-                do  { _Res = nd(_Eng); }
-                while (_Res < _Par0._NA || _Res > _Par0._NB);
-                break;
-            }
-
-        case 1 :
-            {
-                exponential_distribution<_Ty> ed;
-                _Ty a,u,z;
-
-                do
-                {
-                    a = (_Par0._NA + sqrt(Sqr(_Par0._NA)+4.)) / 2.;
-                    z = ed(_Eng, typename exponential_distribution<_Ty>::param_type(a)) + _Par0._NA;
-                    u = _NRAND(_Eng, _Ty);
-                }
-                while ((u > exp(-Sqr(z-a) / 2.)) || (z > _Par0._NB));
-
-                _Res = z;
-                break;
-            }
-
-        case 2 :
-            {
-                exponential_distribution<_Ty> ed;
-                _Ty a,u,z;
-
-                do
-                {
-                    a = (-_Par0._NB + sqrt(Sqr(_Par0._NB) + 4.)) / 2.;
-                    z = ed(_Eng, typename exponential_distribution<_Ty>::param_type(a)) - _Par0._NB;
-                    u = _NRAND(_Eng, _Ty);
-                }
-                while ((u > exp(-Sqr(z-a) / 2.)) || (z > -_Par0._NA));
-
-                _Res = -z;
-                break;
-            }
-
-        default:
-            {
-                _Ty z,u,rho;
-
-                do
-                {
-                    uniform_real_distribution<_Ty> ud(_Par0._NA, _Par0._NB);
-                    z = ud(_Eng);
-                    u = _NRAND(_Eng, _Ty);
-
-                         if (_Par0._NA > 0) rho = exp((Sqr(_Par0._NA) - Sqr(z)) / 2.);
-                    else if (_Par0._NB < 0) rho = exp((Sqr(_Par0._NB) - Sqr(z)) / 2.);
-                    else                    rho = exp(                - Sqr(z)  / 2.);
-                }
-                while (u > rho);
-
-                _Res = z;
-            }
-        }
-
-        return _Res * _Par0._Sigma + _Par0._Mean; // denormalize result
-    }
-
-    int        _Alg; // which algorithm to use
-    param_type _Par;
-};
-
-template<class _Elem, class _Traits, class _Ty>
-basic_istream<_Elem, _Traits>& operator>>(basic_istream<_Elem, _Traits>& _Istr, truncated_normal_distribution<_Ty>& _Dist)
-{   // read state from _Istr
-    return _Dist._Read(_Istr);
-}
-
-template<class _Elem, class _Traits, class _Ty>
-basic_ostream<_Elem, _Traits>& operator<<(basic_ostream<_Elem, _Traits>& _Ostr, const truncated_normal_distribution<_Ty>& _Dist)
-{   // write state to _Ostr
-    return _Dist._Write(_Ostr);
-}
+// ==========================================================================
+// truncated normal distribution
+// Lior Kogan (koganlior1@gmail.com), 2012
+// based on VC 2012 std::normal_distribution (random) as a skeleton
+// and on C. H. Jackson's R's implementation of the following paper:
+// Robert, C. P. Simulation of truncated normal variables. Statistics and Computing (1995) 5, 121-125
+// inverse CDF: Acklam, P. J. An algorithm for computing the inverse normal cumulative distribution function (2003)
+// strip table: Vose, M. D. A linear algorithm for generating random numbers with a given distribution.
+// IEEE Transactions on Software Engineering (1991) 17(9), 972-975
+// ==========================================================================
+
+// DRNadler 14-Oct-2026: Select the sampler by its exact acceptance rate; add inverse-CDF and table samplers.
+
+// DRNadler 14-Oct-2026: Count the samples and the attempts of each algorithm (CircInstrument.h).
+
+// DRNadler 14-Oct-2026: Add bulk fill / generate sampling.
+
+#pragma once
+
+#include <random>
+#include <algorithm>    // std::copy_n, std::min, std::clamp, std::sort
+#include <array>
+#include <assert.h>
+#include <cmath>        // std::erfc
+#include <iterator>     // std::contiguous_iterator
+#include <limits>
+#include <memory>       // std::shared_ptr
+#include <numbers>      // std::numbers::pi
+#include <span>
+#include <stdexcept>    // std::domain_error
+#include <vector>
+#include "CircHelper.h"     // Sqr
+#include "CircInstrument.h" // CIRC_COUNT
+
+#define _NRAND(eng, resty) \
+    (std::generate_canonical<resty, static_cast<size_t>(-1)>(eng))
+
+// ==========================================================================
+// standard normal distribution truncated to [_NA,_NB] - the sampling algorithms of truncated_normal_distribution
+// and wrapped_truncated_normal_distribution. _Site0: instrumentation site of algorithm 0 (see CircInstrument.h)
+//
+// algorithms - their constants are computed once, by _Init:
+//   0: normal rejection                                                  - any range
+//   1: exponential rejection, translated to _NA (Robert 1995)            - _NA >= 0
+//   2: exponential rejection, translated to _NB (mirrored 1)             - _NB <= 0
+//   3: uniform rejection                                                 - finite range
+//   4: inverse CDF, refined to full precision - no rejections            - |mode| <= 30; beyond, the tail mass underflows
+//   5: strip table: rejection from a piecewise-constant envelope of _Strips strips, selected by an alias table;
+//      acceptance ~0.95 for any range, and most values are accepted without evaluating exp.
+//      values whose density is below e^-50 of the mode's are not generated. the table is built by _Init (~1 us),
+//      so algorithm 5 is selected automatically only for alg_auto_table - for parameters used for many values
+//
+// the acceptance rate of each rejection algorithm is computed exactly from [_NA,_NB]; the algorithm with the lowest
+// expected cost - its cost per attempt (_Cost) divided by its acceptance rate - is selected
+template<class _Ty, CircSite _Site0>
+struct _Truncated_std_normal
+{
+    static constexpr int    alg_auto       = -1; // select among algorithms 0..4
+    static constexpr int    alg_auto_table = -2; // select among algorithms 0..5
+    static constexpr size_t _Strips        = 64; // algorithm 5: number of strips
+
+    // relative cost of one attempt of each algorithm - measured by CircularBench (truncated_normal_distribution/...)
+    // 4: while the mode is below 1.97 - beyond, most values take the tail branch of _InvQ (log, sqrt): _CostInvTail
+    static constexpr double _Cost[6]     = { 1.3, 1.25, 1.25, 1.0, 1.4, 1.35 };
+    static constexpr double _CostInvTail = 2.1;
+
+    struct _Table
+    {   // algorithm 5: piecewise-constant envelope of the density exp((m^2 - z^2)/2), m: mode
+        double                        _Lo   ; // lower bound of strip 0
+        double                        _H    ; // width of a strip
+        double                        _HM2  ; // m^2/2
+        std::array<double , _Strips>  _Fmax ; // envelope of each strip: max of the density
+        std::array<double , _Strips>  _Ratio; // min / max of the density in each strip: below, accepted without exp
+        std::array<double , _Strips>  _Prob ; // alias table: probability of keeping the selected strip
+        std::array<uint8_t, _Strips>  _Alias; // alias table: strip used otherwise
+    };
+
+    _Ty    _NA     ; // truncation-range lower-bound, normalized
+    _Ty    _NB     ; // truncation-range upper-bound, normalized
+    int    _Alg    ; // algorithm to use
+    double _Accept ; // acceptance rate of _Alg
+
+    _Ty    _Lambda ; // 1,2: rate of the exponential distribution
+    _Ty    _C      ; // 3  : rho = exp((_C - z^2)/2)
+    bool   _Central; // 4  : 0 is within the range - inverse of the CDF; otherwise inverse of the tail mass (mirrored if _NB <= 0)
+    double _T0     ; // 4  : CDF / tail mass at the near bound
+    double _DT     ; // 4  : mass of the range (tail mode: negative - the tail mass decreases)
+    std::shared_ptr<const _Table> _Tab; // 5
+
+    static double _Q(double x)
+    {   // upper-tail mass of the standard normal distribution
+        return 0.5 * std::erfc(x / std::numbers::sqrt2);
+    }
+
+    static double _ScaledQ(double x)
+    {   // exp(x^2/2) * _Q(x), x >= 0. beyond 5: Laplace's continued fraction (30 terms: ~1e-15)
+        if (x < 5.)
+            return _Q(x) * std::exp(x * x / 2.);
+
+        double t = x;
+        for (int k = 30; k > 0; --k)
+            t = x + k / t;
+        return 1. / (std::sqrt(2. * std::numbers::pi) * t);
+    }
+
+    static double _Mass(double a, double b)
+    {   // integral of exp((m^2 - z^2)/2) over [a,b], m: mode (the point of [a,b] closest to 0) - no underflow in the tails
+        if (a >= 0.) return std::sqrt(2. * std::numbers::pi) * (_ScaledQ(a) - std::exp(-(b - a) * (b + a) / 2.) * _ScaledQ(b));
+        if (b <= 0.) return _Mass(-b, -a);
+        return std::sqrt(2. * std::numbers::pi) * (1. - _Q(-a) - _Q(b));
+    }
+
+    static double _InvQ(double q)
+    {   // z such that _Q(z) = q, q in (0, 0.5]: Acklam's rational approximation (relative error 1.15e-9), refined by a Halley step
+        static constexpr double a[] = { -3.969683028665376e+01,  2.209460984245205e+02, -2.759285104469687e+02,  1.383577518672690e+02, -3.066479806614716e+01,  2.506628277459239e+00 };
+        static constexpr double b[] = { -5.447609879822406e+01,  1.615858368580409e+02, -1.556989798598866e+02,  6.680131188771972e+01, -1.328068155288572e+01 };
+        static constexpr double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00, -2.549732539343734e+00,  4.374664141464968e+00,  2.938163982698783e+00 };
+        static constexpr double d[] = {  7.784695709041462e-03,  3.224671290700398e-01,  2.445134137142996e+00,  3.754408661907416e+00 };
+
+        double z;
+        if (q < 0.02425)
+        {
+            const double r = std::sqrt(-2. * std::log(q));
+            z = -(((((c[0]*r + c[1])*r + c[2])*r + c[3])*r + c[4])*r + c[5]) / ((((d[0]*r + d[1])*r + d[2])*r + d[3])*r + 1.);
+        }
+        else
+        {
+            const double r = q - 0.5, r2 = r * r;
+            z = -(((((a[0]*r2 + a[1])*r2 + a[2])*r2 + a[3])*r2 + a[4])*r2 + a[5])*r / (((((b[0]*r2 + b[1])*r2 + b[2])*r2 + b[3])*r2 + b[4])*r2 + 1.);
+        }
+
+        const double u = (_Q(z) - q) * std::sqrt(2. * std::numbers::pi) * std::exp(z * z / 2.); // (_Q(z) - q) / density(z)
+        return z + u / (1. - z * u / 2.);
+    }
+
+    void _Init(_Ty _NA0, _Ty _NB0, int _Alg0 = alg_auto)
+    {   // set internal state
+        _NA = _NA0;
+        _NB = _NB0;
+        _Tab.reset();
+
+        const double a = _NA;
+        const double b = _NB;
+        const double m = a > 0. ? a : b < 0. ? b : 0.;                                 // mode
+        const double G = _Mass(a, b);                                                  // area under exp((m^2 - z^2)/2)
+
+        _Lambda  = static_cast<_Ty>(a >= 0. ? (a + std::sqrt(a*a + 4.)) / 2. : (-b + std::sqrt(b*b + 4.)) / 2.);
+        _C       = static_cast<_Ty>(m * m);
+        _Central = a < 0. && b > 0.;
+        _T0      = _Central ? _Q(-a)               : a >= 0. ? _Q(a)        : _Q(-b)       ;
+        _DT      = _Central ? 1. - _Q(-a) - _Q(b) : a >= 0. ? _Q(b) - _Q(a) : _Q(-a) - _Q(-b);
+
+        // acceptance rate of each algorithm; 0: not applicable
+        double _Acc[6] = {};
+        _Acc[0] = G * std::exp(-m * m / 2.) / std::sqrt(2. * std::numbers::pi);
+        if (a >= 0.              ) _Acc[1] = _Lambda * G * std::exp(-Sqr(_Lambda - a) / 2.);
+        if (b <= 0.              ) _Acc[2] = _Lambda * G * std::exp(-Sqr(_Lambda + b) / 2.);
+        if (std::isfinite(b - a) ) _Acc[3] = G / (b - a);
+        if (std::abs(m) <= 30.   ) _Acc[4] = 1.;
+        if (_Alg0 == 5 || _Alg0 == alg_auto_table)
+            _Acc[5] = _InitTable(a, b, m, G);
+
+        if (!(b > a))                                                                  // a single value
+        {
+            _Alg    = 3;
+            _Accept = 1.;
+            return;
+        }
+
+        if (_Alg0 >= 0)
+        {
+            if (_Alg0 > 5 || !(_Acc[_Alg0] > 0.))
+                throw std::domain_error("invalid algorithm for the truncation-range of truncated_normal_distribution");
+            _Alg = _Alg0;
+        }
+        else
+        {   // decide on the fastest algorithm for our case
+            _Alg = 3;
+            double _MinCost = std::numeric_limits<double>::infinity();
+            for (int k = 0; k < (_Alg0 == alg_auto_table ? 6 : 5); ++k)
+            {
+                const double _C0 = k == 4 && std::abs(m) >= 1.97 ? _CostInvTail : _Cost[k];
+                if (_Acc[k] > 0. && _C0 / _Acc[k] < _MinCost)
+                {
+                    _MinCost = _C0 / _Acc[k];
+                    _Alg     = k;
+                }
+            }
+        }
+
+        _Accept = __min(_Acc[_Alg], 1.);
+        if (_Alg != 5)
+            _Tab.reset();
+    }
+
+    double _InitTable(double a, double b, double m, double G)
+    {   // algorithm 5: build the table; return its acceptance rate
+        const double R  = std::sqrt(m * m + 100.);                                     // beyond +-R: exp((m^2 - z^2)/2) < e^-50
+        const double lo = __max(a, -R);
+        const double hi = __min(b,  R);
+        if (!(hi > lo))
+            return 0.;
+
+        auto T   = std::make_shared<_Table>();
+        T->_Lo   = lo;
+        T->_H    = (hi - lo) / _Strips;
+        T->_HM2  = m * m / 2.;
+
+        auto F   = [&](double z) { return std::exp(T->_HM2 - z * z / 2.); };
+        double fSum = 0.;
+        for (size_t i = 0; i < _Strips; ++i)
+        {
+            const double z0 = lo + i * T->_H;
+            const double z1 = i + 1 == _Strips ? hi : z0 + T->_H;
+            T->_Fmax [i] = F(std::clamp(0., z0, z1));
+            T->_Ratio[i] = __min(F(z0), F(z1)) / T->_Fmax[i];
+            fSum        += T->_Fmax[i];
+        }
+
+        // alias table (Vose): strip i is selected with probability _Fmax[i] / fSum
+        std::array<double, _Strips> P;
+        std::array<uint8_t, _Strips> Small, Large;
+        size_t nSmall = 0, nLarge = 0;
+        for (size_t i = 0; i < _Strips; ++i)
+        {
+            P[i] = T->_Fmax[i] * _Strips / fSum;
+            (P[i] < 1. ? Small[nSmall++] : Large[nLarge++]) = static_cast<uint8_t>(i);
+        }
+        while (nSmall && nLarge)
+        {
+            const uint8_t s = Small[--nSmall];
+            const uint8_t l = Large[--nLarge];
+            T->_Prob [s] = P[s];
+            T->_Alias[s] = l;
+            P[l] += P[s] - 1.;
+            (P[l] < 1. ? Small[nSmall++] : Large[nLarge++]) = l;
+        }
+        while (nLarge) { const uint8_t l = Large[--nLarge]; T->_Prob[l] = 1.; T->_Alias[l] = l; }
+        while (nSmall) { const uint8_t s = Small[--nSmall]; T->_Prob[s] = 1.; T->_Alias[s] = s; } // rounding
+
+        _Tab = std::move(T);
+        return G / (_Tab->_H * fSum);
+    }
+
+    _Ty _Clamp(double z) const
+    {   // rounding may leave the range
+        return std::clamp(static_cast<_Ty>(z), _NA, _NB);
+    }
+
+    _Ty _InvCdf(double u) const
+    {   // algorithm 4: u in [0,1)
+        constexpr double fMin = std::numeric_limits<double>::min();
+        const double     t    = _T0 + u * _DT;
+
+        if (_Central) return _Clamp(t < 0.5 ? -_InvQ(__max(t, fMin)) : _InvQ(__max(1. - t, fMin)));
+        if (_NA >= 0) return _Clamp( _InvQ(__max(t, fMin)));
+        return               _Clamp(-_InvQ(__max(t, fMin)));
+    }
+
+    template<class _Engine> _Ty _Strip(_Engine& _Eng) const
+    {   // algorithm 5
+        const _Table& T = *_Tab;
+        for (;;)
+        {
+            CIRC_COUNT(CircSiteOfAlg(_Site0, 5), Attempts, 1);
+            const double u = _NRAND(_Eng, double) * _Strips;
+            const size_t j = __min(static_cast<size_t>(u), _Strips - 1);
+            const size_t i = u - j < T._Prob[j] ? j : T._Alias[j];
+            const double z = T._Lo + (i + _NRAND(_Eng, double)) * T._H;
+            const double v = _NRAND(_Eng, double);
+
+            if (v < T._Ratio[i] || v * T._Fmax[i] <= std::exp(T._HM2 - z * z / 2.))
+                return _Clamp(z);
+        }
+    }
+
+    template<class _Engine> _Ty _Eval(_Engine& _Eng) const
+    {   // return next value
+        CIRC_COUNT(CircSiteOfAlg(_Site0, _Alg), Samples, 1);
+        return _Sample(_Eng);
+    }
+
+    template<class _Engine> _Ty _Sample(_Engine& _Eng) const
+    {   // return next value - not counted
+        _Ty _Res;
+
+        switch (_Alg)
+        {
+        case 0 :
+            {
+                normal_distribution<_Ty> nd;
+                do  { CIRC_COUNT(CircSiteOfAlg(_Site0, 0), Attempts, 1); _Res = nd(_Eng); }
+                while (_Res < _NA || _Res > _NB);
+                break;
+            }
+
+        case 1 :
+            {
+                exponential_distribution<_Ty> ed(_Lambda);
+                _Ty u,z;
+
+                do
+                {
+                    CIRC_COUNT(CircSiteOfAlg(_Site0, 1), Attempts, 1);
+                    z = ed(_Eng) + _NA;
+                    u = _NRAND(_Eng, _Ty);
+                }
+                while ((u > exp(-Sqr(z - _Lambda) / 2.)) || (z > _NB));
+
+                _Res = z;
+                break;
+            }
+
+        case 2 :
+            {
+                exponential_distribution<_Ty> ed(_Lambda);
+                _Ty u,z;
+
+                do
+                {
+                    CIRC_COUNT(CircSiteOfAlg(_Site0, 2), Attempts, 1);
+                    z = ed(_Eng) - _NB;
+                    u = _NRAND(_Eng, _Ty);
+                }
+                while ((u > exp(-Sqr(z - _Lambda) / 2.)) || (z > -_NA));
+
+                _Res = -z;
+                break;
+            }
+
+        case 3 :
+            {
+                uniform_real_distribution<_Ty> ud(_NA, _NB);
+                _Ty z,u;
+
+                do
+                {
+                    CIRC_COUNT(CircSiteOfAlg(_Site0, 3), Attempts, 1);
+                    z = ud(_Eng);
+                    u = _NRAND(_Eng, _Ty);
+                }
+                while (u > exp((_C - Sqr(z)) / 2.));
+
+                _Res = z;
+                break;
+            }
+
+        case 4 :
+            CIRC_COUNT(CircSiteOfAlg(_Site0, 4), Attempts, 1);
+            _Res = _InvCdf(_NRAND(_Eng, double));
+            break;
+
+        default:
+            _Res = _Strip(_Eng);
+        }
+
+        return _Res;
+    }
+
+    template<class _Engine> void _Fill(_Engine& _Eng, std::span<_Ty> _Out) const
+    {   // compute next values: same algorithms as _Eval
+        CIRC_COUNT(CircSiteOfAlg(_Site0, _Alg), Samples, _Out.size());
+
+        switch (_Alg)
+        {
+        case 0 :
+            {   // unlike _Eval, both values of each pair generated by nd are used
+                normal_distribution<_Ty> nd;
+                for (_Ty& _Res : _Out)
+                {
+                    do  { CIRC_COUNT(CircSiteOfAlg(_Site0, 0), Attempts, 1); _Res = nd(_Eng); }
+                    while (_Res < _NA || _Res > _NB);
+                }
+                break;
+            }
+
+        default:
+            for (_Ty& _Res : _Out)                           // the other algorithms have no state shared between values
+                _Res = _Sample(_Eng);
+        }
+    }
+};
+
+// ==========================================================================
+// TEMPLATE CLASS truncated_normal_distribution
+template<class _Ty= double>
+class truncated_normal_distribution
+{   // template class for truncated normal distribution
+public:
+    static_assert(std::is_floating_point<_Ty>::value,
+        "invalid template argument for truncated_normal_distribution");
+
+    typedef truncated_normal_distribution<_Ty> _Myt;
+    typedef _Ty result_type;
+
+    typedef _Truncated_std_normal<_Ty, CircSite::TruncNormal0> _Std_type;
+
+    struct param_type
+    {   // parameter package
+        typedef _Myt distribution_type;
+
+        static constexpr int alg_auto       = _Std_type::alg_auto      ; // select the fastest algorithm, among 0..4
+        static constexpr int alg_auto_table = _Std_type::alg_auto_table; // select the fastest algorithm, among 0..5 - for parameters used for many values
+
+        // _Alg0: algorithm to use (0..5 - see _Truncated_std_normal), or alg_auto, alg_auto_table
+        explicit param_type(_Ty _Mean0 = 0., _Ty _Sigma0 = 1., _Ty _A0 = 0., _Ty _B0 = 0., int _Alg0 = alg_auto)
+        {   // construct from parameters
+            _Init(_Mean0, _Sigma0, _A0, _B0, _Alg0);
+        }
+
+        bool operator==(const param_type& _Right) const
+        {   // test for equality
+            return _Mean  == _Right._Mean  &&
+                   _Sigma == _Right._Sigma &&
+                   _A     == _Right._A     &&
+                   _B     == _Right._B        ;
+        }
+
+        bool operator!=(const param_type& _Right) const
+        {   // test for inequality
+            return !(*this == _Right);
+        }
+
+        _Ty mean() const
+        {   // return mean value
+            return _Mean;
+        }
+
+        _Ty sigma() const
+        {   // return sigma value
+            return _Sigma;
+        }
+
+        _Ty a() const
+        {   // return truncation-range lower-bound
+            return _A;
+        }
+
+        _Ty b() const
+        {   // return truncation-range upper-bound
+            return _B;
+        }
+
+        _Ty stddev() const
+        {   // return sigma value
+            return _Sigma;
+        }
+
+        int alg() const
+        {  // return fastest algorithm for the given parameters
+            return _Std._Alg;
+        }
+
+        double acceptance() const
+        {   // return acceptance rate of the algorithm: expected values per attempt
+            return _Std._Accept;
+        }
+
+        void _Init(_Ty _Mean0, _Ty _Sigma0, _Ty _A0, _Ty _B0, int _Alg0 = alg_auto)
+        {   // set internal state
+            if (_Sigma0 <  0.) throw std::domain_error("invalid sigma argument for truncated_normal_distribution"  );
+            if (_B0     < _A0) throw std::logic_error ("invalid truncation-range for truncated_normal_distribution");
+            _Mean  = _Mean0 ;
+            _Sigma = _Sigma0;
+            _A     = _A0    ;
+            _B     = _B0    ;
+
+            _Std._Init((_A - _Mean) / _Sigma, (_B - _Mean) / _Sigma, _Alg0); // decide on the fastest algorithm for our case
+        }
+
+        _Ty       _Mean ;
+        _Ty       _Sigma;
+        _Ty       _A    ;
+        _Ty       _B    ;
+
+        _Std_type _Std  ; // normalized range [_NA,_NB], algorithm to use, and its constants
+    };
+
+    explicit truncated_normal_distribution(_Ty _Mean0  = 0.                              ,
+                                           _Ty _Sigma0 = 1.                              ,
+                                           _Ty _A0     = std::numeric_limits< _Ty>::min(),  // truncation-range lower-bound
+                                           _Ty _B0     = std::numeric_limits< _Ty>::max() ) // truncation-range upper-bound
+
+        : _Par(_Mean0, _Sigma0, _A0, _B0)
+    {   // construct
+    }
+
+    explicit truncated_normal_distribution(param_type _Par0)
+        : _Par(_Par0)
+    {   // construct from parameter package
+    }
+
+    _Ty mean() const
+    {   // return mean value
+        return _Par.mean();
+    }
+
+    _Ty sigma() const
+    {   // return sigma value
+        return _Par.sigma();
+    }
+
+    _Ty a() const
+    {   // return truncation-range lower-bound
+        return _Par.a();
+    }
+
+    _Ty b() const
+    {   // return truncation-range upper-bound
+        return _Par.b();
+    }
+
+    _Ty stddev() const
+    {   // return sigma value
+        return _Par.sigma();
+    }
+
+    param_type param() const
+    {   // return parameter package
+        return _Par;
+    }
+
+    void param(const param_type& _Par0)
+    {   // set parameter package
+        _Par = _Par0;
+        reset();
+    }
+
+    result_type (min)() const
+    {   // get smallest possible result
+        return _Par._A;
+    }
+
+    result_type (max)() const
+    {   // get largest possible result
+        return _Par._B;
+    }
+
+    void reset()
+    {   // clear internal state
+    }
+
+    template<class _Engine>
+    result_type operator()(_Engine& _Eng) const
+    {   // return next value
+        return _Eval(_Eng, _Par);
+    }
+
+    template<class _Engine>
+    result_type operator()(_Engine& _Eng, const param_type& _Par0) const
+    {   // return next value, given parameter package
+        reset();
+        return _Eval(_Eng, _Par0);
+    }
+
+    template<class _Engine>
+    void fill(_Engine& _Eng, std::span<_Ty> _Out) const
+    {   // fill _Out with next values
+        _Fill(_Eng, _Out, _Par);
+    }
+
+    template<class _Engine, class _FwdIt>
+    void generate(_Engine& _Eng, _FwdIt _First, _FwdIt _Last) const
+    {   // assign next values to [_First, _Last)
+        if constexpr (std::contiguous_iterator<_FwdIt> && std::is_same_v<std::iter_value_t<_FwdIt>, _Ty>)
+            fill(_Eng, std::span<_Ty>(std::to_address(_First), std::to_address(_Last)));
+        else
+        {
+            _Ty _Buf[_BlockSize];
+            for (auto _Count = std::distance(_First, _Last); _Count > 0; )
+            {
+                const size_t _N = std::min(static_cast<size_t>(_Count), _BlockSize);
+                fill(_Eng, std::span<_Ty>(_Buf, _N));
+                _First  = std::copy_n(_Buf, _N, _First);
+                _Count -= _N;
+            }
+        }
+    }
+
+    template<class _Elem, class _Traits>
+    basic_istream<_Elem, _Traits>& _Read(basic_istream<_Elem, _Traits>& _Istr)
+    {   // read state from _Istr
+        _Ty _Mean0 ;
+        _Ty _Sigma0;
+        _Ty _A0    ;
+        _Ty _B0    ;
+        _In(_Istr, _Mean0 );
+        _In(_Istr, _Sigma0);
+        _In(_Istr, _A0    );
+        _In(_Istr, _B0    );
+        _Par._Init(_Mean0, _Sigma0, _A0, _B0);
+
+        return _Istr;
+    }
+
+    template<class _Elem, class _Traits>
+    basic_ostream<_Elem, _Traits>& _Write(basic_ostream<_Elem, _Traits>& _Ostr) const
+    {   // write state to _Ostr
+        _Out(_Ostr, _Par._Mean );
+        _Out(_Ostr, _Par._Sigma);
+        _Out(_Ostr, _Par._A    );
+        _Out(_Ostr, _Par._B    );
+
+        return _Ostr;
+    }
+
+private:
+    template<class _Engine> result_type _Eval(_Engine& _Eng, const param_type& _Par0) const
+    {
+        return _Par0._Std._Eval(_Eng) * _Par0._Sigma + _Par0._Mean; // denormalize result
+    }
+
+    template<class _Engine> void _Fill(_Engine& _Eng, std::span<_Ty> _Out, const param_type& _Par0) const
+    {   // compute next values: same algorithms as _Eval, with the per-algorithm setup done once for the whole block
+        _Par0._Std._Fill(_Eng, _Out);
+
+        for (_Ty& d : _Out)
+            d = d * _Par0._Sigma + _Par0._Mean; // denormalize result
+    }
+
+    static constexpr size_t _BlockSize = 256; // generate(): number of values generated at once
+
+    param_type _Par;
+};
+
+template<class _Elem, class _Traits, class _Ty>
+basic_istream<_Elem, _Traits>& operator>>(basic_istream<_Elem, _Traits>& _Istr, truncated_normal_distribution<_Ty>& _Dist)
+{   // read state from _Istr
+    return _Dist._Read(_Istr);
+}
+
+template<class _Elem, class _Traits, class _Ty>
+basic_ostream<_Elem, _Traits>& operator<<(basic_ostream<_Elem, _Traits>& _Ostr, const truncated_normal_distribution<_Ty>& _Dist)
+{   // write state to _Ostr
+    return _Dist._Write(_Ostr);
+}
+
+// ==========================================================================
+// statistical tester for truncated_normal_distribution
+// Kolmogorov-Smirnov test of the generated values against the truncated normal CDF - for each applicable algorithm,
+// by operator() and by fill(); the automatic selection; the acceptance rates (when instrumented)
+template<class _Ty= double>
+class TruncNormalDistTester
+{
+    typedef typename truncated_normal_distribution<_Ty>::param_type param_type;
+
+    static constexpr double fKSCrit = 2.3; // critical value of sqrt(n)*D; p ~ 5e-5
+
+    static double Phi(double z)
+    {   // standard normal CDF
+        return 0.5 * std::erfc(-z / std::numbers::sqrt2);
+    }
+
+    static double Q(double z)
+    {   // standard normal upper-tail mass
+        return 0.5 * std::erfc(z / std::numbers::sqrt2);
+    }
+
+    template<class Cdf>
+    static double KS(std::vector<_Ty>& v, Cdf&& F)
+    {   // return sqrt(n) * Kolmogorov-Smirnov statistic
+        std::sort(v.begin(), v.end());
+
+        const double n = static_cast<double>(v.size());
+        double       d = 0.;
+        for (size_t i = 0; i < v.size(); ++i)
+        {
+            const double f = F(v[i]);
+            d = std::max({d, f - i/n, (i+1)/n - f});
+        }
+
+        return d * std::sqrt(n);
+    }
+
+    static void Test(_Ty fMean, _Ty fSigma, _Ty fA, _Ty fB)
+    {
+        const size_t n  = 20000;
+        const double NA = (static_cast<double>(fA) - fMean) / fSigma;
+        const double NB = (static_cast<double>(fB) - fMean) / fSigma;
+
+        auto F = [=](double x)
+        {   // truncated normal CDF - by the upper-tail mass in the upper tail, to avoid cancellation
+            const double z = (x - fMean) / fSigma;
+            return NA >= 0. ? (Q(NA) - Q(z)) / (Q(NA) - Q(NB)) : (Phi(z) - Phi(NA)) / (Phi(NB) - Phi(NA));
+        };
+
+        // the automatic selection never picks a slow algorithm
+        [[maybe_unused]] const param_type Auto(fMean, fSigma, fA, fB);
+        assert(Auto.acceptance() >= 0.5);
+        assert(param_type(fMean, fSigma, fA, fB, param_type::alg_auto_table).acceptance() >= 0.5);
+
+        std::mt19937_64  Eng(3);
+        std::vector<_Ty> v(n);
+
+        for (int nAlg = 0; nAlg <= 5; ++nAlg)
+        {
+            bool bApplicable = true;
+            try                              { param_type(fMean, fSigma, fA, fB, nAlg); }
+            catch (const std::domain_error&) { bApplicable = false; }
+
+            assert(bApplicable || nAlg != Auto.alg());            // the selected algorithm is applicable
+            if (!bApplicable)
+                continue;
+
+            const truncated_normal_distribution<_Ty> tnd(param_type(fMean, fSigma, fA, fB, nAlg));
+            if (tnd.param().acceptance() < 0.05)                  // applicable, but far too slow to test
+                continue;
+
+            CircInstrument::Drain();
+            for (auto& x : v)
+            {
+                x = tnd(Eng);
+                assert(x >= fA && x <= fB);
+            }
+
+            if constexpr (CircInstrument::bEnabled)
+            {   // the number of attempts matches the acceptance rate
+                [[maybe_unused]] const CircInstrumentData D = CircInstrument::Drain();
+                [[maybe_unused]] const CircSite           S = CircSiteOfAlg(CircSite::TruncNormal0, nAlg);
+                [[maybe_unused]] const double             p = tnd.param().acceptance();
+                assert(D.Count(S, CircCounter::Samples) == n);
+                assert(std::abs(D.Count(S, CircCounter::Attempts) - n / p) < 5. * std::sqrt(n * (1. - p)) / p + 1.);
+            }
+
+            [[maybe_unused]] const double ks1 = KS(v, F);
+            assert(ks1 < fKSCrit);
+
+            tnd.fill(Eng, std::span<_Ty>(v));
+            for ([[maybe_unused]] auto x : v)
+                assert(x >= fA && x <= fB);
+            [[maybe_unused]] const double ks2 = KS(v, F);
+            assert(ks2 < fKSCrit);
+        }
+    }
+
+public:
+    TruncNormalDistTester()
+    {
+        constexpr _Ty Inf = std::numeric_limits<_Ty>::infinity();
+
+        const _Ty Params[][4] = { {  0.,  1.,  -3. ,   3.  },   // mean, sigma, truncation-range: central
+                                  {  0.,  1.,  -0.1,  Inf  },   // one-sided, including the mode
+                                  {  0.,  1.,   0. ,   1.5 },   // bounded by the mode
+                                  {  0.,  1.,   2. ,  Inf  },   // tail
+                                  {  0.,  1.,   5. ,   5.2 },   // narrow far tail
+                                  {  0.,  1.,   8. ,   8.1 },   // narrow deep tail
+                                  {  0.,  1., -Inf ,  -4.  },   // lower tail
+                                  { 10.,  2.,   0. ,  12.  },   // [-5,1] normalized
+                                  { 90., 30.,  45. , 100.  } };
+
+        for (const auto& p : Params)
+            Test(p[0], p[1], p[2], p[3]);
+
+        // forcing an algorithm that does not apply to the range
+        [[maybe_unused]] bool bThrown = false;
+        try                              { param_type(0., 1., 2., Inf, 2); }
+        catch (const std::domain_error&) { bThrown = true; }
+        assert(bThrown);
+
+        bThrown = false;
+        try                              { param_type(0., 1., 0., Inf, 3); }
+        catch (const std::domain_error&) { bThrown = true; }
+        assert(bThrown);
+
+        // a single value
+        [[maybe_unused]] const truncated_normal_distribution<_Ty> One(0., 1., 1., 1.);
+        std::mt19937_64 Eng(4);
+        assert(One(Eng) == 1.);
+    }
+};
@@ -1,252 +1,1044 @@
-// ==========================================================================
-// wrapped normal distribution
-// Lior Kogan (koganlior1@gmail.com), 2012
-// based on VC 2012 std::normal_distribution (random) as a skeleton
-// ==========================================================================
-
-#pragma once
-
-#include <random>
-#include "CircHelper.h" // Mod
-
-#define _NRAND(eng, resty) \
-    (std::generate_canonical<resty, static_cast<size_t>(-1)>(eng))
-
-// ==========================================================================
-// TEMPLATE CLASS wrapped_normal_distribution
-template<class _Ty= double>
-class wrapped_normal_distribution
-{   // template class for wrapped normal distribution
-public:
-    static_assert(std::is_floating_point<_Ty>::value,
-        "invalid template argument for wrapped_normal_distribution");
-
-    typedef wrapped_normal_distribution<_Ty> _Myt;
-    typedef _Ty result_type;
-
-    struct param_type
-    {   // parameter package
-        typedef _Myt distribution_type;
-
-        explicit param_type(_Ty _Mean0 = 0., _Ty _Sigma0 = 1., _Ty _L0 = 0., _Ty _H0 = 0.)
-        {   // construct from parameters
-            _Init(_Mean0, _Sigma0, _L0, _H0);
-        }
-
-        bool operator==(const param_type& _Right) const
-        {   // test for equality
-            return _Mean  == _Right._Mean  &&
-                   _Sigma == _Right._Sigma &&
-                   _L     == _Right._L     &&
-                   _H     == _Right._H        ;
-
-        }
-
-        bool operator!=(const param_type& _Right) const
-        {   // test for inequality
-            return !(*this == _Right);
-        }
-
-        _Ty mean() const
-        {   // return mean value
-            return _Mean;
-        }
-
-        _Ty sigma() const
-        {   // return sigma value
-            return _Sigma;
-        }
-
-        _Ty l() const
-        {   // return wrapping-range lower-bound
-            return _L;
-        }
-
-        _Ty h() const
-        {   // return wrapping-range upper-bound
-            return _H;
-        }
-
-        _Ty stddev() const
-        {   // return sigma value
-            return _Sigma;
-        }
-
-        void _Init(_Ty _Mean0, _Ty _Sigma0, _Ty _L0, _Ty _H0)
-        {   // set internal state
-            
-            if (_Sigma0 <  0.) throw std::domain_error("invalid sigma argument for wrapped_normal_distribution");
-            if (_H0     < _L0) throw std::logic_error ("invalid wrapping-range for wrapped_normal_distribution");
-            _Mean  = _Mean0 ;
-            _Sigma = _Sigma0;
-            _L     = _L0    ;
-            _H     = _H0    ;
-        }
-
-        _Ty _Mean ;
-        _Ty _Sigma;
-        _Ty _L    ;
-        _Ty _H    ;
-    };
-
-    explicit wrapped_normal_distribution(_Ty _Mean0  =    0.,
-                                         _Ty _Sigma0 =   45.,
-                                         _Ty _L0     = -180.,  // wrapping-range lower-bound
-                                         _Ty _H0     =  180. ) // wrapping-range upper-bound
-        : _Par(_Mean0, _Sigma0, _L0, _H0), _Valid(false), _X2(0)
-    {   // construct
-    }
-
-    explicit wrapped_normal_distribution(param_type _Par0)
-        : _Par(_Par0), _Valid(false), _X2(0)
-    {   // construct from parameter package
-    }
-
-    _Ty mean() const
-    {   // return mean value
-        return _Par.mean();
-    }
-
-    _Ty sigma() const
-    {   // return sigma value
-        return _Par.sigma();
-    }
-
-    _Ty l() const
-    {   // return wrapping-range lower-bound
-        return _Par.l();
-    }
-
-    _Ty h() const
-    {   // return wrapping-range upper-bound
-        return _Par.h();
-    }
-
-    _Ty stddev() const
-    {   // return sigma value
-        return _Par.sigma();
-    }
-
-    param_type param() const
-    {   // return parameter package
-        return _Par;
-    }
-
-    void param(const param_type& _Par0)
-    {   // set parameter package
-        _Par = _Par0;
-        reset();
-    }
-
-    result_type (min)() const
-    {   // get smallest possible result
-        return _Par._L;
-    }
-
-    result_type (max)() const
-    {   // get largest possible result
-        return _Par._H;
-    }
-
-    void reset()
-    {   // clear internal state
-        _Valid= false;
-    }
-
-    template<class _Engine>
-    result_type operator()(_Engine& _Eng)
-    {   // return next value
-        return _Eval(_Eng, _Par);
-    }
-
-    template<class _Engine>
-    result_type operator()(_Engine& _Eng, const param_type& _Par0)
-    {   // return next value, given parameter package
-        reset();
-        return _Eval(_Eng, _Par0, false);
-    }
-
-    template<class _Elem, class _Traits>
-    basic_istream<_Elem, _Traits>& _Read(basic_istream<_Elem, _Traits>& _Istr)
-    {   // read state from _Istr
-        _Ty _Mean0 ;
-        _Ty _Sigma0;
-        _Ty _L0    ;
-        _Ty _H0    ;
-        _In(_Istr, _Mean0 );
-        _In(_Istr, _Sigma0);
-        _In(_Istr, _L0    );
-        _In(_Istr, _H0    );
-        _Par._Init(_Mean0, _Sigma0, _L0, _H0);
-
-        _Istr >> _Valid;
-        _In(_Istr, _X2);
-        return _Istr;
-    }
-
-    template<class _Elem, class _Traits>
-    basic_ostream<_Elem, _Traits>& _Write(basic_ostream<_Elem, _Traits>& _Ostr) const
-    {   // write state to _Ostr
-        _Out(_Ostr, _Par._Mean );
-        _Out(_Ostr, _Par._Sigma);
-        _Out(_Ostr, _Par._L    );
-        _Out(_Ostr, _Par._H    );
-
-        _Ostr << ' ' << _Valid;
-        _Out(_Ostr, _X2);
-        return _Ostr;
-    }
-
-private:
-    template<class _Engine> result_type _Eval(_Engine& _Eng, const param_type& _Par0, bool _Keep = true)
-    {   // compute next value
-        // Knuth, vol. 2, p. 122, alg. P
-        _Ty _Res;
-
-        if (_Keep && _Valid)
-        {   // return stored value
-            _Res   = _X2  ;
-            _Valid = false;
-        }
-        else
-        {   // generate two values, store one, return one
-            double _V1, _V2, _Sx;
-            for (; ; )
-            {   // reject bad values
-                _V1 = 2 * _NRAND(_Eng, _Ty) - 1.;
-                _V2 = 2 * _NRAND(_Eng, _Ty) - 1.;
-                _Sx = _V1 * _V1 + _V2 * _V2;
-                if (_Sx < 1.)
-                    break;
-            }
-
-            double _Fx = std::sqrt(-2. * std::log(_Sx) / _Sx);
-            if (_Keep)
-            {   // save second value for next call
-                _X2    = _Fx * _V2;
-                _Valid = true     ;
-            }
-
-            _Res = _Fx * _V1;
-        }
-
-        result_type d = _Res * _Par0._Sigma + _Par0._Mean;        // denormalize result
-        return Mod(d - _Par0._L, _Par0._H - _Par0._L) + _Par0._L; // wrap        result
-    }
-
-    param_type _Par  ;
-    bool       _Valid;
-    _Ty        _X2   ;
-};
-
-template<class _Elem, class _Traits, class _Ty>
-basic_istream<_Elem, _Traits>& operator>>(basic_istream<_Elem, _Traits>& _Istr, wrapped_normal_distribution<_Ty>& _Dist)
-{   // read state from _Istr
-    return _Dist._Read(_Istr);
-}
-
-template<class _Elem, class _Traits, class _Ty>
-basic_ostream<_Elem, _Traits>& operator<<(basic_ostream<_Elem, _Traits>& _Ostr, const wrapped_normal_distribution<_Ty>& _Dist)
-{   // write state to _Ostr
-    return _Dist._Write(_Ostr);
-}
+// ==========================================================================
+// wrapped normal distribution
+// Lior Kogan (koganlior1@gmail.com), 2012
+// based on VC 2012 std::normal_distribution (random) as a skeleton
+// ziggurat method: Marsaglia, G., Tsang, W. W. The Ziggurat Method for Generating Random Variables.
+// Journal of Statistical Software (2000) 5(8), with the improvement of Doornik, J. A. An Improved Ziggurat Method
+// to Generate Normal Random Samples (2005)
+// ==========================================================================
+
+// DRNadler 14-Oct-2026: Add pdf, log_pdf, cdf and quantile, and wrapped_density_table.
+
+// DRNadler 14-Oct-2026: Add ziggurat_normal - a selectable normal core.
+
+// DRNadler 14-Oct-2026: Add bulk fill / generate sampling.
+
+#pragma once
+
+#include <random>
+#include <cmath>
+#include <numbers>      // std::numbers::pi
+#include <assert.h>
+#include <algorithm>    // std::copy_n, std::min, std::sort, std::clamp
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <iterator>     // std::contiguous_iterator
+#include <list>         // WrappedNormalDistTester
+#include <span>
+#include "CircHelper.h"      // Mod, Sqr
+#include "TruncNormalDist.h" // _Truncated_std_normal
+
+#define _NRAND(eng, resty) \
+    (std::generate_canonical<resty, static_cast<size_t>(-1)>(eng))
+
+// ==========================================================================
+// methods for generating the normal values - used as wrapped_normal_distribution template argument
+struct normal_polar_method    {}; // Knuth, vol. 2, p. 122, alg. P      - default
+struct normal_ziggurat_method {}; // ziggurat_normal - faster; a different sequence of values for the same engine
+
+// ==========================================================================
+// CLASS ziggurat_normal
+// standard normal values, generated by the ziggurat method with 256 layers
+// about 99% of the values cost a single 64-bit engine draw, one multiplication and one comparison
+class ziggurat_normal
+{
+public:
+    template<class _Engine>
+    static double sample(_Engine& _Eng)
+    {   // return next value
+        return _Sample(_Eng, _Tab());
+    }
+
+    template<class _Ty, class _Engine>
+    static void fill(_Engine& _Eng, std::span<_Ty> _Out)
+    {   // fill _Out with next values
+        const _Tables& _T = _Tab();
+        for (_Ty& d : _Out)
+            d = static_cast<_Ty>(_Sample(_Eng, _T));
+    }
+
+private:
+    struct _Tables
+    {   // _X[i]: right edge of layer i (_X[0]: virtual edge of the base layer, with the tail); _F[i]= f(_X[i])
+        double _X[257];
+        double _F[257];
+
+        _Tables()
+        {
+            const double r = 3.6541528853610088;                                                           // right edge of the base layer's rectangle
+            const double v = r * f(r) + std::sqrt(std::numbers::pi / 2.) * std::erfc(r / std::numbers::sqrt2); // area of each layer
+
+            _X[0] = v / f(r);
+            _X[1] = r       ;
+            for (size_t i = 1; i < 255; ++i)
+                _X[i+1] = std::sqrt(-2. * std::log(v / _X[i] + f(_X[i])));
+            _X[256] = 0.;
+
+            for (size_t i = 0; i < 257; ++i)
+                _F[i] = f(_X[i]);
+        }
+
+        static double f(double x) { return std::exp(-0.5 * x * x); }
+    };
+
+    static const _Tables& _Tab()
+    {
+        static const _Tables _T;
+        return _T;
+    }
+
+    template<class _Engine>
+    static uint64_t _Bits(_Engine& _Eng)
+    {   // return 64 random bits
+        if constexpr (_Engine::min() == 0 && _Engine::max() == std::numeric_limits<uint64_t>::max())
+            return _Eng();
+        else if constexpr (_Engine::min() == 0 && _Engine::max() == std::numeric_limits<uint32_t>::max())
+            return (static_cast<uint64_t>(_Eng()) << 32) | static_cast<uint64_t>(_Eng());
+        else
+            return std::uniform_int_distribution<uint64_t>()(_Eng);
+    }
+
+    template<class _Engine>
+    static double _Uniform(_Engine& _Eng)
+    {   // return uniform value in (0,1]
+        return (static_cast<double>(_Bits(_Eng) >> 11) + 1.) * 0x1p-53;
+    }
+
+    template<class _Engine>
+    static double _Sample(_Engine& _Eng, const _Tables& _T)
+    {
+        for (; ; )
+        {
+            const uint64_t _B = _Bits(_Eng);
+            const size_t   i  = _B & 0xFF;                              // layer
+            const double   s  = (_B & 0x100) ? -1. : 1.;                // sign
+            const double   x  = static_cast<double>(_B >> 11) * 0x1p-53 * _T._X[i];
+
+            if (x < _T._X[i+1])                                         // inside the layer's rectangle
+                return s * x;
+
+            if (i == 0)
+            {   // base layer, beyond the rectangle: sample from the tail (Marsaglia, 1964)
+                double xt, yt;
+                do
+                {
+                    xt = -std::log(_Uniform(_Eng)) / _T._X[1];
+                    yt = -std::log(_Uniform(_Eng));
+                }
+                while (2. * yt < xt * xt);
+
+                return s * (_T._X[1] + xt);
+            }
+
+            if (_T._F[i] + _Uniform(_Eng) * (_T._F[i+1] - _T._F[i]) < _Tables::f(x)) // inside the wedge under the curve
+                return s * x;
+        }
+    }
+};
+
+// ==========================================================================
+// density and CDF of the normal distribution N(mean,sigma), optionally truncated to [a,b], wrapped to [l,h) -
+// pdf, log_pdf, cdf and quantile of wrapped_normal_distribution and wrapped_truncated_normal_distribution
+//
+// the density at x is the sum of the truncated normal density over the images x + k*w, w = h-l. _Init selects the
+// form with fewer terms:
+//   images : the images within the truncation-range and within _R sigma of its mode - 2*_R*sigma/w + 1 terms at most
+//   Fourier: Jacobi's theta function - the Fourier series of the untruncated wrapped normal density:
+//            (1/w) * (1 + 2 * sum(rho_n * cos(2*pi*n*(x-mean)/w))), rho_n = exp(-2*(pi*n*sigma/w)^2), n <= _Rn*w/sigma,
+//            minus the images outside the truncation-range - for sigma above ~w/4, and a truncation-range including the mean
+// the terms omitted are below exp(-_R^2/2) ~ e^-37.8 of the density at the mode. where no image is within _R sigma of
+// the mode, the nearest images are summed: pdf is accurate to the underflow, and log_pdf does not underflow.
+// computed in double; sigma 0 is taken as the smallest positive double.
+struct _Wrapped_normal_series
+{
+    typedef _Truncated_std_normal<double, CircSite::TruncNormal0> _Tn; // _ScaledQ
+
+    static constexpr double _R        = 8.7                          ; // images beyond _R sigma of the mode are omitted
+    static constexpr double _Rn       = _R / (2. * std::numbers::pi); // Fourier terms beyond n = _Rn*w/sigma are omitted
+    static constexpr int    _MaxN     = 6                            ; // Fourier form: max number of terms
+    static constexpr double _Sqrt2Pi  = 2.5066282746310002           ;
+
+    double _Mean   ;
+    double _Sigma  ; // > 0
+    double _L      ; // wrapping-range lower-bound
+    double _W      ; // wrapping-range width
+    double _C      ; // position of the mean in [0,_W): Mod(_Mean - _L, _W)
+    double _Lo     ; // truncation-range, relative to the mean (-inf, +inf: untruncated)
+    double _Hi     ;
+    double _M      ; // mode of the truncated normal, relative to the mean: the point of [_Lo,_Hi] closest to 0
+    double _WLo    ; // the summed window, relative to the mean: [_Lo,_Hi] intersected with _M +- _R*_Sigma
+    double _WHi    ;
+    double _XLo    ; // Fourier: the excluded images are below _XLo, above _XHi, within _R sigma of the mean
+    double _XHi    ;
+    double _Mass   ; // integral of exp((m^2 - z^2)/2) over the truncation-range, z = t/_Sigma, m = _M/_Sigma
+    double _HLo    ; // _H at the window's bounds
+    double _HHi    ;
+    double _KLo    ; // images: the cdf telescopes over the images k*_W - _C, k in [_KLo,_KHi]
+    double _KHi    ;
+    double _G0     ; // images: sum of _G(k*_W - _C) - the cdf at _L
+    bool   _Fourier; // form of the sums
+    int    _N      ; // Fourier: number of terms
+    double _F0     ; // Fourier: the sine terms of the CDF at _L: sum(_RhoS[n] * sin(2*pi*n*_C/_W))
+    std::array<double, _MaxN + 1> _Rho ; // Fourier: rho_n
+    std::array<double, _MaxN + 1> _RhoS; // Fourier: rho_n / (pi*n) - the CDF's sine coefficients
+
+    void _Init(double _Mean0, double _Sigma0, double _L0, double _H0,
+               double _A0 = -std::numeric_limits<double>::infinity(), double _B0 = std::numeric_limits<double>::infinity())
+    {   // set internal state; [_A0,_B0]: truncation-range
+        _Mean  = _Mean0;
+        _Sigma = __max(_Sigma0, std::numeric_limits<double>::min());
+        _L     = _L0;
+        _W     = _H0 - _L0;
+        _C     = Mod(_Mean - _L, _W);
+        _Lo    = _A0 - _Mean;
+        _Hi    = _B0 - _Mean;
+        _M     = std::clamp(0., _Lo, _Hi);
+        _WLo   = __max(_Lo, _M - _R * _Sigma);
+        _WHi   = __min(_Hi, _M + _R * _Sigma);
+        _XLo   = std::nextafter(_Lo, -HUGE_VAL);
+        _XHi   = std::nextafter(_Hi,  HUGE_VAL);
+        _Mass  = _H(_Hi / _Sigma) - _H(_Lo / _Sigma);
+        _HLo   = _H(_WLo / _Sigma);
+        _HHi   = _H(_WHi / _Sigma);
+        _KLo   = std::floor((_WLo + _C - _W) / _W);
+        _KHi   = std::ceil ((_WHi + _C     ) / _W);
+        _G0    = 0.;
+        for (double k = _KLo; k <= _KHi; ++k)
+            _G0 += _G(k * _W - _C);
+
+        // number of terms of each form
+        const double _NImages  = (_WHi - _WLo) / _W + 1.;
+        const double _NFourier = std::floor(_Rn * _W / _Sigma);
+        const double _NExclude = (__max(0., _Lo + _R * _Sigma) + __max(0., _R * _Sigma - _Hi)) / _W
+                               + (_Lo > -_R * _Sigma) + (_Hi < _R * _Sigma);
+
+        _Fourier = _M == 0. && _NFourier <= _MaxN && _NFourier + _NExclude < _NImages;
+        _N       = _Fourier ? static_cast<int>(_NFourier) : 0;
+        _F0      = 0.;
+        _Rho .fill(0.);
+        _RhoS.fill(0.);
+        for (int n = 1; n <= _N; ++n)
+        {
+            _Rho [n] = std::exp(-2. * Sqr(std::numbers::pi * n * _Sigma / _W));
+            _RhoS[n] = _Rho[n] / (std::numbers::pi * n);
+            _F0     += _RhoS[n] * std::sin(2. * std::numbers::pi * n * _C / _W);
+        }
+    }
+
+    double _H(double z) const
+    {   // antiderivative of exp((m^2 - z^2)/2), m = _M/_Sigma, on the side of m of the truncation-range - no underflow in the tails
+        const double m = _M / _Sigma;
+        if (m > 0.) return -_Sqrt2Pi * std::exp((m - z) * (m + z) / 2.) * _Tn::_ScaledQ( z); // z >= m
+        if (m < 0.) return  _Sqrt2Pi * std::exp((m + z) * (m - z) / 2.) * _Tn::_ScaledQ(-z); // z <= m
+        return _Sqrt2Pi / 2. * std::erf(z / std::numbers::sqrt2);
+    }
+
+    double _G(double t) const
+    {   // images: _H at t/_Sigma, t clamped to the window
+        if (!(t > _WLo)) return _HLo;
+        if (!(t < _WHi)) return _HHi;
+        return _H(t / _Sigma);
+    }
+
+    double _Offset(double x) const
+    {   // the image of x - _Mean in [0,_W)
+        return Mod(x - _L - _C, _W);
+    }
+
+    bool _Images(double t0, double& kLo, double& kHi) const
+    {   // images form: the images t0 + k*_W summed, k in [kLo,kHi]; false: none within the truncation-range
+        // the images within the window, and the nearest image on each side of the mode - so the terms omitted are also
+        // negligible relative to the density at t0, far from the mode
+        double kA = std::ceil((_M - t0) / _W), kB = kA - 1.;
+        if (t0 + kB * _W < _Lo) ++kB;
+        if (t0 + kA * _W > _Hi) --kA;
+        if (kB > kA)
+            return false;
+
+        kLo = __min(std::ceil ((_WLo - t0) / _W), kB);
+        kHi = __max(std::floor((_WHi - t0) / _W), kA);
+        return true;
+    }
+
+    double _SumImages(double t0, double kLo, double kHi, double e = 0.) const
+    {   // sum of exp((m^2 - z^2)/2 - e) over the images t0 + k*_W, k in [kLo,kHi], z = image/_Sigma
+        const double m = _M / _Sigma;
+        double       s = 0.;
+        for (double k = kLo; k <= kHi; ++k)
+        {
+            const double z = (t0 + k * _W) / _Sigma;
+            s += std::exp((m - z) * (m + z) / 2. - e);
+        }
+        return s;
+    }
+
+    double _SumImagesIn(double t0, double lo, double hi) const
+    {   // Fourier form: sum of exp(-z^2/2) over the images within [lo,hi]
+        return hi >= lo ? _SumImages(t0, std::ceil((lo - t0) / _W), std::floor((hi - t0) / _W)) : 0.;
+    }
+
+    double _SumFourier(double t0) const
+    {   // Fourier form: the untruncated wrapped normal density at offset t0, minus the images outside the truncation-range,
+        // times _Sigma*sqrt(2*pi): in units of _SumImages
+        const double c1 = std::cos(2. * std::numbers::pi * t0 / _W);
+        double       c0 = 1., c = c1, s = 1.;
+        for (int n = 1; n <= _N; ++n)
+        {   // cos(n*theta) by the Chebyshev recurrence
+            s += 2. * _Rho[n] * c;
+            const double c2 = 2. * c1 * c - c0;
+            c0 = c;
+            c  = c2;
+        }
+
+        return s * _Sigma * _Sqrt2Pi / _W - _SumImagesIn(t0, -_R * _Sigma, _XLo) - _SumImagesIn(t0, _XHi, _R * _Sigma);
+    }
+
+    double _Pdf(double x) const
+    {   // density at x
+        const double t0 = _Offset(x);
+        if (_Fourier)
+            return __max(_SumFourier(t0), 0.) / (_Sigma * _Mass);
+
+        double kLo, kHi;
+        return _Images(t0, kLo, kHi) ? _SumImages(t0, kLo, kHi) / (_Sigma * _Mass) : 0.;
+    }
+
+    double _LogPdf(double x) const
+    {   // log of the density at x - the exponents are relative to the image nearest the mode
+        const double t0 = _Offset(x);
+        if (_Fourier)
+            return std::log(__max(_SumFourier(t0), 0.) / (_Sigma * _Mass));
+
+        double kLo, kHi;
+        if (!_Images(t0, kLo, kHi))
+            return -std::numeric_limits<double>::infinity(); // no image within the truncation-range
+
+        const double m = _M / _Sigma;
+        double       e = -std::numeric_limits<double>::infinity();
+        for (double k = kLo; k <= kHi; ++k)
+        {
+            const double z = (t0 + k * _W) / _Sigma;
+            e = __max(e, (m - z) * (m + z) / 2.);
+        }
+
+        return e + std::log(_SumImages(t0, kLo, kHi, e) / (_Sigma * _Mass));
+    }
+
+    double _MassImages(double u, double lo, double hi) const
+    {   // Fourier form: sum of the masses of the intervals [k*_W - _C, k*_W - _C + u] within [lo,hi], over all k
+        double s = 0.;
+        if (!(hi > lo))
+            return s;
+
+        for (double k = std::floor((lo + _C - u) / _W), kHi = std::ceil((hi + _C) / _W); k <= kHi; ++k)
+        {
+            const double p = __max(k * _W - _C    , lo);
+            const double q = __min(k * _W - _C + u, hi);
+            if (q > p)
+                s += _H(q / _Sigma) - _H(p / _Sigma);
+        }
+        return s;
+    }
+
+    double _Cdf(double x) const
+    {   // mass of [_L,x]
+        const double u = x - _L;
+        if (!(u > 0. )) return 0.;
+        if (!(u < _W)) return 1.;
+
+        double s;
+        if (_Fourier)
+        {   // untruncated: u/_W + sum(_RhoS[n] * (sin(n*(theta_u - theta_c)) + sin(n*theta_c)))
+            const double a  = 2. * std::numbers::pi * (u - _C) / _W;
+            const double c1 = std::cos(a);
+            double       s0 = 0., s1 = std::sin(a), f = u / _W + _F0;
+            for (int n = 1; n <= _N; ++n)
+            {   // sin(n*a) by the Chebyshev recurrence
+                f += _RhoS[n] * s1;
+                const double s2 = 2. * c1 * s1 - s0;
+                s0 = s1;
+                s1 = s2;
+            }
+
+            s = f * _Sqrt2Pi - _MassImages(u, -_R * _Sigma, _Lo) - _MassImages(u, _Hi, _R * _Sigma);
+        }
+        else
+        {   // sum of the masses of [k*_W - _C, k*_W - _C + u] within the window: telescopes into _G(k*_W - _C + u) - _G0
+            s = -_G0;
+            for (double k = _KLo; k <= _KHi; ++k)
+                s += _G(k * _W - _C + u);
+        }
+
+        return std::clamp(s / _Mass, 0., 1.);
+    }
+
+    double _Quantile(double p) const
+    {   // x in [_L,_L+_W] such that _Cdf(x) = p: Newton's method, safeguarded by bisection
+        double lo = _L, hi = _L + _W;
+        if (!(p > 0.)) return lo;
+        if (!(p < 1.)) return hi;
+
+        double x = _L + p * _W;
+        for (int i = 0; i < 200 && hi - lo > 4. * std::numeric_limits<double>::epsilon() * (std::abs(lo) + std::abs(hi)); ++i)
+        {
+            const double f = _Cdf(x) - p;
+            if (f == 0.)
+                return x;
+            (f < 0. ? lo : hi) = x;
+
+            const double d  = _Pdf(x);
+            const double xn = d > 0. ? x - f / d : lo;
+            x = xn > lo && xn < hi ? xn : (lo + hi) / 2.;
+        }
+        return x;
+    }
+
+    std::array<double, 2> _Jumps() const
+    {   // the points of [_L,_L+_W) where the density is discontinuous - the wrapped truncation-range bounds; NaN: none
+        const double _NaN = std::numeric_limits<double>::quiet_NaN();
+        return { std::isfinite(_Lo) ? _L + Mod(_Mean + _Lo - _L, _W) : _NaN,
+                 std::isfinite(_Hi) ? _L + Mod(_Mean + _Hi - _L, _W) : _NaN };
+    }
+};
+
+// ==========================================================================
+// TEMPLATE CLASS wrapped_normal_distribution
+template<class _Ty= double, class _Method= normal_polar_method>
+class wrapped_normal_distribution
+{   // template class for wrapped normal distribution
+public:
+    static_assert(std::is_floating_point<_Ty>::value,
+        "invalid template argument for wrapped_normal_distribution");
+    static_assert(std::is_same_v<_Method, normal_polar_method> || std::is_same_v<_Method, normal_ziggurat_method>,
+        "invalid method argument for wrapped_normal_distribution");
+
+    typedef wrapped_normal_distribution<_Ty, _Method> _Myt;
+    typedef _Ty result_type;
+
+    struct param_type
+    {   // parameter package
+        typedef _Myt distribution_type;
+
+        explicit param_type(_Ty _Mean0 = 0., _Ty _Sigma0 = 1., _Ty _L0 = 0., _Ty _H0 = 0.)
+        {   // construct from parameters
+            _Init(_Mean0, _Sigma0, _L0, _H0);
+        }
+
+        bool operator==(const param_type& _Right) const
+        {   // test for equality
+            return _Mean  == _Right._Mean  &&
+                   _Sigma == _Right._Sigma &&
+                   _L     == _Right._L     &&
+                   _H     == _Right._H        ;
+
+        }
+
+        bool operator!=(const param_type& _Right) const
+        {   // test for inequality
+            return !(*this == _Right);
+        }
+
+        _Ty mean() const
+        {   // return mean value
+            return _Mean;
+        }
+
+        _Ty sigma() const
+        {   // return sigma value
+            return _Sigma;
+        }
+
+        _Ty l() const
+        {   // return wrapping-range lower-bound
+            return _L;
+        }
+
+        _Ty h() const
+        {   // return wrapping-range upper-bound
+            return _H;
+        }
+
+        _Ty stddev() const
+        {   // return sigma value
+            return _Sigma;
+        }
+
+        void _Init(_Ty _Mean0, _Ty _Sigma0, _Ty _L0, _Ty _H0)
+        {   // set internal state
+            
+            if (_Sigma0 <  0.) throw std::domain_error("invalid sigma argument for wrapped_normal_distribution");
+            if (_H0     < _L0) throw std::logic_error ("invalid wrapping-range for wrapped_normal_distribution");
+            _Mean  = _Mean0 ;
+            _Sigma = _Sigma0;
+            _L     = _L0    ;
+            _H     = _H0    ;
+
+            _Ser._Init(_Mean, _Sigma, _L, _H);
+        }
+
+        _Ty                    _Mean ;
+        _Ty                    _Sigma;
+        _Ty                    _L    ;
+        _Ty                    _H    ;
+
+        _Wrapped_normal_series _Ser  ; // pdf, cdf: form of the series, and its constants
+    };
+
+    explicit wrapped_normal_distribution(_Ty _Mean0  =    0.,
+                                         _Ty _Sigma0 =   45.,
+                                         _Ty _L0     = -180.,  // wrapping-range lower-bound
+                                         _Ty _H0     =  180. ) // wrapping-range upper-bound
+        : _Par(_Mean0, _Sigma0, _L0, _H0), _Valid(false), _X2(0)
+    {   // construct
+    }
+
+    explicit wrapped_normal_distribution(param_type _Par0)
+        : _Par(_Par0), _Valid(false), _X2(0)
+    {   // construct from parameter package
+    }
+
+    _Ty mean() const
+    {   // return mean value
+        return _Par.mean();
+    }
+
+    _Ty sigma() const
+    {   // return sigma value
+        return _Par.sigma();
+    }
+
+    _Ty l() const
+    {   // return wrapping-range lower-bound
+        return _Par.l();
+    }
+
+    _Ty h() const
+    {   // return wrapping-range upper-bound
+        return _Par.h();
+    }
+
+    _Ty stddev() const
+    {   // return sigma value
+        return _Par.sigma();
+    }
+
+    param_type param() const
+    {   // return parameter package
+        return _Par;
+    }
+
+    void param(const param_type& _Par0)
+    {   // set parameter package
+        _Par = _Par0;
+        reset();
+    }
+
+    result_type (min)() const
+    {   // get smallest possible result
+        return _Par._L;
+    }
+
+    result_type (max)() const
+    {   // get largest possible result
+        return _Par._H;
+    }
+
+    void reset()
+    {   // clear internal state
+        _Valid= false;
+    }
+
+    template<class _Engine>
+    result_type operator()(_Engine& _Eng)
+    {   // return next value
+        return _Eval(_Eng, _Par);
+    }
+
+    template<class _Engine>
+    result_type operator()(_Engine& _Eng, const param_type& _Par0)
+    {   // return next value, given parameter package
+        reset();
+        return _Eval(_Eng, _Par0, false);
+    }
+
+    template<class _Engine>
+    void fill(_Engine& _Eng, std::span<_Ty> _Out)
+    {   // fill _Out with next values - same values as repeated calls to operator()
+        _Fill(_Eng, _Out, _Par);
+    }
+
+    template<class _Engine, class _FwdIt>
+    void generate(_Engine& _Eng, _FwdIt _First, _FwdIt _Last)
+    {   // assign next values to [_First, _Last) - same values as repeated calls to operator()
+        if constexpr (std::contiguous_iterator<_FwdIt> && std::is_same_v<std::iter_value_t<_FwdIt>, _Ty>)
+            fill(_Eng, std::span<_Ty>(std::to_address(_First), std::to_address(_Last)));
+        else
+        {
+            _Ty _Buf[_BlockSize];
+            for (auto _Count = std::distance(_First, _Last); _Count > 0; )
+            {
+                const size_t _N = std::min(static_cast<size_t>(_Count), _BlockSize);
+                fill(_Eng, std::span<_Ty>(_Buf, _N));
+                _First  = std::copy_n(_Buf, _N, _First);
+                _Count -= _N;
+            }
+        }
+    }
+
+    _Ty pdf(_Ty _X) const
+    {   // return density at _X - the density is periodic: _X is wrapped
+        return static_cast<_Ty>(_Par._Ser._Pdf(_X));
+    }
+
+    _Ty log_pdf(_Ty _X) const
+    {   // return log of the density at _X - does not underflow far from the mean
+        return static_cast<_Ty>(_Par._Ser._LogPdf(_X));
+    }
+
+    _Ty cdf(_Ty _X) const
+    {   // return probability of a value in [l,_X]
+        return static_cast<_Ty>(_Par._Ser._Cdf(_X));
+    }
+
+    _Ty quantile(_Ty _P) const
+    {   // return the value in [l,h] whose cdf is _P
+        return static_cast<_Ty>(_Par._Ser._Quantile(_P));
+    }
+
+    void pdf(std::span<const _Ty> _X, std::span<_Ty> _Out) const
+    {   // _Out[i]= pdf(_X[i])
+        assert(_X.size() == _Out.size());
+        for (size_t i = 0; i < _X.size(); ++i)
+            _Out[i] = pdf(_X[i]);
+    }
+
+    void log_pdf(std::span<const _Ty> _X, std::span<_Ty> _Out) const
+    {   // _Out[i]= log_pdf(_X[i])
+        assert(_X.size() == _Out.size());
+        for (size_t i = 0; i < _X.size(); ++i)
+            _Out[i] = log_pdf(_X[i]);
+    }
+
+    void cdf(std::span<const _Ty> _X, std::span<_Ty> _Out) const
+    {   // _Out[i]= cdf(_X[i])
+        assert(_X.size() == _Out.size());
+        for (size_t i = 0; i < _X.size(); ++i)
+            _Out[i] = cdf(_X[i]);
+    }
+
+    template<class _Elem, class _Traits>
+    basic_istream<_Elem, _Traits>& _Read(basic_istream<_Elem, _Traits>& _Istr)
+    {   // read state from _Istr
+        _Ty _Mean0 ;
+        _Ty _Sigma0;
+        _Ty _L0    ;
+        _Ty _H0    ;
+        _In(_Istr, _Mean0 );
+        _In(_Istr, _Sigma0);
+        _In(_Istr, _L0    );
+        _In(_Istr, _H0    );
+        _Par._Init(_Mean0, _Sigma0, _L0, _H0);
+
+        _Istr >> _Valid;
+        _In(_Istr, _X2);
+        return _Istr;
+    }
+
+    template<class _Elem, class _Traits>
+    basic_ostream<_Elem, _Traits>& _Write(basic_ostream<_Elem, _Traits>& _Ostr) const
+    {   // write state to _Ostr
+        _Out(_Ostr, _Par._Mean );
+        _Out(_Ostr, _Par._Sigma);
+        _Out(_Ostr, _Par._L    );
+        _Out(_Ostr, _Par._H    );
+
+        _Ostr << ' ' << _Valid;
+        _Out(_Ostr, _X2);
+        return _Ostr;
+    }
+
+private:
+    template<class _Engine> result_type _Eval(_Engine& _Eng, const param_type& _Par0, bool _Keep = true)
+    {   // compute next value
+        // Knuth, vol. 2, p. 122, alg. P
+        _Ty _Res;
+
+        if constexpr (std::is_same_v<_Method, normal_ziggurat_method>)
+            _Res = static_cast<_Ty>(ziggurat_normal::sample(_Eng));
+        else if (_Keep && _Valid)
+        {   // return stored value
+            _Res   = _X2  ;
+            _Valid = false;
+        }
+        else
+        {   // generate two values, store one, return one
+            double _V1, _V2, _Sx;
+            for (; ; )
+            {   // reject bad values
+                _V1 = 2 * _NRAND(_Eng, _Ty) - 1.;
+                _V2 = 2 * _NRAND(_Eng, _Ty) - 1.;
+                _Sx = _V1 * _V1 + _V2 * _V2;
+                if (_Sx < 1.)
+                    break;
+            }
+
+            double _Fx = std::sqrt(-2. * std::log(_Sx) / _Sx);
+            if (_Keep)
+            {   // save second value for next call
+                _X2    = _Fx * _V2;
+                _Valid = true     ;
+            }
+
+            _Res = _Fx * _V1;
+        }
+
+        result_type d = _Res * _Par0._Sigma + _Par0._Mean;        // denormalize result
+        return Mod(d - _Par0._L, _Par0._H - _Par0._L) + _Par0._L; // wrap        result
+    }
+
+    template<class _Engine> void _Fill(_Engine& _Eng, std::span<_Ty> _Out, const param_type& _Par0)
+    {   // compute next values: first generate normalized values, then denormalize and wrap the whole block
+        const size_t _N = _Out.size();
+        size_t       i  = 0;
+
+        if constexpr (std::is_same_v<_Method, normal_ziggurat_method>)
+        {
+            ziggurat_normal::fill(_Eng, _Out);
+            i = _N;
+        }
+        else if (_N > 0 && _Valid)
+        {   // use stored value
+            _Out[i++] = _X2  ;
+            _Valid    = false;
+        }
+
+        for (; i < _N; i += 2)
+        {   // generate two values (Knuth, vol. 2, p. 122, alg. P)
+            double _V1, _V2, _Sx;
+            for (; ; )
+            {   // reject bad values
+                _V1 = 2 * _NRAND(_Eng, _Ty) - 1.;
+                _V2 = 2 * _NRAND(_Eng, _Ty) - 1.;
+                _Sx = _V1 * _V1 + _V2 * _V2;
+                if (_Sx < 1.)
+                    break;
+            }
+
+            double _Fx = std::sqrt(-2. * std::log(_Sx) / _Sx);
+            _Out[i] = _Fx * _V1;
+
+            if (i + 1 < _N)
+                _Out[i+1] = _Fx * _V2;
+            else
+            {   // save second value for next call
+                _X2    = _Fx * _V2;
+                _Valid = true     ;
+            }
+        }
+
+        for (_Ty& d : _Out)
+            d = d * _Par0._Sigma + _Par0._Mean - _Par0._L; // denormalize result
+
+        Mod(_Out, _Par0._H - _Par0._L);                    // wrap        result
+
+        for (_Ty& d : _Out)
+            d += _Par0._L;
+    }
+
+    static constexpr size_t _BlockSize = 256; // generate(): number of values generated at once
+
+    param_type _Par  ;
+    bool       _Valid;
+    _Ty        _X2   ;
+};
+
+template<class _Elem, class _Traits, class _Ty, class _Method>
+basic_istream<_Elem, _Traits>& operator>>(basic_istream<_Elem, _Traits>& _Istr, wrapped_normal_distribution<_Ty, _Method>& _Dist)
+{   // read state from _Istr
+    return _Dist._Read(_Istr);
+}
+
+template<class _Elem, class _Traits, class _Ty, class _Method>
+basic_ostream<_Elem, _Traits>& operator<<(basic_ostream<_Elem, _Traits>& _Ostr, const wrapped_normal_distribution<_Ty, _Method>& _Dist)
+{   // write state to _Ostr
+    return _Dist._Write(_Ostr);
+}
+
+// ==========================================================================
+// TEMPLATE CLASS wrapped_density_table
+// pdf, log_pdf and cdf of a wrapped distribution with fixed parameters - wrapped_normal_distribution or
+// wrapped_truncated_normal_distribution - by cubic Hermite interpolation over a table of equal cells covering [l,h):
+//   cdf: between the exact CDF values, with the exact densities as slopes
+//   pdf: between the exact densities, with their one-sided derivatives (finite differences) as slopes; log_pdf: log of pdf
+// by default a cell is at most sigma/16 wide - sigma/(16*m) for a truncation-range m sigma from the mean, where the density
+// decays faster - 64..65536 cells: error ~1e-7 of the density at the mode. the density of
+// a wrapped truncated normal is discontinuous at the wrapped truncation-range bounds: the cells next to them are evaluated
+// by the series, exactly
+template<class _Dist>
+class wrapped_density_table
+{
+public:
+    typedef typename _Dist::result_type _Ty;
+    typedef _Ty result_type;
+
+    explicit wrapped_density_table(const _Dist& _D, size_t _Cells0 = 0)
+    {   // tabulate _D; _Cells0: number of cells (0: default)
+        const auto   _Par0 = _D.param();
+        const auto&  _S    = _Par0._Ser;
+
+        _L     = _S._L;
+        _W     = _S._W;
+        _Cells = _Cells0 ? _Cells0 : static_cast<size_t>(std::clamp(std::ceil(16. * _W / _S._Sigma * __max(1., std::abs(_S._M) / _S._Sigma)), 64., 65536.));
+        _CellW = _W / _Cells;
+
+        _F .resize(_Cells + 1);
+        _DL.resize(_Cells + 1);
+        _DR.resize(_Cells + 1);
+        _P .resize(_Cells + 1);
+
+        _S0   = _S;
+        _Exact.fill(_Cells);
+        const auto _J = _S._Jumps();
+        for (size_t j = 0; j < 2; ++j)
+            if (!std::isnan(_J[j]))
+            {   // the cell of the jump, and the preceding one - the jump may be at their common bound
+                const size_t i = __min(static_cast<size_t>((_J[j] - _L) / _CellW), _Cells - 1);
+                _Exact[2*j  ] = i;
+                _Exact[2*j+1] = (i + _Cells - 1) % _Cells;
+            }
+
+        const double d = _CellW / 1024.;
+        for (size_t i = 0; i <= _Cells; ++i)
+        {   // one-sided second-order differences: not across a discontinuity at the cell's bound
+            const double x = _L + i * _CellW;
+            _F [i] = _S._Pdf(x);
+            _DL[i] = ( 3. * _F[i] - 4. * _S._Pdf(x - d) + _S._Pdf(x - 2. * d)) / (2. * d);
+            _DR[i] = (-3. * _F[i] + 4. * _S._Pdf(x + d) - _S._Pdf(x + 2. * d)) / (2. * d);
+            _P [i] = i == _Cells ? 1. : _S._Cdf(x);
+        }
+    }
+
+    size_t cells() const
+    {   // return number of cells
+        return _Cells;
+    }
+
+    _Ty pdf(_Ty _X) const
+    {   // return density at _X - _X is wrapped
+        double t;
+        const size_t i = _Cell(Mod(_X - _L, _W), t);
+        if (_IsExact(i))
+            return static_cast<_Ty>(_S0._Pdf(_X));
+        return static_cast<_Ty>(__max(_Hermite(t, _F[i], _DR[i], _F[i+1], _DL[i+1]), 0.));
+    }
+
+    _Ty log_pdf(_Ty _X) const
+    {   // return log of the density at _X
+        return static_cast<_Ty>(std::log(static_cast<double>(pdf(_X))));
+    }
+
+    _Ty cdf(_Ty _X) const
+    {   // return probability of a value in [l,_X]
+        const double u = _X - _L;
+        if (!(u > 0. )) return 0.;
+        if (!(u < _W)) return 1.;
+
+        double t;
+        const size_t i = _Cell(u, t);
+        if (_IsExact(i))
+            return static_cast<_Ty>(_S0._Cdf(_X));
+        return static_cast<_Ty>(std::clamp(_Hermite(t, _P[i], _F[i], _P[i+1], _F[i+1]), 0., 1.));
+    }
+
+    void pdf(std::span<const _Ty> _X, std::span<_Ty> _Out) const
+    {   // _Out[i]= pdf(_X[i])
+        assert(_X.size() == _Out.size());
+        for (size_t i = 0; i < _X.size(); ++i)
+            _Out[i] = pdf(_X[i]);
+    }
+
+    void log_pdf(std::span<const _Ty> _X, std::span<_Ty> _Out) const
+    {   // _Out[i]= log_pdf(_X[i])
+        assert(_X.size() == _Out.size());
+        for (size_t i = 0; i < _X.size(); ++i)
+            _Out[i] = log_pdf(_X[i]);
+    }
+
+    void cdf(std::span<const _Ty> _X, std::span<_Ty> _Out) const
+    {   // _Out[i]= cdf(_X[i])
+        assert(_X.size() == _Out.size());
+        for (size_t i = 0; i < _X.size(); ++i)
+            _Out[i] = cdf(_X[i]);
+    }
+
+private:
+    bool _IsExact(size_t i) const
+    {   // cell i is next to a discontinuity
+        return i == _Exact[0] || i == _Exact[1] || i == _Exact[2] || i == _Exact[3];
+    }
+
+    size_t _Cell(double u, double& t) const
+    {   // cell of offset u in [0,_W), and the position t in [0,1] within it
+        const double c = u / _CellW;
+        const size_t i = __min(static_cast<size_t>(c), _Cells - 1);
+        t = c - i;
+        return i;
+    }
+
+    double _Hermite(double t, double y0, double d0, double y1, double d1) const
+    {   // cubic Hermite interpolation: y0, y1 at the cell's ends, d0, d1: slopes
+        const double t2 = t * t, t3 = t2 * t;
+        return (2.*t3 - 3.*t2 + 1.) * y0 + (t3 - 2.*t2 + t) * _CellW * d0 + (3.*t2 - 2.*t3) * y1 + (t3 - t2) * _CellW * d1;
+    }
+
+    double                 _L    ; // wrapping-range lower-bound
+    double                 _W    ; // wrapping-range width
+    size_t                 _Cells; // number of cells
+    double                 _CellW; // width of a cell
+    std::vector<double>    _F    ; // density at the cells' bounds
+    std::vector<double>    _DL   ; // left  derivative of the density at the cells' bounds
+    std::vector<double>    _DR   ; // right derivative of the density at the cells' bounds
+    std::vector<double>    _P    ; // CDF at the cells' bounds
+    std::array<size_t, 4>  _Exact; // the cells next to a discontinuity (_Cells: none)
+    _Wrapped_normal_series _S0   ; // the series - for these cells
+};
+
+// ==========================================================================
+// statistical tester for wrapped_normal_distribution
+// Kolmogorov-Smirnov test of the generated values against the wrapped normal CDF - for both methods, by operator() and by fill()
+// fill and generate vs. repeated calls to operator() of an identically seeded engine: the same values
+template<class _Ty= double>
+class WrappedNormalDistTester
+{
+    static constexpr double fKSCrit = 2.3; // critical value of sqrt(n)*D; p ~ 5e-5
+
+    static double Phi(double z)
+    {   // standard normal CDF
+        return 0.5 * std::erfc(-z / std::numbers::sqrt2);
+    }
+
+    template<class Cdf>
+    static double KS(std::vector<_Ty>& v, Cdf&& F)
+    {   // return sqrt(n) * Kolmogorov-Smirnov statistic
+        std::sort(v.begin(), v.end());
+
+        const double n = static_cast<double>(v.size());
+        double       d = 0.;
+        for (size_t i = 0; i < v.size(); ++i)
+        {
+            const double f = F(v[i]);
+            d = std::max({d, f - i/n, (i+1)/n - f});
+        }
+
+        return d * std::sqrt(n);
+    }
+
+    static void TestZiggurat()
+    {
+        std::mt19937_64 Eng(1);
+        const size_t    n = 1000000;
+
+        std::vector<_Ty> v(n);
+        ziggurat_normal::fill(Eng, std::span<_Ty>(v));
+
+        const double r = 3.6541528853610088; // right edge of the base layer's rectangle
+
+        [[maybe_unused]] const double fExpect = n * std::erfc(r / std::numbers::sqrt2); // expected number of values beyond +-r
+        [[maybe_unused]] const double fCount  = static_cast<double>(std::count_if(v.begin(), v.end(), [r](_Ty x) { return std::abs(x) > r; }));
+        assert(std::abs(fCount - fExpect) < 5. * std::sqrt(fExpect));                   // tail is sampled correctly
+
+        double fSum = 0., fSumSqr = 0.;
+        for (const _Ty x : v)
+        {
+            fSum    += x  ;
+            fSumSqr += x*x;
+        }
+        assert(std::abs(fSum    / n     ) < 5. * std::sqrt(1. / n));                   // mean     = 0
+        assert(std::abs(fSumSqr / n - 1.) < 5. * std::sqrt(2. / n));                   // variance = 1 - sensitive to the wedges
+
+        [[maybe_unused]] const double ks = KS(v, [](double x) { return Phi(x); });
+        assert(ks < fKSCrit);
+    }
+
+    template<class _Method>
+    static void Test(_Ty fMean, _Ty fSigma, _Ty fL, _Ty fH)
+    {
+        const size_t n = 50000;
+        const double W = fH - fL;
+        const int    K = static_cast<int>(std::ceil((std::abs(fMean - fL) + 10. * fSigma) / W)) + 1;
+
+        auto F = [=](double x)
+        {   // wrapped normal CDF
+            double f = 0.;
+            for (int k = -K; k <= K; ++k)
+                f += Phi((x - fMean + k*W) / fSigma) - Phi((fL - fMean + k*W) / fSigma);
+            return f;
+        };
+
+        std::mt19937_64                          Eng(2);
+        wrapped_normal_distribution<_Ty, _Method> wnd(fMean, fSigma, fL, fH);
+        std::vector<_Ty>                          v(n);
+
+        for (auto& x : v)
+        {
+            x = wnd(Eng);
+            assert(x >= fL && x < fH);
+        }
+        [[maybe_unused]] const double ks1 = KS(v, F);
+        assert(ks1 < fKSCrit);
+
+        wnd.fill(Eng, std::span<_Ty>(v));
+        for ([[maybe_unused]] auto x : v)
+            assert(x >= fL && x < fH);
+        [[maybe_unused]] const double ks2 = KS(v, F);
+        assert(ks2 < fKSCrit);
+
+        TestSequence<_Method>(fMean, fSigma, fL, fH);
+    }
+
+    template<class _Method>
+    static void TestSequence(_Ty fMean, _Ty fSigma, _Ty fL, _Ty fH)
+    {   // fill and generate - in blocks of odd and even sizes, contiguous or not - return the values of repeated calls to operator()
+        const size_t Sizes[] = { 1, 2, 7, 256, 1000, 3, 513 };
+
+        std::mt19937_64                           Eng1(3), Eng2(3), Eng3(3);
+        wrapped_normal_distribution<_Ty, _Method> wnd1(fMean, fSigma, fL, fH), wnd2(wnd1), wnd3(wnd1);
+
+        for (const size_t n : Sizes)
+        {
+            std::vector<_Ty> v1(n), v2(n);
+            std::list<_Ty>   l3(n);
+            for (auto& x : v1)
+                x = wnd1(Eng1);
+
+            wnd2.fill    (Eng2, std::span<_Ty>(v2));
+            wnd3.generate(Eng3, l3.begin(), l3.end());
+
+            assert(v1 == v2);
+            assert(std::equal(v1.begin(), v1.end(), l3.begin(), l3.end()));
+        }
+
+        [[maybe_unused]] const _Ty x1 = wnd1(Eng1);
+        assert(x1 == wnd2(Eng2) && x1 == wnd3(Eng3)); // the same state, after all blocks
+    }
+
+public:
+    WrappedNormalDistTester()
+    {
+        TestZiggurat();
+
+        const _Ty Params[][4] = { {   0.,  45., -180., 180. },   // mean, sigma, wrapping-range
+                                  { 350.,  20.,    0., 360. },
+                                  {  10., 200.,    0., 360. },
+                                  { 400.,  30.,    0., 360. },
+                                  {   1., 0.5f, static_cast<_Ty>(-std::numbers::pi), static_cast<_Ty>(std::numbers::pi) } };
+
+        for (const auto& p : Params)
+        {
+            Test<normal_polar_method   >(p[0], p[1], p[2], p[3]);
+            Test<normal_ziggurat_method>(p[0], p[1], p[2], p[3]);
+        }
+    }
+};
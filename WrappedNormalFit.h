@@ -0,0 +1,443 @@
+// ==========================================================================
+// Copyright (C) 2026 DRNadler
+// ==========================================================================
+// classes defined here:
+// WrappedNormalFit       - single-pass, mergeable moment estimation of the parameters of a wrapped normal distribution
+// WrappedNormalEMStep    - mergeable EM iteration, refining the parameters to the maximum-likelihood estimate
+// FitWrappedNormal       - fit a wrapped normal distribution to a span of circular values: serial, execution policy
+// WrappedNormalFitTester - tester for WrappedNormalFit, WrappedNormalEMStep, FitWrappedNormal
+// ==========================================================================
+
+#pragma once
+
+#include <assert.h>
+#include <algorithm>    // std::min, std::max, std::for_each
+#include <cmath>
+#include <cstdint>      // uint64_t
+#include <execution>    // execution policies
+#include <limits>
+#include <numbers>      // std::numbers::pi
+#include <random>       // WrappedNormalFitTester
+#include <ranges>       // std::views::iota
+#include <span>
+#include <stdexcept>    // std::domain_error
+#include <vector>
+
+#include "CircVal.h"           // CircVal, CircValue, sincos
+#include "CircHelper.h"        // Sqr, Mod, AddCompensated, SinCosKernel
+#include "WrappedNormalDist.h" // wrapped_normal_distribution, _Wrapped_normal_series
+
+// ==========================================================================
+// mergeable moment estimation of the parameters of a wrapped normal distribution
+// for a wrapped normal, the mean resultant length of the values (as angles in radians) is rho = exp(-sigma^2/2), and
+// their mean direction is the mean. the estimate uses the bias-corrected rho^2: n/(n-1) * (Rbar^2 - 1/n).
+//
+// a single pass; no sort; O(1) memory. values may be added one by one or as spans, in any number of chunks, and
+// summaries of shards are combined by Merge - the sums are compensated.
+// the sums are kept relative to a reference value - the first value added - as sum(sin(d)) and sum(1-cos(d)) =
+// sum(2*sin(d/2)^2), d: the difference from the reference: 1-Rbar^2 is computed without cancellation, and a narrow
+// distribution estimates sigma to full precision.
+// no concentration (Rbar^2 <= 1/n): sigma is that of a practically uniform distribution (rho^2 = smallest double)
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T>
+class WrappedNormalFit
+{
+    uint64_t   m_n      = 0 ; // number of values
+    CircVal<T> m_Ref        ; // reference value: the first value added
+    double     m_fV     = 0.; // sum(1-cos(d))
+    double     m_fVComp = 0.; // compensation of m_fV
+    double     m_fS     = 0.; // sum(sin(d))
+    double     m_fSComp = 0.; // compensation of m_fS
+
+    // sin(d/2), cos(d/2); d: the difference of c from the reference
+    template<CircValue C>
+    void HalfDiff(const C& c, double& s, double& co) const
+    {
+        double d = static_cast<double>(CircVal<T>(c)) - static_cast<double>(m_Ref); // (-R,R): both in [L,H)
+        d += d < -T::R_2 ? T::R : d >= T::R_2 ? -T::R : 0.;                          // [-R/2,R/2)
+        SinCosKernel<CircSimdScalar>(d * (std::numbers::pi / T::R), s, co);
+    }
+
+    double GetV() const { return m_fV + m_fVComp; }
+    double GetS() const { return m_fS + m_fSComp; }
+
+public:
+    WrappedNormalFit() : m_Ref(T::Z)
+    {
+    }
+
+    uint64_t GetN() const { return m_n; }
+
+    // ----------------------------------------------
+    // C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+    template<CircValue C>
+    void Add(const C& c)
+    {
+        if (m_n++ == 0)
+            m_Ref = CircVal<T>(c);
+
+        double s, co;
+        HalfDiff(c, s, co);
+        AddCompensated(m_fV, m_fVComp, 2. * s * s );
+        AddCompensated(m_fS, m_fSComp, 2. * s * co);
+    }
+
+    // the sums of blocks of values are plain, and added compensated
+    template<CircValue C>
+    void Add(std::span<const C> A)
+    {
+        if (A.empty())
+            return;
+        if (m_n == 0)
+            m_Ref = CircVal<T>(A[0]);
+
+        for (size_t i = 0; i < A.size(); i += 256)
+        {
+            double fV = 0., fS = 0.;
+            for (const auto& a : A.subspan(i, std::min<size_t>(256, A.size() - i)))
+            {
+                double s, co;
+                HalfDiff(a, s, co);
+                fV += 2. * s * s ;
+                fS += 2. * s * co;
+            }
+            AddCompensated(m_fV, m_fVComp, fV);
+            AddCompensated(m_fS, m_fSComp, fS);
+        }
+        m_n += A.size();
+    }
+
+    // combine the summary of another shard - associative and commutative, up to rounding
+    WrappedNormalFit& Merge(const WrappedNormalFit& F)
+    {
+        if (F.m_n == 0)
+            return *this;
+        if (m_n == 0)
+            return *this = F;
+
+        // the sums of F, relative to this reference: d' = d + r, r = F.m_Ref - m_Ref
+        const double r = ToR(CircVal<SignedRadRange>(F.m_Ref - m_Ref));
+        const auto [s, c] = sincos(CircVal<SignedRadRange>(0.5 * r));
+        const double fVers = 2. * s * s; // 1-cos(r)
+        const double fSin  = 2. * s * c; //   sin(r)
+        const double n     = static_cast<double>(F.m_n);
+
+        AddCompensated(m_fV, m_fVComp, n * fVers + F.GetV() * (1. - fVers) + F.GetS() * fSin);
+        AddCompensated(m_fS, m_fSComp, F.GetS() * (1. - fVers) + (n - F.GetV()) * fSin);
+        m_n += F.m_n;
+        return *this;
+    }
+
+    // ----------------------------------------------
+    // mean resultant length Rbar
+    double GetR() const
+    {
+        if (m_n == 0)
+            throw std::domain_error("no values for WrappedNormalFit");
+
+        return std::sqrt(std::max(1. - Get1mR2(), 0.));
+    }
+
+    // estimated mean
+    CircVal<T> GetMean() const
+    {
+        if (m_n == 0)
+            throw std::domain_error("no values for WrappedNormalFit");
+
+        return m_Ref + CircVal<T>(CircVal<SignedRadRange>(std::atan2(GetS(), m_n - GetV())));
+    }
+
+    // estimated sigma, in the units of T; 0 for less than 2 values
+    double GetSigma() const
+    {
+        if (m_n == 0)
+            throw std::domain_error("no values for WrappedNormalFit");
+        if (m_n == 1)
+            return 0.;
+
+        const double f1mRho2 = m_n / (m_n - 1.) * Get1mR2();                                    // 1 - rho^2
+        const double fRho2   = std::max(1. - f1mRho2, std::numeric_limits<double>::min());
+        const double fSigma2 = f1mRho2 < 0.5 ? -std::log1p(-f1mRho2) : -std::log(fRho2);       // sigma^2 [rad^2]
+        return std::sqrt(std::max(fSigma2, 0.)) * (T::R / (2. * std::numbers::pi));
+    }
+
+    // the fitted distribution, over the range of T
+    wrapped_normal_distribution<double> GetDist() const
+    {
+        return wrapped_normal_distribution<double>(GetMean(), GetSigma(), T::L, T::H);
+    }
+
+private:
+    // 1 - Rbar^2 = (2*V*n - V^2 - S^2) / n^2, V = sum(1-cos(d)), S = sum(sin(d))
+    double Get1mR2() const
+    {
+        const double n = static_cast<double>(m_n);
+        const double V = GetV() / n;
+        const double S = GetS() / n;
+        return std::clamp(V * (2. - V) - S * S, 0., 1.);
+    }
+};
+
+// ==========================================================================
+// one iteration of the EM algorithm for the parameters of a wrapped normal distribution - mergeable
+// the values are taken as unwrapped normal values x + k*w with unknown k, w: the range of T; the E step weights the
+// images of each value by their densities under the current parameters (fMean, fSigma), the M step sets the mean and
+// sigma to the weighted mean and standard deviation of the images. each iteration does not decrease the likelihood.
+// the images within _Wrapped_normal_series::_R sigma of the mean are summed, the nearest one always: no underflow far
+// from the mean. 2*_R*sigma/w + 1 images at most - a single one for sigma < w/(2*_R).
+// T is a circular value type defined with the CircValTypeDef macro
+template<typename T>
+class WrappedNormalEMStep
+{
+    static constexpr double W = T::R;
+
+    double   m_fMean     ; // current parameters: mean in [L,H), sigma > 0
+    double   m_fSigma    ;
+    int      m_nK        ; // images k in [-m_nK, m_nK]
+    uint64_t m_n     = 0 ; // number of values
+    double   m_fM1   = 0.; // sum of the expected differences of the images from the mean
+    double   m_fM2   = 0.; // sum of their expected squares
+    double   m_fLogL = 0.; // sum of log(density * sigma * sqrt(2*pi))
+
+public:
+    WrappedNormalEMStep(double fMean, double fSigma)
+        : m_fMean (Mod(fMean - T::L, W) + T::L                                 ),
+          m_fSigma(std::max(fSigma, W * std::numeric_limits<double>::epsilon())),
+          m_nK    (static_cast<int>(_Wrapped_normal_series::_R * m_fSigma / W + 0.5))
+    {
+    }
+
+    explicit WrappedNormalEMStep(const wrapped_normal_distribution<double>& D) : WrappedNormalEMStep(D.mean(), D.sigma())
+    {
+    }
+
+    uint64_t GetN() const { return m_n; }
+
+    // C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+    template<CircValue C>
+    void Add(std::span<const C> A)
+    {
+        const double f1_2S2 = 0.5 / Sqr(m_fSigma);
+        double       fM1 = 0., fM2 = 0., fLogL = 0.;
+
+        for (const auto& a : A)
+        {
+            double d = static_cast<double>(CircVal<T>(a)) - m_fMean; // (-w,w): both in [L,H)
+            d += d < -0.5 * W ? W : d >= 0.5 * W ? -W : 0.;          // nearest image [-w/2,w/2)
+
+            double p = 1., s1 = d, s2 = d * d;  // densities relative to the nearest image's
+            for (int k = 1; k <= m_nK; ++k)
+                for (const double y : { d - k * W, d + k * W })
+                {
+                    const double e = std::exp((d * d - y * y) * f1_2S2);
+                    p  += e        ;
+                    s1 += e * y    ;
+                    s2 += e * y * y;
+                }
+
+            fM1   += s1 / p;
+            fM2   += s2 / p;
+            fLogL += std::log(p) - d * d * f1_2S2;
+        }
+
+        m_n     += A.size();
+        m_fM1   += fM1  ;
+        m_fM2   += fM2  ;
+        m_fLogL += fLogL;
+    }
+
+    // combine the step of another shard - the same parameters
+    WrappedNormalEMStep& Merge(const WrappedNormalEMStep& S)
+    {
+        assert(S.m_fMean == m_fMean && S.m_fSigma == m_fSigma);
+        m_n     += S.m_n    ;
+        m_fM1   += S.m_fM1  ;
+        m_fM2   += S.m_fM2  ;
+        m_fLogL += S.m_fLogL;
+        return *this;
+    }
+
+    // log-likelihood of the values under the current parameters
+    double GetLogLikelihood() const
+    {
+        return m_fLogL - m_n * std::log(m_fSigma * _Wrapped_normal_series::_Sqrt2Pi);
+    }
+
+    // the updated parameters
+    double GetMean() const
+    {
+        return m_n ? Mod(m_fMean + m_fM1 / m_n - T::L, W) + T::L : m_fMean;
+    }
+
+    double GetSigma() const
+    {
+        return m_n ? std::sqrt(std::max(m_fM2 / m_n - Sqr(m_fM1 / m_n), 0.)) : m_fSigma;
+    }
+
+    wrapped_normal_distribution<double> GetDist() const
+    {
+        return wrapped_normal_distribution<double>(GetMean(), GetSigma(), T::L, T::H);
+    }
+};
+
+// ==========================================================================
+// fit a wrapped normal distribution to the values of A: the moment estimate, refined by up to nIters EM iterations -
+// until mean and sigma change by less than fTol*sigma
+// the values are processed in chunks of FitWrappedNormalChunk values, whose summaries are merged in order: the result
+// does not depend on the execution policy or the number of threads
+// T is a circular value type defined with the CircValTypeDef macro
+// C is CircVal<T>, or a type convertible to it such as CircValFixed<T, IntT, Bits> - see the CircValue concept
+static constexpr size_t FitWrappedNormalChunk = 1 << 16;
+
+template<typename ExecutionPolicy, CircValue C, typename T = typename C::CircType>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+wrapped_normal_distribution<double> FitWrappedNormal(ExecutionPolicy&& Policy, std::span<const C> A, size_t nIters = 0, double fTol = 1e-9)
+{
+    const size_t nChunks = (A.size() + FitWrappedNormalChunk - 1) / FitWrappedNormalChunk;
+    auto         Chunks  = std::views::iota(size_t(0), nChunks);
+    auto         Chunk   = [&](size_t c) { return A.subspan(c * FitWrappedNormalChunk, std::min(FitWrappedNormalChunk, A.size() - c * FitWrappedNormalChunk)); };
+
+    std::vector<WrappedNormalFit<T>> Fits(nChunks);
+    std::for_each(Policy, Chunks.begin(), Chunks.end(), [&](size_t c) { Fits[c].Add(Chunk(c)); });
+
+    WrappedNormalFit<T> Fit;
+    for (const auto& F : Fits)
+        Fit.Merge(F);
+
+    double fMean  = Fit.GetMean();
+    double fSigma = Fit.GetSigma();
+    for (size_t i = 0; i < nIters && fSigma > 0.; ++i)
+    {
+        std::vector<WrappedNormalEMStep<T>> Steps(nChunks, WrappedNormalEMStep<T>(fMean, fSigma));
+        std::for_each(Policy, Chunks.begin(), Chunks.end(), [&](size_t c) { Steps[c].Add(Chunk(c)); });
+
+        WrappedNormalEMStep<T> Step(fMean, fSigma);
+        for (const auto& S : Steps)
+            Step.Merge(S);
+
+        const double fMean1  = Step.GetMean ();
+        const double fSigma1 = Step.GetSigma();
+        const bool   bDone   = std::abs(CircVal<T>::Sdist(fMean, fMean1)) <= fTol * fSigma && std::abs(fSigma1 - fSigma) <= fTol * fSigma;
+        fMean  = fMean1 ;
+        fSigma = fSigma1;
+        if (bDone)
+            break;
+    }
+
+    return wrapped_normal_distribution<double>(fMean, fSigma, T::L, T::H);
+}
+
+template<CircValue C, typename T = typename C::CircType>
+wrapped_normal_distribution<double> FitWrappedNormal(std::span<const C> A, size_t nIters = 0, double fTol = 1e-9)
+{
+    return FitWrappedNormal(std::execution::seq, A, nIters, fTol);
+}
+
+// ==========================================================================
+// tester for WrappedNormalFit, WrappedNormalEMStep, FitWrappedNormal
+template <typename Type>
+class WrappedNormalFitTester
+{
+    typedef CircVal<Type> CV;
+
+    static std::vector<CV> Sample(double fMean, double fSigma, size_t n, uint64_t nSeed)
+    {
+        std::mt19937_64                     Eng(nSeed);
+        wrapped_normal_distribution<double> wnd(fMean, fSigma, Type::L, Type::H);
+        std::vector<CV>                          v(n);
+        for (auto& c : v)
+            c = wnd(Eng);
+        return v;
+    }
+
+    static void Test(double fMean, double fSigma)
+    {
+        const size_t     n = 200000;
+        const std::vector<CV> v = Sample(fMean, fSigma, n, 7);
+        const std::span<const CV> A(v);
+
+        // moments: within ~5 standard errors
+        WrappedNormalFit<Type> Fit;
+        Fit.Add(A);
+        assert(Fit.GetN() == n);
+        [[maybe_unused]] const double fSE = fSigma / std::sqrt(double(n)) * std::exp(Sqr(2. * std::numbers::pi * fSigma / Type::R) / 4.);
+        assert(std::abs(CV::Sdist(Fit.GetMean(), fMean)) < 5. * fSE);
+        assert(std::abs(Fit.GetSigma() - fSigma)         < 5. * fSE * std::exp(Sqr(2. * std::numbers::pi * fSigma / Type::R) / 4.));
+
+        // merge of shards, in any order
+        WrappedNormalFit<Type> F1, F2, F3;
+        F1.Add(A.subspan(0, n/3));
+        F2.Add(A.subspan(n/3, n/3));
+        for (size_t i = 2*(n/3); i < n; ++i)
+            F3.Add(v[i]);
+        WrappedNormalFit<Type> M1 = F3; M1.Merge(F1).Merge(F2);
+        WrappedNormalFit<Type> M2 = F2; M2.Merge(F3.Merge(F1));
+        assert(M1.GetN() == n && M2.GetN() == n);
+        for ([[maybe_unused]] const auto& M : { M1, M2 })
+        {
+            assert(std::abs(CV::Sdist(M.GetMean(), Fit.GetMean())) <= 1e-9 * Type::R);
+            assert(std::abs(M.GetSigma() - Fit.GetSigma())          <= 1e-9 * fSigma );
+        }
+
+        // EM: the likelihood does not decrease; converges to the maximum-likelihood estimate
+        double                  fMeanI = Fit.GetMean(), fSigmaI = Fit.GetSigma();
+        [[maybe_unused]] double fLogL  = -std::numeric_limits<double>::infinity();
+        for (int i = 0; i < 20; ++i)
+        {
+            WrappedNormalEMStep<Type> Step(fMeanI, fSigmaI);
+            Step.Add(A);
+            assert(Step.GetLogLikelihood() >= fLogL - 1e-9 * std::abs(fLogL));
+            fLogL   = Step.GetLogLikelihood();
+            fMeanI  = Step.GetMean ();
+            fSigmaI = Step.GetSigma();
+        }
+
+        const wrapped_normal_distribution<double> D = FitWrappedNormal(A, 100);
+        assert(std::abs(CV::Sdist(D.mean(), fMean)) < 5. * fSE);
+        assert(std::abs(D.sigma() - fSigma)          < 5. * fSE * std::exp(Sqr(2. * std::numbers::pi * fSigma / Type::R) / 4.));
+        assert(std::abs(CV::Sdist(D.mean(), fMeanI)) <= 1e-3 * fSigma && std::abs(D.sigma() - fSigmaI) <= 1e-3 * fSigma);
+
+        // the log-likelihood of EM is that of the density of the distribution
+        WrappedNormalEMStep<Type> Step(D);
+        Step.Add(A.subspan(0, 1000));
+        double fLogL2 = 0.;
+        for (size_t i = 0; i < 1000; ++i)
+            fLogL2 += D.log_pdf(v[i]);
+        assert(std::abs(Step.GetLogLikelihood() - fLogL2) <= 1e-9 * std::abs(fLogL2));
+
+        // the same result for any execution policy
+        [[maybe_unused]] const wrapped_normal_distribution<double> P = FitWrappedNormal(std::execution::par, A, 100);
+        assert(P.mean() == D.mean() && P.sigma() == D.sigma());
+    }
+
+public:
+    WrappedNormalFitTester()
+    {
+        for (const double f : { 0.001, 0.02, 0.1, 0.2 }) // sigma, as a fraction of the range
+            Test(Type::L + 0.3 * Type::R, f * Type::R);
+
+        // narrow distribution: no cancellation
+        {
+            const std::vector<CV>       v = Sample(Type::H - 1e-7 * Type::R, 1e-7 * Type::R, 10000, 8);
+            WrappedNormalFit<Type> Fit;
+            Fit.Add(std::span<const CV>(v));
+            assert(std::abs(Fit.GetSigma() / (1e-7 * Type::R) - 1.) < 0.05);
+        }
+
+        // degenerate
+        {
+            WrappedNormalFit<Type> Fit;
+            [[maybe_unused]] bool bThrown = false;
+            try { Fit.GetMean(); } catch (const std::domain_error&) { bThrown = true; }
+            assert(bThrown);
+
+            Fit.Add(CV(Type::Z));
+            assert(Fit.GetSigma() == 0. && Fit.GetMean() == CV(Type::Z));
+
+            const std::vector<CV> u = { CV(Type::L), CV(Type::L + Type::R_2) }; // no concentration
+            WrappedNormalFit<Type> Fit2;
+            Fit2.Add(std::span<const CV>(u));
+            assert(std::isfinite(Fit2.GetSigma()) && Fit2.GetSigma() > Type::R);
+        }
+    }
+};
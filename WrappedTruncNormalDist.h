@@ -1,337 +1,496 @@
-// ==========================================================================
-// wrapped truncated normal distribution
-// Lior Kogan (koganlior1@gmail.com), 2012
-// based on VC 2012 std::normal_distribution (random) as a skeleton
-// and on C. H. Jackson's R's implementation of the following paper:
-// Robert, C. P. Simulation of truncated normal variables. Statistics and Computing (1995) 5, 121-125
-// ==========================================================================
-
-#pragma once
-
-#include <random>
-#include "CircHelper.h" // Sqr, Mod
-
-#define _NRAND(eng, resty) \
-    (std::generate_canonical<resty, static_cast<size_t>(-1)>(eng))
-
-// ==========================================================================
-// TEMPLATE CLASS wrapped_truncated_normal_distribution
-template<class _Ty = double>
-class wrapped_truncated_normal_distribution
-{   // template class for wrapped truncated normal distribution
-public:
-    static_assert(std::is_floating_point<_Ty>::value,
-        "invalid template argument for wrapped_truncated_normal_distribution");
-
-    typedef wrapped_truncated_normal_distribution<_Ty> _Myt;
-    typedef _Ty result_type;
-
-    struct param_type
-    {   // parameter package
-        typedef _Myt distribution_type;
-
-        explicit param_type(_Ty _Mean0 = 0., _Ty _Sigma0 = 1., _Ty _A0 = 0., _Ty _B0 = 0., _Ty _L0 = 0., _Ty _H0 = 0.)
-        {   // construct from parameters
-            _Init(_Mean0, _Sigma0, _A0, _B0, _L0, _H0);
-        }
-
-        bool operator==(const param_type& _Right) const
-        {   // test for equality
-            return _Mean  == _Right._Mean  &&
-                   _Sigma == _Right._Sigma &&
-                   _A     == _Right._A     &&
-                   _B     == _Right._B     &&
-                   _L     == _Right._L     &&
-                   _H     == _Right._H        ;
-        }
-
-        bool operator!=(const param_type& _Right) const
-        {   // test for inequality
-            return !(*this == _Right);
-        }
-
-        _Ty mean() const
-        {   // return mean value
-            return _Mean;
-        }
-
-        _Ty sigma() const
-        {   // return sigma value
-            return _Sigma;
-        }
-
-        _Ty a() const
-        {   // return truncation-range lower-bound
-            return _A;
-        }
-
-        _Ty b() const
-        {   // return truncation-range upper-bound
-            return _B;
-        }
-
-        _Ty l() const
-        {   // return wrapping-range lower-bound
-            return _L;
-        }
-
-        _Ty h() const
-        {   // return wrapping-range upper-bound
-            return _H;
-        }
-
-        _Ty stddev() const
-        {   // return sigma value
-            return _Sigma;
-        }
-
-        int alg() const
-        {   // return fastest algorithm for the given parameters
-            return _Alg;
-        }
-
-        void _Init(_Ty _Mean0, _Ty _Sigma0, _Ty _A0, _Ty _B0, _Ty _L0, _Ty _H0)
-        {   // set internal state
-            if (_Sigma0 <  0.) throw std::domain_error("invalid sigma argument for wrapped_truncated_normal_distribution"  );
-            if (_B0     < _A0) throw std::logic_error ("invalid truncation-range for wrapped_truncated_normal_distribution");
-            if (_H0     < _L0) throw std::logic_error ("invalid wrapping-range for wrapped_truncated_normal_distribution"  );
-            _Mean  = _Mean0 ;
-            _Sigma = _Sigma0;
-            _A     = _A0    ;
-            _B     = _B0    ;
-            _L     = _L0    ;
-            _H     = _H0    ;
-
-            _NA = (_A - _Mean) / _Sigma;
-            _NB = (_B - _Mean) / _Sigma;
-
-            // decide on the fastest algorithm for our case
-            _Alg = 3;
-                 if ((_NA < 0 ) && ( _NB > 0) && (_NB - _NA > sqrt(2. * std::numbers::pi)))                                                         _Alg = 0;
-            else if ((_NA >= 0) && ( _NB >  _NA + 2.*sqrt(exp(1.)) / ( _NA + sqrt(Sqr(_NA) + 4.)) * exp((_NA*2. -  _NA*sqrt(Sqr(_NA) + 4.)) / 4.))) _Alg = 1;
-            else if ((_NB <= 0) && (-_NA > -_NB + 2.*sqrt(exp(1.)) / (-_NB + sqrt(Sqr(_NB) + 4.)) * exp((_NB*2. - -_NB*sqrt(Sqr(_NB) + 4.)) / 4.))) _Alg = 2;
-        }
-
-        _Ty _Mean ;
-        _Ty _Sigma;
-        _Ty _A    ;
-        _Ty _B    ;
-        _Ty _L    ;
-        _Ty _H    ;
-
-        _Ty _NA   ; // _A normalized
-        _Ty _NB   ; // _B normalized
-        int _Alg  ; // algorithm to use
-    };
-
-    // normal distribution is first truncated, and then wrapped
-    explicit wrapped_truncated_normal_distribution(_Ty _Mean0  =    0.                           ,
-                                                   _Ty _Sigma0 =    1.                           ,
-                                                   _Ty _A0     = std::numeric_limits< _Ty>::min(),   // truncation-range lower-bound
-                                                   _Ty _B0     = std::numeric_limits< _Ty>::max(),   // truncation-range upper-bound
-                                                   _Ty _L0     = -180.                           ,   // wrapping  -range lower-bound
-                                                   _Ty _H0     =  180.                            )  // wrapping  -range upper-bound
-
-        : _Par(_Mean0, _Sigma0, _A0, _B0, _L0, _H0)
-    {   // construct
-    }
-
-    explicit wrapped_truncated_normal_distribution(param_type _Par0)
-        : _Par(_Par0)
-    {   // construct from parameter package
-    }
-
-    _Ty mean() const
-    {   // return mean value
-        return _Par.mean();
-    }
-
-    _Ty sigma() const
-    {   // return sigma value
-        return _Par.sigma();
-    }
-
-    _Ty a() const
-    {   // return truncation-range lower-bound
-        return _Par.a();
-    }
-
-    _Ty b() const
-    {   // return truncation-range upper-bound
-        return _Par.b();
-    }
-
-    _Ty l() const
-    {   // return wrapping-range lower-bound
-        return _Par.l();
-    }
-
-    _Ty h() const
-    {   // return wrapping-range upper-bound
-        return _Par.h();
-    }
-
-    _Ty stddev() const
-    {   // return sigma value
-        return _Par.sigma();
-    }
-
-    param_type param() const
-    {   // return parameter package
-        return _Par;
-    }
-
-    void param(const param_type& _Par0)
-    {   // set parameter package
-        _Par = _Par0;
-        reset();
-    }
-
-    result_type (min)() const
-    {   // get smallest possible result
-        return _Par._A;
-    }
-
-    result_type (max)() const
-    {   // get largest possible result
-        return _Par._B;
-    }
-
-    void reset()
-    {   // clear internal state
-    }
-
-    template<class _Engine>
-    result_type operator()(_Engine& _Eng) const
-    {   // return next value
-        return _Eval(_Eng, _Par);
-    }
-
-    template<class _Engine>
-    result_type operator()(_Engine& _Eng, const param_type& _Par0) const
-    {   // return next value, given parameter package
-        reset();
-        return _Eval(_Eng, _Par0);
-    }
-
-    template<class _Elem, class _Traits>
-    basic_istream<_Elem, _Traits>& _Read(basic_istream<_Elem, _Traits>& _Istr)
-    {   // read state from _Istr
-        _Ty _Mean0 ;
-        _Ty _Sigma0;
-        _Ty _A0    ;
-        _Ty _B0    ;
-        _Ty _L0    ;
-        _Ty _H0    ;
-        _In(_Istr, _Mean0 );
-        _In(_Istr, _Sigma0);
-        _In(_Istr, _A0    );
-        _In(_Istr, _B0    );
-        _In(_Istr, _L0    );
-        _In(_Istr, _H0    );
-        _Par._Init(_Mean0, _Sigma0, _A0, _B0, _L0, _H0);
-
-        return _Istr;
-    }
-
-    template<class _Elem, class _Traits>
-    basic_ostream<_Elem, _Traits>& _Write(basic_ostream<_Elem, _Traits>& _Ostr) const
-    {   // write state to _Ostr
-        _Out(_Ostr, _Par._Mean );
-        _Out(_Ostr, _Par._Sigma);
-        _Out(_Ostr, _Par._A    );
-        _Out(_Ostr, _Par._B    );
-        _Out(_Ostr, _Par._L    );
-        _Out(_Ostr, _Par._H    );
-
-        return _Ostr;
-    }
-
-private:
-    template<class _Engine> result_type _Eval(_Engine& _Eng, const param_type& _Par0) const
-    {
-        _Ty _Res;
-
-        switch (_Par0._Alg)
-        {
-        case 0 :
-            {
-                normal_distribution<_Ty> nd;
-                do  { _Res = nd(_Eng); }
-                while (_Res < _Par0._NA || _Res > _Par0._NB);
-                break;
-            }
-
-        case 1 :
-            {
-                exponential_distribution<_Ty> ed;
-                _Ty a,u,z;
-
-                do
-                {
-                    a = (_Par0._NA + sqrt(Sqr(_Par0._NA)+4.))/2.;
-                    z = ed(_Eng, typename exponential_distribution<_Ty>::param_type(a)) + _Par0._NA;
-                    u = _NRAND(_Eng, _Ty);
-                }
-                while ((u > exp(-Sqr(z-a) / 2.)) || (z > _Par0._NB));
-
-                _Res = z;
-                break;
-            }
-
-        case 2 :
-            {
-                exponential_distribution<_Ty> ed;
-                _Ty a,u,z;
-
-                do
-                {
-                    a = (-_Par0._NB + sqrt(Sqr(_Par0._NB)+4.))/2.;
-                    z = ed(_Eng, typename exponential_distribution<_Ty>::param_type(a)) - _Par0._NB;
-                    u = _NRAND(_Eng, _Ty);
-                }
-                while ((u > exp(-Sqr(z-a)/2.)) || (z > -_Par0._NA));
-
-                _Res = -z;
-                break;
-            }
-
-        default:
-            {
-                _Ty z,u,rho;
-
-                do
-                {
-                    uniform_real_distribution<_Ty> ud(_Par0._NA, _Par0._NB);
-                    z = ud(_Eng);
-                    u = _NRAND(_Eng, _Ty);
-
-                         if (_Par0._NA > 0) rho = exp((Sqr(_Par0._NA)-Sqr(z)) / 2.);
-                    else if (_Par0._NB < 0) rho = exp((Sqr(_Par0._NB)-Sqr(z)) / 2.);
-                    else                    rho = exp(               -Sqr(z)  / 2.);
-                }
-                while (u > rho);
-
-                _Res = z;
-            }
-        }
-
-        result_type d = _Res * _Par0._Sigma + _Par0._Mean;        // denormalize result
-        return Mod(d - _Par0._L, _Par0._H - _Par0._L) + _Par0._L; // wrap        result
-    }
-
-    int        _Alg; // which algorithm to use
-    param_type _Par;
-};
-
-template<class _Elem, class _Traits, class _Ty>
-basic_istream<_Elem, _Traits>& operator>>(basic_istream<_Elem, _Traits>& _Istr, wrapped_truncated_normal_distribution<_Ty>& _Dist)
-{   // read state from _Istr
-    return _Dist._Read(_Istr);
-}
-
-template<class _Elem, class _Traits, class _Ty>
-basic_ostream<_Elem, _Traits>& operator<<(basic_ostream<_Elem, _Traits>& _Ostr, const wrapped_truncated_normal_distribution<_Ty>& _Dist)
-{   // write state to _Ostr
-    return _Dist._Write(_Ostr);
-}
+// ==========================================================================
+// wrapped truncated normal distribution
+// Lior Kogan (koganlior1@gmail.com), 2012
+// based on VC 2012 std::normal_distribution (random) as a skeleton
+// and on C. H. Jackson's R's implementation of the following paper:
+// Robert, C. P. Simulation of truncated normal variables. Statistics and Computing (1995) 5, 121-125
+// ==========================================================================
+
+// DRNadler 14-Oct-2026: Add pdf, log_pdf, cdf and quantile.
+
+// DRNadler 14-Oct-2026: Sample by _Truncated_std_normal of TruncNormalDist.h - the same selection of algorithms.
+
+// DRNadler 14-Oct-2026: Count the samples and the attempts of each algorithm (CircInstrument.h).
+
+// DRNadler 14-Oct-2026: Add bulk fill / generate sampling.
+
+#pragma once
+
+#include <random>
+#include <algorithm>    // std::copy_n, std::min
+#include <assert.h>
+#include <iterator>     // std::contiguous_iterator
+#include <span>
+#include "CircHelper.h"      // Sqr, Mod
+#include "TruncNormalDist.h"   // _Truncated_std_normal
+#include "WrappedNormalDist.h" // _Wrapped_normal_series
+
+#define _NRAND(eng, resty) \
+    (std::generate_canonical<resty, static_cast<size_t>(-1)>(eng))
+
+// ==========================================================================
+// TEMPLATE CLASS wrapped_truncated_normal_distribution
+template<class _Ty = double>
+class wrapped_truncated_normal_distribution
+{   // template class for wrapped truncated normal distribution
+public:
+    static_assert(std::is_floating_point<_Ty>::value,
+        "invalid template argument for wrapped_truncated_normal_distribution");
+
+    typedef wrapped_truncated_normal_distribution<_Ty> _Myt;
+    typedef _Ty result_type;
+
+    typedef _Truncated_std_normal<_Ty, CircSite::WrappedTruncNormal0> _Std_type;
+
+    struct param_type
+    {   // parameter package
+        typedef _Myt distribution_type;
+
+        static constexpr int alg_auto       = _Std_type::alg_auto      ; // select the fastest algorithm, among 0..4
+        static constexpr int alg_auto_table = _Std_type::alg_auto_table; // select the fastest algorithm, among 0..5 - for parameters used for many values
+
+        // _Alg0: algorithm to use (0..5 - see _Truncated_std_normal), or alg_auto, alg_auto_table
+        explicit param_type(_Ty _Mean0 = 0., _Ty _Sigma0 = 1., _Ty _A0 = 0., _Ty _B0 = 0., _Ty _L0 = 0., _Ty _H0 = 0., int _Alg0 = alg_auto)
+        {   // construct from parameters
+            _Init(_Mean0, _Sigma0, _A0, _B0, _L0, _H0, _Alg0);
+        }
+
+        bool operator==(const param_type& _Right) const
+        {   // test for equality
+            return _Mean  == _Right._Mean  &&
+                   _Sigma == _Right._Sigma &&
+                   _A     == _Right._A     &&
+                   _B     == _Right._B     &&
+                   _L     == _Right._L     &&
+                   _H     == _Right._H        ;
+        }
+
+        bool operator!=(const param_type& _Right) const
+        {   // test for inequality
+            return !(*this == _Right);
+        }
+
+        _Ty mean() const
+        {   // return mean value
+            return _Mean;
+        }
+
+        _Ty sigma() const
+        {   // return sigma value
+            return _Sigma;
+        }
+
+        _Ty a() const
+        {   // return truncation-range lower-bound
+            return _A;
+        }
+
+        _Ty b() const
+        {   // return truncation-range upper-bound
+            return _B;
+        }
+
+        _Ty l() const
+        {   // return wrapping-range lower-bound
+            return _L;
+        }
+
+        _Ty h() const
+        {   // return wrapping-range upper-bound
+            return _H;
+        }
+
+        _Ty stddev() const
+        {   // return sigma value
+            return _Sigma;
+        }
+
+        int alg() const
+        {   // return fastest algorithm for the given parameters
+            return _Std._Alg;
+        }
+
+        double acceptance() const
+        {   // return acceptance rate of the algorithm: expected values per attempt
+            return _Std._Accept;
+        }
+
+        void _Init(_Ty _Mean0, _Ty _Sigma0, _Ty _A0, _Ty _B0, _Ty _L0, _Ty _H0, int _Alg0 = alg_auto)
+        {   // set internal state
+            if (_Sigma0 <  0.) throw std::domain_error("invalid sigma argument for wrapped_truncated_normal_distribution"  );
+            if (_B0     < _A0) throw std::logic_error ("invalid truncation-range for wrapped_truncated_normal_distribution");
+            if (_H0     < _L0) throw std::logic_error ("invalid wrapping-range for wrapped_truncated_normal_distribution"  );
+            _Mean  = _Mean0 ;
+            _Sigma = _Sigma0;
+            _A     = _A0    ;
+            _B     = _B0    ;
+            _L     = _L0    ;
+            _H     = _H0    ;
+
+            _Std._Init((_A - _Mean) / _Sigma, (_B - _Mean) / _Sigma, _Alg0); // decide on the fastest algorithm for our case
+            _Ser._Init(_Mean, _Sigma, _L, _H, _A, _B);
+        }
+
+        _Ty                    _Mean ;
+        _Ty                    _Sigma;
+        _Ty                    _A    ;
+        _Ty                    _B    ;
+        _Ty                    _L    ;
+        _Ty                    _H    ;
+
+        _Std_type              _Std  ; // normalized range [_NA,_NB], algorithm to use, and its constants
+        _Wrapped_normal_series _Ser  ; // pdf, cdf: form of the series, and its constants
+    };
+
+    // normal distribution is first truncated, and then wrapped
+    explicit wrapped_truncated_normal_distribution(_Ty _Mean0  =    0.                           ,
+                                                   _Ty _Sigma0 =    1.                           ,
+                                                   _Ty _A0     = std::numeric_limits< _Ty>::min(),   // truncation-range lower-bound
+                                                   _Ty _B0     = std::numeric_limits< _Ty>::max(),   // truncation-range upper-bound
+                                                   _Ty _L0     = -180.                           ,   // wrapping  -range lower-bound
+                                                   _Ty _H0     =  180.                            )  // wrapping  -range upper-bound
+
+        : _Par(_Mean0, _Sigma0, _A0, _B0, _L0, _H0)
+    {   // construct
+    }
+
+    explicit wrapped_truncated_normal_distribution(param_type _Par0)
+        : _Par(_Par0)
+    {   // construct from parameter package
+    }
+
+    _Ty mean() const
+    {   // return mean value
+        return _Par.mean();
+    }
+
+    _Ty sigma() const
+    {   // return sigma value
+        return _Par.sigma();
+    }
+
+    _Ty a() const
+    {   // return truncation-range lower-bound
+        return _Par.a();
+    }
+
+    _Ty b() const
+    {   // return truncation-range upper-bound
+        return _Par.b();
+    }
+
+    _Ty l() const
+    {   // return wrapping-range lower-bound
+        return _Par.l();
+    }
+
+    _Ty h() const
+    {   // return wrapping-range upper-bound
+        return _Par.h();
+    }
+
+    _Ty stddev() const
+    {   // return sigma value
+        return _Par.sigma();
+    }
+
+    param_type param() const
+    {   // return parameter package
+        return _Par;
+    }
+
+    void param(const param_type& _Par0)
+    {   // set parameter package
+        _Par = _Par0;
+        reset();
+    }
+
+    result_type (min)() const
+    {   // get smallest possible result
+        return _Par._A;
+    }
+
+    result_type (max)() const
+    {   // get largest possible result
+        return _Par._B;
+    }
+
+    void reset()
+    {   // clear internal state
+    }
+
+    template<class _Engine>
+    result_type operator()(_Engine& _Eng) const
+    {   // return next value
+        return _Eval(_Eng, _Par);
+    }
+
+    template<class _Engine>
+    result_type operator()(_Engine& _Eng, const param_type& _Par0) const
+    {   // return next value, given parameter package
+        reset();
+        return _Eval(_Eng, _Par0);
+    }
+
+    template<class _Engine>
+    void fill(_Engine& _Eng, std::span<_Ty> _Out) const
+    {   // fill _Out with next values
+        _Fill(_Eng, _Out, _Par);
+    }
+
+    template<class _Engine, class _FwdIt>
+    void generate(_Engine& _Eng, _FwdIt _First, _FwdIt _Last) const
+    {   // assign next values to [_First, _Last)
+        if constexpr (std::contiguous_iterator<_FwdIt> && std::is_same_v<std::iter_value_t<_FwdIt>, _Ty>)
+            fill(_Eng, std::span<_Ty>(std::to_address(_First), std::to_address(_Last)));
+        else
+        {
+            _Ty _Buf[_BlockSize];
+            for (auto _Count = std::distance(_First, _Last); _Count > 0; )
+            {
+                const size_t _N = std::min(static_cast<size_t>(_Count), _BlockSize);
+                fill(_Eng, std::span<_Ty>(_Buf, _N));
+                _First  = std::copy_n(_Buf, _N, _First);
+                _Count -= _N;
+            }
+        }
+    }
+
+    _Ty pdf(_Ty _X) const
+    {   // return density at _X - the density is periodic: _X is wrapped
+        return static_cast<_Ty>(_Par._Ser._Pdf(_X));
+    }
+
+    _Ty log_pdf(_Ty _X) const
+    {   // return log of the density at _X - does not underflow far from the mean
+        return static_cast<_Ty>(_Par._Ser._LogPdf(_X));
+    }
+
+    _Ty cdf(_Ty _X) const
+    {   // return probability of a value in [l,_X]
+        return static_cast<_Ty>(_Par._Ser._Cdf(_X));
+    }
+
+    _Ty quantile(_Ty _P) const
+    {   // return the value in [l,h] whose cdf is _P
+        return static_cast<_Ty>(_Par._Ser._Quantile(_P));
+    }
+
+    void pdf(std::span<const _Ty> _X, std::span<_Ty> _Out) const
+    {   // _Out[i]= pdf(_X[i])
+        assert(_X.size() == _Out.size());
+        for (size_t i = 0; i < _X.size(); ++i)
+            _Out[i] = pdf(_X[i]);
+    }
+
+    void log_pdf(std::span<const _Ty> _X, std::span<_Ty> _Out) const
+    {   // _Out[i]= log_pdf(_X[i])
+        assert(_X.size() == _Out.size());
+        for (size_t i = 0; i < _X.size(); ++i)
+            _Out[i] = log_pdf(_X[i]);
+    }
+
+    void cdf(std::span<const _Ty> _X, std::span<_Ty> _Out) const
+    {   // _Out[i]= cdf(_X[i])
+        assert(_X.size() == _Out.size());
+        for (size_t i = 0; i < _X.size(); ++i)
+            _Out[i] = cdf(_X[i]);
+    }
+
+    template<class _Elem, class _Traits>
+    basic_istream<_Elem, _Traits>& _Read(basic_istream<_Elem, _Traits>& _Istr)
+    {   // read state from _Istr
+        _Ty                    _Mean0 ;
+        _Ty                    _Sigma0;
+        _Ty                    _A0    ;
+        _Ty                    _B0    ;
+        _Ty                    _L0    ;
+        _Ty                    _H0    ;
+        _In(_Istr, _Mean0 );
+        _In(_Istr, _Sigma0);
+        _In(_Istr, _A0    );
+        _In(_Istr, _B0    );
+        _In(_Istr, _L0    );
+        _In(_Istr, _H0    );
+        _Par._Init(_Mean0, _Sigma0, _A0, _B0, _L0, _H0);
+
+        return _Istr;
+    }
+
+    template<class _Elem, class _Traits>
+    basic_ostream<_Elem, _Traits>& _Write(basic_ostream<_Elem, _Traits>& _Ostr) const
+    {   // write state to _Ostr
+        _Out(_Ostr, _Par._Mean );
+        _Out(_Ostr, _Par._Sigma);
+        _Out(_Ostr, _Par._A    );
+        _Out(_Ostr, _Par._B    );
+        _Out(_Ostr, _Par._L    );
+        _Out(_Ostr, _Par._H    );
+
+        return _Ostr;
+    }
+
+private:
+    template<class _Engine> result_type _Eval(_Engine& _Eng, const param_type& _Par0) const
+    {
+        result_type d = _Par0._Std._Eval(_Eng) * _Par0._Sigma + _Par0._Mean; // denormalize result
+        return Mod(d - _Par0._L, _Par0._H - _Par0._L) + _Par0._L;           // wrap        result
+    }
+
+    template<class _Engine> void _Fill(_Engine& _Eng, std::span<_Ty> _Out, const param_type& _Par0) const
+    {   // compute next values: same algorithms as _Eval, with the per-algorithm setup done once for the whole block
+        _Par0._Std._Fill(_Eng, _Out);
+
+        for (_Ty& d : _Out)
+            d = d * _Par0._Sigma + _Par0._Mean - _Par0._L; // denormalize result
+
+        Mod(_Out, _Par0._H - _Par0._L);                    // wrap        result
+
+        for (_Ty& d : _Out)
+            d += _Par0._L;
+    }
+
+    static constexpr size_t _BlockSize = 256; // generate(): number of values generated at once
+
+    param_type _Par;
+};
+
+template<class _Elem, class _Traits, class _Ty>
+basic_istream<_Elem, _Traits>& operator>>(basic_istream<_Elem, _Traits>& _Istr, wrapped_truncated_normal_distribution<_Ty>& _Dist)
+{   // read state from _Istr
+    return _Dist._Read(_Istr);
+}
+
+template<class _Elem, class _Traits, class _Ty>
+basic_ostream<_Elem, _Traits>& operator<<(basic_ostream<_Elem, _Traits>& _Ostr, const wrapped_truncated_normal_distribution<_Ty>& _Dist)
+{   // write state to _Ostr
+    return _Dist._Write(_Ostr);
+}
+
+// ==========================================================================
+// tester for the pdf, log_pdf, cdf and quantile of wrapped_normal_distribution and wrapped_truncated_normal_distribution,
+// and for wrapped_density_table - against direct summation of the truncated images
+template<class _Ty= double>
+class WrappedDensityTester
+{
+    static constexpr bool   bDouble = std::is_same_v<_Ty, double>;
+    static constexpr double fRelTol = bDouble ? 1e-10 : 2e-5; // pdf, relative
+    static constexpr double fAbsTol = bDouble ? 1e-12 : 2e-6; // cdf, absolute
+    static constexpr double fTabTol = bDouble ? 1e-6  : 1e-5; // wrapped_density_table, relative to the peak density
+
+    static double PhiDiff(double a, double b)
+    {   // Phi(b) - Phi(a), a <= b - without cancellation in the tails
+        const double s = std::numbers::sqrt2;
+        return a > 0. ? 0.5 * (std::erfc( a / s) - std::erfc( b / s))
+                      : 0.5 * (std::erfc(-b / s) - std::erfc(-a / s));
+    }
+
+    struct Brute
+    {   // normal(fMean, fSigma), truncated to [fA,fB], wrapped to [fL,fH): direct summation
+        double fMean, fSigma, fA, fB, fL, fH;
+
+        double Lo() const { return std::max(fA, fMean - 40. * fSigma); }
+        double Hi() const { return std::min(fB, fMean + 40. * fSigma); }
+        double W () const { return fH - fL; }
+        double Z () const { return PhiDiff((Lo() - fMean) / fSigma, (Hi() - fMean) / fSigma); }
+
+        double Pdf(double x) const
+        {
+            x = Mod(x - fL, W()) + fL;
+            double f = 0.;
+            for (double k = std::floor((Lo() - x) / W()) - 1.; k <= std::ceil((Hi() - x) / W()) + 1.; ++k)
+            {
+                const double y = x + k * W();
+                if (y >= fA && y <= fB)
+                    f += std::exp(-0.5 * Sqr((y - fMean) / fSigma));
+            }
+            return f / (fSigma * std::sqrt(2. * std::numbers::pi) * Z());
+        }
+
+        double Cdf(double x) const
+        {   // probability of a value in [fL,x]
+            double f = 0.;
+            for (double k = std::floor((Lo() - fH) / W()) - 1.; k <= std::ceil((Hi() - fL) / W()) + 1.; ++k)
+            {
+                const double y0 = std::max(fL + k * W(), Lo());
+                const double y1 = std::min(x  + k * W(), Hi());
+                if (y0 < y1)
+                    f += PhiDiff((y0 - fMean) / fSigma, (y1 - fMean) / fSigma);
+            }
+            return f / Z();
+        }
+    };
+
+    template<class _Dist>
+    static void Test(const _Dist& D, const Brute& B, bool& bFourier, bool& bImages)
+    {
+        (D.param()._Ser._Fourier ? bFourier : bImages) = true;
+
+        const size_t n = 1000;
+        std::vector<_Ty> x(n), f(n), g(n);
+        double           fPeak = 0.;
+        for (size_t i = 0; i < n; ++i)
+        {
+            x[i]  = static_cast<_Ty>(B.fL + B.W() * (i + 0.5) / n);
+            fPeak = std::max(fPeak, B.Pdf(x[i]));
+        }
+
+        D.pdf(std::span<const _Ty>(x), std::span<_Ty>(f));
+        D.cdf(std::span<const _Ty>(x), std::span<_Ty>(g));
+        for (size_t i = 0; i < n; ++i)
+        {
+            [[maybe_unused]] const double p = B.Pdf(x[i]);
+            [[maybe_unused]] const double c = B.Cdf(x[i]);
+            assert(f[i] == D.pdf(x[i]) && g[i] == D.cdf(x[i]));                               // batch == scalar
+            assert(std::abs(f[i] - p) <= fRelTol * p + std::numeric_limits<_Ty>::min());
+            assert(std::abs(g[i] - c) <= fAbsTol);
+            assert(i == 0 || g[i] >= g[i-1]);                                                  // monotonic
+            if (p > 1e-30)
+                assert(std::abs(D.log_pdf(x[i]) - std::log(p)) <= (bDouble ? 1e-9 : 1e-4));
+        }
+
+        for (double q = 0.01; q < 1.; q += 0.01)
+            assert(std::abs(D.cdf(D.quantile(static_cast<_Ty>(q))) - q) <= (bDouble ? 1e-10 : 1e-4));
+
+        const wrapped_density_table<_Dist> T(D);
+        for (size_t i = 0; i < n; ++i)
+        {
+            assert(std::abs(T.pdf(x[i]) - f[i]) <= fTabTol * fPeak);
+            assert(std::abs(T.cdf(x[i]) - g[i]) <= fTabTol);
+        }
+    }
+
+public:
+    WrappedDensityTester()
+    {
+        bool bFourier = false, bImages = false;
+
+        const double Normal[][4] = { {   0.,   5., -180., 180. },   // mean, sigma, wrapping-range
+                                     {   0.,  45., -180., 180. },
+                                     { 350.,  80.,    0., 360. },
+                                     {  10., 100.,    0., 360. },
+                                     { 400., 300.,    0., 360. },
+                                     {   1., 0.5 , -std::numbers::pi, std::numbers::pi } };
+
+        for (const auto& p : Normal)
+            Test(wrapped_normal_distribution<_Ty>(static_cast<_Ty>(p[0]), static_cast<_Ty>(p[1]), static_cast<_Ty>(p[2]), static_cast<_Ty>(p[3])),
+                 Brute{ p[0], p[1], -HUGE_VAL, HUGE_VAL, p[2], p[3] }, bFourier, bImages);
+
+        const double Trunc[][6] = { {   0.,  30.,  -50.,   70., -180., 180. },   // mean, sigma, truncation-range, wrapping-range
+                                    {  10., 100., -400.,  300.,    0., 360. },
+                                    {   0.,   1.,    3.,    4., -180., 180. },
+                                    {   0., 200., -1e4 ,  1e4 , -180., 180. },
+                                    { 100.,  20.,  150.,  900.,    0., 360. } };
+
+        for (const auto& p : Trunc)
+            Test(wrapped_truncated_normal_distribution<_Ty>(static_cast<_Ty>(p[0]), static_cast<_Ty>(p[1]), static_cast<_Ty>(p[2]), static_cast<_Ty>(p[3]), static_cast<_Ty>(p[4]), static_cast<_Ty>(p[5])),
+                 Brute{ p[0], p[1], p[2], p[3], p[4], p[5] }, bFourier, bImages);
+
+        assert(bFourier && bImages); // both forms of the series are tested
+
+        // far from the mode the density underflows, its log does not: two images at distance 180 sigma
+        [[maybe_unused]] const wrapped_normal_distribution<_Ty> N(0, 1, -180, 180);
+        [[maybe_unused]] const double fLog = std::log(2.) - 0.5 * 180. * 180. - 0.5 * std::log(2. * std::numbers::pi);
+        assert(N.pdf(180) == 0. && std::abs(N.log_pdf(180) - fLog) <= (bDouble ? 1e-12 : 1e-6) * std::abs(fLog));
+    }
+};
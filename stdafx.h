@@ -1,4 +1,12 @@
-#pragma once
-
-#include <stdio.h>
-#include <tchar.h>
+// DRNadler 14-Oct-2026: Define the MSVC names used by Circular.cpp (_tmain, _TCHAR) for other platforms.
+
+#pragma once
+
+#include <stdio.h>
+#ifdef _WIN32
+#include <tchar.h>
+#else
+// the MSVC names used by Circular.cpp, for other platforms
+#define _tmain main
+typedef char _TCHAR;
+#endif